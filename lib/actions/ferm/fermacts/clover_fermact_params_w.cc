@@ -21,6 +21,11 @@ namespace Chroma
 
     sub_zero=0;
     sub_zero_usedP=false;
+
+    twisted_m=0;
+    twisted_m_usedP=false;
+
+    comms_overlap=false;
   }
 
   //! Read parameters
@@ -101,6 +106,12 @@ namespace Chroma
     }
     else {				       
       twisted_m_usedP = false;
+      twisted_m=Real(0);
+    }
+
+    comms_overlap = false;
+    if( paramtop.count("CommsOverlap") != 0 ) { 
+      read(paramtop, "CommsOverlap", comms_overlap);
     }
 
   }
@@ -143,6 +154,10 @@ namespace Chroma
       write(xml, "TwistedM", param.twisted_m);
     }
 
+    if (param.comms_overlap) { 
+      write(xml, "CommsOverlap", param.comms_overlap);
+    }
+
     pop(xml);
   }
 
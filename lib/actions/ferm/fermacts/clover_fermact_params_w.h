@@ -35,6 +35,9 @@ namespace Chroma
     Real twisted_m;
     bool twisted_m_usedP;
 
+    // Overlap the dslash face exchange, if supported
+    bool comms_overlap;
+
   };
 
 
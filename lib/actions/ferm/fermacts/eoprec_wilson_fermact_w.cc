@@ -71,7 +71,9 @@ namespace Chroma
 				    multi1d<LatticeColorMatrix> >* 
   EvenOddPrecWilsonFermAct::linOp(Handle< FermState<T,P,Q> > state) const
   {
-    return new EvenOddPrecWilsonLinOp(state,param.Mass,param.anisoParam);
+    EvenOddPrecWilsonLinOp* lo = new EvenOddPrecWilsonLinOp(state,param.Mass,param.anisoParam);
+    lo->setCommsOverlap(param.comms_overlap);
+    return lo;
   }
 
 
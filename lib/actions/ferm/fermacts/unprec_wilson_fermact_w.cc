@@ -69,7 +69,9 @@ namespace Chroma
 		       multi1d<LatticeColorMatrix> >*
   UnprecWilsonFermAct::linOp(Handle< FermState<T,P,Q> > state) const
   {
-    return new UnprecWilsonLinOp(state,param.Mass,param.anisoParam); 
+    UnprecWilsonLinOp* lo = new UnprecWilsonLinOp(state,param.Mass,param.anisoParam);
+    lo->setCommsOverlap(param.comms_overlap);
+    return lo;
   }
 
 }
@@ -13,6 +13,7 @@ namespace Chroma
   WilsonFermActParams::WilsonFermActParams()
   {
     Mass = 0.0;
+    comms_overlap = false;
   }
 
 
@@ -46,6 +47,11 @@ namespace Chroma
     //  Read optional anisoParam.
     if (paramtop.count("AnisoParam") != 0) 
       read(paramtop, "AnisoParam", anisoParam);
+
+    //  Read optional overlap of the dslash communications
+    comms_overlap = false;
+    if (paramtop.count("CommsOverlap") != 0) 
+      read(paramtop, "CommsOverlap", comms_overlap);
   }
 
   //! Read parameters
@@ -63,6 +69,8 @@ namespace Chroma
     write(xml, "Mass", param.Mass);
     if (param.anisoParam.anisoP)
       write(xml, "AnisoParam", param.anisoParam);
+    if (param.comms_overlap)
+      write(xml, "CommsOverlap", param.comms_overlap);
 
     pop(xml);
   }
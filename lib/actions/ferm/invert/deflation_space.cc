@@ -0,0 +1,312 @@
+/*! \file
+ *  \brief Deflation subspace shared between solves
+ */
+
+#include "actions/ferm/invert/deflation_space.h"
+#include "actions/ferm/invert/inv_eigcg2.h"
+#include "actions/ferm/invert/norm_gram_schm.h"
+#include "meas/inline/io/named_objmap.h"
+#include "qdp_map_obj_disk.h"
+
+#include <qdp-lapack.h>
+
+namespace Chroma 
+{
+
+  //! Empty space
+  DeflationSpace::DeflationSpace(int Nvec_, int RefineEvery_) : 
+    Nvec(Nvec_), RefineEvery(RefineEvery_), 
+    evec(Nvec_ + RefineEvery_), eval(Nvec_),
+    nvec(0), npending(0), modified(false),
+    n_solves(0), n_iters(0), n_empty_solves(0), n_empty_iters(0),
+    last_guess_rsd(1)
+  {
+    eval = zero;
+  }
+
+
+  //! Add the deflated guess  x += sum_i v_i <v_i, b - A x> / lambda_i
+  void DeflationSpace::guess(const LinearOperator<T>& MdagM, T& x, const T& b, int& n_count) const
+  {
+    n_count = 0;
+    if (nvec == 0)
+      return;
+
+    InvEigCG2Env::InitGuess(MdagM, x, b, eval, evec, nvec, n_count);
+  }
+
+
+  //! Queue a vector, orthogonal to the space, for the next refinement
+  /*!
+   * Two passes of Gram-Schmidt are done. A vector that is (nearly)
+   * contained in the space already is dropped.
+   */
+  void DeflationSpace::addVector(const T& x, const Subset& s)
+  {
+    int n = nvec + npending;
+    if (n >= evec.size())
+      return;
+
+    T& v = evec[n];
+    v = zero;
+    v[s] = x;
+
+    Double nrm0 = sqrt(norm2(v, s));
+    if (toDouble(nrm0) == 0)
+      return;
+
+    for(int pass=0; pass < 2; ++pass)
+    {
+      for(int k=0; k < n; ++k)
+      {
+	Complex cc = innerProduct(evec[k], v, s);
+	v[s] -= cc*evec[k];
+      }
+    }
+
+    Double nrm = sqrt(norm2(v, s));
+    if (toDouble(nrm) < 1.0e-8*toDouble(nrm0))
+      return;
+
+    v[s] *= Real(1.0/nrm);
+
+    ++npending;
+    modified = true;
+  }
+
+
+  //! Rayleigh-Ritz on the space and the queue with operator MdagM
+  void DeflationSpace::refine(const LinearOperator<T>& MdagM)
+  {
+    START_CODE();
+
+    int n = nvec + npending;
+    if (n == 0)
+      return;
+
+    StopWatch swatch;
+    swatch.reset();
+    swatch.start();
+
+    const Subset& s = MdagM.subset();
+
+    LinAlg::Matrix<DComplex> H(n);
+    InvEigCG2Env::SubSpaceMatrix(H, MdagM, evec, n);
+
+    multi1d<Double> lambda;
+    char V = 'V'; char U = 'U';
+    QDPLapack::zheev(V, U, H.mat, lambda);
+
+    // Keep the lowest Ritz pairs, zheev returns them in ascending order
+    int nkeep = (n < Nvec) ? n : Nvec;
+
+    multi1d<T> rot(nkeep);
+    for(int k=0; k < nkeep; ++k)
+    {
+      rot[k] = zero;
+      for(int j=0; j < n; ++j)
+      {
+	Complex cc = conj(H(k,j));
+	rot[k][s] += cc*evec[j];
+      }
+    }
+
+    for(int k=0; k < nkeep; ++k)
+    {
+      evec[k][s] = rot[k];
+      eval[k] = lambda[k];
+    }
+
+    // Undo the rounding drift of repeated rotations
+    normGramSchmidt(evec, 0, nkeep, s);
+
+    nvec = nkeep;
+    npending = 0;
+    modified = true;
+
+    swatch.stop();
+    QDPIO::cout << "DeflationSpace: refined " << n << " -> " << nvec << " vectors."
+		<< " lambda_min = " << eval[0] << " lambda_max = " << eval[nvec-1]
+		<< " time = " << swatch.getTimeInSeconds() << " secs" << std::endl;
+
+    END_CODE();
+  }
+
+
+  //! Count a solve
+  void DeflationSpace::record(int n_count, const Real& guess_rsd)
+  {
+    if (nvec > 0)
+    {
+      ++n_solves;
+      n_iters += n_count;
+      last_guess_rsd = guess_rsd;
+    }
+    else
+    {
+      ++n_empty_solves;
+      n_empty_iters += n_count;
+    }
+  }
+
+
+  //! Print the effectiveness counters
+  void DeflationSpace::report(const std::string& id) const
+  {
+    QDPIO::cout << "DEFLATION_SPACE " << id << ": Nvec = " << nvec;
+    if (n_empty_solves > 0)
+      QDPIO::cout << "  undeflated solves = " << n_empty_solves
+		  << " mean iterations = " << double(n_empty_iters) / double(n_empty_solves);
+    if (n_solves > 0)
+      QDPIO::cout << "  deflated solves = " << n_solves
+		  << " mean iterations = " << double(n_iters) / double(n_solves)
+		  << " last guess relative rsd = " << last_guess_rsd;
+    QDPIO::cout << std::endl;
+  }
+
+
+  //! Read the vectors from a MapObjectDisk file
+  void DeflationSpace::readDisk(const std::string& file_name)
+  {
+    START_CODE();
+
+    QDP::MapObjectDisk<int,T> db;
+    db.open(file_name, std::ios_base::in);
+
+    std::string user_data;
+    db.getUserdata(user_data);
+
+    int n;
+    try
+    {
+      std::istringstream is(user_data);
+      XMLReader xml(is);
+      read(xml, "/DeflationSpace/nvec", n);
+    }
+    catch(const std::string& e)
+    {
+      QDPIO::cerr << "DeflationSpace: error reading " << file_name << ": " << e << std::endl;
+      QDP_abort(1);
+    }
+
+    // A file written with more vectors is truncated
+    if (n > Nvec)
+      n = Nvec;
+
+    for(int k=0; k < n; ++k)
+    {
+      if (db.get(k, evec[k]) != 0)
+      {
+	QDPIO::cerr << "DeflationSpace: vector " << k << " missing in " << file_name << std::endl;
+	QDP_abort(1);
+      }
+    }
+
+    // The Ritz values belong to the operator, they are recomputed
+    // by the first refinement
+    nvec = n;
+    npending = 0;
+    eval = zero;
+    modified = false;
+
+    QDPIO::cout << "DeflationSpace: read " << nvec << " vectors from " << file_name << std::endl;
+
+    END_CODE();
+  }
+
+
+  //! Write the Ritz vectors to a MapObjectDisk file
+  void DeflationSpace::writeDisk(const std::string& file_name)
+  {
+    START_CODE();
+
+    XMLBufferWriter file_xml;
+    push(file_xml, "DeflationSpace");
+    write(file_xml, "Nvec", Nvec);
+    write(file_xml, "RefineEvery", RefineEvery);
+    write(file_xml, "nvec", nvec);
+    multi1d<Real> ritz(nvec);
+    for(int k=0; k < nvec; ++k)
+      ritz[k] = eval[k];
+    write(file_xml, "eval", ritz);
+    pop(file_xml);
+
+    QDP::MapObjectDisk<int,T> db;
+    db.insertUserdata(file_xml.str());
+    db.open(file_name, std::ios_base::in | std::ios_base::out | std::ios_base::trunc);
+
+    for(int k=0; k < nvec; ++k)
+      db.insert(k, evec[k]);
+
+    db.flush();
+    modified = false;
+
+    QDPIO::cout << "DeflationSpace: wrote " << nvec << " vectors to " << file_name << std::endl;
+
+    END_CODE();
+  }
+
+
+  //! Deflation spaces held in the named object map
+  namespace DeflationSpaceEnv
+  {
+    //! Get the space with id params.space_id, creating it if necessary
+    Handle<DeflationSpace> getSpace(const DeflationSpaceParams& params)
+    {
+      if (TheNamedObjMap::Instance().check(params.space_id))
+	return TheNamedObjMap::Instance().getData< Handle<DeflationSpace> >(params.space_id);
+
+      Handle<DeflationSpace> space(new DeflationSpace(params.Nvec, params.RefineEvery));
+
+      if (params.file.read && params.file.file_name != "")
+      {
+	QDP::MapObjectDisk<int,LatticeFermion> probe;
+	if (probe.fileExists(params.file.file_name))
+	  space->readDisk(params.file.file_name);
+	else
+	  QDPIO::cout << "DeflationSpace: " << params.file.file_name 
+		      << " not found, starting with an empty space" << std::endl;
+      }
+
+      TheNamedObjMap::Instance().create< Handle<DeflationSpace> >(params.space_id);
+      TheNamedObjMap::Instance().getData< Handle<DeflationSpace> >(params.space_id) = space;
+
+      return space;
+    }
+
+
+    //! Create the space space_id from a file written by DeflationSpace::writeDisk
+    Handle<DeflationSpace> readSpace(const std::string& space_id,
+				     const std::string& file_name)
+    {
+      std::string user_data;
+      {
+	QDP::MapObjectDisk<int,LatticeFermion> db;
+	db.open(file_name, std::ios_base::in);
+	db.getUserdata(user_data);
+      }
+
+      DeflationSpaceParams params;
+      params.space_id = space_id;
+      params.file.file_name = file_name;
+      params.file.read  = true;
+      params.file.write = false;
+
+      try
+      {
+	std::istringstream is(user_data);
+	XMLReader xml(is);
+	read(xml, "/DeflationSpace/Nvec", params.Nvec);
+	read(xml, "/DeflationSpace/RefineEvery", params.RefineEvery);
+      }
+      catch(const std::string& e)
+      {
+	QDPIO::cerr << "DeflationSpace: " << file_name << " has no size information: " << e << std::endl;
+	QDP_abort(1);
+      }
+
+      return getSpace(params);
+    }
+  }
+
+}
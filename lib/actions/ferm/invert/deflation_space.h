@@ -0,0 +1,129 @@
+// -*- C++ -*-
+/*! \file
+ *  \brief Deflation subspace shared between solves
+ */
+
+#ifndef __deflation_space_h__
+#define __deflation_space_h__
+
+#include "chromabase.h"
+#include "handle.h"
+#include "linearop.h"
+#include "actions/ferm/invert/syssolver_deflated_params.h"
+
+namespace Chroma 
+{
+
+  //! Deflation subspace of a hermitian positive operator
+  /*! \ingroup invert
+   *
+   * Holds approximate low modes of M^dag M that outlive a single solver.
+   * Solutions of deflated solves are orthogonalised against the subspace
+   * and queued. Once RefineEvery of them are queued, a Rayleigh-Ritz step
+   * on the subspace plus the queue keeps the Nvec lowest Ritz vectors.
+   * When the operator changes (a new gauge field) the same step with the
+   * new operator updates the Ritz values, so the vectors are refined
+   * across configurations instead of being rebuilt from scratch.
+   *
+   * The space also counts the solves and iterations it was used for and
+   * the residual of the deflated guess, so its effect can be monitored.
+   */
+  class DeflationSpace
+  {
+  public:
+    typedef LatticeFermion T;
+
+    //! Empty space
+    /*!
+     * \param Nvec_         number of vectors kept        ( Read )
+     * \param RefineEvery_  queued vectors before a refinement ( Read )
+     */
+    DeflationSpace(int Nvec_, int RefineEvery_);
+
+    //! Number of Ritz vectors
+    int size() const {return nvec;}
+
+    //! Number of queued vectors
+    int pending() const {return npending;}
+
+    //! Ritz vector k
+    const T& vector(int k) const {return evec[k];}
+
+    //! Ritz value k, valid after a refinement with the current operator
+    const Double& value(int k) const {return eval[k];}
+
+    //! Has the space changed since it was read or written
+    bool dirty() const {return modified;}
+
+    //! Add the deflated guess  x += sum_i v_i <v_i, b - A x> / lambda_i
+    /*!
+     * \param MdagM    hermitian operator          ( Read )
+     * \param x        guess                       ( Modify )
+     * \param b        right hand side             ( Read )
+     * \param n_count  operator applications      ( Write )
+     */
+    void guess(const LinearOperator<T>& MdagM, T& x, const T& b, int& n_count) const;
+
+    //! Queue a vector, orthogonal to the space, for the next refinement
+    void addVector(const T& x, const Subset& s);
+
+    //! Rayleigh-Ritz on the space and the queue with operator MdagM
+    void refine(const LinearOperator<T>& MdagM);
+
+    //! Count a solve
+    /*!
+     * \param n_count    iterations of the solve           ( Read )
+     * \param guess_rsd  relative residual of the guess     ( Read )
+     */
+    void record(int n_count, const Real& guess_rsd);
+
+    //! Print the effectiveness counters
+    void report(const std::string& id) const;
+
+    //! Read the vectors from a MapObjectDisk file
+    void readDisk(const std::string& file_name);
+
+    //! Write the Ritz vectors to a MapObjectDisk file
+    void writeDisk(const std::string& file_name);
+
+  private:
+    //! Hide copies, the vectors are large
+    DeflationSpace(const DeflationSpace&);
+    DeflationSpace& operator=(const DeflationSpace&);
+
+    int Nvec;
+    int RefineEvery;
+
+    multi1d<T>       evec;       /*!< Ritz vectors followed by the queue */
+    multi1d<Double>  eval;       /*!< Ritz values */
+    int nvec;
+    int npending;
+    bool modified;
+
+    int n_solves;                /*!< solves using this space */
+    int n_iters;                 /*!< their iterations */
+    int n_empty_solves;          /*!< solves done with an empty space */
+    int n_empty_iters;           /*!< their iterations */
+    Real last_guess_rsd;
+  };
+
+
+  //! Deflation spaces held in the named object map
+  namespace DeflationSpaceEnv
+  {
+    //! Get the space with id params.space_id, creating it if necessary
+    /*!
+     * A new space is filled from params.file when it should be read and
+     * the file exists.
+     */
+    Handle<DeflationSpace> getSpace(const DeflationSpaceParams& params);
+
+    //! Create the space space_id from a file written by DeflationSpace::writeDisk
+    /*! The file holds the size of the space, the read does not need params */
+    Handle<DeflationSpace> readSpace(const std::string& space_id,
+				     const std::string& file_name);
+  }
+
+}
+
+#endif
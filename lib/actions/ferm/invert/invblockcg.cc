@@ -0,0 +1,386 @@
+/*! \file
+ *  \brief Block Conjugate-Gradient algorithm for a generic Linear Operator
+ */
+
+#include "chromabase.h"
+#include "actions/ferm/invert/invblockcg.h"
+
+namespace Chroma
+{
+
+  //! Anonymous namespace for the small dense linear algebra
+  namespace
+  {
+    //! Solve  G . X = B  for the N x N matrix X
+    /*!
+     * Gaussian elimination with partial pivoting. The matrices are the
+     * small block-CG Gram matrices, so this is cheap compared to a single
+     * lattice-wide operation and is done redundantly on every node.
+     */
+    void solveSmall(multi2d<DComplex>& X, const multi2d<DComplex>& G_, const multi2d<DComplex>& B)
+    {
+      const int n = G_.size1();
+      multi2d<DComplex> G(n,n);
+      X.resize(n, B.size1());
+      for(int i = 0; i < n; ++i)
+      {
+	for(int j = 0; j < n; ++j)
+	  G(i,j) = G_(i,j);
+	for(int j = 0; j < B.size1(); ++j)
+	  X(i,j) = B(i,j);
+      }
+
+      for(int col = 0; col < n; ++col)
+      {
+	// Find the pivot
+	int piv = col;
+	Double piv_sq = real(conj(G(col,col))*G(col,col));
+	for(int row = col+1; row < n; ++row)
+	{
+	  Double tmp = real(conj(G(row,col))*G(row,col));
+	  if ( toBool(tmp > piv_sq) )
+	  {
+	    piv = row;
+	    piv_sq = tmp;
+	  }
+	}
+
+	if ( toDouble(piv_sq) == 0.0 )
+	{
+	  QDPIO::cerr << "InvBlockCG: singular Gram matrix" << std::endl;
+	  QDP_abort(1);
+	}
+
+	if (piv != col)
+	{
+	  for(int j = 0; j < n; ++j)
+	  {
+	    DComplex t = G(col,j); G(col,j) = G(piv,j); G(piv,j) = t;
+	  }
+	  for(int j = 0; j < X.size1(); ++j)
+	  {
+	    DComplex t = X(col,j); X(col,j) = X(piv,j); X(piv,j) = t;
+	  }
+	}
+
+	// Eliminate below the pivot
+	for(int row = col+1; row < n; ++row)
+	{
+	  DComplex f = G(row,col) / G(col,col);
+	  for(int j = col; j < n; ++j)
+	    G(row,j) -= f * G(col,j);
+	  for(int j = 0; j < X.size1(); ++j)
+	    X(row,j) -= f * X(col,j);
+	}
+      }
+
+      // Back substitution
+      for(int row = n-1; row >= 0; --row)
+      {
+	for(int j = 0; j < X.size1(); ++j)
+	{
+	  DComplex t = X(row,j);
+	  for(int k = row+1; k < n; ++k)
+	    t -= G(row,k) * X(k,j);
+	  X(row,j) = t / G(row,row);
+	}
+      }
+    }
+
+
+    //! Hermitian Gram matrix  G(i,j) = < x_i, y_j >  with  x == y
+    template<typename T>
+    void gramMatrix(multi2d<DComplex>& G, const multi1d<T>& x, const Subset& s)
+    {
+      const int n = x.size();
+      G.resize(n,n);
+
+      for(int i = 0; i < n; ++i)
+      {
+	G(i,i) = cmplx(Double(norm2(x[i], s)), Double(0));
+	for(int j = i+1; j < n; ++j)
+	{
+	  G(i,j) = innerProduct(x[i], x[j], s);
+	  G(j,i) = conj(G(i,j));
+	}
+      }
+    }
+
+
+    //! Rectangular Gram matrix  G(i,j) = < x_i, y_j >
+    template<typename T>
+    void gramMatrix(multi2d<DComplex>& G, const multi1d<T>& x, const multi1d<T>& y, 
+		    const Subset& s)
+    {
+      G.resize(x.size(), y.size());
+
+      for(int i = 0; i < x.size(); ++i)
+	for(int j = 0; j < y.size(); ++j)
+	  G(i,j) = innerProduct(x[i], y[j], s);
+    }
+
+
+    //! y_j += sum_i p_i c(i,j)
+    template<typename T, typename CT>
+    void blockAxpy(multi1d<T>& y, const multi1d<T>& p, const multi2d<DComplex>& c,
+		   const Subset& s)
+    {
+      for(int j = 0; j < y.size(); ++j)
+	for(int i = 0; i < p.size(); ++i)
+	{
+	  CT cc = c(i,j);
+	  y[j][s] += cc * p[i];
+	}
+    }
+  }
+
+
+  //! Block Conjugate-Gradient (CGNE) algorithm for a generic Linear Operator
+  /*! \ingroup invert
+   *
+   * See the header file for the description of the algorithm
+   */
+  template<typename T, typename CT>
+  multi1d<SystemSolverResults_t>
+  InvBlockCG_a(const LinearOperator<T>& M,
+	       const multi1d<T>& chi,
+	       multi1d<T>& psi,
+	       const Real& RsdCG,
+	       int MaxCG)
+  {
+    START_CODE();
+
+    const Subset& s = M.subset();
+    const int nrhs = chi.size();
+
+    if (psi.size() != nrhs)
+    {
+      QDPIO::cerr << "InvBlockCG: psi and chi sizes do not match" << std::endl;
+      QDP_abort(1);
+    }
+
+    multi1d<SystemSolverResults_t> res(nrhs);
+
+    QDPIO::cout << "InvBlockCG: starting with " << nrhs << " sources" << std::endl;
+    FlopCounter flopcount;
+    flopcount.reset();
+    StopWatch swatch;
+    swatch.reset();
+    swatch.start();
+
+    // Target residuals
+    multi1d<Double> rsd_sq(nrhs);
+    multi1d<bool> converged(nrhs);
+    for(int i = 0; i < nrhs; ++i)
+    {
+      rsd_sq[i] = (RsdCG * RsdCG) * norm2(chi[i], s);
+      converged[i] = false;
+    }
+    flopcount.addSiteFlops(4*Nc*Ns*nrhs,s);
+
+    // The columns still being solved
+    multi1d<int> active(nrhs);
+    for(int i = 0; i < nrhs; ++i)
+      active[i] = i;
+    int nb = nrhs;
+
+    multi1d<T> x(nb), r(nb), mp(nb), mmp(nb);
+    for(int j = 0; j < nb; ++j)
+    {
+      moveToFastMemoryHint(r[j]);
+      x[j][s] = psi[j];
+    }
+
+    //  R  :=  Chi - M^dag . M . Psi
+    M(mp, x, PLUS);
+    M(mmp, mp, MINUS);
+    flopcount.addFlops(2*nb*M.nFlops());
+
+    for(int j = 0; j < nb; ++j)
+      r[j][s] = chi[j] - mmp[j];
+    flopcount.addSiteFlops(2*Nc*Ns*nb,s);
+
+    int k = 0;
+    multi1d<T> p;              // search directions, one per column of the previous step
+    multi2d<DComplex> pap;     // their Gram matrix < M.P, M.P >
+    for(;;)
+    {
+      // Deflate the converged columns out of the block
+      {
+	multi1d<Double> rsq(nb);
+	int n = 0;
+	for(int j = 0; j < nb; ++j)
+	{
+	  rsq[j] = norm2(r[j], s);
+	  if ( toBool(rsq[j] > rsd_sq[active[j]]) )
+	    ++n;
+	}
+	flopcount.addSiteFlops(4*Nc*Ns*nb,s);
+
+	multi1d<int> active_new(n);
+	multi1d<T> x_new(n), r_new(n);
+	n = 0;
+	for(int j = 0; j < nb; ++j)
+	{
+	  res[active[j]].n_count = k;
+	  res[active[j]].resid = sqrt(rsq[j]);
+
+	  if ( toBool(rsq[j] > rsd_sq[active[j]]) )
+	  {
+	    active_new[n] = active[j];
+	    x_new[n][s] = x[j];
+	    r_new[n][s] = r[j];
+	    ++n;
+	  }
+	  else
+	  {
+	    converged[active[j]] = true;
+	    psi[active[j]][s] = x[j];
+	  }
+	}
+
+	if (n < nb)
+	{
+	  active = active_new;
+	  x = x_new;
+	  r = r_new;
+	  nb = n;
+	}
+      }
+
+      if (nb == 0 || k == MaxCG)
+	break;
+
+      if (p.size() == 0)
+      {
+	//  P  :=  R
+	p.resize(nb);
+	for(int j = 0; j < nb; ++j)
+	{
+	  moveToFastMemoryHint(p[j]);
+	  p[j][s] = r[j];
+	}
+      }
+      else
+      {
+	//  b = -PAP^-1 < M^dag . M . P, R > ,  so the new P is A-orthogonal to the old one
+	multi2d<DComplex> aptr;
+	gramMatrix(aptr, mmp, r, s);
+	flopcount.addSiteFlops(4*Nc*Ns*p.size()*nb,s);
+
+	multi2d<DComplex> b;
+	solveSmall(b, pap, aptr);
+	for(int i = 0; i < b.size2(); ++i)
+	  for(int j = 0; j < b.size1(); ++j)
+	    b(i,j) = -b(i,j);
+
+	//  P  :=  R + P b ,  with one column per remaining source
+	multi1d<T> p_old(p);
+	p.resize(nb);
+	for(int j = 0; j < nb; ++j)
+	  p[j][s] = r[j];
+	blockAxpy<T,CT>(p, p_old, b, s);
+	flopcount.addSiteFlops(8*Nc*Ns*p_old.size()*nb,s);
+      }
+
+      ++k;
+
+      //  PAP  =  < M.P, M.P >
+      mp.resize(p.size());
+      mmp.resize(p.size());
+      M(mp, p, PLUS);
+      flopcount.addFlops(p.size()*M.nFlops());
+
+      gramMatrix(pap, mp, s);
+      flopcount.addSiteFlops(4*Nc*Ns*p.size()*p.size(),s);
+
+      //  a = PAP^-1 < P, R >
+      multi2d<DComplex> ptr;
+      gramMatrix(ptr, p, r, s);
+      flopcount.addSiteFlops(4*Nc*Ns*p.size()*nb,s);
+
+      multi2d<DComplex> a;
+      solveSmall(a, pap, ptr);
+
+      //  Psi += P a ;   R -= M^dag . M . P a
+      M(mmp, mp, MINUS);
+      flopcount.addFlops(p.size()*M.nFlops());
+
+      blockAxpy<T,CT>(x, p, a, s);
+      for(int i = 0; i < a.size2(); ++i)
+	for(int j = 0; j < a.size1(); ++j)
+	  a(i,j) = -a(i,j);
+      blockAxpy<T,CT>(r, mmp, a, s);
+      flopcount.addSiteFlops(16*Nc*Ns*p.size()*nb,s);
+    }
+
+    // Copy out the solutions which did not converge
+    for(int j = 0; j < nb; ++j)
+      psi[active[j]][s] = x[j];
+
+    swatch.stop();
+    flopcount.report("invblockcg", swatch.getTimeInSeconds());
+
+    for(int i = 0; i < nrhs; ++i)
+    {
+      if (! converged[i])
+      {
+	QDPIO::cerr << "Nonconvergence Warning" << std::endl;
+	QDPIO::cerr << "too many BlockCG iterations: source = " << i
+		    << " count = " << res[i].n_count << " rsd = " << res[i].resid << std::endl;
+      }
+    }
+
+    END_CODE();
+    return res;
+  }
+
+
+  //
+  // Explicit versions
+  //
+  // Single precision
+  multi1d<SystemSolverResults_t>
+  InvBlockCG(const LinearOperator<LatticeFermionF>& M,
+	     const multi1d<LatticeFermionF>& chi,
+	     multi1d<LatticeFermionF>& psi,
+	     const Real& RsdCG,
+	     int MaxCG)
+  {
+    return InvBlockCG_a<LatticeFermionF,ComplexF>(M, chi, psi, RsdCG, MaxCG);
+  }
+
+  // Double precision
+  multi1d<SystemSolverResults_t>
+  InvBlockCG(const LinearOperator<LatticeFermionD>& M,
+	     const multi1d<LatticeFermionD>& chi,
+	     multi1d<LatticeFermionD>& psi,
+	     const Real& RsdCG,
+	     int MaxCG)
+  {
+    return InvBlockCG_a<LatticeFermionD,ComplexD>(M, chi, psi, RsdCG, MaxCG);
+  }
+
+  // Single precision
+  multi1d<SystemSolverResults_t>
+  InvBlockCG(const LinearOperator<LatticeStaggeredFermionF>& M,
+	     const multi1d<LatticeStaggeredFermionF>& chi,
+	     multi1d<LatticeStaggeredFermionF>& psi,
+	     const Real& RsdCG,
+	     int MaxCG)
+  {
+    return InvBlockCG_a<LatticeStaggeredFermionF,ComplexF>(M, chi, psi, RsdCG, MaxCG);
+  }
+
+  // Double precision
+  multi1d<SystemSolverResults_t>
+  InvBlockCG(const LinearOperator<LatticeStaggeredFermionD>& M,
+	     const multi1d<LatticeStaggeredFermionD>& chi,
+	     multi1d<LatticeStaggeredFermionD>& psi,
+	     const Real& RsdCG,
+	     int MaxCG)
+  {
+    return InvBlockCG_a<LatticeStaggeredFermionD,ComplexD>(M, chi, psi, RsdCG, MaxCG);
+  }
+
+}  // end namespace Chroma
@@ -0,0 +1,95 @@
+// -*- C++ -*-
+/*! \file
+ *  \brief Block Conjugate-Gradient algorithm for a generic Linear Operator
+ */
+
+#ifndef __invblockcg_h__
+#define __invblockcg_h__
+
+#include "linearop.h"
+#include "syssolver.h"
+
+namespace Chroma
+{
+
+  //! Block Conjugate-Gradient (CGNE) algorithm for a generic Linear Operator
+  /*! \ingroup invert
+   * This subroutine uses the block Conjugate Gradient algorithm of O'Leary
+   * to find the solutions of the set of linear equations
+   *
+   *   	    Chi[i]  =  A . Psi[i]      i = 0 .. N-1
+   *
+   * where       A = M^dag . M
+   *
+   * All N systems share one Krylov space, and every iteration applies
+   * the operator to the whole block of search directions at once.
+   *
+   * Algorithm:
+   *
+   *  Psi[0]  :=  initial guess;
+   *  R[0]    :=  Chi - M^dag . M . Psi[0] ;     Initial residuals
+   *  P[1]    :=  R[0] ;	       	       	       Initial directions
+   *  FOR k FROM 1 TO MaxCG DO
+   *      a[k] := ( <MP[k],MP[k]> )^-1 <P[k],R[k-1]> ;   (N x N)
+   *      Psi[k] += P[k] a[k] ;
+   *      R[k] -= M^dag . M . P[k] a[k] ;
+   *      IF |R[k]_i| <= RsdCG |Chi_i| THEN
+   *           remove column i from Psi and R ;
+   *      b[k+1] := - ( <MP[k],MP[k]> )^-1 <M^dag . M . P[k],R[k]> ;
+   *      P[k+1] := R[k] + P[k] b[k+1] ;
+   *
+   * Converged columns are deflated out of the block, so the small Gram
+   * matrices stay well conditioned. The new directions are made
+   * A-orthogonal to all old ones, so the remaining columns keep the
+   * Krylov space built so far. Without deflation this is the usual
+   * block CG.
+   *
+   * Arguments:
+   *
+   *  \param M       Linear Operator    	       (Read)
+   *  \param chi     Sources	               (Read)
+   *  \param psi     Solutions    	       (Modify)
+   *  \param RsdCG   CG residual accuracy        (Read)
+   *  \param MaxCG   Maximum CG iterations       (Read)
+   *  \return res    System solver results, one per source
+   *
+   * @{
+   */
+
+  // Single precision
+  multi1d<SystemSolverResults_t>
+  InvBlockCG(const LinearOperator<LatticeFermionF>& M,
+	     const multi1d<LatticeFermionF>& chi,
+	     multi1d<LatticeFermionF>& psi,
+	     const Real& RsdCG,
+	     int MaxCG);
+
+  // Double precision
+  multi1d<SystemSolverResults_t>
+  InvBlockCG(const LinearOperator<LatticeFermionD>& M,
+	     const multi1d<LatticeFermionD>& chi,
+	     multi1d<LatticeFermionD>& psi,
+	     const Real& RsdCG,
+	     int MaxCG);
+
+  // Single precision
+  multi1d<SystemSolverResults_t>
+  InvBlockCG(const LinearOperator<LatticeStaggeredFermionF>& M,
+	     const multi1d<LatticeStaggeredFermionF>& chi,
+	     multi1d<LatticeStaggeredFermionF>& psi,
+	     const Real& RsdCG,
+	     int MaxCG);
+
+  // Double precision
+  multi1d<SystemSolverResults_t>
+  InvBlockCG(const LinearOperator<LatticeStaggeredFermionD>& M,
+	     const multi1d<LatticeStaggeredFermionD>& chi,
+	     multi1d<LatticeStaggeredFermionD>& psi,
+	     const Real& RsdCG,
+	     int MaxCG);
+
+  /*! @} */  // end of group invert
+
+}  // end namespace Chroma
+
+#endif
@@ -0,0 +1,585 @@
+/*! \file
+ *  \brief Conjugate-Gradient variants with one global reduction per iteration
+ */
+
+#include "chromabase.h"
+#include "actions/ferm/invert/invcacg.h"
+
+#include <vector>
+
+#ifndef QDP_IS_QDPJIT
+
+namespace Chroma
+{
+
+  //! Anonymous namespace for the fused kernels
+  namespace
+  {
+    //! Arguments of the fused inner products
+    template<typename T>
+    struct DotArgs
+    {
+      const std::vector<const T*>& a;
+      const std::vector<const T*>& b;
+      const multi1d<int>& tab;
+      std::vector<REAL64>& partial;    /*!< 2*a.size() reals per thread */
+    };
+
+    //! Node-local  <a_k, b_k>  for all pairs k
+    template<typename T>
+    void localDots(int lo, int hi, int myId, DotArgs<T>* arg)
+    {
+      typedef typename WordType<T>::Type_t REALT;
+      const int n = Ns*Nc;
+      const int np = arg->a.size();
+      REAL64* out = &(arg->partial[2*np*myId]);
+
+      for(int j=lo; j < hi; ++j)
+      {
+	const int site = arg->tab[j];
+	for(int k=0; k < np; ++k)
+	{
+	  const REALT* pa = &(arg->a[k]->elem(site).elem(0).elem(0).real());
+	  const REALT* pb = &(arg->b[k]->elem(site).elem(0).elem(0).real());
+	  REAL64 re = 0;
+	  REAL64 im = 0;
+	  for(int i=0; i < n; ++i)
+	  {
+	    re += REAL64(pa[2*i])*REAL64(pb[2*i]) + REAL64(pa[2*i+1])*REAL64(pb[2*i+1]);
+	    im += REAL64(pa[2*i])*REAL64(pb[2*i+1]) - REAL64(pa[2*i+1])*REAL64(pb[2*i]);
+	  }
+	  out[2*k]   += re;
+	  out[2*k+1] += im;
+	}
+      }
+    }
+
+    //! All  <a_k, b_k>  on the subset s with a single global reduction
+    template<typename T>
+    void fusedInnerProducts(multi1d<DComplex>& res,
+			    const std::vector<const T*>& a,
+			    const std::vector<const T*>& b,
+			    const Subset& s)
+    {
+      const int np = a.size();
+      const int nthr = qdpNumThreads();
+
+      std::vector<REAL64> partial(2*np*nthr, 0);
+      DotArgs<T> arg = {a, b, s.siteTable(), partial};
+      dispatch_to_threads(s.numSiteTable(), arg, localDots<T>);
+
+      std::vector<REAL64> sum(2*np, 0);
+      for(int t=0; t < nthr; ++t)
+	for(int k=0; k < 2*np; ++k)
+	  sum[k] += partial[2*np*t + k];
+
+      QDPInternal::globalSumArray(&sum[0], 2*np);
+
+      res.resize(np);
+      for(int k=0; k < np; ++k)
+	res[k] = cmplx(Double(sum[2*k]), Double(sum[2*k+1]));
+    }
+
+
+    //! Arguments of the pipelined CG update
+    template<typename T>
+    struct PipeUpdateArgs
+    {
+      T& psi;
+      T& r;
+      T& w;
+      T& p;
+      T& sv;
+      T& z;
+      const T& q;
+      REAL64 alpha;
+      REAL64 beta;
+      const multi1d<int>& tab;
+      multi1d<REAL64>& partial;        /*!< <r,r> and Re <w,r>, one pair per thread */
+    };
+
+    //! All vector recurrences of an iteration and the next inner products
+    template<typename T>
+    void pipeUpdate(int lo, int hi, int myId, PipeUpdateArgs<T>* arg)
+    {
+      typedef typename WordType<T>::Type_t REALT;
+      const int n = 2*Ns*Nc;
+      const REALT alpha = arg->alpha;
+      const REALT beta = arg->beta;
+      REAL64 rr = 0;
+      REAL64 wr = 0;
+
+      for(int j=lo; j < hi; ++j)
+      {
+	const int site = arg->tab[j];
+	REALT* x = &(arg->psi.elem(site).elem(0).elem(0).real());
+	REALT* r = &(arg->r.elem(site).elem(0).elem(0).real());
+	REALT* w = &(arg->w.elem(site).elem(0).elem(0).real());
+	REALT* p = &(arg->p.elem(site).elem(0).elem(0).real());
+	REALT* sv = &(arg->sv.elem(site).elem(0).elem(0).real());
+	REALT* z = &(arg->z.elem(site).elem(0).elem(0).real());
+	const REALT* q = &(arg->q.elem(site).elem(0).elem(0).real());
+
+	for(int i=0; i < n; ++i)
+	{
+	  z[i]  = q[i] + beta * z[i];
+	  sv[i] = w[i] + beta * sv[i];
+	  p[i]  = r[i] + beta * p[i];
+	  x[i] += alpha * p[i];
+	  r[i] -= alpha * sv[i];
+	  w[i] -= alpha * z[i];
+
+	  rr += REAL64(r[i])*REAL64(r[i]);
+	  wr += REAL64(w[i])*REAL64(r[i]);
+	}
+      }
+
+      arg->partial[2*myId]   += rr;
+      arg->partial[2*myId+1] += wr;
+    }
+
+
+    //! Solve  W . X = B  for hermitian positive definite W by Cholesky
+    /*!
+     * Returns false if W is not numerically positive definite, which for
+     * the s-step Gram matrices signals a degenerate Krylov basis.
+     */
+    bool cholSolve(multi2d<DComplex>& X, const multi2d<DComplex>& W, const multi2d<DComplex>& B)
+    {
+      const int n = W.size1();
+      const int m = B.size1();
+      multi2d<DComplex> L(n,n);
+
+      for(int j=0; j < n; ++j)
+      {
+	Double d = real(W(j,j));
+	for(int k=0; k < j; ++k)
+	  d -= real(conj(L(j,k))*L(j,k));
+	if ( toBool(d <= Double(0)) )
+	  return false;
+
+	L(j,j) = cmplx(sqrt(d), Double(0));
+	for(int i=j+1; i < n; ++i)
+	{
+	  DComplex t = W(i,j);
+	  for(int k=0; k < j; ++k)
+	    t -= L(i,k)*conj(L(j,k));
+	  L(i,j) = t / L(j,j);
+	}
+      }
+
+      // L Y = B, then L^dag X = Y
+      X.resize(n,m);
+      for(int c=0; c < m; ++c)
+      {
+	for(int i=0; i < n; ++i)
+	{
+	  DComplex t = B(i,c);
+	  for(int k=0; k < i; ++k)
+	    t -= L(i,k)*X(k,c);
+	  X(i,c) = t / L(i,i);
+	}
+	for(int i=n-1; i >= 0; --i)
+	{
+	  DComplex t = X(i,c);
+	  for(int k=i+1; k < n; ++k)
+	    t -= conj(L(k,i))*X(k,c);
+	  X(i,c) = t / L(i,i);
+	}
+      }
+
+      return true;
+    }
+  }
+
+
+  //! Pipelined CG
+  /*! \ingroup invert
+   *
+   * See the header file for the description of the algorithm
+   */
+  template<typename T>
+  SystemSolverResults_t
+  InvPipeCG_a(const LinearOperator<T>& M,
+	      const T& chi,
+	      T& psi,
+	      const Real& RsdCG,
+	      int MaxCG)
+  {
+    START_CODE();
+
+    const Subset& s = M.subset();
+    const multi1d<int>& tab = s.siteTable();
+    const int nsites = s.numSiteTable();
+    multi1d<REAL64> partial(2*qdpNumThreads());
+
+    SystemSolverResults_t res;
+
+    QDPIO::cout << "InvPipeCG: starting" << std::endl;
+    FlopCounter flopcount;
+    flopcount.reset();
+    StopWatch swatch;
+    swatch.reset();
+    swatch.start();
+
+    Double chi_sq = norm2(chi,s);
+    Double rsd_sq = (RsdCG * RsdCG) * chi_sq;
+    flopcount.addSiteFlops(4*Nc*Ns,s);
+
+    T r, w, q, z, sv, p, tmp;
+    moveToFastMemoryHint(r);
+    moveToFastMemoryHint(w);
+    moveToFastMemoryHint(p);
+
+    int k = 0;
+    bool breakdown = false;
+    Double r_sq;
+    while (! breakdown)
+    {
+      //  r  :=  Chi - A . Psi  from scratch, on entry and on every restart
+      M(tmp, psi, PLUS);
+      M(r, tmp, MINUS);
+      r[s] = chi - r;
+      r_sq = norm2(r,s);
+      flopcount.addFlops(2*M.nFlops());
+      flopcount.addSiteFlops(6*Nc*Ns,s);
+
+      if ( toBool(r_sq <= rsd_sq) || k >= MaxCG )
+	break;
+
+      if (k > 0)
+	QDPIO::cout << "InvPipeCG: restart at k = " << k << "  || r ||= " << sqrt(r_sq) << std::endl;
+
+      //  w  :=  A . r
+      M(tmp, r, PLUS);
+      M(w, tmp, MINUS);
+      z[s] = zero;
+      sv[s] = zero;
+      p[s] = zero;
+
+      REAL64 gamma = toDouble(r_sq);
+      REAL64 delta = toDouble(innerProductReal(w, r, s));
+      REAL64 gamma_old = 0;
+      REAL64 alpha_old = 0;
+      flopcount.addFlops(2*M.nFlops());
+      flopcount.addSiteFlops(4*Nc*Ns,s);
+
+      for(bool first=true; k < MaxCG; ++k, first=false)
+      {
+	if (gamma <= toDouble(rsd_sq))
+	  break;
+
+	//  q  :=  A . w  does not depend on the reduction just done
+	M(tmp, w, PLUS);
+	M(q, tmp, MINUS);
+	flopcount.addFlops(2*M.nFlops());
+
+	REAL64 beta = 0;
+	REAL64 den = delta;
+	if (! first)
+	{
+	  beta = gamma / gamma_old;
+	  den = delta - beta * gamma / alpha_old;
+	}
+
+	// Loss of positivity, start again from the true residual. Right
+	// after a restart that would only rebuild the same state, so stop
+	if (! (den > 0))
+	{
+	  QDPIO::cout << "InvPipeCG: loss of positivity at k = " << k << std::endl;
+	  breakdown = first;
+	  break;
+	}
+
+	const REAL64 alpha = gamma / den;
+
+	partial = 0;
+	PipeUpdateArgs<T> arg = {psi, r, w, p, sv, z, q, alpha, beta, tab, partial};
+	dispatch_to_threads(nsites, arg, pipeUpdate<T>);
+	flopcount.addSiteFlops(28*Nc*Ns,s);
+
+	// The only global reduction of the iteration
+	REAL64 sums[2] = {0, 0};
+	for(int t=0; t < qdpNumThreads(); ++t)
+	{
+	  sums[0] += partial[2*t];
+	  sums[1] += partial[2*t+1];
+	}
+	QDPInternal::globalSumArray(sums, 2);
+
+	gamma_old = gamma;
+	alpha_old = alpha;
+	gamma = sums[0];
+	delta = sums[1];
+      }
+    }
+
+    swatch.stop();
+    flopcount.report("invpipecg", swatch.getTimeInSeconds());
+
+    res.n_count = k;
+    res.resid = sqrt(r_sq);
+
+    if ( toBool(r_sq > rsd_sq) )
+    {
+      QDPIO::cerr << "Nonconvergence Warning" << std::endl;
+      QDPIO::cerr << "too many PipeCG iterations: count =" << res.n_count << " rsd^2= " << r_sq << std::endl << std::flush;
+    }
+
+    END_CODE();
+    return res;
+  }
+
+
+  //! s-step CG
+  /*! \ingroup invert
+   *
+   * See the header file for the description of the algorithm
+   */
+  template<typename T, typename CT>
+  SystemSolverResults_t
+  InvSStepCG_a(const LinearOperator<T>& M,
+	       const T& chi,
+	       T& psi,
+	       const Real& RsdCG,
+	       int MaxCG,
+	       int SStep)
+  {
+    START_CODE();
+
+    if (SStep < 1)
+    {
+      QDPIO::cerr << "InvSStepCG: SStep must be positive" << std::endl;
+      QDP_abort(1);
+    }
+
+    const Subset& s = M.subset();
+    const int ns = SStep;
+
+    SystemSolverResults_t res;
+
+    QDPIO::cout << "InvSStepCG: starting with s = " << ns << std::endl;
+    FlopCounter flopcount;
+    flopcount.reset();
+    StopWatch swatch;
+    swatch.reset();
+    swatch.start();
+
+    Double chi_sq = norm2(chi,s);
+    Double rsd_sq = (RsdCG * RsdCG) * chi_sq;
+    flopcount.addSiteFlops(4*Nc*Ns,s);
+
+    //  V[j] = A^j r ;  two sets of directions P and A.P, used alternately
+    multi1d<T> V(ns+1);
+    multi1d<T> P[2] = {multi1d<T>(ns), multi1d<T>(ns)};
+    multi1d<T> AP[2] = {multi1d<T>(ns), multi1d<T>(ns)};
+    T tmp;
+
+    int k = 0;
+    bool breakdown = false;
+    Double r_sq;
+    while (! breakdown)
+    {
+      //  r  :=  Chi - A . Psi  from scratch, on entry and on every restart
+      M(tmp, psi, PLUS);
+      M(V[0], tmp, MINUS);
+      V[0][s] = chi - V[0];
+      r_sq = norm2(V[0],s);
+      flopcount.addFlops(2*M.nFlops());
+      flopcount.addSiteFlops(6*Nc*Ns,s);
+
+      if ( toBool(r_sq <= rsd_sq) || k >= MaxCG )
+	break;
+
+      if (k > 0)
+	QDPIO::cout << "InvSStepCG: restart at k = " << k << "  || r ||= " << sqrt(r_sq) << std::endl;
+
+      int cur = 0;
+      multi2d<DComplex> W_old;
+      for(bool first=true; k < MaxCG; first=false)
+      {
+	// Monomial basis
+	for(int j=0; j < ns; ++j)
+	{
+	  M(tmp, V[j], PLUS);
+	  M(V[j+1], tmp, MINUS);
+	}
+	flopcount.addFlops(2*ns*M.nFlops());
+
+	//  R^dag A R,  R^dag r  and  (A P_old)^dag R  in one reduction
+	std::vector<const T*> a, b;
+	for(int i=0; i < ns; ++i)
+	  for(int j=0; j < ns; ++j)
+	  {
+	    a.push_back(&V[i]);
+	    b.push_back(&V[j+1]);
+	  }
+	for(int i=0; i < ns; ++i)
+	{
+	  a.push_back(&V[i]);
+	  b.push_back(&V[0]);
+	}
+	if (! first)
+	  for(int i=0; i < ns; ++i)
+	    for(int j=0; j < ns; ++j)
+	    {
+	      a.push_back(&AP[cur][i]);
+	      b.push_back(&V[j]);
+	    }
+
+	multi1d<DComplex> dots;
+	fusedInnerProducts(dots, a, b, s);
+	flopcount.addSiteFlops(8*Nc*Ns*a.size(),s);
+
+	multi2d<DComplex> G1(ns,ns), G2(ns,ns), g(ns,1);
+	for(int i=0; i < ns; ++i)
+	{
+	  for(int j=0; j < ns; ++j)
+	  {
+	    G1(i,j) = dots[i*ns + j];
+	    if (! first)
+	      G2(i,j) = dots[ns*ns + ns + i*ns + j];
+	  }
+	  g(i,0) = dots[ns*ns + i];
+	}
+
+	if ( toBool(real(g(0,0)) <= rsd_sq) )
+	  break;
+
+	//  P  :=  R + P_old B ,  B = - W_old^-1 (A P_old)^dag R
+	multi2d<DComplex> W(ns,ns);
+	const int nxt = 1 - cur;
+	if (first)
+	{
+	  for(int j=0; j < ns; ++j)
+	  {
+	    P[nxt][j][s] = V[j];
+	    AP[nxt][j][s] = V[j+1];
+	  }
+	  W = G1;
+	}
+	else
+	{
+	  multi2d<DComplex> B;
+	  if (! cholSolve(B, W_old, G2))
+	  {
+	    QDPIO::cout << "InvSStepCG: direction Gram matrix singular at k = " << k << std::endl;
+	    break;
+	  }
+
+	  for(int j=0; j < ns; ++j)
+	  {
+	    P[nxt][j][s] = V[j];
+	    AP[nxt][j][s] = V[j+1];
+	    for(int i=0; i < ns; ++i)
+	    {
+	      CT cc = -B(i,j);
+	      P[nxt][j][s] += cc * P[cur][i];
+	      AP[nxt][j][s] += cc * AP[cur][i];
+	    }
+	  }
+	  flopcount.addSiteFlops(16*Nc*Ns*ns*ns,s);
+
+	  //  W = P^dag A P = G1 - G2^dag W_old^-1 G2
+	  for(int i=0; i < ns; ++i)
+	    for(int j=0; j < ns; ++j)
+	    {
+	      W(i,j) = G1(i,j);
+	      for(int l=0; l < ns; ++l)
+		W(i,j) -= conj(G2(l,i)) * B(l,j);
+	    }
+	}
+	cur = nxt;
+
+	//  a = W^-1 P^dag r  with  P^dag r = R^dag r
+	multi2d<DComplex> alpha;
+	if (! cholSolve(alpha, W, g))
+	{
+	  QDPIO::cout << "InvSStepCG: Krylov basis degenerate at k = " << k << std::endl;
+	  breakdown = first;
+	  break;
+	}
+
+	//  Psi += P a ;  r -= A P a
+	for(int j=0; j < ns; ++j)
+	{
+	  CT cc = alpha(j,0);
+	  psi[s] += cc * P[cur][j];
+	  V[0][s] -= cc * AP[cur][j];
+	}
+	flopcount.addSiteFlops(16*Nc*Ns*ns,s);
+
+	W_old = W;
+	k += ns;
+      }
+    }
+
+    swatch.stop();
+    flopcount.report("invsstepcg", swatch.getTimeInSeconds());
+
+    res.n_count = k;
+    res.resid = sqrt(r_sq);
+
+    if ( toBool(r_sq > rsd_sq) )
+    {
+      QDPIO::cerr << "Nonconvergence Warning" << std::endl;
+      QDPIO::cerr << "too many SStepCG iterations: count =" << res.n_count << " rsd^2= " << r_sq << std::endl << std::flush;
+    }
+
+    END_CODE();
+    return res;
+  }
+
+
+  //
+  // Explicit versions
+  //
+  // Single precision
+  SystemSolverResults_t
+  InvPipeCG(const LinearOperator<LatticeFermionF>& M,
+	    const LatticeFermionF& chi,
+	    LatticeFermionF& psi,
+	    const Real& RsdCG,
+	    int MaxCG)
+  {
+    return InvPipeCG_a(M, chi, psi, RsdCG, MaxCG);
+  }
+
+  // Double precision
+  SystemSolverResults_t
+  InvPipeCG(const LinearOperator<LatticeFermionD>& M,
+	    const LatticeFermionD& chi,
+	    LatticeFermionD& psi,
+	    const Real& RsdCG,
+	    int MaxCG)
+  {
+    return InvPipeCG_a(M, chi, psi, RsdCG, MaxCG);
+  }
+
+  // Single precision
+  SystemSolverResults_t
+  InvSStepCG(const LinearOperator<LatticeFermionF>& M,
+	     const LatticeFermionF& chi,
+	     LatticeFermionF& psi,
+	     const Real& RsdCG,
+	     int MaxCG,
+	     int SStep)
+  {
+    return InvSStepCG_a<LatticeFermionF, ComplexF>(M, chi, psi, RsdCG, MaxCG, SStep);
+  }
+
+  // Double precision
+  SystemSolverResults_t
+  InvSStepCG(const LinearOperator<LatticeFermionD>& M,
+	     const LatticeFermionD& chi,
+	     LatticeFermionD& psi,
+	     const Real& RsdCG,
+	     int MaxCG,
+	     int SStep)
+  {
+    return InvSStepCG_a<LatticeFermionD, ComplexD>(M, chi, psi, RsdCG, MaxCG, SStep);
+  }
+
+}  // end namespace Chroma
+
+#endif
@@ -0,0 +1,120 @@
+// -*- C++ -*-
+/*! \file
+ *  \brief Conjugate-Gradient variants with one global reduction per iteration
+ */
+
+#ifndef __invcacg_h__
+#define __invcacg_h__
+
+#include "linearop.h"
+#include "syssolver.h"
+
+namespace Chroma
+{
+
+  //! Pipelined Conjugate-Gradient (CGNE) algorithm
+  /*! \ingroup invert
+   *
+   * Solves  Chi = A . Psi  with  A = M^dag . M  like InvCG2, using the
+   * pipelined recurrences of Ghysels and Vanroose. The two inner products
+   * of an iteration, gamma = <r,r> and delta = <w,r> with w = A r, are
+   * computed in the same sweep that updates the vectors and are summed
+   * across the nodes in a single global reduction. That reduction does
+   * not depend on  A . w , the only operator application of the
+   * iteration, so the two can be overlapped.
+   *
+   *  r := Chi - A Psi ;  w := A r
+   *  FOR k DO
+   *      gamma := <r,r> ;  delta := <w,r>        one global sum
+   *      IF gamma <= RsdCG^2 |Chi|^2 THEN check true residual, restart or RETURN
+   *      q := A w
+   *      beta := gamma / gamma_old ;  alpha := gamma / (delta - beta gamma / alpha_old)
+   *      z := q + beta z ;  s := w + beta s ;  p := r + beta p
+   *      Psi += alpha p ;  r -= alpha s ;  w -= alpha z
+   *
+   * The recursively updated residual drifts further from the true one
+   * than in InvCG2. On convergence the true residual is therefore
+   * computed and the iteration is restarted from it if needed. A loss of
+   * positivity also restarts, unless it happens in the first iteration
+   * after a restart (e.g. an indefinite operator or a nan source). The
+   * solver then returns unconverged.
+   *
+   *  \param M       Linear Operator    	       (Read)
+   *  \param chi     Source	               (Read)
+   *  \param psi     Solution    	    	       (Modify)
+   *  \param RsdCG   CG residual accuracy        (Read)
+   *  \param MaxCG   Maximum CG iterations       (Read)
+   *  \return res    System solver results
+   *
+   * @{
+   */
+
+  // Single precision
+  SystemSolverResults_t
+  InvPipeCG(const LinearOperator<LatticeFermionF>& M,
+	    const LatticeFermionF& chi,
+	    LatticeFermionF& psi,
+	    const Real& RsdCG,
+	    int MaxCG);
+
+  // Double precision
+  SystemSolverResults_t
+  InvPipeCG(const LinearOperator<LatticeFermionD>& M,
+	    const LatticeFermionD& chi,
+	    LatticeFermionD& psi,
+	    const Real& RsdCG,
+	    int MaxCG);
+
+  /*! @} */
+
+
+  //! s-step Conjugate-Gradient (CGNE) algorithm
+  /*! \ingroup invert
+   *
+   * Solves  Chi = A . Psi  with  A = M^dag . M  by the s-step CG of
+   * Chronopoulos and Gear. Each outer step builds the monomial basis
+   *  R = [r, A r, ..., A^(s-1) r]  and does s CG iterations at once with
+   * block recurrences. All inner products of a step (R^dag A R,
+   * (A P_old)^dag R and R^dag r) go into one global reduction, so there
+   * is one reduction per s iterations.
+   *
+   * The monomial basis becomes ill-conditioned for larger s, SStep of
+   * 2 to 4 is the useful range. As for InvPipeCG the true residual is
+   * checked on convergence. A singular Gram matrix restarts from the
+   * true residual, or returns unconverged in the first step after a
+   * restart.
+   *
+   *  \param M       Linear Operator    	       (Read)
+   *  \param chi     Source	               (Read)
+   *  \param psi     Solution    	    	       (Modify)
+   *  \param RsdCG   CG residual accuracy        (Read)
+   *  \param MaxCG   Maximum CG iterations       (Read)
+   *  \param SStep   Iterations per outer step   (Read)
+   *  \return res    System solver results
+   *
+   * @{
+   */
+
+  // Single precision
+  SystemSolverResults_t
+  InvSStepCG(const LinearOperator<LatticeFermionF>& M,
+	     const LatticeFermionF& chi,
+	     LatticeFermionF& psi,
+	     const Real& RsdCG,
+	     int MaxCG,
+	     int SStep);
+
+  // Double precision
+  SystemSolverResults_t
+  InvSStepCG(const LinearOperator<LatticeFermionD>& M,
+	     const LatticeFermionD& chi,
+	     LatticeFermionD& psi,
+	     const Real& RsdCG,
+	     int MaxCG,
+	     int SStep);
+
+  /*! @} */  // end of group invert
+
+}  // end namespace Chroma
+
+#endif
@@ -0,0 +1,740 @@
+/*! \file
+ *  \brief Aggregation-based coarse space for the multigrid solver
+ */
+
+#include "actions/ferm/invert/mg_aggregation_w.h"
+
+#ifndef QDP_IS_QDPJIT
+
+#include <map>
+#include <cmath>
+#include <algorithm>
+
+namespace Chroma
+{
+
+  //! Anonymous namespace
+  namespace
+  {
+    //! Complex numbers per site
+    const int ncomplex = Ns*Nc;
+
+    inline const REAL* sitePtr(const LatticeFermion& f, int site)
+    {
+      return &(f.elem(site).elem(0).elem(0).real());
+    }
+
+    inline REAL* sitePtr(LatticeFermion& f, int site)
+    {
+      return &(f.elem(site).elem(0).elem(0).real());
+    }
+
+    //! conj(a).b on one site
+    inline MGComplex siteDot(const REAL* a, const REAL* b)
+    {
+      double re = 0;
+      double im = 0;
+      for(int i=0; i < ncomplex; ++i)
+      {
+	re += double(a[2*i])*double(b[2*i]) + double(a[2*i+1])*double(b[2*i+1]);
+	im += double(a[2*i])*double(b[2*i+1]) - double(a[2*i+1])*double(b[2*i]);
+      }
+      return MGComplex(re, im);
+    }
+
+    //! b += c a on one site
+    inline void siteAxpy(REAL* b, const MGComplex& c, const REAL* a)
+    {
+      const double cr = c.real();
+      const double ci = c.imag();
+      for(int i=0; i < ncomplex; ++i)
+      {
+	b[2*i]   += REAL(cr*a[2*i] - ci*a[2*i+1]);
+	b[2*i+1] += REAL(cr*a[2*i+1] + ci*a[2*i]);
+      }
+    }
+
+    //! Euclidean norm of a distributed coarse vector
+    inline double coarseNorm(const MGCoarseVector& v)
+    {
+      double n = 0;
+      for(int i=0; i < v.size(); ++i)
+	n += std::norm(v[i]);
+      QDPInternal::globalSum(n);
+      return std::sqrt(n);
+    }
+
+    //! w -= sum_i V[i] (V[i]^dag w) for i <= k, adding the coefficients to h
+    /*! One global sum for all k+1 inner products */
+    void coarseProject(std::vector<MGComplex>& h, const std::vector<MGCoarseVector>& V, int k,
+		       MGCoarseVector& w)
+    {
+      std::vector<MGComplex> d(k+1, MGComplex(0, 0));
+      for(int i=0; i <= k; ++i)
+	for(int l=0; l < w.size(); ++l)
+	  d[i] += std::conj(V[i][l]) * w[l];
+
+      QDPInternal::globalSumArray(reinterpret_cast<double*>(&d[0]), 2*(k+1));
+
+      for(int i=0; i <= k; ++i)
+      {
+	h[i] += d[i];
+	for(int l=0; l < w.size(); ++l)
+	  w[l] -= d[i] * V[i][l];
+      }
+    }
+  }
+
+
+  //! Arguments of the threaded restriction and prolongation
+  struct MGAggregation::BlockArgs
+  {
+    const MGAggregation& agg;
+    MGCoarseVector& c;
+    LatticeFermion& f;
+  };
+
+
+  // Build the blocks
+  MGAggregation::MGAggregation(const multi1d<int>& blocking, int nvec_) :
+    block(blocking), nvec(nvec_)
+  {
+    START_CODE();
+
+    if (block.size() != Nd)
+    {
+      QDPIO::cerr << "MGAggregation: Blocking must have " << Nd << " entries" << std::endl;
+      QDP_abort(1);
+    }
+
+    const multi1d<int>& subgrid = Layout::subgridLattSize();
+    const multi1d<int>& latt = Layout::lattSize();
+
+    nblk.resize(Nd);
+    nblocks = 1;
+    for(int mu=0; mu < Nd; ++mu)
+    {
+      if (block[mu] < 1 || subgrid[mu] % block[mu] != 0)
+      {
+	QDPIO::cerr << "MGAggregation: block extent " << block[mu] << " in direction " << mu
+		    << " does not divide the subgrid extent " << subgrid[mu] << std::endl;
+	QDP_abort(1);
+      }
+
+      nblk[mu] = latt[mu] / block[mu];
+      nblocks *= nblk[mu];
+
+      // The probing colours are the parities of the block coordinates
+      if (nblk[mu] > 1 && nblk[mu] % 2 != 0)
+      {
+	QDPIO::cerr << "MGAggregation: the number of blocks " << nblk[mu] << " in direction " << mu
+		    << " must be 1 or even" << std::endl;
+	QDP_abort(1);
+      }
+
+      // Forward and backward couplings are separated by the block faces
+      if (nblk[mu] > 2 && block[mu] < 2)
+      {
+	QDPIO::cerr << "MGAggregation: block extent in direction " << mu << " must be at least 2" << std::endl;
+	QDP_abort(1);
+      }
+    }
+
+    // Sort the sites of this node into their blocks
+    const int node = Layout::nodeNumber();
+    const int nodeSites = Layout::sitesOnNode();
+
+    std::map<int, std::vector<int> > sites_of;
+    std::vector<int> faces(nodeSites);
+    for(int site=0; site < nodeSites; ++site)
+    {
+      multi1d<int> coord = Layout::siteCoords(node, site);
+      multi1d<int> bc(Nd);
+      int face = 0;
+      for(int mu=0; mu < Nd; ++mu)
+      {
+	bc[mu] = coord[mu] / block[mu];
+	const int x = coord[mu] % block[mu];
+	if (x == 0)
+	  face |= 1 << (2*mu);
+	if (x == block[mu]-1)
+	  face |= 1 << (2*mu+1);
+      }
+      faces[site] = face;
+      sites_of[blockIndex(bc)].push_back(site);
+    }
+
+    local_index.assign(nblocks, -1);
+    block_start.push_back(0);
+    for(std::map<int, std::vector<int> >::const_iterator b=sites_of.begin(); b != sites_of.end(); ++b)
+    {
+      local_index[b->first] = local_blocks.size();
+      local_blocks.push_back(b->first);
+      for(int j=0; j < b->second.size(); ++j)
+      {
+	block_sites.push_back(b->second[j]);
+	site_faces.push_back(faces[b->second[j]]);
+      }
+      block_start.push_back(block_sites.size());
+    }
+
+    // Node faces of the split directions. The local blocks are ordered by
+    // their global index, which orders each face by its transverse
+    // coordinates on every node
+    split_dir.resize(Nd);
+    face_blocks.resize(2*Nd);
+    for(int mu=0; mu < Nd; ++mu)
+    {
+      split_dir[mu] = (Layout::logicalSize()[mu] > 1);
+      if (! split_dir[mu])
+	continue;
+
+      const int lblk = subgrid[mu] / block[mu];
+      for(int lb=0; lb < local_blocks.size(); ++lb)
+      {
+	const int x = blockCoords(local_blocks[lb])[mu] % lblk;
+	if (x == 0)
+	  face_blocks[2*mu].push_back(lb);
+	if (x == lblk-1)
+	  face_blocks[2*mu+1].push_back(lb);
+      }
+    }
+
+    QDPIO::cout << "MGAggregation: " << nblocks << " blocks of " << block[0];
+    for(int mu=1; mu < Nd; ++mu)
+      QDPIO::cout << "x" << block[mu];
+    QDPIO::cout << " sites, " << 2*nvec << " coarse dof per block" << std::endl;
+
+    END_CODE();
+  }
+
+
+  // Block coordinates of block b
+  multi1d<int> MGAggregation::blockCoords(int b) const
+  {
+    multi1d<int> bc(Nd);
+    for(int mu=0; mu < Nd; ++mu)
+    {
+      bc[mu] = b % nblk[mu];
+      b /= nblk[mu];
+    }
+    return bc;
+  }
+
+
+  // Block of block coordinates bc
+  int MGAggregation::blockIndex(const multi1d<int>& bc) const
+  {
+    int b = 0;
+    for(int mu=Nd-1; mu >= 0; --mu)
+      b = b*nblk[mu] + bc[mu];
+    return b;
+  }
+
+
+  // Local index of block b
+  int MGAggregation::localIndex(int b) const
+  {
+    return local_index[b];
+  }
+
+
+  // Neighbouring block in direction mu
+  int MGAggregation::neighbourBlock(int b, int mu, int isign) const
+  {
+    if (nblk[mu] == 1 || (nblk[mu] == 2 && isign < 0))
+      return -1;
+
+    multi1d<int> bc = blockCoords(b);
+    bc[mu] = (bc[mu] + isign + nblk[mu]) % nblk[mu];
+    return blockIndex(bc);
+  }
+
+
+  // Colour of a block for probing
+  int MGAggregation::blockColour(int b) const
+  {
+    multi1d<int> bc = blockCoords(b);
+    int colour = 0;
+    for(int mu=0; mu < Nd; ++mu)
+      colour |= (bc[mu] % 2) << mu;
+    return colour;
+  }
+
+
+  // Set the null vectors and build the block-orthonormal basis
+  void MGAggregation::setNullVectors(const multi1d<LatticeFermion>& v)
+  {
+    START_CODE();
+
+    if (v.size() != nvec)
+    {
+      QDPIO::cerr << "MGAggregation: expected " << nvec << " null vectors, got " << v.size() << std::endl;
+      QDP_abort(1);
+    }
+
+    // Chiral halves
+    basis.resize(2*nvec);
+    for(int k=0; k < nvec; ++k)
+    {
+      LatticeFermion g5v = Gamma(Ns*Ns-1) * v[k];
+      basis[2*k]   = 0.5*(v[k] + g5v);
+      basis[2*k+1] = 0.5*(v[k] - g5v);
+    }
+
+    // Gram-Schmidt on every block, applied twice for stability
+    for(int lb=0; lb < local_blocks.size(); ++lb)
+    {
+      for(int k=0; k < 2*nvec; ++k)
+      {
+	for(int pass=0; pass < 2; ++pass)
+	  for(int j=0; j < k; ++j)
+	  {
+	    const MGComplex d = -blockDot(lb, j, basis[k], -1);
+	    for(int s=block_start[lb]; s < block_start[lb+1]; ++s)
+	      siteAxpy(sitePtr(basis[k], block_sites[s]), d, sitePtr(basis[j], block_sites[s]));
+	  }
+
+	const double nrm = std::sqrt(blockDot(lb, k, basis[k], -1).real());
+	if (nrm == 0)
+	{
+	  QDPIO::cerr << "MGAggregation: null vectors are linearly dependent on a block" << std::endl;
+	  QDP_abort(1);
+	}
+
+	const double scale = 1.0 / nrm;
+	for(int s=block_start[lb]; s < block_start[lb+1]; ++s)
+	{
+	  REAL* p = sitePtr(basis[k], block_sites[s]);
+	  for(int i=0; i < 2*ncomplex; ++i)
+	    p[i] = REAL(scale*p[i]);
+	}
+      }
+    }
+
+    END_CODE();
+  }
+
+
+  // Inner product of basis vector dof with f on local block lb
+  MGComplex MGAggregation::blockDot(int lb, int dof, const LatticeFermion& f, int face) const
+  {
+    MGComplex sum(0, 0);
+    for(int s=block_start[lb]; s < block_start[lb+1]; ++s)
+      if (face < 0 || (site_faces[s] & (1 << face)))
+	sum += siteDot(sitePtr(basis[dof], block_sites[s]), sitePtr(f, block_sites[s]));
+    return sum;
+  }
+
+
+  void MGAggregation::restrictBlocks(int lo, int hi, int myId, BlockArgs* a)
+  {
+    const MGAggregation& agg = a->agg;
+    const int ndof = agg.coarseDof();
+
+    for(int lb=lo; lb < hi; ++lb)
+      for(int k=0; k < ndof; ++k)
+	a->c[lb*ndof + k] = agg.blockDot(lb, k, a->f, -1);
+  }
+
+
+  void MGAggregation::prolongBlocks(int lo, int hi, int myId, BlockArgs* a)
+  {
+    const MGAggregation& agg = a->agg;
+    const int ndof = agg.coarseDof();
+
+    for(int lb=lo; lb < hi; ++lb)
+    {
+      for(int s=agg.block_start[lb]; s < agg.block_start[lb+1]; ++s)
+      {
+	const int site = agg.block_sites[s];
+	REAL* p = sitePtr(a->f, site);
+	for(int k=0; k < ndof; ++k)
+	  siteAxpy(p, a->c[lb*ndof + k], sitePtr(agg.basis[k], site));
+      }
+    }
+  }
+
+
+  // c = P^dag f
+  void MGAggregation::restrictVec(MGCoarseVector& c, const LatticeFermion& f) const
+  {
+    c.assign(localSize(), MGComplex(0, 0));
+
+    // The kernel only reads f when restricting
+    BlockArgs arg = {*this, c, const_cast<LatticeFermion&>(f)};
+    dispatch_to_threads(local_blocks.size(), arg, restrictBlocks);
+  }
+
+
+  // f = P c
+  void MGAggregation::prolongVec(LatticeFermion& f, const MGCoarseVector& c) const
+  {
+    f = zero;
+
+    // The kernel only reads c when prolonging
+    BlockArgs arg = {*this, const_cast<MGCoarseVector&>(c), f};
+    dispatch_to_threads(local_blocks.size(), arg, prolongBlocks);
+  }
+
+
+  // Basis vector dof on all blocks of one colour
+  void MGAggregation::probeVec(LatticeFermion& f, int colour, int dof) const
+  {
+    f = zero;
+    for(int lb=0; lb < local_blocks.size(); ++lb)
+    {
+      if (blockColour(local_blocks[lb]) != colour)
+	continue;
+
+      for(int s=block_start[lb]; s < block_start[lb+1]; ++s)
+      {
+	const int site = block_sites[s];
+	const REAL* src = sitePtr(basis[dof], site);
+	REAL* dst = sitePtr(f, site);
+	for(int i=0; i < 2*ncomplex; ++i)
+	  dst[i] = src[i];
+      }
+    }
+  }
+
+
+  //! Arguments of the threaded coarse apply
+  struct MGCoarseOperator::ApplyArgs
+  {
+    const MGCoarseOperator& op;
+    MGCoarseVector& y;
+    const MGCoarseVector& x;
+  };
+
+
+  // Probe A on the aggregation
+  MGCoarseOperator::MGCoarseOperator(const LinearOperator<LatticeFermion>& A,
+				     Handle<MGAggregation> agg_) : agg(agg_)
+  {
+    START_CODE();
+
+    StopWatch swatch;
+    swatch.start();
+
+    ndof = agg->coarseDof();
+    nlinks = 1 + 2*Nd;
+
+    const std::vector<int>& local = agg->localBlocks();
+    const int nloc = local.size();
+
+    // Halos after the local blocks. Kind 0 holds the forward neighbours
+    // of the upper face, kind 1 the backward neighbours of the lower face
+    halo_start.assign(2*Nd, 0);
+    int next = nloc;
+    for(int mu=0; mu < Nd; ++mu)
+    {
+      halo_start[2*mu] = next;
+      next += agg->faceBlocks(mu, 1).size();
+      halo_start[2*mu+1] = next;
+      next += agg->faceBlocks(mu, 0).size();
+    }
+    x_ext.resize(next*ndof);
+
+    // Neighbours as block indices into x_ext
+    nbr.resize(nloc*nlinks);
+    stencil.assign(nloc*nlinks*ndof*ndof, MGComplex(0, 0));
+    for(int lb=0; lb < nloc; ++lb)
+      nbr[lb*nlinks] = lb;
+
+    for(int mu=0; mu < Nd; ++mu)
+    {
+      for(int lb=0; lb < nloc; ++lb)
+	for(int d=0; d < 2; ++d)
+	{
+	  const int n = agg->neighbourBlock(local[lb], mu, (d == 0) ? +1 : -1);
+	  nbr[lb*nlinks + 1 + 2*mu + d] = (n < 0) ? -1 : agg->localIndex(n);
+	}
+
+      if (! agg->splitDir(mu))
+	continue;
+
+      // Neighbours on the next node are found on the opposite face
+      for(int d=0; d < 2; ++d)
+      {
+	const std::vector<int>& face = agg->faceBlocks(mu, 1-d);
+	for(int i=0; i < face.size(); ++i)
+	{
+	  int& n = nbr[face[i]*nlinks + 1 + 2*mu + d];
+	  if (n < 0 && agg->neighbourBlock(local[face[i]], mu, (d == 0) ? +1 : -1) >= 0)
+	    n = halo_start[2*mu+d] + i;
+	}
+      }
+    }
+
+    // Messages of the halos, all on checkerboard 0
+    bool split = false;
+    multi2d<int> send_bytes(2, 2*Nd);
+    multi2d<int> recv_bytes(2, 2*Nd);
+    send_bytes = 0;
+    recv_bytes = 0;
+    for(int mu=0; mu < Nd; ++mu)
+    {
+      if (! agg->splitDir(mu))
+	continue;
+
+      split = true;
+      const int bytes_lo = agg->faceBlocks(mu, 0).size()*ndof*sizeof(MGComplex);
+      const int bytes_hi = agg->faceBlocks(mu, 1).size()*ndof*sizeof(MGComplex);
+      send_bytes[0][2*mu]   = bytes_lo;
+      recv_bytes[0][2*mu]   = bytes_hi;
+      send_bytes[0][2*mu+1] = bytes_hi;
+      recv_bytes[0][2*mu+1] = bytes_lo;
+    }
+    if (split)
+      comms = new DslashFaceComms(send_bytes, recv_bytes);
+
+    LatticeFermion f, g;
+    for(int colour=0; colour < agg->numColours(); ++colour)
+      for(int j=0; j < ndof; ++j)
+      {
+	agg->probeVec(f, colour, j);
+	A(g, f, PLUS);
+
+	for(int lb=0; lb < nloc; ++lb)
+	{
+	  const int diff = colour ^ agg->blockColour(local[lb]);
+
+	  // Probed blocks couple to this one only if it is one of them
+	  // or a neighbour in a single direction
+	  if (diff == 0)
+	  {
+	    for(int i=0; i < ndof; ++i)
+	      stencil[(lb*nlinks*ndof + i)*ndof + j] = agg->blockDot(lb, i, g, -1);
+	    continue;
+	  }
+
+	  if ((diff & (diff-1)) != 0)
+	    continue;
+
+	  int mu = 0;
+	  while ((1 << mu) != diff)
+	    ++mu;
+
+	  const int fwd = lb*nlinks + 1 + 2*mu;
+	  const int bwd = lb*nlinks + 2 + 2*mu;
+	  for(int i=0; i < ndof; ++i)
+	  {
+	    if (nbr[bwd] < 0)
+	    {
+	      // Two blocks in this direction: both faces couple to the same one
+	      stencil[(fwd*ndof + i)*ndof + j] = agg->blockDot(lb, i, g, -1);
+	    }
+	    else
+	    {
+	      stencil[(fwd*ndof + i)*ndof + j] = agg->blockDot(lb, i, g, 2*mu+1);
+	      stencil[(bwd*ndof + i)*ndof + j] = agg->blockDot(lb, i, g, 2*mu);
+	    }
+	  }
+	}
+      }
+
+    swatch.stop();
+    QDPIO::cout << "MGCoarseOperator: probed with " << agg->numColours()*ndof
+		<< " applications, time = " << swatch.getTimeInSeconds() << " sec" << std::endl;
+
+    END_CODE();
+  }
+
+
+  void MGCoarseOperator::applyBlocks(int lo, int hi, int myId, ApplyArgs* a)
+  {
+    const MGCoarseOperator& op = a->op;
+    const int ndof = op.ndof;
+
+    for(int lb=lo; lb < hi; ++lb)
+    {
+      MGComplex* y = &(a->y[lb*ndof]);
+      for(int l=0; l < op.nlinks; ++l)
+      {
+	const int n = op.nbr[lb*op.nlinks + l];
+	if (n < 0)
+	  continue;
+
+	const MGComplex* x = &(a->x[n*ndof]);
+	const MGComplex* S = &(op.stencil[(lb*op.nlinks + l)*ndof*ndof]);
+	for(int i=0; i < ndof; ++i)
+	{
+	  MGComplex sum(0, 0);
+	  for(int j=0; j < ndof; ++j)
+	    sum += S[i*ndof + j] * x[j];
+	  y[i] += sum;
+	}
+      }
+    }
+  }
+
+
+  // Copy x and the neighbour blocks of the other nodes into x_ext
+  void MGCoarseOperator::exchangeHalos(const MGCoarseVector& x) const
+  {
+    std::copy(x.begin(), x.end(), x_ext.begin());
+
+    if (comms.operator->() == 0)
+      return;
+
+    // Kind 0 sends the lower face down, kind 1 the upper face up
+    for(int mu=0; mu < Nd; ++mu)
+    {
+      if (! agg->splitDir(mu))
+	continue;
+
+      for(int kind=0; kind < 2; ++kind)
+      {
+	const std::vector<int>& face = agg->faceBlocks(mu, kind);
+	MGComplex* buf = static_cast<MGComplex*>(comms->sendBuffer(0, mu, kind));
+	for(int i=0; i < face.size(); ++i)
+	  std::copy(&x[face[i]*ndof], &x[face[i]*ndof] + ndof, buf + i*ndof);
+      }
+    }
+
+    comms->start(0);
+    comms->wait(0);
+
+    for(int mu=0; mu < Nd; ++mu)
+    {
+      if (! agg->splitDir(mu))
+	continue;
+
+      for(int kind=0; kind < 2; ++kind)
+      {
+	const int nface = agg->faceBlocks(mu, 1-kind).size();
+	const MGComplex* buf = static_cast<const MGComplex*>(comms->recvBuffer(0, mu, kind));
+	std::copy(buf, buf + nface*ndof, &x_ext[halo_start[2*mu+kind]*ndof]);
+      }
+    }
+  }
+
+
+  // y = Dc x
+  void MGCoarseOperator::operator()(MGCoarseVector& y, const MGCoarseVector& x) const
+  {
+    exchangeHalos(x);
+    y.assign(size(), MGComplex(0, 0));
+
+    ApplyArgs arg = {*this, y, x_ext};
+    dispatch_to_threads(agg->localBlocks().size(), arg, applyBlocks);
+  }
+
+
+  // Restarted GMRES on the coarse grid
+  int MGCoarseGMRES(const MGCoarseOperator& Dc,
+		    MGCoarseVector& x,
+		    const MGCoarseVector& b,
+		    double rsd,
+		    int max_iter,
+		    int n_krylov)
+  {
+    const int n = b.size();
+    const int m = n_krylov;
+
+    x.resize(n, MGComplex(0, 0));
+
+    const double target = rsd * coarseNorm(b);
+    if (target == 0)
+    {
+      x.assign(n, MGComplex(0, 0));
+      return 0;
+    }
+
+    std::vector<MGCoarseVector> V(m+1, MGCoarseVector(n));
+    std::vector<MGComplex> H((m+1)*m);
+    std::vector<MGComplex> g(m+1);
+    std::vector<MGComplex> y(m);
+    std::vector<double> cs(m);
+    std::vector<MGComplex> sn(m);
+    MGCoarseVector w(n);
+
+    int iter = 0;
+    while (iter < max_iter)
+    {
+      // Restart from the true residual
+      Dc(w, x);
+      for(int i=0; i < n; ++i)
+	V[0][i] = b[i] - w[i];
+
+      const double beta = coarseNorm(V[0]);
+      if (beta <= target)
+	break;
+
+      for(int i=0; i < n; ++i)
+	V[0][i] /= beta;
+      g.assign(m+1, MGComplex(0, 0));
+      g[0] = beta;
+
+      int k = 0;
+      while (k < m && iter < max_iter)
+      {
+	Dc(w, V[k]);
+	++iter;
+
+	// Classical Gram-Schmidt, twice for stability
+	std::vector<MGComplex> h(k+1, MGComplex(0, 0));
+	coarseProject(h, V, k, w);
+	coarseProject(h, V, k, w);
+	for(int i=0; i <= k; ++i)
+	  H[i*m + k] = h[i];
+
+	const double hn = coarseNorm(w);
+	if (hn > 0)
+	  for(int l=0; l < n; ++l)
+	    V[k+1][l] = w[l] / hn;
+
+	// Previous Givens rotations on the new column
+	for(int i=0; i < k; ++i)
+	{
+	  const MGComplex a = H[i*m + k];
+	  const MGComplex c = H[(i+1)*m + k];
+	  H[i*m + k]     = cs[i]*a + sn[i]*c;
+	  H[(i+1)*m + k] = -std::conj(sn[i])*a + cs[i]*c;
+	}
+
+	// New rotation to annihilate H(k+1,k)
+	const MGComplex a = H[k*m + k];
+	const double r = std::sqrt(std::norm(a) + hn*hn);
+	if (std::abs(a) == 0)
+	{
+	  cs[k] = 0;
+	  sn[k] = 1;
+	}
+	else
+	{
+	  cs[k] = std::abs(a) / r;
+	  sn[k] = (a / std::abs(a)) * hn / r;
+	}
+	H[k*m + k] = cs[k]*a + sn[k]*hn;
+	g[k+1] = -std::conj(sn[k]) * g[k];
+	g[k]   = cs[k] * g[k];
+
+	++k;
+	if (std::abs(g[k]) <= target || hn == 0)
+	  break;
+      }
+
+      // Back substitution and update
+      for(int i=k-1; i >= 0; --i)
+      {
+	MGComplex t = g[i];
+	for(int l=i+1; l < k; ++l)
+	  t -= H[i*m + l] * y[l];
+	y[i] = t / H[i*m + i];
+      }
+      for(int i=0; i < k; ++i)
+	for(int l=0; l < n; ++l)
+	  x[l] += y[i] * V[i][l];
+
+      if (std::abs(g[k]) <= target)
+	break;
+    }
+
+    return iter;
+  }
+
+}  // end namespace Chroma
+
+#endif
@@ -0,0 +1,205 @@
+// -*- C++ -*-
+/*! \file
+ *  \brief Aggregation-based coarse space for the multigrid solver
+ */
+
+#ifndef __mg_aggregation_w_h__
+#define __mg_aggregation_w_h__
+
+#include "chromabase.h"
+#include "handle.h"
+#include "linearop.h"
+#include "actions/ferm/linop/dslash_face_comms.h"
+
+#include <vector>
+#include <complex>
+
+namespace Chroma
+{
+  //! Coarse grid complex numbers and vectors
+  /*!
+   * \ingroup invert
+   *
+   * Coarse vectors are distributed like the blocks. Every node holds the
+   * entries of its own blocks, indexed by
+   * local block*coarseDof() + dof, see MGAggregation::localBlocks().
+   */
+  typedef std::complex<double>   MGComplex;
+  typedef std::vector<MGComplex> MGCoarseVector;
+
+
+  //! Aggregation of the lattice into blocks with a chirally split basis
+  /*!
+   * \ingroup invert
+   *
+   * The lattice is cut into blocks of extent Blocking, which must divide
+   * the subgrid of every node. Every null vector is split into its two
+   * chiral halves, and these halves are orthonormalised on each block.
+   * The result is a block-local basis of 2*nvec vectors per block, the
+   * columns of the prolongator P. Since gamma_5 commutes with P, the
+   * coarse operator keeps the gamma_5 hermiticity of the fine one.
+   */
+  class MGAggregation
+  {
+  public:
+    //! Build the blocks
+    /*!
+     * \param blocking  block extent in each direction      (Read)
+     * \param nvec      number of null vectors              (Read)
+     */
+    MGAggregation(const multi1d<int>& blocking, int nvec);
+
+    //! Number of blocks on the whole lattice
+    int numBlocks() const {return nblocks;}
+
+    //! Degrees of freedom per block
+    int coarseDof() const {return 2*nvec;}
+
+    //! Length of a coarse vector on the whole lattice
+    int coarseSize() const {return nblocks*2*nvec;}
+
+    //! Length of the part of a coarse vector on this node
+    int localSize() const {return local_blocks.size()*2*nvec;}
+
+    //! Blocks owned by this node, in increasing order
+    const std::vector<int>& localBlocks() const {return local_blocks;}
+
+    //! Local index of block b, -1 if it is on another node
+    int localIndex(int b) const;
+
+    //! Is direction mu split across nodes
+    bool splitDir(int mu) const {return split_dir[mu];}
+
+    //! Local blocks on the lower (hi = 0) or upper (hi = 1) node face in direction mu
+    /*! In the order of the transverse block coordinates, so the lists of
+     *  two neighbouring nodes match block by block */
+    const std::vector<int>& faceBlocks(int mu, int hi) const {return face_blocks[2*mu+hi];}
+
+    //! Neighbouring block in direction mu, isign = +1 or -1
+    /*! Returns -1 if the neighbour is the block itself or duplicates the
+     *  forward neighbour, so each coupling is only counted once. */
+    int neighbourBlock(int b, int mu, int isign) const;
+
+    //! Colour of a block for probing. Blocks of one colour never couple
+    int blockColour(int b) const;
+
+    //! Number of block colours
+    int numColours() const {return 1 << Nd;}
+
+    //! Set the null vectors and build the block-orthonormal basis
+    void setNullVectors(const multi1d<LatticeFermion>& v);
+
+    //! c = P^dag f
+    void restrictVec(MGCoarseVector& c, const LatticeFermion& f) const;
+
+    //! f = P c
+    void prolongVec(LatticeFermion& f, const MGCoarseVector& c) const;
+
+    //! Basis vector dof on all blocks of one colour, zero elsewhere
+    void probeVec(LatticeFermion& f, int colour, int dof) const;
+
+    //! Inner product of basis vector dof with f on local block lb
+    /*!
+     * \param face  -1 for the whole block, 2*mu+1 for the sites on its
+     *              forward face in direction mu, 2*mu for the backward face
+     */
+    MGComplex blockDot(int lb, int dof, const LatticeFermion& f, int face) const;
+
+  private:
+    //! Arguments of the threaded restriction and prolongation
+    struct BlockArgs;
+
+    static void restrictBlocks(int lo, int hi, int myId, BlockArgs* a);
+    static void prolongBlocks(int lo, int hi, int myId, BlockArgs* a);
+
+    //! Block coordinates of block b
+    multi1d<int> blockCoords(int b) const;
+
+    //! Block of block coordinates bc
+    int blockIndex(const multi1d<int>& bc) const;
+
+    multi1d<int> block;                 /*!< block extents */
+    multi1d<int> nblk;                  /*!< blocks in each direction */
+    int nblocks;                        /*!< total number of blocks */
+    int nvec;                           /*!< number of null vectors */
+    std::vector<int> local_blocks;      /*!< blocks on this node */
+    std::vector<int> local_index;       /*!< local index of each block, -1 off node */
+    std::vector<bool> split_dir;        /*!< direction is split across nodes */
+    std::vector< std::vector<int> > face_blocks;  /*!< [2*mu+hi] local blocks on the node faces */
+    std::vector<int> block_start;       /*!< offsets of local block sites */
+    std::vector<int> block_sites;       /*!< node sites ordered by local block */
+    std::vector<int> site_faces;        /*!< face bits of each of the block_sites */
+    multi1d<LatticeFermion> basis;      /*!< 2*nvec block-orthonormal vectors */
+  };
+
+
+  //! Galerkin coarse operator  Dc = P^dag A P
+  /*!
+   * \ingroup invert
+   *
+   * A nearest neighbour operator on the blocks. It is built by probing A
+   * with the basis vectors of all blocks of one colour at a time. This
+   * needs only 2^Nd * coarseDof() applications of A and works for any
+   * nearest neighbour fine operator (Wilson, clover, twisted mass).
+   * The forward and backward neighbours of a block have the same colour,
+   * their couplings are told apart by restricting over the two faces of
+   * the block. Every node holds the rows of its own blocks.
+   *
+   * An application only exchanges the entries of the blocks on the node
+   * faces with the neighbouring nodes, there is no global sum.
+   */
+  class MGCoarseOperator
+  {
+  public:
+    //! Probe A on the aggregation
+    MGCoarseOperator(const LinearOperator<LatticeFermion>& A,
+		     Handle<MGAggregation> agg_);
+
+    //! y = Dc x
+    void operator()(MGCoarseVector& y, const MGCoarseVector& x) const;
+
+    //! Length of the part of a coarse vector on this node
+    int size() const {return agg->localSize();}
+
+  private:
+    //! Arguments of the threaded apply
+    struct ApplyArgs;
+
+    static void applyBlocks(int lo, int hi, int myId, ApplyArgs* a);
+
+    //! Copy x and the neighbour blocks of the other nodes into x_ext
+    void exchangeHalos(const MGCoarseVector& x) const;
+
+    Handle<MGAggregation> agg;
+    int ndof;
+    int nlinks;                         /*!< self plus 2*Nd neighbours */
+    std::vector<int> nbr;               /*!< neighbour of each local block and link, in x_ext */
+    std::vector<MGComplex> stencil;     /*!< ndof x ndof matrix per local block and link */
+
+    std::vector<int> halo_start;        /*!< [2*mu+kind] first block of each halo in x_ext */
+    Handle<DslashFaceComms> comms;      /*!< face messages, null without split directions */
+    mutable MGCoarseVector x_ext;       /*!< local blocks followed by the halo blocks */
+  };
+
+
+  //! Restarted GMRES on the coarse grid
+  /*!
+   * \ingroup invert
+   *
+   * Solves  Dc x = b  to relative residual rsd. The vectors are
+   * distributed, each Arnoldi step orthogonalises by classical
+   * Gram-Schmidt applied twice, with one global sum per pass and one
+   * for the norm.
+   *
+   * \return the number of iterations
+   */
+  int MGCoarseGMRES(const MGCoarseOperator& Dc,
+		    MGCoarseVector& x,
+		    const MGCoarseVector& b,
+		    double rsd,
+		    int max_iter,
+		    int n_krylov);
+
+} // End namespace
+
+#endif
@@ -0,0 +1,406 @@
+/*! \file
+ *  \brief Multishift Conjugate-Gradient algorithm for several sources at once
+ */
+
+#include "chromabase.h"
+#include "actions/ferm/invert/minvcg_block.h"
+
+#include <vector>
+
+#ifndef QDP_IS_QDPJIT
+
+namespace Chroma
+{
+
+  //! Anonymous namespace for the fused kernels
+  namespace
+  {
+    //! Arguments of the fused update and norms
+    template<typename T>
+    struct AxpyNormArgs
+    {
+      const std::vector<T*>& x;
+      const std::vector<const T*>& y;  /*!< null entries only take the norm of x */
+      const std::vector<REAL64>& a;
+      const multi1d<int>& tab;
+      std::vector<REAL64>& partial;    /*!< x.size() reals per thread */
+    };
+
+    //! Node-local  x_k += a_k y_k  and  |x_k|^2  for all k
+    template<typename T>
+    void axpyNorms(int lo, int hi, int myId, AxpyNormArgs<T>* arg)
+    {
+      typedef typename WordType<T>::Type_t REALT;
+      const int n = 2*Ns*Nc;
+      const int nv = arg->x.size();
+      REAL64* out = &(arg->partial[nv*myId]);
+
+      for(int k=0; k < nv; ++k)
+      {
+	const REALT a = arg->a[k];
+	REAL64 sum = 0;
+
+	for(int j=lo; j < hi; ++j)
+	{
+	  const int site = arg->tab[j];
+	  REALT* x = &(arg->x[k]->elem(site).elem(0).elem(0).real());
+
+	  if (arg->y[k] != 0)
+	  {
+	    const REALT* y = &(arg->y[k]->elem(site).elem(0).elem(0).real());
+	    for(int i=0; i < n; ++i)
+	      x[i] += a * y[i];
+	  }
+
+	  for(int i=0; i < n; ++i)
+	    sum += REAL64(x[i])*REAL64(x[i]);
+	}
+
+	out[k] += sum;
+      }
+    }
+
+    //! x_k += a_k y_k  and all  |x_k|^2  on the subset s with a single global reduction
+    template<typename T>
+    void fusedAxpyNorms(std::vector<Double>& norms,
+			const std::vector<T*>& x,
+			const std::vector<const T*>& y,
+			const std::vector<REAL64>& a,
+			const Subset& s)
+    {
+      const int nv = x.size();
+      const int nthr = qdpNumThreads();
+
+      std::vector<REAL64> partial(nv*nthr, 0);
+      AxpyNormArgs<T> arg = {x, y, a, s.siteTable(), partial};
+      dispatch_to_threads(s.numSiteTable(), arg, axpyNorms<T>);
+
+      std::vector<REAL64> sum(nv, 0);
+      for(int t=0; t < nthr; ++t)
+	for(int k=0; k < nv; ++k)
+	  sum[k] += partial[nv*t + k];
+
+      QDPInternal::globalSumArray(&sum[0], nv);
+
+      norms.resize(nv);
+      for(int k=0; k < nv; ++k)
+	norms[k] = Double(sum[k]);
+    }
+  }
+
+
+  //! Multishift CG for several sources
+  /*!
+   * Per source this is MInvCG2. The unshifted system of every source has
+   * its own  p, r, a, b, c  and the shifted systems their own  z, bs.
+   */
+  template<typename T, typename R>
+  SystemSolverResults_t
+  MInvCGBlock_a(const LinearOperator<T>& M,
+		const multi1d<T>& chi,
+		multi1d< multi1d<T> >& psi,
+		const multi1d<Real>& shifts,
+		const multi1d<Real>& RsdCG,
+		int MaxCG)
+  {
+    START_CODE();
+
+    const Subset& sub = M.subset();
+    const int n_src = chi.size();
+    const int n_shift = shifts.size();
+
+    if (n_shift == 0 || RsdCG.size() != n_shift)
+    {
+      QDPIO::cerr << "MInvCGBlock: need at least one shift and one residual per shift" << std::endl;
+      QDP_abort(1);
+    }
+
+    SystemSolverResults_t res;
+
+    psi.resize(n_src);
+    for(int n=0; n < n_src; ++n)
+    {
+      if (psi[n].size() < n_shift)
+	psi[n].resize(n_shift);
+
+      for(int s=0; s < n_shift; ++s)
+	psi[n][s][sub] = zero;
+    }
+
+    if (n_src == 0)
+    {
+      END_CODE();
+      return res;
+    }
+
+    FlopCounter flopcount;
+    flopcount.reset();
+    StopWatch swatch;
+    swatch.reset();
+    swatch.start();
+
+    multi1d<T> r(n_src);
+    multi1d<T> p_0(n_src);
+    multi1d<T> Mp(n_src);
+    multi1d<T> MMp(n_src);
+    multi1d< multi1d<T> > p(n_src);
+
+    multi1d<Double> c(n_src), cp(n_src), a(n_src), b(n_src), bp(n_src);
+    multi2d<Double> rsd_sq(n_src, n_shift);
+    multi2d<Double> bs(n_src, n_shift);
+    multi2d<Double> z[2] = {multi2d<Double>(n_src, n_shift), multi2d<Double>(n_src, n_shift)};
+    multi2d<bool> convsP(n_src, n_shift);
+    multi1d<bool> convP(n_src);
+
+    //  | chi[n] |^2  of all sources in one reduction
+    std::vector<T*> x;
+    std::vector<const T*> y;
+    std::vector<REAL64> coef;
+    std::vector<Double> norms;
+    for(int n=0; n < n_src; ++n)
+    {
+      r[n][sub] = chi[n];
+      x.push_back(&r[n]);
+      y.push_back(0);
+      coef.push_back(0);
+    }
+    fusedAxpyNorms(norms, x, y, coef, sub);
+    flopcount.addSiteFlops(4*Nc*Ns*n_src,sub);
+
+    // Smallest shift, it converges last
+    int isz = 0;
+    for(int s=1; s < n_shift; ++s)
+      if (toBool(shifts[s] < shifts[isz]))
+	isz = s;
+
+    int iz = 1;
+    int n_active = 0;
+    for(int n=0; n < n_src; ++n)
+    {
+      cp[n] = norms[n];
+      for(int s=0; s < n_shift; ++s)
+      {
+	rsd_sq[n][s] = cp[n] * Double(RsdCG[s] * RsdCG[s]);
+	convsP[n][s] = false;
+      }
+
+      // A zero source has a zero solution
+      convP[n] = toBool(cp[n] < fuzz*fuzz);
+      if (convP[n])
+	continue;
+
+      ++n_active;
+      p_0[n][sub] = chi[n];
+      p[n].resize(n_shift);
+      for(int s=0; s < n_shift; ++s)
+	p[n][s][sub] = chi[n];
+    }
+
+    // The first step, as in MInvCG2
+    x.clear(); y.clear(); coef.clear();
+    for(int n=0; n < n_src; ++n)
+    {
+      if (convP[n])
+	continue;
+      M(Mp[n], p_0[n], PLUS);
+      x.push_back(&Mp[n]);
+      y.push_back(0);
+      coef.push_back(0);
+    }
+    fusedAxpyNorms(norms, x, y, coef, sub);
+    flopcount.addFlops(n_active*M.nFlops());
+    flopcount.addSiteFlops(4*Nc*Ns*n_active,sub);
+
+    x.clear(); y.clear(); coef.clear();
+    for(int n=0, i=0; n < n_src; ++n)
+    {
+      if (convP[n])
+	continue;
+
+      //  b[0] := - | r[0] |**2 / < M p[0], M p[0] >
+      b[n] = -cp[n] / norms[i++];
+      M(MMp[n], Mp[n], MINUS);
+
+      //  r[1] += b[0] A . p[0]
+      x.push_back(&r[n]);
+      y.push_back(&MMp[n]);
+      coef.push_back(toDouble(b[n]));
+
+      for(int s=0; s < n_shift; ++s)
+      {
+	z[1-iz][n][s] = Double(1);
+	z[iz][n][s] = Double(1) / (Double(1) - Double(shifts[s])*b[n]);
+	bs[n][s] = b[n] * z[iz][n][s];
+
+	//  Psi[1] -= b[0] p[0] = - b[0] chi
+	R bs_r = bs[n][s];
+	psi[n][s][sub] = - bs_r*chi[n];
+      }
+    }
+    fusedAxpyNorms(norms, x, y, coef, sub);
+    flopcount.addFlops(n_active*M.nFlops());
+    flopcount.addSiteFlops((8 + 2*n_shift)*Nc*Ns*n_active,sub);
+
+    bool all_conv = true;
+    for(int n=0, i=0; n < n_src; ++n)
+    {
+      if (convP[n])
+	continue;
+
+      c[n] = norms[i++];
+      convP[n] = toBool(c[n] < rsd_sq[n][isz]);
+      all_conv &= convP[n];
+    }
+
+    int k;
+    for(k = 1; k <= MaxCG && ! all_conv; ++k)
+    {
+      n_active = 0;
+      x.clear(); y.clear(); coef.clear();
+      for(int n=0; n < n_src; ++n)
+      {
+	if (convP[n])
+	  continue;
+	++n_active;
+
+	//  a[k+1] := |r[k]|**2 / |r[k-1]|**2
+	a[n] = c[n] / cp[n];
+
+	//  p[k+1] := r[k+1] + a[k+1] p[k]
+	R a_r = a[n];
+	p_0[n][sub] = r[n] + a_r*p_0[n];
+
+	//  ps[k+1] := zs[k+1] r[k+1] + as[k+1] ps[k]
+	for(int s=0; s < n_shift; ++s)
+	{
+	  if (convsP[n][s])
+	    continue;
+
+	  Double as = a[n] * z[iz][n][s]*bs[n][s] / (z[1-iz][n][s]*b[n]);
+	  R zizs = z[iz][n][s];
+	  R as_r = as;
+	  p[n][s][sub] = zizs*r[n] + as_r*p[n][s];
+	  flopcount.addSiteFlops(6*Nc*Ns,sub);
+	}
+
+	cp[n] = c[n];
+
+	M(Mp[n], p_0[n], PLUS);
+	x.push_back(&Mp[n]);
+	y.push_back(0);
+	coef.push_back(0);
+      }
+
+      //  d = < M p, M p >  of all active sources
+      fusedAxpyNorms(norms, x, y, coef, sub);
+      flopcount.addFlops(n_active*M.nFlops());
+      flopcount.addSiteFlops(8*Nc*Ns*n_active,sub);
+
+      x.clear(); y.clear(); coef.clear();
+      for(int n=0, i=0; n < n_src; ++n)
+      {
+	if (convP[n])
+	  continue;
+
+	bp[n] = b[n];
+	b[n] = -cp[n] / norms[i++];
+
+	M(MMp[n], Mp[n], MINUS);
+
+	//  r[k+1] += b[k] A . p[k]
+	x.push_back(&r[n]);
+	y.push_back(&MMp[n]);
+	coef.push_back(toDouble(b[n]));
+      }
+
+      //  c = | r[k+1] |**2  of all active sources
+      fusedAxpyNorms(norms, x, y, coef, sub);
+      flopcount.addFlops(n_active*M.nFlops());
+      flopcount.addSiteFlops(8*Nc*Ns*n_active,sub);
+
+      iz = 1 - iz;
+      all_conv = true;
+      for(int n=0, i=0; n < n_src; ++n)
+      {
+	if (convP[n])
+	  continue;
+
+	c[n] = norms[i++];
+
+	bool conv = true;
+	for(int s=0; s < n_shift; ++s)
+	{
+	  if (convsP[n][s])
+	    continue;
+
+	  // The shifted bs and z
+	  Double z0 = z[1-iz][n][s];
+	  Double z1 = z[iz][n][s];
+	  z[iz][n][s] = z0*z1*bp[n];
+	  z[iz][n][s] /= b[n]*a[n]*(z1-z0) + z1*bp[n]*(Double(1) - shifts[s]*b[n]);
+	  bs[n][s] = b[n]*z[iz][n][s]/z0;
+
+	  //  Psi[k+1] -= b[k] p[k]
+	  R bs_r = bs[n][s];
+	  psi[n][s][sub] -= bs_r*p[n][s];
+	  flopcount.addSiteFlops(2*Nc*Ns,sub);
+
+	  // Norm of the shifted residual
+	  Double css = c[n] * z[iz][n][s] * z[iz][n][s];
+	  convsP[n][s] = toBool(css < rsd_sq[n][s]);
+	  conv &= convsP[n][s];
+	}
+
+	convP[n] = conv;
+	all_conv &= conv;
+      }
+
+      res.n_count = k;
+    }
+
+    swatch.stop();
+
+    QDPIO::cout << "MInvCGBlock: " << n_src << " sources  " << res.n_count << " iterations" << std::endl;
+    flopcount.report("minvcg_block", swatch.getTimeInSeconds());
+
+    if (! all_conv)
+    {
+      QDPIO::cerr << "MInvCGBlock: too many CG iterations: " << res.n_count << std::endl;
+      QDP_abort(1);
+    }
+
+    END_CODE();
+    return res;
+  }
+
+
+  //
+  // Explicit versions
+  //
+  // Single precision
+  SystemSolverResults_t
+  MInvCGBlock(const LinearOperator<LatticeFermionF>& M,
+	      const multi1d<LatticeFermionF>& chi,
+	      multi1d< multi1d<LatticeFermionF> >& psi,
+	      const multi1d<Real>& shifts,
+	      const multi1d<Real>& RsdCG,
+	      int MaxCG)
+  {
+    return MInvCGBlock_a<LatticeFermionF, RealF>(M, chi, psi, shifts, RsdCG, MaxCG);
+  }
+
+  // Double precision
+  SystemSolverResults_t
+  MInvCGBlock(const LinearOperator<LatticeFermionD>& M,
+	      const multi1d<LatticeFermionD>& chi,
+	      multi1d< multi1d<LatticeFermionD> >& psi,
+	      const multi1d<Real>& shifts,
+	      const multi1d<Real>& RsdCG,
+	      int MaxCG)
+  {
+    return MInvCGBlock_a<LatticeFermionD, RealD>(M, chi, psi, shifts, RsdCG, MaxCG);
+  }
+
+}  // end namespace Chroma
+
+#endif
@@ -0,0 +1,60 @@
+// -*- C++ -*-
+/*! \file
+ *  \brief Multishift Conjugate-Gradient algorithm for several sources at once
+ */
+
+#ifndef __minvcg_block_h__
+#define __minvcg_block_h__
+
+#include "linearop.h"
+#include "syssolver.h"
+
+namespace Chroma
+{
+
+  //! Multishift Conjugate-Gradient (CGNE) algorithm for several sources
+  /*! \ingroup invert
+   *
+   * Solves  Chi[n] = (M^dag M + shifts[s]) . Psi[n][s]  for all sources n
+   * and shifts s with the recurrences of MInvCG2. All sources are
+   * advanced in the same iteration loop. The norms of all sources that
+   * are needed in one step are summed across the nodes in a single
+   * global reduction, so an iteration costs two reductions whatever the
+   * number of sources. A source drops out of the loop once all its
+   * shifts have converged.
+   *
+   *  \param M       Linear Operator                   (Read)
+   *  \param chi     Sources                           (Read)
+   *  \param psi     Solutions psi[n][s]               (Write)
+   *  \param shifts  Shifts of the form  M^dag M + shift (Read)
+   *  \param RsdCG   Residual accuracy of each shift   (Read)
+   *  \param MaxCG   Maximum CG iterations             (Read)
+   *  \return res    System solver results, n_count is the largest count
+   *
+   * @{
+   */
+
+  // Single precision
+  SystemSolverResults_t
+  MInvCGBlock(const LinearOperator<LatticeFermionF>& M,
+	      const multi1d<LatticeFermionF>& chi,
+	      multi1d< multi1d<LatticeFermionF> >& psi,
+	      const multi1d<Real>& shifts,
+	      const multi1d<Real>& RsdCG,
+	      int MaxCG);
+
+  // Double precision
+  SystemSolverResults_t
+  MInvCGBlock(const LinearOperator<LatticeFermionD>& M,
+	      const multi1d<LatticeFermionD>& chi,
+	      multi1d< multi1d<LatticeFermionD> >& psi,
+	      const multi1d<Real>& shifts,
+	      const multi1d<Real>& RsdCG,
+	      int MaxCG);
+
+  /*! @} */  // end of group invert
+
+}  // end namespace Chroma
+
+
+#endif
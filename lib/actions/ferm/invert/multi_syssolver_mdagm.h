@@ -26,6 +26,13 @@ namespace Chroma
   {
   };
 
+  //! SystemSolver disambiguator
+  /*! This struct is solely to disambiguate the type of SystemSolvers */
+  template<typename T>
+  struct MdagMMultiSystemSolverBlock : virtual public MultiSystemSolverBlock<T>
+  {
+  };
+
 }
 
 
@@ -0,0 +1,77 @@
+// -*- C++ -*-
+/*! \file
+ *  \brief Solve MdagM*psi=chi multi-shift systems for several sources one by one
+ */
+
+#ifndef __multi_syssolver_mdagm_block_loop_h__
+#define __multi_syssolver_mdagm_block_loop_h__
+
+#include "handle.h"
+#include "syssolver.h"
+#include "actions/ferm/invert/multi_syssolver_mdagm.h"
+
+namespace Chroma
+{
+
+  //! Several sources with a single-source multi-shift solver
+  /*! \ingroup invert
+   *
+   * Fallback for multi-shift solvers that have no version for several
+   * sources. The sources are solved one after the other.
+   */
+  template<typename T>
+  class MdagMMultiSysSolverBlockLoop : public MdagMMultiSystemSolverBlock<T>
+  {
+  public:
+    //! Constructor
+    /*!
+     * \param invMdagM_  single-source multi-shift solver ( Read )
+     */
+    MdagMMultiSysSolverBlockLoop(Handle< MdagMMultiSystemSolver<T> > invMdagM_) : 
+      invMdagM(invMdagM_) 
+      {}
+
+    //! Destructor is automatic
+    ~MdagMMultiSysSolverBlockLoop() {}
+
+    //! Return the subset on which the operator acts
+    const Subset& subset() const {return invMdagM->subset();}
+
+    //! Solve the linear systems
+    /*!
+     * \param psi      solutions psi[source][shift] ( Modify )
+     * \param shifts   shifts ( Read )
+     * \param chi      sources ( Read )
+     * \return syssolver results, n_count is the sum over the sources
+     */
+    SystemSolverResults_t operator() (multi1d< multi1d<T> >& psi, 
+				      const multi1d<Real>& shifts, 
+				      const multi1d<T>& chi) const
+      {
+	START_CODE();
+
+	SystemSolverResults_t res;
+	psi.resize(chi.size());
+	for(int n=0; n < chi.size(); ++n)
+	{
+	  SystemSolverResults_t r = (*invMdagM)(psi[n], shifts, chi[n]);
+	  res.n_count += r.n_count;
+	}
+
+	END_CODE();
+
+	return res;
+      }
+
+
+  private:
+    // Hide default constructor
+    MdagMMultiSysSolverBlockLoop() {}
+
+    Handle< MdagMMultiSystemSolver<T> > invMdagM;
+  };
+
+
+} // End namespace
+
+#endif 
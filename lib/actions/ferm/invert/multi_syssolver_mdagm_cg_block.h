@@ -0,0 +1,92 @@
+// -*- C++ -*-
+/*! \file
+ *  \brief Solve MdagM*psi=chi multi-shift systems for several sources by CG
+ */
+
+#ifndef __multi_syssolver_mdagm_cg_block_h__
+#define __multi_syssolver_mdagm_cg_block_h__
+
+#include "handle.h"
+#include "syssolver.h"
+#include "linearop.h"
+#include "actions/ferm/invert/multi_syssolver_mdagm.h"
+#include "actions/ferm/invert/multi_syssolver_cg_params.h"
+#include "actions/ferm/invert/minvcg_block.h"
+
+namespace Chroma
+{
+
+  //! Solve multi-shift CG systems for several sources at once
+  /*! \ingroup invert
+   *
+   * Takes the same parameters as the CG_INVERTER multi-shift solver and
+   * advances all sources in one loop with MInvCGBlock.
+   */
+  template<typename T>
+  class MdagMMultiSysSolverCGBlock : public MdagMMultiSystemSolverBlock<T>
+  {
+  public:
+    //! Constructor
+    /*!
+     * \param A_        Linear operator ( Read )
+     * \param invParam  inverter parameters ( Read )
+     */
+    MdagMMultiSysSolverCGBlock(Handle< LinearOperator<T> > A_,
+			       const MultiSysSolverCGParams& invParam_) : 
+      A(A_), invParam(invParam_) 
+      {}
+
+    //! Destructor is automatic
+    ~MdagMMultiSysSolverCGBlock() {}
+
+    //! Return the subset on which the operator acts
+    const Subset& subset() const {return A->subset();}
+
+    //! Solve the linear systems
+    /*!
+     * \param psi      solutions psi[source][shift] ( Modify )
+     * \param shifts   shifts ( Read )
+     * \param chi      sources ( Read )
+     * \return syssolver results
+     */
+    SystemSolverResults_t operator() (multi1d< multi1d<T> >& psi, 
+				      const multi1d<Real>& shifts, 
+				      const multi1d<T>& chi) const
+      {
+	START_CODE();
+
+	multi1d<Real> RsdCG(shifts.size());
+	if (invParam.RsdCG.size() == 1)
+	{
+	  RsdCG = invParam.RsdCG[0];
+	}
+	else if (invParam.RsdCG.size() == RsdCG.size())
+	{
+	  RsdCG = invParam.RsdCG;
+	}
+	else
+	{
+	  QDPIO::cerr << "MdagMMultiSysSolverCGBlock: shifts incompatible" << std::endl;
+	  QDP_abort(1);
+	}
+
+	SystemSolverResults_t res = MInvCGBlock(*A, chi, psi, shifts, RsdCG, invParam.MaxCG);
+
+	END_CODE();
+
+	return res;
+      }
+
+
+  private:
+    // Hide default constructor
+    MdagMMultiSysSolverCGBlock() {}
+
+    Handle< LinearOperator<T> > A;
+    MultiSysSolverCGParams invParam;
+  };
+
+
+} // End namespace
+
+#endif 
@@ -4,6 +4,7 @@
 
 #include "chromabase.h"
 #include "actions/ferm/invert/reliable_cg.h"
+#include "util/ferm/half_storage.h"
 
 namespace Chroma {
 
@@ -227,4 +228,261 @@ InvCGReliable(const LinearOperator<LatticeFermionD>& A,
 }
 
 
+#ifndef QDP_IS_QDPJIT
+  //! Anonymous namespace for the 16-bit storage kernels
+  namespace
+  {
+    //! Arguments of the fused solution/residual update
+    struct HalfUpdateArgs
+    {
+      HalfPrecFermion& x;
+      HalfPrecFermion& r;
+      const LatticeFermionF& p;
+      const LatticeFermionF& mmp;
+      REAL32 a;
+      const multi1d<int>& tab;
+      multi1d<REAL64>& r_sq;     /*!< partial norms, one per thread */
+    };
+
+    //!  x += a p ;  r -= a mmp ;  r_sq = |r|^2
+    void halfUpdateXR(int lo, int hi, int myId, HalfUpdateArgs* arg)
+    {
+      const int n = HalfPrecFermion::nreal;
+      REAL32 xs[HalfPrecFermion::nreal];
+      REAL32 rs[HalfPrecFermion::nreal];
+      REAL64 sum = 0;
+
+      for(int j=lo; j < hi; ++j)
+      {
+	const int site = arg->tab[j];
+	const REAL32* ps = &(arg->p.elem(site).elem(0).elem(0).real());
+	const REAL32* ms = &(arg->mmp.elem(site).elem(0).elem(0).real());
+
+	arg->x.loadSite(xs, site);
+	arg->r.loadSite(rs, site);
+	for(int i=0; i < n; ++i)
+	{
+	  xs[i] += arg->a * ps[i];
+	  rs[i] -= arg->a * ms[i];
+	  sum += REAL64(rs[i])*REAL64(rs[i]);
+	}
+	arg->x.storeSite(xs, site);
+	arg->r.storeSite(rs, site);
+      }
+
+      arg->r_sq[myId] += sum;
+    }
+
+    //! Arguments of the search direction update
+    struct HalfDirArgs
+    {
+      const HalfPrecFermion& r;
+      LatticeFermionF& p;
+      REAL32 beta;
+      const multi1d<int>& tab;
+    };
+
+    //!  p = r + beta p
+    void halfUpdateP(int lo, int hi, int myId, HalfDirArgs* arg)
+    {
+      const int n = HalfPrecFermion::nreal;
+      REAL32 rs[HalfPrecFermion::nreal];
+
+      for(int j=lo; j < hi; ++j)
+      {
+	const int site = arg->tab[j];
+	REAL32* ps = &(arg->p.elem(site).elem(0).elem(0).real());
+
+	arg->r.loadSite(rs, site);
+	for(int i=0; i < n; ++i)
+	  ps[i] = rs[i] + arg->beta * ps[i];
+      }
+    }
+  }
+
+
+  // single double, sloppy solution and residual stored in 16 bits
+SystemSolverResults_t
+InvCGReliableHalf(const LinearOperator<LatticeFermionD>& A,
+		  const LinearOperator<LatticeFermionF>& AF,
+		  const LatticeFermionD& chi,
+		  LatticeFermionD& psi,
+		  const Real& RsdCG, 
+		  const Real& Delta,
+		  int MaxCG)
+  {
+    START_CODE();
+    SystemSolverResults_t ret;
+
+    const Subset& s = A.subset();
+    const multi1d<int>& tab = s.siteTable();
+    const int nsites = s.numSiteTable();
+    multi1d<REAL64> partial(qdpNumThreads());
+
+    bool convP = false;
+
+    // Sloppy solution and residual in 16 bits
+    HalfPrecFermion r;
+    HalfPrecFermion x;
+
+    LatticeFermionD b; 
+    LatticeFermionD r_dble;
+    LatticeFermionD x_dble;
+    LatticeFermionF p, mp, mmp;
+    int k;
+
+    StopWatch swatch;
+    FlopCounter flopcount;
+    flopcount.reset();
+    swatch.reset();
+    swatch.start();
+
+    b[s] = chi;
+    Double chi_norm = norm2(chi,s);
+    Double rsd_sq=RsdCG*RsdCG*chi_norm;
+
+    {
+      LatticeFermionD tmp1, tmp2;
+      A(tmp1, psi, PLUS);
+      A(tmp2, tmp1, MINUS);
+      b[s] -= tmp2;
+      flopcount.addFlops(2*A.nFlops());
+      flopcount.addSiteFlops(2*Nc*Ns,s);
+    }
+
+    x.zero(s);
+ 
+    // now work out r= chi - Apsi = chi - r0
+    mp[s] = b;
+    r.pack(mp, s);
+
+    Double r_sq = norm2(b,s);
+    flopcount.addSiteFlops(4*Nc*Ns,s);
+
+    QDPIO::cout << "Reliable CG (16-bit storage): || r0 ||/|| b ||=" << sqrt(r_sq/chi_norm) << std::endl;
+
+    Double rNorm = sqrt(r_sq);
+    Double r0Norm = rNorm;
+    Double maxrx = rNorm;
+    Double maxrr = rNorm;
+    bool updateR = false;
+    bool updateX = false;
+
+    Double a, c, d;
+
+    // The iterations 
+    for(k = 0; k < MaxCG && !convP; k++) { 
+      if( k == 0 ) { 
+	r.unpack(p, s);
+      }
+      else { 
+	Double beta = r_sq / c;
+	HalfDirArgs arg = {r, p, REAL32(toDouble(beta)), tab};
+	dispatch_to_threads(nsites, arg, halfUpdateP);
+	flopcount.addSiteFlops(4*Nc*Ns,s);
+      }
+
+      c = r_sq;
+
+      AF(mp, p, PLUS); 
+      d = norm2(mp,s); 
+      AF(mmp,mp,MINUS); 
+
+      a = c/d;
+
+      // x += a p ;  r -= a mmp ;  |r|^2  in one pass
+      {
+	partial = 0;
+	HalfUpdateArgs arg = {x, r, p, mmp, REAL32(toDouble(a)), tab, partial};
+	dispatch_to_threads(nsites, arg, halfUpdateXR);
+
+	REAL64 sum = 0;
+	for(int i=0; i < partial.size(); ++i)
+	  sum += partial[i];
+	QDPInternal::globalSum(sum);
+	r_sq = Double(sum);
+      }
+
+      flopcount.addSiteFlops(16*Nc*Ns,s);
+      flopcount.addFlops(2*A.nFlops());
+
+      // Reliable update part...
+      rNorm = sqrt(r_sq);
+      if( toBool( rNorm > maxrx) ) maxrx = rNorm;
+      if( toBool( rNorm > maxrr) ) maxrr = rNorm;
+      
+      updateX = toBool ( rNorm < Delta*r0Norm && r0Norm <= maxrx );
+      updateR = toBool ( rNorm < Delta*maxrr && r0Norm <= maxrr ) || updateX;
+
+      // Do the R update with real DP residual
+      if( updateR ) { 
+
+	{
+	  LatticeFermionD tmp1,tmp2;
+	  x.unpack(mp, s);
+	  x_dble[s] = mp;
+	  
+	  A(tmp1, x_dble, PLUS); // Use full solution so far
+	  A(tmp2, tmp1, MINUS); // Use full solution so far
+
+	  r_dble[s] = b - tmp2;
+	}
+
+	mp[s] = r_dble;     // new R = b - Ax
+	r.pack(mp, s);
+	r_sq = norm2(r_dble,s);
+
+	flopcount.addSiteFlops(6*Nc*Ns,s); // 4 from norm2, 2 from r=b-tmp2
+	flopcount.addFlops(2*A.nFlops());
+
+	rNorm = sqrt(r_sq);
+	maxrr = rNorm;
+	
+	// Group wise x update
+	if( updateX ) { 
+	  psi[s] += x_dble; // Add on group accumulated solution in y
+	  flopcount.addSiteFlops(2*Nc*Ns,s);
+
+	  x.zero(s); // zero y
+	  b[s] = r_dble;
+	  r0Norm = rNorm;
+	  maxrx = rNorm;
+	}
+
+      }
+
+      // Convergence check
+      if( toBool(r_sq < rsd_sq ) ) {
+	// We've converged.
+	x.unpack(mp, s);
+	x_dble[s] = mp;
+	psi[s]+=x_dble;
+	flopcount.addSiteFlops(2*Nc*Ns,s);
+	ret.resid = rNorm;
+	ret.n_count = k;
+	convP = true;
+      }
+      else { 
+	convP = false;
+      }
+
+    }
+
+    // Loop is finished. Report FLOP Count...
+    swatch.stop();
+    flopcount.report("reliable_invcg2_half", swatch.getTimeInSeconds());
+
+    // Check for nonconvergence
+    if( k >= MaxCG ) { 
+      QDPIO::cout << "Nonconvergence: Reliable CG (16-bit storage) Failed to converge in " << MaxCG << " iterations " << std::endl;
+      QDP_abort(1);
+    }
+
+    // Done
+    END_CODE();
+    return ret;
+  }
+#endif
+
+
 }  // end namespace Chroma
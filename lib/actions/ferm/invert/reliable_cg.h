@@ -46,6 +46,25 @@ namespace Chroma
 		int MaxCG);
   
 
+#ifndef QDP_IS_QDPJIT
+  // single double, sloppy solution and residual stored in 16 bits
+  /*!
+   * Same as the single/double version, but the sloppy solution and
+   * residual are kept in HalfPrecFermion storage between iterations.
+   * Their updates and the residual norm are done in one threaded
+   * site loop. The reliable updates recompute the residual in double.
+   */
+  SystemSolverResults_t
+  InvCGReliableHalf(const LinearOperator<LatticeFermionD>& A,
+		    const LinearOperator<LatticeFermionF>& AF,
+		    const LatticeFermionD& chi,
+		    LatticeFermionD& psi,
+		    const Real& RsdCG, 
+		    const Real& Delta,
+		    int MaxCG);
+#endif
+
+
   /*! @} */  // end of group invert
 	    
 }  // end namespace Chroma
@@ -0,0 +1,43 @@
+/*! \file
+ *  \brief Params of the block CG inverter
+ */
+
+#include "actions/ferm/invert/syssolver_block_cg_params.h"
+
+namespace Chroma
+{
+
+  // Read parameters
+  void read(XMLReader& xml, const std::string& path, SysSolverBlockCGParams& param)
+  {
+    XMLReader paramtop(xml, path);
+
+    read(paramtop, "RsdCG", param.RsdCG);
+    read(paramtop, "MaxCG", param.MaxCG);
+  }
+
+  // Writer parameters
+  void write(XMLWriter& xml, const std::string& path, const SysSolverBlockCGParams& param)
+  {
+    push(xml, path);
+
+    write(xml, "invType", "BLOCK_CG_INVERTER");
+    write(xml, "RsdCG", param.RsdCG);
+    write(xml, "MaxCG", param.MaxCG);
+    pop(xml);
+  }
+
+  //! Default constructor
+  SysSolverBlockCGParams::SysSolverBlockCGParams()
+  {
+    RsdCG = zero;
+    MaxCG = 0;
+  }
+
+  //! Read parameters
+  SysSolverBlockCGParams::SysSolverBlockCGParams(XMLReader& xml, const std::string& path)
+  {
+    read(xml, path, *this);
+  }
+
+}
@@ -0,0 +1,37 @@
+// -*- C++ -*-
+/*! \file
+ *  \brief Params of the block CG inverter
+ */
+
+#ifndef __syssolver_block_cg_params_h__
+#define __syssolver_block_cg_params_h__
+
+#include "chromabase.h"
+
+
+namespace Chroma
+{
+
+  //! Params for block CG inverter
+  /*! \ingroup invert */
+  struct SysSolverBlockCGParams
+  {
+    SysSolverBlockCGParams();
+    SysSolverBlockCGParams(XMLReader& in, const std::string& path);
+
+    Real          RsdCG;           /*!< CG residual */
+    int           MaxCG;           /*!< Maximum CG iterations */
+  };
+
+
+  // Reader/writers
+  /*! \ingroup invert */
+  void read(XMLReader& xml, const std::string& path, SysSolverBlockCGParams& param);
+
+  /*! \ingroup invert */
+  void write(XMLWriter& xml, const std::string& path, const SysSolverBlockCGParams& param);
+
+} // End namespace
+
+#endif 
+
@@ -0,0 +1,37 @@
+// -*- C++ -*-
+/*! \file
+ *  \brief Params of the pipelined and s-step CG inverters
+ */
+
+#ifndef __syssolver_cacg_params_h__
+#define __syssolver_cacg_params_h__
+
+#include "chromabase.h"
+
+
+namespace Chroma
+{
+
+  //! Params for the pipelined and s-step CG inverters
+  /*! \ingroup invert */
+  struct SysSolverCACGParams
+  {
+    SysSolverCACGParams();
+    SysSolverCACGParams(XMLReader& in, const std::string& path);
+    
+    Real          RsdCG;           /*!< CG residual */
+    int           MaxCG;           /*!< Maximum CG iterations */
+    int           SStep;           /*!< Iterations per global reduction of the s-step CG */
+  };
+
+
+  // Reader/writers
+  /*! \ingroup invert */
+  void read(XMLReader& xml, const std::string& path, SysSolverCACGParams& param);
+
+  /*! \ingroup invert */
+  void write(XMLWriter& xml, const std::string& path, const SysSolverCACGParams& param);
+
+} // End namespace
+
+#endif
@@ -0,0 +1,101 @@
+/*! \file
+ *  \brief Params of the solvers deflated with a shared subspace
+ */
+
+#include "actions/ferm/invert/syssolver_deflated_params.h"
+#include "chromabase.h"
+#include "io/xml_group_reader.h"
+
+using namespace QDP;
+
+namespace Chroma 
+{
+
+  //! Default subspace params
+  DeflationSpaceParams::DeflationSpaceParams()
+  {
+    space_id = "NULL";
+    Nvec = 0;
+    RefineEvery = 4;
+    file.read = false;
+    file.write = false;
+    file.file_name = "";
+  }
+
+  //! Read the subspace params
+  DeflationSpaceParams::DeflationSpaceParams(XMLReader& xml, const std::string& path)
+  {
+    *this = DeflationSpaceParams();
+
+    XMLReader paramtop(xml, path);
+    read(paramtop, "space_id", space_id);
+    read(paramtop, "Nvec", Nvec);
+
+    if (paramtop.count("RefineEvery") > 0)
+      read(paramtop, "RefineEvery", RefineEvery);
+
+    if (paramtop.count("File") > 0)
+    {
+      XMLReader filetop(paramtop, "File");
+      read(filetop, "file_name", file.file_name);
+      if (filetop.count("read") > 0)
+	read(filetop, "read", file.read);
+      if (filetop.count("write") > 0)
+	read(filetop, "write", file.write);
+    }
+
+    if (Nvec < 1 || RefineEvery < 1)
+    {
+      QDPIO::cerr << "DeflationSpaceParams: Nvec and RefineEvery must be positive" << std::endl;
+      QDP_abort(1);
+    }
+  }
+
+  void read(XMLReader& xml, const std::string& path, DeflationSpaceParams& p)
+  {
+    DeflationSpaceParams tmp(xml, path);
+    p = tmp;
+  }
+
+  void write(XMLWriter& xml, const std::string& path, const DeflationSpaceParams& p)
+  {
+    push(xml, path);
+    write(xml, "space_id", p.space_id);
+    write(xml, "Nvec", p.Nvec);
+    write(xml, "RefineEvery", p.RefineEvery);
+    if (p.file.file_name != "")
+    {
+      push(xml, "File");
+      write(xml, "file_name", p.file.file_name);
+      write(xml, "read", p.file.read);
+      write(xml, "write", p.file.write);
+      pop(xml);
+    }
+    pop(xml);
+  }
+
+
+  //! Read the solver params
+  SysSolverDeflatedParams::SysSolverDeflatedParams(XMLReader& xml, const std::string& path)
+  {
+    XMLReader paramtop(xml, path);
+    read(paramtop, "DeflationSpace", space);
+    subInvParam = readXMLGroup(paramtop, "SubInvParam", "invType");
+  }
+
+  void read(XMLReader& xml, const std::string& path, SysSolverDeflatedParams& p)
+  {
+    SysSolverDeflatedParams tmp(xml, path);
+    p = tmp;
+  }
+
+  void write(XMLWriter& xml, const std::string& path, const SysSolverDeflatedParams& p)
+  {
+    push(xml, path);
+    write(xml, "invType", "DEFLATED_INVERTER");
+    write(xml, "DeflationSpace", p.space);
+    xml << p.subInvParam.xml;
+    pop(xml);
+  }
+
+}
@@ -0,0 +1,59 @@
+// -*- C++ -*-
+/*! \file
+ *  \brief Params of the solvers deflated with a shared subspace
+ */
+
+#ifndef __syssolver_deflated_params_h__
+#define __syssolver_deflated_params_h__
+
+#include "chromabase.h"
+#include "io/xml_group_reader.h"
+
+namespace Chroma 
+{
+  //! Params of a deflation subspace shared through a named object
+  /*! \ingroup invert */
+  struct DeflationSpaceParams
+  {
+    DeflationSpaceParams();
+    DeflationSpaceParams(XMLReader& xml, const std::string& path);
+
+    std::string space_id;     /*!< named object holding the subspace */
+    int  Nvec;                /*!< number of vectors kept */
+    int  RefineEvery;         /*!< Rayleigh-Ritz after this many new solutions */
+
+    struct File_t
+    {
+      bool read;              /*!< read the subspace if the named object is new */
+      bool write;             /*!< write the subspace when it has changed */
+      std::string file_name;  /*!< MapObjectDisk file */
+    } file;
+  };
+
+  //! Params for a solver deflated with a shared subspace
+  /*! \ingroup invert */
+  struct SysSolverDeflatedParams
+  { 
+    SysSolverDeflatedParams() {}
+    SysSolverDeflatedParams(XMLReader& xml, const std::string& path);
+
+    DeflationSpaceParams space;    /*!< the subspace */
+    GroupXML_t subInvParam;        /*!< solver started from the deflated guess */
+  };
+
+
+  //! Read the params
+  void read(XMLReader& xml, const std::string& path, DeflationSpaceParams& p);
+
+  //! Write the params
+  void write(XMLWriter& xml, const std::string& path, const DeflationSpaceParams& p);
+
+  //! Read the params
+  void read(XMLReader& xml, const std::string& path, SysSolverDeflatedParams& p);
+
+  //! Write the params
+  void write(XMLWriter& xml, const std::string& path, const SysSolverDeflatedParams& p);
+
+}
+
+#endif
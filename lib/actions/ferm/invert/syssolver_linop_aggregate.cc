@@ -6,6 +6,8 @@
 #include "actions/ferm/invert/syssolver_linop_aggregate.h"
 
 #include "actions/ferm/invert/syssolver_linop_cg.h"
+#include "actions/ferm/invert/syssolver_linop_cacg.h"
+#include "actions/ferm/invert/syssolver_linop_block_cg.h"
 #include "actions/ferm/invert/syssolver_linop_bicgstab.h"
 #include "actions/ferm/invert/syssolver_linop_ibicgstab.h"
 #include "actions/ferm/invert/syssolver_linop_bicrstab.h"
@@ -14,10 +16,13 @@
 #include "actions/ferm/invert/syssolver_linop_eigcg.h"
 #include "actions/ferm/invert/syssolver_linop_eigbicg.h"
 #include "actions/ferm/invert/syssolver_linop_richardson_multiprec_clover.h"
+#include "actions/ferm/invert/syssolver_linop_mixed_prec_richardson.h"
+#include "actions/ferm/invert/syssolver_linop_deflated.h"
 #include "actions/ferm/invert/syssolver_linop_rel_bicgstab_clover.h"
 #include "actions/ferm/invert/syssolver_linop_rel_ibicgstab_clover.h"
 #include "actions/ferm/invert/syssolver_linop_rel_cg_clover.h"
 #include "actions/ferm/invert/syssolver_linop_fgmres_dr.h"
+#include "actions/ferm/invert/syssolver_linop_mg_w.h"
 
 
 #include "chroma_config.h"
@@ -62,6 +67,10 @@ namespace Chroma
       {
 	// 4D system solvers
 	success &= LinOpSysSolverCGEnv::registerAll();
+	success &= LinOpSysSolverBlockCGEnv::registerAll();
+#ifndef QDP_IS_QDPJIT
+	success &= LinOpSysSolverCACGEnv::registerAll();
+#endif
 	success &= LinOpSysSolverBiCGStabEnv::registerAll();
 	success &= LinOpSysSolverBiCRStabEnv::registerAll();
 	success &= LinOpSysSolverIBiCGStabEnv::registerAll();
@@ -70,10 +79,15 @@ namespace Chroma
 	success &= LinOpSysSolverEigCGEnv::registerAll();
 	success &= LinOpSysSolverEigBiCGEnv::registerAll();
 	success &= LinOpSysSolverRichardsonCloverEnv::registerAll();
+	success &= LinOpSysSolverMixedPrecRichardsonEnv::registerAll();
+	success &= LinOpSysSolverDeflatedEnv::registerAll();
 	success &= LinOpSysSolverReliableBiCGStabCloverEnv::registerAll();
 	success &= LinOpSysSolverReliableIBiCGStabCloverEnv::registerAll();
 	success &= LinOpSysSolverReliableCGCloverEnv::registerAll();
 	success &= LinOpSysSolverFGMRESDREnv::registerAll();
+#ifndef QDP_IS_QDPJIT
+	success &= LinOpSysSolverMGEnv::registerAll();
+#endif
 
 #ifdef BUILD_QUDA
 	success &= LinOpSysSolverQUDACloverEnv::registerAll();
@@ -0,0 +1,79 @@
+/*! \file
+ *  \brief Solve M*psi=chi linear systems for several sources by block CG
+ */
+#include "state.h"
+#include "actions/ferm/invert/syssolver_linop_factory.h"
+#include "actions/ferm/invert/syssolver_linop_aggregate.h"
+
+#include "actions/ferm/invert/syssolver_linop_block_cg.h"
+
+namespace Chroma
+{
+
+  //! Block CG system solver namespace
+  namespace LinOpSysSolverBlockCGEnv
+  {
+    //! Anonymous namespace
+    namespace
+    {
+      //! Name to be used
+      const std::string name("BLOCK_CG_INVERTER");
+
+      //! Local registration flag
+      bool registered = false;
+    }
+
+
+    //! Callback function
+    LinOpSystemSolver<LatticeFermion>* createFerm(XMLReader& xml_in,
+						  const std::string& path,
+						  Handle< FermState<
+						                     LatticeFermion, 
+						                     multi1d<LatticeColorMatrix>,
+						                     multi1d<LatticeColorMatrix> 
+					 	  > 
+							  > state, 
+
+						  Handle< LinearOperator<LatticeFermion> > A)
+    {
+      return new LinOpSysSolverBlockCG<LatticeFermion>(A, SysSolverBlockCGParams(xml_in, path));
+    }
+
+    //! Callback function
+    LinOpSystemSolver<LatticeFermionF>* createFermF(XMLReader& xml_in,
+						  const std::string& path,
+						  Handle< FermState<
+						                     LatticeFermionF, 
+						                     multi1d<LatticeColorMatrixF>,
+						                     multi1d<LatticeColorMatrixF> 
+						  > 
+							  > state, 
+
+						  Handle< LinearOperator<LatticeFermionF> > A)
+    {
+      return new LinOpSysSolverBlockCG<LatticeFermionF>(A, SysSolverBlockCGParams(xml_in, path));
+    }
+
+    //! Callback function
+    LinOpSystemSolver<LatticeStaggeredFermion>* createStagFerm(XMLReader& xml_in,
+							       const std::string& path,
+							       Handle< LinearOperator<LatticeStaggeredFermion> > A)
+    {
+      return new LinOpSysSolverBlockCG<LatticeStaggeredFermion>(A, SysSolverBlockCGParams(xml_in, path));
+    }
+
+    //! Register all the factories
+    bool registerAll() 
+    {
+      bool success = true; 
+      if (! registered)
+      {
+	success &= Chroma::TheLinOpFermSystemSolverFactory::Instance().registerObject(name, createFerm);
+	success &= Chroma::TheLinOpFFermSystemSolverFactory::Instance().registerObject(name, createFermF);
+	success &= Chroma::TheLinOpStagFermSystemSolverFactory::Instance().registerObject(name, createStagFerm);
+	registered = true;
+      }
+      return success;
+    }
+  }
+}
@@ -0,0 +1,127 @@
+// -*- C++ -*-
+/*! \file
+ *  \brief Solve M*psi=chi linear systems for several sources by block CG
+ */
+
+#ifndef __syssolver_linop_block_cg_h__
+#define __syssolver_linop_block_cg_h__
+#include "chroma_config.h"
+#include "handle.h"
+#include "syssolver.h"
+#include "linearop.h"
+#include "actions/ferm/invert/syssolver_linop.h"
+#include "actions/ferm/invert/syssolver_block_cg_params.h"
+#include "actions/ferm/invert/invblockcg.h"
+
+
+namespace Chroma
+{
+
+  //! Block CG system solver namespace
+  namespace LinOpSysSolverBlockCGEnv
+  {
+    //! Register the syssolver
+    bool registerAll();
+  }
+
+
+  //! Solve M*psi=chi linear systems for several sources by block CG
+  /*! \ingroup invert
+   *
+   * A single source is solved as a block of size one. Callers with many
+   * sources reach the block solve through the SystemSolverBlock interface.
+   */
+  template<typename T>
+  class LinOpSysSolverBlockCG : public LinOpSystemSolver<T>, public SystemSolverBlock<T>
+  {
+  public:
+    //! Constructor
+    /*!
+     * \param M_        Linear operator ( Read )
+     * \param invParam  inverter parameters ( Read )
+     */
+    LinOpSysSolverBlockCG(Handle< LinearOperator<T> > A_,
+			  const SysSolverBlockCGParams& invParam_) : 
+      A(A_), invParam(invParam_) 
+      {}
+
+    //! Destructor is automatic
+    ~LinOpSysSolverBlockCG() {}
+
+    //! Return the subset on which the operator acts
+    const Subset& subset() const {return A->subset();}
+
+    //! Solve the linear system
+    /*!
+     * \param psi      solution ( Modify )
+     * \param chi      source ( Read )
+     * \return syssolver results
+     */
+    SystemSolverResults_t operator() (T& psi, const T& chi) const
+      {
+	multi1d<T> psi_b(1);
+	multi1d<T> chi_b(1);
+	psi_b[0][A->subset()] = psi;
+	chi_b[0][A->subset()] = chi;
+
+	multi1d<SystemSolverResults_t> res = (*this)(psi_b, chi_b);
+
+	psi[A->subset()] = psi_b[0];
+	return res[0];
+      }
+
+    //! Solve the linear systems for a block of sources
+    /*!
+     * \param psi      solutions ( Modify )
+     * \param chi      sources ( Read )
+     * \return syssolver results for each source
+     */
+    multi1d<SystemSolverResults_t> operator() (multi1d<T>& psi, const multi1d<T>& chi) const
+      {
+	START_CODE();
+	StopWatch swatch;
+	swatch.reset();
+	swatch.start();
+
+	multi1d<T> chi_tmp;
+	(*A)(chi_tmp, chi, MINUS);
+	multi1d<SystemSolverResults_t> res = InvBlockCG(*A, chi_tmp, psi, invParam.RsdCG, invParam.MaxCG);
+
+	swatch.stop();
+	double time = swatch.getTimeInSeconds();
+
+	{ 
+	  multi1d<T> tmp;
+	  (*A)(tmp, psi, PLUS);
+
+	  for(int i=0; i < chi.size(); ++i)
+	  {
+	    T r;
+	    r[A->subset()] = chi[i] - tmp[i];
+	    res[i].resid = sqrt(norm2(r, A->subset()));
+
+	    QDPIO::cout << "BLOCK_CG_SOLVER: source " << i << " : " << res[i].n_count 
+			<< " iterations. Rsd = " << res[i].resid 
+			<< " Relative Rsd = " << res[i].resid/sqrt(norm2(chi[i],A->subset())) << std::endl;
+	  }
+	}
+	QDPIO::cout << "BLOCK_CG_SOLVER_TIME: "<<time<< " sec" << std::endl;
+
+	END_CODE();
+
+	return res;
+      }
+
+
+  private:
+    // Hide default constructor
+    LinOpSysSolverBlockCG() {}
+
+    Handle< LinearOperator<T> > A;
+    SysSolverBlockCGParams invParam;
+  };
+
+} // End namespace
+
+#endif 
+
@@ -0,0 +1,83 @@
+/*! \file
+ *  \brief Solve a M*psi=chi linear system by pipelined or s-step CG
+ */
+#include "state.h"
+#include "actions/ferm/invert/syssolver_linop_factory.h"
+#include "actions/ferm/invert/syssolver_linop_aggregate.h"
+
+#include "actions/ferm/invert/syssolver_linop_cacg.h"
+
+#ifndef QDP_IS_QDPJIT
+
+namespace Chroma
+{
+
+  //! Pipelined and s-step CG system solver namespace
+  namespace LinOpSysSolverCACGEnv
+  {
+    //! Anonymous namespace
+    namespace
+    {
+      //! Names to be used
+      const std::string pipe_name("PIPELINED_CG_INVERTER");
+      const std::string sstep_name("SSTEP_CG_INVERTER");
+
+      //! Local registration flag
+      bool registered = false;
+    }
+
+
+    //! Callback function
+    LinOpSystemSolver<LatticeFermion>* createPipeFerm(XMLReader& xml_in,
+						      const std::string& path,
+						      Handle< FermState< LatticeFermion, multi1d<LatticeColorMatrix>, multi1d<LatticeColorMatrix> > > state, 
+						      Handle< LinearOperator<LatticeFermion> > A)
+    {
+      return new LinOpSysSolverCACG<LatticeFermion>(A, SysSolverCACGParams(xml_in, path), false);
+    }
+
+    //! Callback function
+    LinOpSystemSolver<LatticeFermionF>* createPipeFermF(XMLReader& xml_in,
+							const std::string& path,
+							Handle< FermState< LatticeFermionF, multi1d<LatticeColorMatrixF>, multi1d<LatticeColorMatrixF> > > state, 
+							Handle< LinearOperator<LatticeFermionF> > A)
+    {
+      return new LinOpSysSolverCACG<LatticeFermionF>(A, SysSolverCACGParams(xml_in, path), false);
+    }
+
+    //! Callback function
+    LinOpSystemSolver<LatticeFermion>* createSStepFerm(XMLReader& xml_in,
+						       const std::string& path,
+						       Handle< FermState< LatticeFermion, multi1d<LatticeColorMatrix>, multi1d<LatticeColorMatrix> > > state, 
+						       Handle< LinearOperator<LatticeFermion> > A)
+    {
+      return new LinOpSysSolverCACG<LatticeFermion>(A, SysSolverCACGParams(xml_in, path), true);
+    }
+
+    //! Callback function
+    LinOpSystemSolver<LatticeFermionF>* createSStepFermF(XMLReader& xml_in,
+							 const std::string& path,
+							 Handle< FermState< LatticeFermionF, multi1d<LatticeColorMatrixF>, multi1d<LatticeColorMatrixF> > > state, 
+							 Handle< LinearOperator<LatticeFermionF> > A)
+    {
+      return new LinOpSysSolverCACG<LatticeFermionF>(A, SysSolverCACGParams(xml_in, path), true);
+    }
+
+    //! Register all the factories
+    bool registerAll() 
+    {
+      bool success = true; 
+      if (! registered)
+      {
+	success &= Chroma::TheLinOpFermSystemSolverFactory::Instance().registerObject(pipe_name, createPipeFerm);
+	success &= Chroma::TheLinOpFFermSystemSolverFactory::Instance().registerObject(pipe_name, createPipeFermF);
+	success &= Chroma::TheLinOpFermSystemSolverFactory::Instance().registerObject(sstep_name, createSStepFerm);
+	success &= Chroma::TheLinOpFFermSystemSolverFactory::Instance().registerObject(sstep_name, createSStepFermF);
+	registered = true;
+      }
+      return success;
+    }
+  }
+}
+
+#endif
@@ -0,0 +1,110 @@
+// -*- C++ -*-
+/*! \file
+ *  \brief Solve a M*psi=chi linear system by pipelined or s-step CG
+ */
+
+#ifndef __syssolver_linop_cacg_h__
+#define __syssolver_linop_cacg_h__
+#include "chroma_config.h"
+#include "handle.h"
+#include "syssolver.h"
+#include "linearop.h"
+#include "actions/ferm/invert/syssolver_linop.h"
+#include "actions/ferm/invert/syssolver_cacg_params.h"
+#include "actions/ferm/invert/invcacg.h"
+
+
+namespace Chroma
+{
+
+  //! Pipelined and s-step CG system solver namespace
+  namespace LinOpSysSolverCACGEnv
+  {
+    //! Register the syssolvers
+    bool registerAll();
+  }
+
+
+  //! Solve a M*psi=chi linear system by CG with fused reductions
+  /*! \ingroup invert
+   *
+   * CGNE like LinOpSysSolverCG, with either InvPipeCG (one global
+   * reduction per iteration) or InvSStepCG (one per SStep iterations).
+   */
+  template<typename T>
+  class LinOpSysSolverCACG : public LinOpSystemSolver<T>
+  {
+  public:
+    //! Constructor
+    /*!
+     * \param A_        Linear operator ( Read )
+     * \param invParam  inverter parameters ( Read )
+     * \param sstep_    use the s-step variant ( Read )
+     */
+    LinOpSysSolverCACG(Handle< LinearOperator<T> > A_,
+		       const SysSolverCACGParams& invParam_,
+		       bool sstep_) : 
+      A(A_), invParam(invParam_), sstep(sstep_)
+      {}
+
+    //! Destructor is automatic
+    ~LinOpSysSolverCACG() {}
+
+    //! Return the subset on which the operator acts
+    const Subset& subset() const {return A->subset();}
+
+    //! Solver the linear system
+    /*!
+     * \param psi      solution ( Modify )
+     * \param chi      source ( Read )
+     * \return syssolver results
+     */
+    SystemSolverResults_t operator() (T& psi, const T& chi) const
+      {
+	START_CODE();	
+	SystemSolverResults_t res;  // initialized by a constructor
+	StopWatch swatch;
+	swatch.reset();
+	swatch.start();
+
+	T chi_tmp;
+	(*A)(chi_tmp, chi, MINUS);
+	if (sstep)
+	  res = InvSStepCG(*A, chi_tmp, psi, invParam.RsdCG, invParam.MaxCG, invParam.SStep);
+	else
+	  res = InvPipeCG(*A, chi_tmp, psi, invParam.RsdCG, invParam.MaxCG);
+
+	swatch.stop();
+	double time = swatch.getTimeInSeconds();
+
+	{ 
+	  T r;
+	  r[A->subset()]=chi;
+	  T tmp;
+	  (*A)(tmp, psi, PLUS);
+	  r[A->subset()] -= tmp;
+	  res.resid = sqrt(norm2(r, A->subset()));
+	}
+	QDPIO::cout << (sstep ? "SSTEP" : "PIPELINED") << "_CG_SOLVER: " << res.n_count 
+		    << " iterations. Rsd = " << res.resid 
+		    << " Relative Rsd = " << res.resid/sqrt(norm2(chi,A->subset())) << std::endl;
+	QDPIO::cout << (sstep ? "SSTEP" : "PIPELINED") << "_CG_SOLVER_TIME: "<<time<< " sec" << std::endl;
+
+	END_CODE();
+
+	return res;
+      }
+
+
+  private:
+    // Hide default constructor
+    LinOpSysSolverCACG() {}
+
+    Handle< LinearOperator<T> > A;
+    SysSolverCACGParams invParam;
+    bool sstep;
+  };
+
+} // End namespace
+
+#endif 
@@ -0,0 +1,60 @@
+/*! \file
+ *  \brief Solve a M*psi=chi linear system with a shared deflation subspace
+ */
+
+#include "actions/ferm/invert/syssolver_linop_deflated.h"
+#include "actions/ferm/invert/syssolver_linop_factory.h"
+#include "actions/ferm/invert/syssolver_linop_aggregate.h"
+
+#include "actions/ferm/invert/syssolver_mdagm_factory.h"
+#include "actions/ferm/invert/syssolver_mdagm_aggregate.h"
+#include "actions/ferm/invert/syssolver_mdagm_deflated.h"
+
+namespace Chroma
+{
+
+  //! Deflated system solver namespace
+  namespace LinOpSysSolverDeflatedEnv
+  {
+    //! Anonymous namespace
+    namespace
+    {
+      //! Name to be used
+      const std::string name("DEFLATED_INVERTER");
+
+      //! Local registration flag
+      bool registered = false;
+    }
+
+
+    //! Callback function
+    LinOpSystemSolver<LatticeFermion>* createFerm(XMLReader& xml_in,
+						  const std::string& path,
+						  Handle< FermState< LatticeFermion, multi1d<LatticeColorMatrix>, multi1d<LatticeColorMatrix> > > state, 
+						  Handle< LinearOperator<LatticeFermion> > A)
+    {
+      Handle< MdagMSystemSolver<LatticeFermion> > mdagmSysSolver(
+	TheMdagMFermSystemSolverFactory::Instance().createObject(name,
+								 xml_in,
+								 path,
+								 state,
+								 A));
+
+      return new LinOpSysSolverDeflated<LatticeFermion>(A, mdagmSysSolver);
+    }
+
+    //! Register all the factories
+    bool registerAll() 
+    {
+      bool success = true; 
+      if (! registered)
+      {
+	success &= MdagMSysSolverDeflatedEnv::registerAll();
+	success &= Chroma::TheLinOpFermSystemSolverFactory::Instance().registerObject(name, createFerm);
+	registered = true;
+      }
+      return success;
+    }
+  }
+
+}
@@ -0,0 +1,70 @@
+// -*- C++ -*-
+/*! \file
+ *  \brief Solve a M*psi=chi linear system with a shared deflation subspace
+ */
+
+#ifndef __syssolver_linop_deflated_h__
+#define __syssolver_linop_deflated_h__
+
+#include "actions/ferm/invert/syssolver_linop.h"
+#include "actions/ferm/invert/syssolver_mdagm.h"
+
+namespace Chroma
+{
+
+  //! Deflated system solver namespace
+  namespace LinOpSysSolverDeflatedEnv
+  {
+    //! Register the syssolver
+    bool registerAll();
+  }
+
+
+  //! Solve a M*psi=chi linear system through the deflated MdagM solver
+  /*! \ingroup invert
+   *
+   * Solves  M^dag M psi = M^dag chi  with the DEFLATED_INVERTER of the
+   * MdagM factory, so the subspace is shared with MdagM solves that use
+   * the same space_id.
+   */
+  template<typename T>
+  class LinOpSysSolverDeflated : public LinOpSystemSolver<T>
+  {
+  public:
+    //! Constructor
+    /*!
+     * \param A_          Linear operator ( Read )
+     * \param sysSolver_  MdagM system solver ( Read )
+     */
+    LinOpSysSolverDeflated(Handle< LinearOperator<T> > A_,
+			   Handle< MdagMSystemSolver<T> > sysSolver_) 
+      : A(A_), sysSolver(sysSolver_) {}
+
+    //! Destructor is automatic
+    ~LinOpSysSolverDeflated() {}
+
+    //! Return the subset on which the operator acts
+    const Subset& subset() const {return A->subset();}
+
+    //! Solver the linear system
+    /*!
+     * \param psi      solution ( Modify )
+     * \param chi      source ( Read )
+     * \return syssolver results
+     */
+    SystemSolverResults_t operator() (T& psi, const T& chi) const
+      {
+	T chi_tmp;	
+	(*A)(chi_tmp, chi, MINUS);
+
+	return (*sysSolver)(psi, chi_tmp);
+      }
+
+  private:
+    Handle< LinearOperator<T> > A;
+    Handle< MdagMSystemSolver<T> > sysSolver;
+  };
+ 
+} // End namespace
+
+#endif 
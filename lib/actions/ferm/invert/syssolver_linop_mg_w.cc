@@ -0,0 +1,167 @@
+/*! \file
+ *  \brief Solve a M*psi=chi linear system by aggregation multigrid
+ */
+
+#include "actions/ferm/invert/syssolver_linop_factory.h"
+#include "actions/ferm/invert/syssolver_linop_aggregate.h"
+#include "actions/ferm/invert/syssolver_linop_mg_w.h"
+
+#ifndef QDP_IS_QDPJIT
+
+namespace Chroma
+{
+
+  //! Aggregation multigrid system solver namespace
+  namespace LinOpSysSolverMGEnv
+  {
+    //! Anonymous namespace
+    namespace
+    {
+      //! Name to be used
+      const std::string name("MULTIGRID");
+
+      //! Local registration flag
+      bool registered = false;
+    }
+
+
+    //! Callback function
+    LinOpSystemSolver<LatticeFermion>* createFerm(XMLReader& xml_in,
+						  const std::string& path,
+						  Handle< FermState< LatticeFermion, multi1d<LatticeColorMatrix>, multi1d<LatticeColorMatrix> > > state, 
+						  Handle< LinearOperator<LatticeFermion> > A)
+    {
+      return new LinOpSysSolverMG(A, SysSolverMGParams(xml_in, path));
+    }
+
+    //! Register all the factories
+    bool registerAll() 
+    {
+      bool success = true; 
+      if (! registered)
+      {
+	success &= Chroma::TheLinOpFermSystemSolverFactory::Instance().registerObject(name, createFerm);
+	registered = true;
+      }
+      return success;
+    }
+  }
+
+
+  // Setup of the null vectors and the coarse operator
+  LinOpSysSolverMG::LinOpSysSolverMG(Handle< LinearOperator<T> > A_,
+				     const SysSolverMGParams& invParam_) :
+    A(A_), invParam(invParam_)
+  {
+    START_CODE();
+
+    if (A->subset().numSiteTable() != Layout::sitesOnNode())
+    {
+      QDPIO::cerr << "MULTIGRID: only unpreconditioned operators are supported" << std::endl;
+      QDP_abort(1);
+    }
+
+    StopWatch swatch;
+    swatch.start();
+
+    // Relax random vectors towards the low modes of A
+    multi1d<T> v(invParam.NullVecs);
+    T z = zero;
+    for(int k=0; k < v.size(); ++k)
+    {
+      gaussian(v[k]);
+      Double r = smooth(v[k], z, invParam.NullVecSetupIter);
+      v[k] *= Real(1) / sqrt(norm2(v[k]));
+
+      QDPIO::cout << "MULTIGRID: null vector " << k << " |A v| = " << r << std::endl;
+    }
+
+    agg = new MGAggregation(invParam.Blocking, invParam.NullVecs);
+    agg->setNullVectors(v);
+    Dc = new MGCoarseOperator(*A, agg);
+
+    swatch.stop();
+    QDPIO::cout << "MULTIGRID_SETUP_TIME: " << swatch.getTimeInSeconds() << " sec" << std::endl;
+
+    END_CODE();
+  }
+
+
+  // MR iterations on A psi = chi
+  Double LinOpSysSolverMG::smooth(T& psi, const T& chi, int n_iter) const
+  {
+    T r, Ar;
+    (*A)(Ar, psi, PLUS);
+    r = chi - Ar;
+
+    for(int i=0; i < n_iter; ++i)
+    {
+      (*A)(Ar, r, PLUS);
+      Double Ar_sq = norm2(Ar);
+      if (toBool(Ar_sq == 0))
+	break;
+
+      Complex a = innerProduct(Ar, r) / Ar_sq;
+      psi += a * r;
+      r -= a * Ar;
+    }
+
+    return sqrt(norm2(r));
+  }
+
+
+  // Apply NCycles multigrid cycles, ignoring the initial guess
+  SystemSolverResults_t LinOpSysSolverMG::operator() (T& psi, const T& chi) const
+  {
+    START_CODE();
+
+    SystemSolverResults_t res;
+    StopWatch swatch;
+    swatch.start();
+
+    psi = zero;
+    T r = chi;
+    T e, tmp;
+    MGCoarseVector rc, ec;
+    int coarse_iter = 0;
+
+    for(int cycle=0; cycle < invParam.NCycles; ++cycle)
+    {
+      e = zero;
+      smooth(e, r, invParam.PreSmooth);
+
+      // Coarse grid correction
+      (*A)(tmp, e, PLUS);
+      tmp = r - tmp;
+      agg->restrictVec(rc, tmp);
+      ec.assign(rc.size(), MGComplex(0, 0));
+      coarse_iter += MGCoarseGMRES(*Dc, ec, rc, 
+				   toDouble(invParam.CoarseRsdTarget), 
+				   invParam.CoarseMaxIter, 
+				   invParam.CoarseNKrylov);
+      agg->prolongVec(tmp, ec);
+      e += tmp;
+
+      smooth(e, r, invParam.PostSmooth);
+
+      psi += e;
+      (*A)(tmp, e, PLUS);
+      r -= tmp;
+    }
+
+    swatch.stop();
+
+    res.n_count = invParam.NCycles;
+    res.resid = sqrt(norm2(r));
+
+    QDPIO::cout << "MULTIGRID: " << invParam.NCycles << " cycles, " << coarse_iter 
+		<< " coarse iterations. Relative Rsd = " << res.resid / sqrt(norm2(chi))
+		<< " Time = " << swatch.getTimeInSeconds() << " sec" << std::endl;
+
+    END_CODE();
+    return res;
+  }
+
+}
+
+#endif
@@ -0,0 +1,87 @@
+// -*- C++ -*-
+/*! \file
+ *  \brief Solve a M*psi=chi linear system by aggregation multigrid
+ */
+
+#ifndef __syssolver_linop_mg_w_h__
+#define __syssolver_linop_mg_w_h__
+
+#include "handle.h"
+#include "state.h"
+#include "syssolver.h"
+#include "linearop.h"
+#include "actions/ferm/invert/syssolver_linop.h"
+#include "actions/ferm/invert/syssolver_mg_params.h"
+#include "actions/ferm/invert/mg_aggregation_w.h"
+
+namespace Chroma
+{
+
+  //! Aggregation multigrid system solver namespace
+  namespace LinOpSysSolverMGEnv
+  {
+    //! Register the syssolver
+    bool registerAll();
+  }
+
+
+  //! Two level aggregation multigrid for Wilson-type operators
+  /*! \ingroup invert
+   *
+   * The setup relaxes NullVecs random vectors with MR on A v = 0, splits
+   * them chirally and orthonormalises them on blocks of size Blocking.
+   * The coarse operator is the Galerkin product P^dag A P.
+   *
+   * Every application runs NCycles cycles of MR pre-smoothing, a coarse
+   * correction by restarted GMRES to CoarseRsdTarget and MR
+   * post-smoothing. The initial guess is ignored, so the solver can be
+   * used as the variable preconditioner (PrecondParams) of
+   * FGMRESDR_INVERTER, which gives a K-cycle.
+   *
+   * Only unpreconditioned operators are supported.
+   */
+  class LinOpSysSolverMG : public LinOpSystemSolver<LatticeFermion>
+  {
+  public:
+    typedef LatticeFermion T;
+
+    //! Constructor
+    /*!
+     * \param A_        Linear operator ( Read )
+     * \param invParam  inverter parameters ( Read )
+     */
+    LinOpSysSolverMG(Handle< LinearOperator<T> > A_,
+		     const SysSolverMGParams& invParam_);
+
+    //! Destructor is automatic
+    ~LinOpSysSolverMG() {}
+
+    //! Return the subset on which the operator acts
+    const Subset& subset() const {return A->subset();}
+
+    //! Solver the linear system
+    /*!
+     * \param psi      solution ( Write )
+     * \param chi      source ( Read )
+     * \return syssolver results
+     */
+    SystemSolverResults_t operator() (T& psi, const T& chi) const;
+
+  private:
+    // Hide default constructor
+    LinOpSysSolverMG() {}
+
+    //! MR iterations on A psi = chi, returns the residual norm
+    Double smooth(T& psi, const T& chi, int n_iter) const;
+
+    Handle< LinearOperator<T> > A;
+    SysSolverMGParams invParam;
+
+    // Created and initialized here.
+    Handle< MGAggregation > agg;
+    Handle< MGCoarseOperator > Dc;
+  };
+
+} // End namespace
+
+#endif 
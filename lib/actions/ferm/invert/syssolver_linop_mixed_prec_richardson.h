@@ -0,0 +1,181 @@
+// -*- C++ -*-
+/*! \file
+ *  \brief Solve a M*psi=chi linear system by mixed precision Richardson iteration
+ */
+
+#ifndef __syssolver_linop_mixed_prec_richardson_h__
+#define __syssolver_linop_mixed_prec_richardson_h__
+
+#include "handle.h"
+#include "state.h"
+#include "syssolver.h"
+#include "linearop.h"
+#include "actions/ferm/fermstates/periodic_fermstate.h"
+#include "actions/ferm/invert/inv_multiprec_richardson.h"
+#include "actions/ferm/invert/syssolver_linop_factory.h"
+#include "actions/ferm/invert/syssolver_mixed_prec_richardson_params.h"
+#include "actions/ferm/linop/lopconv.h"
+#include "actions/ferm/linop/eoprec_linop_f_factory_w.h"
+
+#include <string>
+
+namespace Chroma
+{
+
+  //! Generic mixed precision Richardson system solver namespace
+  namespace LinOpSysSolverMixedPrecRichardsonEnv
+  {
+    //! Register the syssolver
+    bool registerAll();
+  }
+
+
+  //! Solve a system using mixed precision Richardson iteration.
+  /*! \ingroup invert
+   *
+   * Defect correction around any single precision solver registered in
+   * TheLinOpFFermSystemSolverFactory. The outer residual and solution are
+   * accumulated in double precision.
+   *
+   * With FermionAction in the params, the inner solver gets a single
+   * precision operator built from the single precision links by
+   * TheEvenOddPrecLinOpFFactory. The action must be the one of A.
+   * Without it, the inner solver iterates on single precision vectors
+   * but sees A itself through a precision converting wrapper, so each
+   * inner matvec still costs a double precision operator.
+   */
+  class LinOpSysSolverMixedPrecRichardson : public LinOpSystemSolver<LatticeFermion>
+  {
+  public:
+    typedef LatticeFermion T;
+    typedef multi1d<LatticeColorMatrix> Q;
+ 
+    typedef LatticeFermionF TF;
+    typedef multi1d<LatticeColorMatrixF> QF;
+
+    typedef LatticeFermionD TD;
+
+    //! Constructor
+    /*!
+     * \param A_        Linear operator ( Read )
+     * \param state_    Fermion state ( Read )
+     * \param invParam  inverter parameters ( Read )
+     */
+    LinOpSysSolverMixedPrecRichardson(Handle< LinearOperator<T> > A_,
+				      Handle< FermState<T,Q,Q> > state_,
+				      const SysSolverMixedPrecRichardsonParams& invParam_) : 
+      A(A_), invParam(invParam_) 
+    {
+      // Single precision copy of the (possibly smeared) links for the
+      // inner solver. Boundary conditions are already in the operator.
+      QF links_single(Nd);
+      const Q& links = state_->getLinks();
+      for(int mu=0; mu < Nd; mu++)
+	links_single[mu] = links[mu];
+
+      fstate_single = new PeriodicFermState<TF,QF,QF>(links_single);
+
+      if (invParam.fermActParams.xml != "")
+      {
+	std::istringstream is_f( invParam.fermActParams.xml );
+	XMLReader fermacttop(is_f);
+
+	M_single = TheEvenOddPrecLinOpFFactory::Instance().createObject(invParam.fermActParams.id,
+									 fermacttop,
+									 invParam.fermActParams.path,
+									 fstate_single);
+
+	if (M_single->subset().numSiteTable() != A->subset().numSiteTable())
+	{
+	  QDPIO::cerr << "MIXED_PRECISION_RICHARDSON: FermionAction " << invParam.fermActParams.id
+		      << " does not act on the subset of the operator" << std::endl;
+	  QDP_abort(1);
+	}
+      }
+      else
+      {
+	M_single = new lopconv<TF,T>(A);
+      }
+      M_double = new lopconv<TD,T>(A);
+
+      std::istringstream is( invParam.innerSolverParams.xml );
+      XMLReader paramtop(is);
+
+      DInv = TheLinOpFFermSystemSolverFactory::Instance().createObject(invParam.innerSolverParams.id, 
+								       paramtop, 
+								       invParam.innerSolverParams.path,
+								       fstate_single, 
+								       M_single);
+    }
+
+    //! Destructor is automatic
+    ~LinOpSysSolverMixedPrecRichardson() {}
+
+    //! Return the subset on which the operator acts
+    const Subset& subset() const {return A->subset();}
+
+    //! Solver the linear system
+    /*!
+     * \param psi      solution ( Modify )
+     * \param chi      source ( Read )
+     * \return syssolver results
+     */
+    SystemSolverResults_t operator() (T& psi, const T& chi) const
+    {
+      SystemSolverResults_t res;
+
+      START_CODE();
+      StopWatch swatch;
+      swatch.start();
+
+      TD psi_d = psi;
+      TD chi_d = chi;
+
+      InvMultiPrecRichardson(*DInv, 
+			     *M_double,
+			     chi_d,
+			     psi_d,
+			     invParam.MaxIter,
+			     invParam.RsdTarget,
+			     res);
+      
+      psi[A->subset()] = psi_d;
+
+      swatch.stop();
+      double time = swatch.getTimeInSeconds();
+
+      { 
+	T r;
+	r[A->subset()] = chi;
+	T tmp;
+	(*A)(tmp, psi, PLUS);
+	r[A->subset()] -= tmp;
+	res.resid = sqrt(norm2(r, A->subset()));
+      }
+      QDPIO::cout << "MIXED_PRECISION_RICHARDSON_SOLVER: " << res.n_count << " iterations. Rsd = " << res.resid 
+		  << " Relative Rsd = " << res.resid/sqrt(norm2(chi,A->subset())) << std::endl;
+      QDPIO::cout << "MIXED_PRECISION_RICHARDSON_SOLVER_TIME: " << time << " sec" << std::endl;
+      
+      END_CODE();
+      return res;
+    }
+
+
+  private:
+    // Hide default constructor
+    LinOpSysSolverMixedPrecRichardson() {}
+
+    Handle< LinearOperator<T> > A;
+    const SysSolverMixedPrecRichardsonParams invParam;
+
+    // Created and initialized here.
+    Handle< FermState<TF, QF, QF> > fstate_single;
+    Handle< LinearOperator<TF> > M_single;
+    Handle< LinearOperator<TD> > M_double;
+    Handle< LinOpSystemSolver<TF> > DInv;
+  };
+
+
+} // End namespace
+
+#endif 
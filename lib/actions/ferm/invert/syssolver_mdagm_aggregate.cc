@@ -6,11 +6,13 @@
 
 
 #include "actions/ferm/invert/syssolver_mdagm_cg.h"
+#include "actions/ferm/invert/syssolver_mdagm_cacg.h"
 #include "actions/ferm/invert/syssolver_mdagm_bicgstab.h"
 #include "actions/ferm/invert/syssolver_mdagm_ibicgstab.h"
 #include "actions/ferm/invert/syssolver_mdagm_cg_timing.h"
 #include "actions/ferm/invert/syssolver_mdagm_cg_array.h"
 #include "actions/ferm/invert/syssolver_mdagm_eigcg.h"
+#include "actions/ferm/invert/syssolver_mdagm_deflated.h"
 #include "actions/ferm/invert/syssolver_mdagm_richardson_multiprec_clover.h"
 #include "actions/ferm/invert/syssolver_mdagm_rel_bicgstab_clover.h"
 #include "actions/ferm/invert/syssolver_mdagm_rel_ibicgstab_clover.h"
@@ -48,10 +50,14 @@ namespace Chroma
       {
 	// Sources
 	success &= MdagMSysSolverCGEnv::registerAll();
+#ifndef QDP_IS_QDPJIT
+	success &= MdagMSysSolverCACGEnv::registerAll();
+#endif
 	success &= MdagMSysSolverCGTimingsEnv::registerAll();
 	success &= MdagMSysSolverBiCGStabEnv::registerAll();
 	success &= MdagMSysSolverIBiCGStabEnv::registerAll();
 	success &= MdagMSysSolverEigCGEnv::registerAll();
+	success &= MdagMSysSolverDeflatedEnv::registerAll();
 	success &= MdagMSysSolverRichardsonCloverEnv::registerAll();
 	success &= MdagMSysSolverReliableBiCGStabCloverEnv::registerAll();
 	success &= MdagMSysSolverReliableIBiCGStabCloverEnv::registerAll();
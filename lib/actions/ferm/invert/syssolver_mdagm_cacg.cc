@@ -0,0 +1,103 @@
+/*! \file
+ *  \brief Solve a MdagM*psi=chi linear system by pipelined or s-step CG
+ */
+
+#include "actions/ferm/invert/syssolver_mdagm_factory.h"
+#include "actions/ferm/invert/syssolver_mdagm_aggregate.h"
+
+#include "actions/ferm/invert/syssolver_mdagm_cacg.h"
+
+#ifndef QDP_IS_QDPJIT
+
+namespace Chroma
+{
+
+  //! Pipelined and s-step CG system solver namespace
+  namespace MdagMSysSolverCACGEnv
+  {
+    //! Anonymous namespace
+    namespace
+    {
+      //! Names to be used
+      const std::string pipe_name("PIPELINED_CG_INVERTER");
+      const std::string sstep_name("SSTEP_CG_INVERTER");
+
+      //! Local registration flag
+      bool registered = false;
+    }
+
+
+    //! Callback function
+    MdagMSystemSolver<LatticeFermion>* createPipeFerm(XMLReader& xml_in,
+						      const std::string& path,
+						      Handle< FermState< LatticeFermion, multi1d<LatticeColorMatrix>, multi1d<LatticeColorMatrix> > > state, 
+						      Handle< LinearOperator<LatticeFermion> > A)
+    {
+      return new MdagMSysSolverCACG<LatticeFermion>(A, SysSolverCACGParams(xml_in, path), false);
+    }
+
+    //! Callback function
+    MdagMSystemSolver<LatticeFermionF>* createPipeFermF(XMLReader& xml_in,
+							const std::string& path,
+							Handle< FermState< LatticeFermionF, multi1d<LatticeColorMatrixF>, multi1d<LatticeColorMatrixF> > > state, 
+							Handle< LinearOperator<LatticeFermionF> > A)
+    {
+      return new MdagMSysSolverCACG<LatticeFermionF>(A, SysSolverCACGParams(xml_in, path), false);
+    }
+
+    //! Callback function
+    MdagMSystemSolver<LatticeFermionD>* createPipeFermD(XMLReader& xml_in,
+							const std::string& path,
+							Handle< FermState< LatticeFermionD, multi1d<LatticeColorMatrixD>, multi1d<LatticeColorMatrixD> > > state, 
+							Handle< LinearOperator<LatticeFermionD> > A)
+    {
+      return new MdagMSysSolverCACG<LatticeFermionD>(A, SysSolverCACGParams(xml_in, path), false);
+    }
+
+    //! Callback function
+    MdagMSystemSolver<LatticeFermion>* createSStepFerm(XMLReader& xml_in,
+						       const std::string& path,
+						       Handle< FermState< LatticeFermion, multi1d<LatticeColorMatrix>, multi1d<LatticeColorMatrix> > > state, 
+						       Handle< LinearOperator<LatticeFermion> > A)
+    {
+      return new MdagMSysSolverCACG<LatticeFermion>(A, SysSolverCACGParams(xml_in, path), true);
+    }
+
+    //! Callback function
+    MdagMSystemSolver<LatticeFermionF>* createSStepFermF(XMLReader& xml_in,
+							 const std::string& path,
+							 Handle< FermState< LatticeFermionF, multi1d<LatticeColorMatrixF>, multi1d<LatticeColorMatrixF> > > state, 
+							 Handle< LinearOperator<LatticeFermionF> > A)
+    {
+      return new MdagMSysSolverCACG<LatticeFermionF>(A, SysSolverCACGParams(xml_in, path), true);
+    }
+
+    //! Callback function
+    MdagMSystemSolver<LatticeFermionD>* createSStepFermD(XMLReader& xml_in,
+							 const std::string& path,
+							 Handle< FermState< LatticeFermionD, multi1d<LatticeColorMatrixD>, multi1d<LatticeColorMatrixD> > > state, 
+							 Handle< LinearOperator<LatticeFermionD> > A)
+    {
+      return new MdagMSysSolverCACG<LatticeFermionD>(A, SysSolverCACGParams(xml_in, path), true);
+    }
+
+    //! Register all the factories
+    bool registerAll() 
+    {
+      bool success = true; 
+      if (! registered)
+      {
+	success &= Chroma::TheMdagMFermSystemSolverFactory::Instance().registerObject(pipe_name, createPipeFerm);
+	success &= Chroma::TheMdagMFermFSystemSolverFactory::Instance().registerObject(pipe_name, createPipeFermF);
+	success &= Chroma::TheMdagMFermDSystemSolverFactory::Instance().registerObject(pipe_name, createPipeFermD);
+	success &= Chroma::TheMdagMFermSystemSolverFactory::Instance().registerObject(sstep_name, createSStepFerm);
+	success &= Chroma::TheMdagMFermFSystemSolverFactory::Instance().registerObject(sstep_name, createSStepFermF);
+	success &= Chroma::TheMdagMFermDSystemSolverFactory::Instance().registerObject(sstep_name, createSStepFermD);
+	registered = true;
+      }
+      return success;
+    }
+  }
+}
+
+#endif
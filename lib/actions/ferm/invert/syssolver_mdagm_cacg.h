@@ -0,0 +1,137 @@
+// -*- C++ -*-
+/*! \file
+ *  \brief Solve a MdagM*psi=chi linear system by pipelined or s-step CG
+ */
+
+#ifndef __syssolver_mdagm_cacg_h__
+#define __syssolver_mdagm_cacg_h__
+#include "chroma_config.h"
+
+#include "handle.h"
+#include "syssolver.h"
+#include "linearop.h"
+#include "lmdagm.h"
+#include "actions/ferm/invert/syssolver_mdagm.h"
+#include "actions/ferm/invert/syssolver_cacg_params.h"
+#include "actions/ferm/invert/invcacg.h"
+
+
+namespace Chroma
+{
+
+  //! Pipelined and s-step CG system solver namespace
+  namespace MdagMSysSolverCACGEnv
+  {
+    //! Register the syssolvers
+    bool registerAll();
+  }
+
+
+  //! Solve a MdagM system by CG with fused reductions
+  /*! \ingroup invert
+   *
+   * Like MdagMSysSolverCG, with either InvPipeCG (one global reduction
+   * per iteration) or InvSStepCG (one per SStep iterations).
+   */
+  template<typename T>
+  class MdagMSysSolverCACG : public MdagMSystemSolver<T>
+  {
+  public:
+    //! Constructor
+    /*!
+     * \param A_        Linear operator ( Read )
+     * \param invParam  inverter parameters ( Read )
+     * \param sstep_    use the s-step variant ( Read )
+     */
+    MdagMSysSolverCACG(Handle< LinearOperator<T> > A_,
+		       const SysSolverCACGParams& invParam_,
+		       bool sstep_) : 
+      A(A_), invParam(invParam_), sstep(sstep_)
+      {}
+
+    //! Destructor is automatic
+    ~MdagMSysSolverCACG() {}
+
+    //! Return the subset on which the operator acts
+    const Subset& subset() const {return A->subset();}
+
+    //! Solver the linear system
+    /*!
+     * \param psi      solution ( Modify )
+     * \param chi      source ( Read )
+     * \return syssolver results
+     */
+    SystemSolverResults_t operator() (T& psi, const T& chi) const
+      {
+	START_CODE();
+	StopWatch swatch;
+	swatch.reset(); swatch.start();
+
+	SystemSolverResults_t res;  // initialized by a constructor
+	if (sstep)
+	  res = InvSStepCG(*A, chi, psi, invParam.RsdCG, invParam.MaxCG, invParam.SStep);
+	else
+	  res = InvPipeCG(*A, chi, psi, invParam.RsdCG, invParam.MaxCG);
+
+	{ // Find true residuum
+	  T tmp=zero;
+	  T r=zero;
+	  (*A)(tmp,psi, PLUS);
+	  (*A)(r,tmp, MINUS);
+	  r[A->subset()] -= chi;
+	  res.resid = sqrt(norm2(r,A->subset()));
+	}
+	
+	swatch.stop();
+	QDPIO::cout << (sstep ? "SSTEP" : "PIPELINED") << "_CG_SOLVER: " << res.n_count 
+		    << " iterations. Rsd = " << res.resid 
+		    << " Relative Rsd = " << res.resid/sqrt(norm2(chi,A->subset())) << std::endl;
+	
+	double time = swatch.getTimeInSeconds();
+	QDPIO::cout << (sstep ? "SSTEP" : "PIPELINED") << "_CG_SOLVER_TIME: "<<time<< " sec" << std::endl;
+
+	END_CODE();
+
+	return res;
+      }
+
+
+    //! Solve the linear system starting with a chrono guess 
+    /*! 
+     * \param psi solution (Write)
+     * \param chi source   (Read)
+     * \param predictor   a chronological predictor (Read)
+     * \return syssolver results
+     */
+    SystemSolverResults_t operator()(T& psi, const T& chi, 
+				     AbsChronologicalPredictor4D<T>& predictor) const 
+    {
+      START_CODE();
+
+      // The CG solves with A^dag A, so predict with it
+      {
+	Handle< LinearOperator<T> > MdagM( new MdagMLinOp<T>(A) );
+	predictor(psi, (*MdagM), chi);
+      }
+      // Do solve
+      SystemSolverResults_t res=(*this)(psi,chi);
+
+      // Store result
+      predictor.newVector(psi);
+      END_CODE();
+      return res;
+    }
+
+  private:
+    // Hide default constructor
+    MdagMSysSolverCACG() {}
+
+    Handle< LinearOperator<T> > A;
+    SysSolverCACGParams invParam;
+    bool sstep;
+  };
+
+
+} // End namespace
+
+#endif 
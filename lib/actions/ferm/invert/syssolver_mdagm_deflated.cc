@@ -0,0 +1,127 @@
+/*! \file
+ *  \brief Solve a MdagM*psi=chi linear system with a shared deflation subspace
+ */
+
+#include "actions/ferm/invert/syssolver_mdagm_factory.h"
+#include "actions/ferm/invert/syssolver_mdagm_aggregate.h"
+
+#include "actions/ferm/invert/syssolver_mdagm_deflated.h"
+
+namespace Chroma
+{
+
+  //! Deflated MdagM system solver namespace
+  namespace MdagMSysSolverDeflatedEnv
+  {
+    //! Anonymous namespace
+    namespace
+    {
+      //! Name to be used
+      const std::string name("DEFLATED_INVERTER");
+
+      //! Local registration flag
+      bool registered = false;
+    }
+
+
+    //! Callback function
+    MdagMSystemSolver<LatticeFermion>* createFerm(XMLReader& xml_in,
+						  const std::string& path,
+						  Handle< FermState< LatticeFermion, multi1d<LatticeColorMatrix>, multi1d<LatticeColorMatrix> > > state, 
+
+						  Handle< LinearOperator<LatticeFermion> > A)
+    {
+      return new MdagMSysSolverDeflated(A, state, SysSolverDeflatedParams(xml_in, path));
+    }
+
+    //! Register all the factories
+    bool registerAll() 
+    {
+      bool success = true; 
+      if (! registered)
+      {
+	success &= Chroma::TheMdagMFermSystemSolverFactory::Instance().registerObject(name, createFerm);
+	registered = true;
+      }
+      return success;
+    }
+  }
+
+
+  //! Constructor
+  MdagMSysSolverDeflated::MdagMSysSolverDeflated(Handle< LinearOperator<T> > A_,
+						 Handle< FermState<T,Q,Q> > state_,
+						 const SysSolverDeflatedParams& invParam_) :
+    A(A_), MdagM(new MdagMLinOp<T>(A_)), invParam(invParam_), refined(false)
+  {
+    std::istringstream is(invParam.subInvParam.xml);
+    XMLReader paramtop(is);
+
+    subSolver = TheMdagMFermSystemSolverFactory::Instance().createObject(invParam.subInvParam.id,
+									 paramtop,
+									 invParam.subInvParam.path,
+									 state_,
+									 A);
+
+    space = DeflationSpaceEnv::getSpace(invParam.space);
+  }
+
+
+  //! Write the subspace if it changed
+  MdagMSysSolverDeflated::~MdagMSysSolverDeflated()
+  {
+    if (refined)
+      space->report(invParam.space.space_id);
+
+    if (invParam.space.file.write && space->dirty())
+      space->writeDisk(invParam.space.file.file_name);
+  }
+
+
+  //! Solver the linear system
+  SystemSolverResults_t MdagMSysSolverDeflated::operator() (T& psi, const T& chi) const
+  {
+    START_CODE();
+    StopWatch swatch;
+    swatch.reset(); swatch.start();
+
+    const Subset& s = A->subset();
+
+    // The space may come from another operator, update the Ritz values
+    if (! refined)
+    {
+      space->refine(*MdagM);
+      refined = true;
+    }
+
+    int n_guess;
+    space->guess(*MdagM, psi, chi, n_guess);
+
+    Real guess_rsd;
+    {
+      T r;
+      (*MdagM)(r, psi, PLUS);
+      r[s] -= chi;
+      guess_rsd = sqrt(norm2(r, s) / norm2(chi, s));
+    }
+
+    SystemSolverResults_t res = (*subSolver)(psi, chi);
+
+    space->record(res.n_count, guess_rsd);
+    space->addVector(psi, s);
+    if (space->pending() >= invParam.space.RefineEvery)
+      space->refine(*MdagM);
+
+    res.n_count += n_guess + 1;
+
+    swatch.stop();
+    QDPIO::cout << "DEFLATED_SOLVER: " << res.n_count 
+		<< " iterations. Deflated vectors = " << space->size()
+		<< " guess relative rsd = " << guess_rsd << std::endl;
+    QDPIO::cout << "DEFLATED_SOLVER_TIME: " << swatch.getTimeInSeconds() << " sec" << std::endl;
+
+    END_CODE();
+    return res;
+  }
+
+}
@@ -0,0 +1,109 @@
+// -*- C++ -*-
+/*! \file
+ *  \brief Solve a MdagM*psi=chi linear system with a shared deflation subspace
+ */
+
+#ifndef __syssolver_mdagm_deflated_h__
+#define __syssolver_mdagm_deflated_h__
+
+#include "handle.h"
+#include "state.h"
+#include "syssolver.h"
+#include "linearop.h"
+#include "lmdagm.h"
+#include "actions/ferm/invert/syssolver_mdagm.h"
+#include "actions/ferm/invert/syssolver_deflated_params.h"
+#include "actions/ferm/invert/deflation_space.h"
+
+namespace Chroma
+{
+
+  //! Deflated MdagM system solver namespace
+  namespace MdagMSysSolverDeflatedEnv
+  {
+    //! Register the syssolver
+    bool registerAll();
+  }
+
+
+  //! Solve a MdagM system with any solver, started from a deflated guess
+  /*! \ingroup invert
+   *
+   * The subspace is a named object, so it is shared by every solver with
+   * the same space_id: all solves of a measurement, the following
+   * measurements and the trajectories of an HMC run. Each solution is fed
+   * back into the subspace. The first solve with a new operator refines
+   * the subspace with that operator.
+   *
+   * If requested, the subspace is read from a MapObjectDisk file when it
+   * is created and written back when a solver that changed it is
+   * destroyed.
+   */
+  class MdagMSysSolverDeflated : public MdagMSystemSolver<LatticeFermion>
+  {
+  public:
+    typedef LatticeFermion T;
+    typedef multi1d<LatticeColorMatrix> Q;
+
+    //! Constructor
+    /*!
+     * \param A_        Linear operator ( Read )
+     * \param state_    Fermion state ( Read )
+     * \param invParam  inverter parameters ( Read )
+     */
+    MdagMSysSolverDeflated(Handle< LinearOperator<T> > A_,
+			   Handle< FermState<T,Q,Q> > state_,
+			   const SysSolverDeflatedParams& invParam_);
+
+    //! Write the subspace if it changed
+    ~MdagMSysSolverDeflated();
+
+    //! Return the subset on which the operator acts
+    const Subset& subset() const {return A->subset();}
+
+    //! Solver the linear system
+    /*!
+     * \param psi      solution ( Modify )
+     * \param chi      source ( Read )
+     * \return syssolver results
+     */
+    SystemSolverResults_t operator() (T& psi, const T& chi) const;
+
+    //! Solve the linear system starting with a chrono guess 
+    /*! 
+     * \param psi solution (Write)
+     * \param chi source   (Read)
+     * \param predictor   a chronological predictor (Read)
+     * \return syssolver results
+     */
+    SystemSolverResults_t operator()(T& psi, const T& chi, 
+				     AbsChronologicalPredictor4D<T>& predictor) const 
+    {
+      START_CODE();
+
+      predictor(psi, (*MdagM), chi);
+      SystemSolverResults_t res = (*this)(psi, chi);
+      predictor.newVector(psi);
+
+      END_CODE();
+      return res;
+    }
+
+  private:
+    // Hide default constructor
+    MdagMSysSolverDeflated() {}
+
+    Handle< LinearOperator<T> > A;
+    Handle< LinearOperator<T> > MdagM;
+    SysSolverDeflatedParams invParam;
+
+    Handle< MdagMSystemSolver<T> > subSolver;
+    Handle< DeflationSpace > space;
+
+    //! The subspace has been refined with this operator
+    mutable bool refined;
+  };
+
+} // End namespace
+
+#endif 
@@ -123,13 +123,27 @@ namespace Chroma
       // Two Step CG:
       // Step 1:  M^\dagger Y = chi;
 
-      res=InvCGReliable(*M_double,
-			*M_single,
-			chi_d,
-			psi_d,
-			invParam.RsdTarget,
-			invParam.Delta,
-			invParam.MaxIter);
+#ifndef QDP_IS_QDPJIT
+      if( invParam.HalfPrecStorage ) { 
+	res=InvCGReliableHalf(*M_double,
+			      *M_single,
+			      chi_d,
+			      psi_d,
+			      invParam.RsdTarget,
+			      invParam.Delta,
+			      invParam.MaxIter);
+      }
+      else
+#endif
+      {
+	res=InvCGReliable(*M_double,
+			  *M_single,
+			  chi_d,
+			  psi_d,
+			  invParam.RsdTarget,
+			  invParam.Delta,
+			  invParam.MaxIter);
+      }
       psi = psi_d;
       
       { 
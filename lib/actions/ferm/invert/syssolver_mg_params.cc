@@ -0,0 +1,82 @@
+/*! \file
+ *  \brief Params of the aggregation multigrid solver
+ */
+
+#include "actions/ferm/invert/syssolver_mg_params.h"
+#include "chromabase.h"
+
+using namespace QDP;
+
+namespace Chroma 
+{
+
+  SysSolverMGParams::SysSolverMGParams()
+  {
+    Blocking.resize(Nd);
+    Blocking = 4;
+    NullVecs = 12;
+    NullVecSetupIter = 20;
+    PreSmooth = 0;
+    PostSmooth = 4;
+    CoarseRsdTarget = 0.05;
+    CoarseMaxIter = 200;
+    CoarseNKrylov = 20;
+    NCycles = 1;
+  }
+  
+  SysSolverMGParams::SysSolverMGParams(XMLReader& xml, const std::string& path)
+  {
+    // Defaults for the optional params
+    *this = SysSolverMGParams();
+
+    XMLReader paramtop(xml, path);
+    read(paramtop, "Blocking", Blocking);
+    read(paramtop, "NullVecs", NullVecs);
+
+    if (paramtop.count("NullVecSetupIter") > 0)
+      read(paramtop, "NullVecSetupIter", NullVecSetupIter);
+
+    if (paramtop.count("PreSmooth") > 0)
+      read(paramtop, "PreSmooth", PreSmooth);
+
+    if (paramtop.count("PostSmooth") > 0)
+      read(paramtop, "PostSmooth", PostSmooth);
+
+    if (paramtop.count("CoarseRsdTarget") > 0)
+      read(paramtop, "CoarseRsdTarget", CoarseRsdTarget);
+
+    if (paramtop.count("CoarseMaxIter") > 0)
+      read(paramtop, "CoarseMaxIter", CoarseMaxIter);
+
+    if (paramtop.count("CoarseNKrylov") > 0)
+      read(paramtop, "CoarseNKrylov", CoarseNKrylov);
+
+    if (paramtop.count("NCycles") > 0)
+      read(paramtop, "NCycles", NCycles);
+  }
+
+  void read(XMLReader& xml, const std::string& path, 
+	    SysSolverMGParams& p)
+  {
+    SysSolverMGParams tmp(xml, path);
+    p = tmp;
+  }
+
+  void write(XMLWriter& xml, const std::string& path, 
+	     const SysSolverMGParams& p)
+  {
+    push(xml, path);
+    write(xml, "invType", "MULTIGRID");
+    write(xml, "Blocking", p.Blocking);
+    write(xml, "NullVecs", p.NullVecs);
+    write(xml, "NullVecSetupIter", p.NullVecSetupIter);
+    write(xml, "PreSmooth", p.PreSmooth);
+    write(xml, "PostSmooth", p.PostSmooth);
+    write(xml, "CoarseRsdTarget", p.CoarseRsdTarget);
+    write(xml, "CoarseMaxIter", p.CoarseMaxIter);
+    write(xml, "CoarseNKrylov", p.CoarseNKrylov);
+    write(xml, "NCycles", p.NCycles);
+    pop(xml);
+  }
+
+}
@@ -0,0 +1,41 @@
+// -*- C++ -*-
+/*! \file
+ *  \brief Params of the aggregation multigrid solver
+ */
+
+#ifndef __syssolver_mg_params_h__
+#define __syssolver_mg_params_h__
+
+#include "chromabase.h"
+
+namespace Chroma 
+{
+  //! Params for the aggregation multigrid solver
+  /*! \ingroup invert */
+  struct SysSolverMGParams
+  { 
+    SysSolverMGParams(XMLReader& xml, const std::string& path);
+    SysSolverMGParams();
+
+    multi1d<int> Blocking;         /*!< Block extent in each direction */
+    int NullVecs;                  /*!< Number of null vectors, the coarse grid has 2*NullVecs dof per block */
+    int NullVecSetupIter;          /*!< MR iterations on A v = 0 for each null vector */
+    int PreSmooth;                 /*!< MR pre-smoothing iterations */
+    int PostSmooth;                /*!< MR post-smoothing iterations */
+    Real CoarseRsdTarget;          /*!< Relative residual of the coarse GMRES solve */
+    int CoarseMaxIter;             /*!< Maximum iterations of the coarse solve */
+    int CoarseNKrylov;             /*!< Restart length of the coarse GMRES */
+    int NCycles;                   /*!< Number of cycles per application */
+  };
+
+
+  //! Read the params
+  void read(XMLReader& xml, const std::string& path, SysSolverMGParams& p);
+
+  //! Write the params
+  void write(XMLWriter& xml, const std::string& path, 
+	     const SysSolverMGParams& param);
+
+}
+
+#endif
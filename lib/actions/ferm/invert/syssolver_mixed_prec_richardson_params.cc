@@ -0,0 +1,46 @@
+/*! \file
+ *  \brief Params of the generic mixed precision Richardson solver
+ */
+
+#include "actions/ferm/invert/syssolver_mixed_prec_richardson_params.h"
+#include "chromabase.h"
+#include "io/xml_group_reader.h"
+
+using namespace QDP;
+
+namespace Chroma 
+{
+  
+  SysSolverMixedPrecRichardsonParams::SysSolverMixedPrecRichardsonParams(XMLReader& xml, 
+									 const std::string& path)
+  {
+    XMLReader paramtop(xml, path);
+    read(paramtop, "MaxIter", MaxIter);
+    read(paramtop, "RsdTarget", RsdTarget);
+    innerSolverParams = readXMLGroup(paramtop, "InnerSolverParams", "invType");
+
+    if (paramtop.count("FermionAction") != 0)
+      fermActParams = readXMLGroup(paramtop, "FermionAction", "FermAct");
+  }
+
+  void read(XMLReader& xml, const std::string& path, 
+	    SysSolverMixedPrecRichardsonParams& p)
+  {
+    SysSolverMixedPrecRichardsonParams tmp(xml, path);
+    p = tmp;
+  }
+
+  void write(XMLWriter& xml, const std::string& path, 
+	     const SysSolverMixedPrecRichardsonParams& p)
+  {
+    push(xml, path);
+    write(xml, "invType", "MIXED_PRECISION_RICHARDSON");
+    write(xml, "MaxIter", p.MaxIter);
+    write(xml, "RsdTarget", p.RsdTarget);
+    xml << p.innerSolverParams.xml;
+    if (p.fermActParams.xml != "")
+      xml << p.fermActParams.xml;
+    pop(xml);
+  }
+
+}
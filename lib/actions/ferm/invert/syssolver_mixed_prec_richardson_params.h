@@ -0,0 +1,43 @@
+// -*- C++ -*-
+/*! \file
+ *  \brief Params of the generic mixed precision Richardson solver
+ */
+
+#ifndef __syssolver_mixed_prec_richardson_params_h__
+#define __syssolver_mixed_prec_richardson_params_h__
+
+#include "chromabase.h"
+#include "io/xml_group_reader.h"
+
+namespace Chroma 
+{
+  //! Params for the generic mixed precision Richardson solver
+  /*! \ingroup invert */
+  struct SysSolverMixedPrecRichardsonParams
+  { 
+    SysSolverMixedPrecRichardsonParams(XMLReader& xml, const std::string& path);
+    SysSolverMixedPrecRichardsonParams() {};
+    SysSolverMixedPrecRichardsonParams(const SysSolverMixedPrecRichardsonParams& p) {
+      MaxIter = p.MaxIter;
+      RsdTarget = p.RsdTarget;
+      innerSolverParams = p.innerSolverParams;
+      fermActParams = p.fermActParams;
+    }
+
+    int MaxIter;                   /*!< Maximum number of outer iterations */
+    Real RsdTarget;                /*!< Relative residual target of the outer (double) solve */
+    GroupXML_t innerSolverParams;  /*!< Single precision solver, any LinOp solver */
+    GroupXML_t fermActParams;      /*!< Optional action of the single precision operator */
+  };
+
+
+  //! Read the params
+  void read(XMLReader& xml, const std::string& path, SysSolverMixedPrecRichardsonParams& p);
+
+  //! Write the params
+  void write(XMLWriter& xml, const std::string& path, 
+	     const SysSolverMixedPrecRichardsonParams& param);
+
+}
+
+#endif
@@ -37,5 +37,41 @@ namespace Chroma {
   }
 
 
+  SysSolverReliableCGCloverParams::SysSolverReliableCGCloverParams(XMLReader& xml, 
+								   const std::string& path) :
+    SysSolverReliableBiCGStabCloverParams(xml, path)
+  {
+    XMLReader paramtop(xml, path);
+
+    if( paramtop.count("HalfPrecStorage") > 0 ) { 
+      read(paramtop, "HalfPrecStorage", HalfPrecStorage);
+    }
+    else { 
+      HalfPrecStorage = false;
+    }
+  }
+
+  void read(XMLReader& xml, const std::string& path, 
+	    SysSolverReliableCGCloverParams& p)
+  {
+    SysSolverReliableCGCloverParams tmp(xml, path);
+    p = tmp;
+  }
+
+  void write(XMLWriter& xml, const std::string& path, 
+	     const SysSolverReliableCGCloverParams& p) {
+    push(xml, path);
+    write(xml, "MaxIter", p.MaxIter);
+    write(xml, "RsdTarget", p.RsdTarget);
+    write(xml, "CloverParams", p.clovParams);
+    write(xml, "Delta", p.Delta);
+    if( p.HalfPrecStorage ) { 
+      write(xml, "HalfPrecStorage", p.HalfPrecStorage);
+    }
+    pop(xml);
+
+  }
+
+
 
 }
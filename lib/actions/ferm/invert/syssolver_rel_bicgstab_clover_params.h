@@ -22,13 +22,29 @@ namespace Chroma
     Real Delta;
   };
 
-  typedef SysSolverReliableBiCGStabCloverParams SysSolverReliableCGCloverParams;
   void read(XMLReader& xml, const std::string& path, SysSolverReliableBiCGStabCloverParams& p);
 
   void write(XMLWriter& xml, const std::string& path, 
 	     const SysSolverReliableBiCGStabCloverParams& param);
 
 
+  //! Params of the reliable CG, which can also keep its vectors in 16 bits
+  struct SysSolverReliableCGCloverParams : public SysSolverReliableBiCGStabCloverParams { 
+    SysSolverReliableCGCloverParams(XMLReader& xml, const std::string& path);
+    SysSolverReliableCGCloverParams() : HalfPrecStorage(false) {};
+    SysSolverReliableCGCloverParams( const SysSolverReliableCGCloverParams& p) :
+      SysSolverReliableBiCGStabCloverParams(p) {
+      HalfPrecStorage = p.HalfPrecStorage;
+    }
+    bool HalfPrecStorage;   /*!< keep the sloppy CG vectors in 16 bits */
+  };
+
+  void read(XMLReader& xml, const std::string& path, SysSolverReliableCGCloverParams& p);
+
+  void write(XMLWriter& xml, const std::string& path, 
+	     const SysSolverReliableCGCloverParams& param);
+
+
 
 }
 
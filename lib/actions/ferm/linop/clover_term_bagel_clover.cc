@@ -8,6 +8,7 @@
 #include "chromabase.h"
 #include "actions/ferm/linop/clover_term_bagel_clover.h"
 #include "meas/glue/mesfield.h"
+#include "update/molecdyn/hamiltonian/repro_sum.h"
 
 #include <bagel_clover.h>
 
@@ -567,7 +568,7 @@ namespace Chroma
 
     END_CODE();
 
-    return sum(tr_log_diag_, rb[cb]);
+    return reproSum(tr_log_diag_, rb[cb]);
   }    
 
    /*! An LDL^\dag decomposition and inversion? */
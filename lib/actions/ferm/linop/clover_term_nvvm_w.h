@@ -12,6 +12,7 @@
 #include "actions/ferm/fermacts/clover_fermact_params_w.h"
 #include "actions/ferm/linop/clover_term_base_w.h"
 #include "meas/glue/mesfield.h"
+#include "update/molecdyn/hamiltonian/repro_sum.h"
 
 
 namespace QDP
@@ -873,9 +874,8 @@ namespace Chroma
     }
     END_CODE();
 
-    // Need to thread generic sums in QDP++?
-    // Need to thread generic norm2() in QDP++?
-    return sum(ff, rb[cb]);
+    // Layout independent if the reproducible sums are on
+    return reproSum(ff, rb[cb]);
   }
 
 
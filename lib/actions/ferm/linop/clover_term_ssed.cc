@@ -8,6 +8,7 @@
 #include "chromabase.h"
 #include "actions/ferm/linop/clover_term_ssed.h"
 #include "meas/glue/mesfield.h"
+#include "update/molecdyn/hamiltonian/repro_sum.h"
 
 
 namespace Chroma 
@@ -498,7 +499,7 @@ LatticeReal ff=tr_log_diag_;
     }
     END_CODE();
 
-    return sum(ff, rb[cb]);
+    return reproSum(ff, rb[cb]);
   }    
 
 
@@ -0,0 +1,172 @@
+/*! \file
+ *  \brief Persistent face exchange for site-loop dslash operators
+ */
+
+#include "actions/ferm/linop/dslash_face_comms.h"
+
+#include <cstdlib>
+
+namespace Chroma
+{
+
+  //! Node that owns the subgrid shifted by isign in direction mu
+  int DslashFaceComms::neighbourNode(int mu, int isign)
+  {
+    const multi1d<int>& latt_size = Layout::lattSize();
+    const multi1d<int>& subgrid = Layout::subgridLattSize();
+
+    multi1d<int> coord = Layout::siteCoords(Layout::nodeNumber(), 0);
+    coord[mu] = (coord[mu] + isign*subgrid[mu] + latt_size[mu]) % latt_size[mu];
+
+    return Layout::nodeNumber(coord);
+  }
+
+
+  //! Allocate the buffers and declare the messages
+  DslashFaceComms::DslashFaceComms(const multi2d<int>& send_bytes,
+				   const multi2d<int>& recv_bytes)
+  {
+    START_CODE();
+
+    for(int cb=0; cb < 2; ++cb)
+    {
+      for(int i=0; i < 2*Nd; ++i)
+      {
+	send_buf[cb][i] = recv_buf[cb][i] = 0;
+	active[cb][i] = (send_bytes[cb][i] > 0) || (recv_bytes[cb][i] > 0);
+
+	if (! active[cb][i])
+	  continue;
+
+#ifdef ARCH_PARSCALAR
+	const int mu = i / 2;
+	const int kind = i % 2;
+
+	// Kind 0 comes from +mu and goes to -mu, kind 1 the other way round
+	const int src_node = neighbourNode(mu, (kind == 0) ? +1 : -1);
+	const int dst_node = neighbourNode(mu, (kind == 0) ? -1 : +1);
+
+	send_mem[cb][i] = QMP_allocate_aligned_memory(send_bytes[cb][i], QDP_ALIGNMENT_SIZE,
+						      (QMP_MEM_COMMS|QMP_MEM_FAST));
+	if (send_mem[cb][i] == 0x0)
+	  send_mem[cb][i] = QMP_allocate_aligned_memory(send_bytes[cb][i], QDP_ALIGNMENT_SIZE, QMP_MEM_COMMS);
+
+	recv_mem[cb][i] = QMP_allocate_aligned_memory(recv_bytes[cb][i], QDP_ALIGNMENT_SIZE,
+						      (QMP_MEM_COMMS|QMP_MEM_FAST));
+	if (recv_mem[cb][i] == 0x0)
+	  recv_mem[cb][i] = QMP_allocate_aligned_memory(recv_bytes[cb][i], QDP_ALIGNMENT_SIZE, QMP_MEM_COMMS);
+
+	if (send_mem[cb][i] == 0x0 || recv_mem[cb][i] == 0x0)
+	{
+	  QDPIO::cerr << "DslashFaceComms: unable to allocate face buffers" << std::endl;
+	  QDP_abort(1);
+	}
+
+	send_buf[cb][i] = QMP_get_memory_pointer(send_mem[cb][i]);
+	recv_buf[cb][i] = QMP_get_memory_pointer(recv_mem[cb][i]);
+
+	recv_msg[cb][i] = QMP_declare_msgmem(recv_buf[cb][i], recv_bytes[cb][i]);
+	send_msg[cb][i] = QMP_declare_msgmem(send_buf[cb][i], send_bytes[cb][i]);
+	if (recv_msg[cb][i] == (QMP_msgmem_t)NULL || send_msg[cb][i] == (QMP_msgmem_t)NULL)
+	{
+	  QDPIO::cerr << "DslashFaceComms: QMP_declare_msgmem failed" << std::endl;
+	  QDP_abort(1);
+	}
+
+	QMP_msghandle_t mh_a[2];
+	mh_a[0] = QMP_declare_receive_from(recv_msg[cb][i], src_node, 0);
+	mh_a[1] = QMP_declare_send_to(send_msg[cb][i], dst_node, 0);
+	if (mh_a[0] == (QMP_msghandle_t)NULL || mh_a[1] == (QMP_msghandle_t)NULL)
+	{
+	  QDPIO::cerr << "DslashFaceComms: declaring the face messages failed" << std::endl;
+	  QDP_abort(1);
+	}
+
+	mh[cb][i] = QMP_declare_multiple(mh_a, 2);
+	if (mh[cb][i] == (QMP_msghandle_t)NULL)
+	{
+	  QDPIO::cerr << "DslashFaceComms: QMP_declare_multiple failed" << std::endl;
+	  QDP_abort(1);
+	}
+#else
+	// Without a network there is nothing to overlap. The buffers are
+	// only provided so a caller does not need to special case this.
+	send_buf[cb][i] = std::malloc(send_bytes[cb][i]);
+	recv_buf[cb][i] = std::malloc(recv_bytes[cb][i]);
+#endif
+      }
+    }
+
+    END_CODE();
+  }
+
+
+  //! Free the messages and the buffers
+  DslashFaceComms::~DslashFaceComms()
+  {
+    for(int cb=0; cb < 2; ++cb)
+    {
+      for(int i=0; i < 2*Nd; ++i)
+      {
+	if (! active[cb][i])
+	  continue;
+
+#ifdef ARCH_PARSCALAR
+	QMP_free_msghandle(mh[cb][i]);
+	QMP_free_msgmem(send_msg[cb][i]);
+	QMP_free_msgmem(recv_msg[cb][i]);
+	QMP_free_memory(recv_mem[cb][i]);
+	QMP_free_memory(send_mem[cb][i]);
+#else
+	std::free(send_buf[cb][i]);
+	std::free(recv_buf[cb][i]);
+#endif
+      }
+    }
+  }
+
+
+  //! Start all messages of checkerboard cb
+  /*!
+   * Every node starts the directions and kinds in the same order, so
+   * two messages between the same pair of nodes are matched correctly.
+   */
+  void DslashFaceComms::start(int cb) const
+  {
+#ifdef ARCH_PARSCALAR
+    for(int i=0; i < 2*Nd; ++i)
+    {
+      if (! active[cb][i])
+	continue;
+
+      QMP_status_t err;
+      if ((err = QMP_start(mh[cb][i])) != QMP_SUCCESS)
+      {
+	QDPIO::cerr << "DslashFaceComms: " << QMP_error_string(err) << std::endl;
+	QDP_abort(1);
+      }
+    }
+#endif
+  }
+
+
+  //! Wait for all messages of checkerboard cb
+  void DslashFaceComms::wait(int cb) const
+  {
+#ifdef ARCH_PARSCALAR
+    for(int i=0; i < 2*Nd; ++i)
+    {
+      if (! active[cb][i])
+	continue;
+
+      QMP_status_t err;
+      if ((err = QMP_wait(mh[cb][i])) != QMP_SUCCESS)
+      {
+	QDPIO::cerr << "DslashFaceComms: " << QMP_error_string(err) << std::endl;
+	QDP_abort(1);
+      }
+    }
+#endif
+  }
+
+} // End namespace
@@ -0,0 +1,78 @@
+// -*- C++ -*-
+/*! \file
+ *  \brief Persistent face exchange for site-loop dslash operators
+ */
+
+#ifndef __dslash_face_comms_h__
+#define __dslash_face_comms_h__
+
+#include "chromabase.h"
+
+namespace Chroma
+{
+  //! Persistent exchange of the faces of all split directions
+  /*!
+   * \ingroup linop
+   *
+   * Holds a pair of messages for each direction mu and halo kind, for
+   * each output checkerboard. Kind 0 receives the forward halo from the
+   * node in the +mu direction and sends to the node in -mu. Kind 1
+   * receives the backward halo from -mu and sends to +mu.
+   *
+   * The messages are declared once and restarted for every apply. This
+   * lets a dslash start all faces at once, work on the interior sites
+   * and only wait before the boundary sites.
+   *
+   * Sizes are in bytes. A message of size 0 is skipped, which also
+   * skips directions that are not split.
+   */
+  class DslashFaceComms
+  {
+  public:
+    //! Allocate the buffers and declare the messages
+    /*!
+     * \param send_bytes  bytes sent per [cb](2*mu+kind)        (Read)
+     * \param recv_bytes  bytes received per [cb](2*mu+kind)    (Read)
+     */
+    DslashFaceComms(const multi2d<int>& send_bytes,
+		    const multi2d<int>& recv_bytes);
+
+    //! Free the messages and the buffers
+    ~DslashFaceComms();
+
+    //! Buffer to pack for checkerboard cb, direction mu and halo kind
+    void* sendBuffer(int cb, int mu, int kind) const {return send_buf[cb][2*mu+kind];}
+
+    //! Buffer received for checkerboard cb, direction mu and halo kind
+    const void* recvBuffer(int cb, int mu, int kind) const {return recv_buf[cb][2*mu+kind];}
+
+    //! Start all messages of checkerboard cb
+    void start(int cb) const;
+
+    //! Wait for all messages of checkerboard cb
+    void wait(int cb) const;
+
+  private:
+    //! Hide copies, the messages are owned
+    DslashFaceComms(const DslashFaceComms&);
+    DslashFaceComms& operator=(const DslashFaceComms&);
+
+    //! Node that owns the subgrid shifted by isign in direction mu
+    static int neighbourNode(int mu, int isign);
+
+    void* send_buf[2][2*Nd];
+    void* recv_buf[2][2*Nd];
+    bool  active[2][2*Nd];
+
+#ifdef ARCH_PARSCALAR
+    QMP_mem_t*      send_mem[2][2*Nd];
+    QMP_mem_t*      recv_mem[2][2*Nd];
+    QMP_msgmem_t    send_msg[2][2*Nd];
+    QMP_msgmem_t    recv_msg[2][2*Nd];
+    QMP_msghandle_t mh[2][2*Nd];
+#endif
+  };
+
+} // End namespace
+
+#endif
@@ -100,6 +100,28 @@ namespace Chroma {
 #endif
 
 
+}  // end namespace Chroma
+
+#elif defined BUILD_FUSED_WILSON_DSLASH
+// Site-fused, cache-blocked dslash on a neighbour table. Plain QDP++ site
+// loops, so it needs no external library but cannot run under QDP-JIT
+#ifdef QDP_IS_QDPJIT
+#error "The fused Wilson dslash needs a CPU build of QDP++"
+#endif
+
+# include "lwldslash_fused_w.h"
+namespace Chroma {
+
+  typedef FusedWilsonDslash WilsonDslash;
+#ifdef BUILD_HALF_PREC_LINKS
+  // Single precision operators are used in the inner solves, so they
+  // read 16-bit links
+  typedef FusedWilsonDslashHalfLinksF WilsonDslashF;
+#else
+  typedef FusedWilsonDslashF WilsonDslashF;
+#endif
+  typedef FusedWilsonDslashD WilsonDslashD;
+
 }  // end namespace Chroma
 
 #else
@@ -116,6 +138,20 @@ namespace Chroma {
 #endif
 
 
+namespace Chroma {
+
+  //! Select the overlapped face exchange of a Wilson dslash
+  /*!
+   * Only the fused dslash has an overlapped mode. For all other dslash
+   * classes the flag is ignored.
+   */
+  template<typename D>
+  inline
+  void setDslashCommsOverlap(D& dslash, bool overlap) {}
+
+}  // end namespace Chroma
+
+
 // 3D Dslashes
 // These guards make sure 3D is only ever considered in the right situations
 #include "qdp_config.h"
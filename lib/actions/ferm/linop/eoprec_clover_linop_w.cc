@@ -30,6 +30,7 @@ namespace Chroma
     invclov.choles(0);  // invert the cb=0 part
 
     D.create(fs, param.anisoParam);
+    setDslashCommsOverlap(D, param.comms_overlap);
 
     clov_deriv_time = 0;
     clov_apply_time = 0;
@@ -187,6 +188,66 @@ namespace Chroma
   }
 
 
+  //! Apply even-odd preconditioned Clover fermion linear operator onto a block
+  /*!
+   * The same as the single source operator, but the two dslashes read
+   * each link once for all sources.
+   *
+   * \param chi 	  Pseudofermion fields     	       (Write)
+   * \param psi 	  Pseudofermion fields     	       (Read)
+   * \param isign   Flag ( PLUS | MINUS )   	       (Read)
+   */
+  void EvenOddPrecCloverLinOp::operator()(multi1d<LatticeFermion>& chi, 
+					  const multi1d<LatticeFermion>& psi, 
+					  enum PlusMinus isign) const
+  {
+    START_CODE();
+
+    const int n = psi.size();
+    multi1d<LatticeFermion> tmp1, tmp2(n);
+    Real mquarter = -0.25;
+
+    //  tmp1_o  =  D_oe   A^(-1)_ee  D_eo  psi_o
+    D.applyBlock(tmp1, psi, isign, 0);
+
+    swatch.reset(); swatch.start();
+    for(int i=0; i < n; ++i)
+      invclov.apply(tmp2[i], tmp1[i], isign, 0);
+    swatch.stop();
+    clov_apply_time += swatch.getTimeInSeconds();
+
+    D.applyBlock(tmp1, tmp2, isign, 1);
+
+    //  chi_o  =  A_oo  psi_o  -  tmp1_o
+    chi.resize(n);
+    swatch.reset(); swatch.start();
+    for(int i=0; i < n; ++i)
+      clov.apply(chi[i], psi[i], isign, 1);
+    swatch.stop();
+    clov_apply_time += swatch.getTimeInSeconds();
+
+    for(int i=0; i < n; ++i)
+    {
+      chi[i][rb[1]] += mquarter*tmp1[i];
+
+      // Twisted Term?
+      if( param.twisted_m_usedP ){ 
+	// tmp2 = i mu gamma_5 psi
+	tmp2[i][rb[1]] = (GammaConst<Ns,Ns*Ns-1>() * timesI(psi[i]));
+
+	if( isign == PLUS ) {
+	  chi[i][rb[1]] += param.twisted_m * tmp2[i];
+	}
+	else {
+	  chi[i][rb[1]] -= param.twisted_m * tmp2[i];
+	}
+      }
+    }
+
+    END_CODE();
+  }
+
+
   //! Apply the even-even block onto a source std::vector
   void 
   EvenOddPrecCloverLinOp::derivEvenEvenLinOp(multi1d<LatticeColorMatrix>& ds_u, 
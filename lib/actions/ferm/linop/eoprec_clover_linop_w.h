@@ -83,6 +83,10 @@ namespace Chroma
     void operator()(LatticeFermion& chi, const LatticeFermion& psi, 
 		    enum PlusMinus isign) const;
 
+    //! Apply onto a block of sources, sharing the link loads of the dslash
+    void operator()(multi1d<LatticeFermion>& chi, const multi1d<LatticeFermion>& psi, 
+		    enum PlusMinus isign) const;
+
     //! Apply the even-even block onto a source std::vector
     void derivEvenEvenLinOp(multi1d<LatticeColorMatrix>& ds_u, 
 			    const LatticeFermion& chi, const LatticeFermion& psi, 
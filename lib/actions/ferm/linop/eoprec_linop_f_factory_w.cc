@@ -0,0 +1,61 @@
+/*! \file
+ *  \brief Factory of single precision even-odd preconditioned linops
+ */
+
+#include "actions/ferm/linop/eoprec_linop_f_factory_w.h"
+#include "actions/ferm/linop/eoprec_clover_dumb_linop_w.h"
+#include "actions/ferm/fermacts/clover_fermact_params_w.h"
+#include "actions/ferm/fermacts/wilson_fermact_params_w.h"
+
+namespace Chroma
+{
+
+  namespace EvenOddPrecLinOpFEnv
+  {
+    //! Anonymous namespace
+    namespace
+    {
+      typedef Handle< FermState< LatticeFermionF, multi1d<LatticeColorMatrixF>, multi1d<LatticeColorMatrixF> > > FSHandleF;
+
+      //! Local registration flag
+      bool registered = false;
+    }
+
+    //! Callback for CLOVER
+    LinearOperator<LatticeFermionF>* createClover(XMLReader& xml_in,
+						  const std::string& path,
+						  FSHandleF state)
+    {
+      return new EvenOddPrecDumbCloverFLinOp(state, CloverFermActParams(xml_in, path));
+    }
+
+    //! Callback for WILSON
+    /*! The clover operator with zero clover coefficients is the Wilson one */
+    LinearOperator<LatticeFermionF>* createWilson(XMLReader& xml_in,
+						  const std::string& path,
+						  FSHandleF state)
+    {
+      WilsonFermActParams wils(xml_in, path);
+
+      CloverFermActParams clov;
+      clov.Mass       = wils.Mass;
+      clov.anisoParam = wils.anisoParam;
+
+      return new EvenOddPrecDumbCloverFLinOp(state, clov);
+    }
+
+    //! Register all the factories
+    bool registerAll() 
+    {
+      bool success = true; 
+      if (! registered)
+      {
+	success &= TheEvenOddPrecLinOpFFactory::Instance().registerObject(std::string("CLOVER"), createClover);
+	success &= TheEvenOddPrecLinOpFFactory::Instance().registerObject(std::string("WILSON"), createWilson);
+	registered = true;
+      }
+      return success;
+    }
+  }
+
+}
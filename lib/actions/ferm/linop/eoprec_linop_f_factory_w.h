@@ -0,0 +1,48 @@
+// -*- C++ -*-
+/*! \file
+ *  \brief Factory of single precision even-odd preconditioned linops
+ */
+
+#ifndef __eoprec_linop_f_factory_w_h__
+#define __eoprec_linop_f_factory_w_h__
+
+#include "chromabase.h"
+#include "handle.h"
+#include "state.h"
+#include "linearop.h"
+#include "singleton.h"
+#include "typelist.h"
+#include "objfactory.h"
+
+namespace Chroma
+{
+
+  //! Single precision even-odd preconditioned linop factory (foundry)
+  /*! \ingroup linop
+   *
+   * Keyed by the FermAct name of the double precision action, so a
+   * mixed precision solver can build the single precision version of
+   * the operator it is handed from the same FermionAction params.
+   */
+  typedef SingletonHolder< 
+    ObjectFactory<LinearOperator<LatticeFermionF>, 
+		  std::string,
+		  TYPELIST_3(XMLReader&, const std::string&, 
+			     Handle< FermState< LatticeFermionF, multi1d<LatticeColorMatrixF>, multi1d<LatticeColorMatrixF> > >),
+		  LinearOperator<LatticeFermionF>* (*)(XMLReader&,
+						       const std::string&,
+						       Handle< FermState< LatticeFermionF, multi1d<LatticeColorMatrixF>, multi1d<LatticeColorMatrixF> > >),
+		  StringFactoryError> >
+  TheEvenOddPrecLinOpFFactory;
+
+
+  //! Single precision even-odd preconditioned linops
+  namespace EvenOddPrecLinOpFEnv
+  {
+    //! Register the linops
+    bool registerAll();
+  }
+
+}
+
+#endif
@@ -167,6 +167,39 @@ namespace Chroma
   }
 
 
+  //! Apply even-odd preconditioned Wilson fermion linear operator onto a block
+  /*!
+   * The same as the single source operator, but the two dslashes read
+   * each link once for all sources.
+   *
+   * \param chi 	  Pseudofermion fields     	       (Write)
+   * \param psi 	  Pseudofermion fields     	       (Read)
+   * \param isign   Flag ( PLUS | MINUS )   	       (Read)
+   */
+  void EvenOddPrecWilsonLinOp::operator()(multi1d<LatticeFermion>& chi, 
+					  const multi1d<LatticeFermion>& psi, 
+					  enum PlusMinus isign) const
+  {
+    START_CODE();
+
+    multi1d<LatticeFermion> tmp1, tmp2;
+    Real mquarterinvfact = -0.25*invfact;
+
+    // tmp2[1] = D_oe D_eo psi[1]
+    D.applyBlock(tmp1, psi, isign, 0);
+    D.applyBlock(tmp2, tmp1, isign, 1);
+
+    chi.resize(psi.size());
+    for(int i=0; i < psi.size(); ++i)
+    {
+      chi[i][rb[1]] = fact*psi[i] + mquarterinvfact*tmp2[i];
+      getFermBC().modifyF(chi[i], rb[1]);
+    }
+    
+    END_CODE();
+  }
+
+
   //! Derivative of even-odd linop component
   void 
   EvenOddPrecWilsonLinOp::derivEvenOddLinOp(multi1d<LatticeColorMatrix>& ds_u,
@@ -59,6 +59,9 @@ namespace Chroma
     //! Return the fermion BC object for this linear operator
     const FermBC<T,P,Q>& getFermBC() const {return D.getFermBC();}
 
+    //! Overlap the face exchange of the dslash with its interior sites
+    void setCommsOverlap(bool overlap) {setDslashCommsOverlap(D, overlap);}
+
     //! Creation routine
     void create(Handle< FermState<T,P,Q> > fs, 
 		const Real& Mass_);
@@ -109,6 +112,10 @@ namespace Chroma
     void operator()(LatticeFermion& chi, const LatticeFermion& psi, 
 		    enum PlusMinus isign) const;
 
+    //! Apply onto a block of sources, sharing the link loads of the dslash
+    void operator()(multi1d<LatticeFermion>& chi, const multi1d<LatticeFermion>& psi, 
+		    enum PlusMinus isign) const;
+
 
     //! Apply the even-even block onto a source std::vector
     void derivEvenEvenLinOp(multi1d<LatticeColorMatrix>& ds_u, 
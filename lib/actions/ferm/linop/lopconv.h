@@ -0,0 +1,62 @@
+// -*- C++ -*-
+/*! \file
+ *  \brief Precision converting linear operator
+ */
+
+#ifndef __lopconv_h__
+#define __lopconv_h__
+
+#include "handle.h"
+#include "linearop.h"
+
+
+namespace Chroma 
+{ 
+  //! Precision converting Linear Operator
+  /*!
+   * \ingroup linop
+   *
+   * Presents an operator acting on fields of type T as an operator acting
+   * on fields of type TL (typically a different precision). The source is
+   * converted to T, the underlying operator applied, and the result
+   * converted back to TL on the subset of the underlying operator.
+   */
+  template<typename TL, typename T>
+  class lopconv : public LinearOperator<TL>
+  {
+  public:
+    //! Initialize pointer with existing pointer
+    /*! Requires that the pointer p is a return value of new */
+    lopconv(LinearOperator<T>* p) : A(p) {}
+
+    //! Copy pointer (one more owner)
+    lopconv(Handle< LinearOperator<T> > p) : A(p) {}
+
+    //! Destructor
+    ~lopconv() {}
+
+    //! Subset comes from underlying operator
+    inline const Subset& subset() const {return A->subset();}
+
+    //! Apply the operator onto a source std::vector
+    inline void operator() (TL& chi, const TL& psi, enum PlusMinus isign) const
+      {
+	const Subset& sub = A->subset();
+	T psi_t;
+	T chi_t;
+	psi_t[sub] = psi;
+	(*A)(chi_t, psi_t, isign);
+	chi[sub] = chi_t;
+      }
+
+    //! Flops come from underlying operator
+    unsigned long nFlops() const {return A->nFlops();}
+
+  private:
+    Handle< LinearOperator<T> > A;
+  };
+
+} // End Namespace Chroma
+
+
+#endif
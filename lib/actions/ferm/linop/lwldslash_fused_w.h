@@ -0,0 +1,1033 @@
+// -*- C++ -*-
+/*! \file
+ *  \brief Site-fused, cache-blocked Wilson Dslash linear operator
+ */
+
+#ifndef __lwldslash_fused_h__
+#define __lwldslash_fused_h__
+
+#include "chroma_config.h"
+#include "state.h"
+#include "io/aniso_io.h"
+#include "actions/ferm/linop/lwldslash_base_w.h"
+#include "actions/ferm/linop/dslash_face_comms.h"
+#include "util/ferm/half_storage.h"
+#include "util/gauge/compressed_links.h"
+
+#include <vector>
+#include <algorithm>
+
+
+namespace Chroma
+{
+  //! Helpers for the site-fused Wilson dslash
+  namespace FusedWilsonDslashEnv
+  {
+    //! Extent of a cache tile in each direction of the local subgrid
+    /*!
+     * A 4^4 tile of single precision spinors and links is about 100KB,
+     * so the neighbours of one tile are still in cache when they are used.
+     */
+    const int tile_extent = 4;
+
+    //! Sites per thread chunk of the boundary sites in the overlapped mode
+    const int face_chunk = 64;
+
+    //! Overlap the face exchange with the interior sites unless set otherwise
+    const bool default_comms_overlap = false;
+
+    //! Reals per link read by the site loop, a LinkReconstruct
+#ifdef BUILD_LINK_RECONSTRUCT
+    const int default_reconstruct = BUILD_LINK_RECONSTRUCT;
+#else
+    const int default_reconstruct = RECONSTRUCT_NONE;
+#endif
+
+    //! Spin projection  (1 + sign gamma_mu) psi  of a single site
+    template<typename HS, typename FS>
+    inline
+    void projectSite(HS& h, const FS& s, int mu, int sign)
+    {
+      switch (mu)
+      {
+      case 0:
+	if (sign > 0) h = spinProjectDir0Plus(s); else h = spinProjectDir0Minus(s);
+	break;
+      case 1:
+	if (sign > 0) h = spinProjectDir1Plus(s); else h = spinProjectDir1Minus(s);
+	break;
+      case 2:
+	if (sign > 0) h = spinProjectDir2Plus(s); else h = spinProjectDir2Minus(s);
+	break;
+      case 3:
+	if (sign > 0) h = spinProjectDir3Plus(s); else h = spinProjectDir3Minus(s);
+	break;
+      default:
+	break;
+      }
+    }
+
+    //! Spin reconstruction of  (1 + sign gamma_mu)  accumulated into a single site
+    template<typename FS, typename HS>
+    inline
+    void reconstructSite(FS& r, const HS& h, int mu, int sign)
+    {
+      switch (mu)
+      {
+      case 0:
+	if (sign > 0) r += spinReconstructDir0Plus(h); else r += spinReconstructDir0Minus(h);
+	break;
+      case 1:
+	if (sign > 0) r += spinReconstructDir1Plus(h); else r += spinReconstructDir1Minus(h);
+	break;
+      case 2:
+	if (sign > 0) r += spinReconstructDir2Plus(h); else r += spinReconstructDir2Minus(h);
+	break;
+      case 3:
+	if (sign > 0) r += spinReconstructDir3Plus(h); else r += spinReconstructDir3Minus(h);
+	break;
+      default:
+	break;
+      }
+    }
+
+    //! Lattice-wide spin projection, used to fill the halos of directions split across nodes
+    template<typename HT, typename T>
+    inline
+    void projectLattice(HT& h, const T& psi, int mu, int sign, const Subset& s)
+    {
+      switch (mu)
+      {
+      case 0:
+	if (sign > 0) h[s] = spinProjectDir0Plus(psi); else h[s] = spinProjectDir0Minus(psi);
+	break;
+      case 1:
+	if (sign > 0) h[s] = spinProjectDir1Plus(psi); else h[s] = spinProjectDir1Minus(psi);
+	break;
+      case 2:
+	if (sign > 0) h[s] = spinProjectDir2Plus(psi); else h[s] = spinProjectDir2Minus(psi);
+	break;
+      case 3:
+	if (sign > 0) h[s] = spinProjectDir3Plus(psi); else h[s] = spinProjectDir3Minus(psi);
+	break;
+      default:
+	break;
+      }
+    }
+
+    //! Link U_mu(site) from full precision links
+    template<typename CM, typename Q>
+    inline
+    void loadLink(CM& m, const Q& u, int mu, int site)
+    {
+      m = u[mu].elem(site).elem();
+    }
+
+    //! Link U_mu(site) decompressed from 16-bit links
+    template<typename CM>
+    inline
+    void loadLink(CM& m, const HalfPrecLinks& u, int mu, int site)
+    {
+      u.load(m, mu, site);
+    }
+
+    //! Link U_mu(site) rebuilt from 12- or 8-real links
+    template<typename CM, typename R>
+    inline
+    void loadLink(CM& m, const CompressedLinksT<R>& u, int mu, int site)
+    {
+      u.load(m, mu, site);
+    }
+
+    //! Arguments of the threaded site loop
+    template<typename T, typename Q, typename HT>
+    struct ApplyArgs
+    {
+      T* const* chi;                    /*!< results, one per source */
+      const T* const* psi;              /*!< sources, all read with one load of each link */
+      int nsrc;                         /*!< number of sources */
+      const Q& u;                       /*!< links, full, HalfPrecLinks or CompressedLinksT */
+      const multi1d<HT>& halo_f;        /*!< U(x) P(psi(x+mu)) of split directions, per source */
+      const multi1d<HT>& halo_b;        /*!< U^dag(x-mu) P(psi(x-mu)) of split directions, per source */
+      const multi1d<int>& halo_dir;     /*!< index of each direction in the halos, -1 if local */
+      int n_split;                      /*!< halos per source */
+      const multi1d<int>& nbr;          /*!< neighbour table, -1 for a neighbour off node */
+      const multi1d<int>& sites;        /*!< sites of the checkerboard ordered by tile */
+      const multi1d<int>& tile_start;   /*!< offset of each tile in sites */
+      int sign;                         /*!< +1 for PLUS, -1 for MINUS */
+    };
+
+    //! Apply the hopping term to all sites of the tiles [lo,hi)
+    /*!
+     * Each link is loaded, or rebuilt, once per site and applied to all
+     * sources before the next one is read.
+     */
+    template<typename T, typename Q, typename HT>
+    void applyTiles(int lo, int hi, int myId, ApplyArgs<T,Q,HT>* a)
+    {
+      typedef typename WordType<T>::Type_t REALT;
+      typedef PColorVector< RComplex<REALT>, Nc>  CV;
+      typedef PSpinVector< CV, 4 >                FourSpinor;
+      typedef PSpinVector< CV, 2 >                HalfSpinor;
+      typedef PColorMatrix< RComplex<REALT>, Nc>  CM;
+
+      const int sign = a->sign;
+      const int nsrc = a->nsrc;
+      std::vector<FourSpinor> res(nsrc);
+
+      for(int tile = lo; tile < hi; ++tile)
+      {
+	for(int j = a->tile_start[tile]; j < a->tile_start[tile+1]; ++j)
+	{
+	  const int site = a->sites[j];
+	  HalfSpinor h, uh;
+	  CM link;
+
+	  for(int k = 0; k < nsrc; ++k)
+	    zero_rep(res[k]);
+
+	  for(int mu = 0; mu < Nd; ++mu)
+	  {
+	    const int hd = a->halo_dir[mu];
+
+	    // Forward hop:  U(x) (1 - isign gamma_mu) psi(x+mu)
+	    loadLink(link, a->u, mu, site);
+	    const int fn = a->nbr[2*(Nd*site + mu)];
+	    for(int k = 0; k < nsrc; ++k)
+	    {
+	      if (fn >= 0)
+	      {
+		projectSite(h, a->psi[k]->elem(fn), mu, -sign);
+		for(int s = 0; s < 2; ++s)
+		  uh.elem(s) = link * h.elem(s);
+	      }
+	      else
+	      {
+		for(int s = 0; s < 2; ++s)
+		  uh.elem(s) = link * a->halo_f[k*a->n_split + hd].elem(site).elem(s);
+	      }
+	      reconstructSite(res[k], uh, mu, -sign);
+	    }
+
+	    // Backward hop:  U^dag(x-mu) (1 + isign gamma_mu) psi(x-mu)
+	    const int bn = a->nbr[2*(Nd*site + mu) + 1];
+	    if (bn >= 0)
+	    {
+	      loadLink(link, a->u, mu, bn);
+	      for(int k = 0; k < nsrc; ++k)
+	      {
+		projectSite(h, a->psi[k]->elem(bn), mu, sign);
+		for(int s = 0; s < 2; ++s)
+		  uh.elem(s) = adj(link) * h.elem(s);
+		reconstructSite(res[k], uh, mu, sign);
+	      }
+	    }
+	    else
+	    {
+	      for(int k = 0; k < nsrc; ++k)
+		reconstructSite(res[k], a->halo_b[k*a->n_split + hd].elem(site), mu, sign);
+	    }
+	  }
+
+	  for(int k = 0; k < nsrc; ++k)
+	    a->chi[k]->elem(site) = res[k];
+	}
+      }
+    }
+  }
+
+
+  //! Site-fused, cache-blocked Wilson-Dirac dslash
+  /*!
+   * \ingroup linop
+   *
+   * DSLASH
+   *
+   * This routine is specific to Wilson fermions!
+   *
+   * Description:
+   *
+   * This routine applies the operator D' to Psi, putting the result in Chi.
+   *
+   *	       Nd-1
+   *	       ---
+   *	       \
+   *   chi(x)  :=  >  U  (x) (1 - isign gamma  ) psi(x+mu)
+   *	       /    mu			  mu
+   *	       ---
+   *	       mu=0
+   *
+   *	             Nd-1
+   *	             ---
+   *	             \    +
+   *                +    >  U  (x-mu) (1 + isign gamma  ) psi(x-mu)
+   *	             /    mu			   mu
+   *	             ---
+   *	             mu=0
+   *
+   * Rather than building half spinor lattices for every direction, the
+   * spin projection, link multiply and reconstruction are done per site
+   * from a neighbour table built at creation. The sites are visited in
+   * cache-sized tiles of the local subgrid, and the tiles are distributed
+   * over threads. Directions that are split across nodes still get their
+   * neighbours through a QDP shift of the projected half spinors.
+   *
+   * With setCommsOverlap(true) the faces are instead exchanged with
+   * persistent messages (DslashFaceComms). All faces are started at once,
+   * the sites with no off-node neighbour are computed while they are in
+   * flight, and the boundary sites are done after the wait. On a single
+   * node, or without a split direction, the flag has no effect.
+   *
+   * With half_links the site loop reads the links from a 16-bit fixed
+   * point copy (HalfPrecLinks) and decompresses them on the fly, which
+   * halves the link traffic of single precision inner solves. The halos
+   * of split directions still use the full precision links.
+   *
+   * Otherwise the site loop can read the links with 12- or 8-real
+   * reconstruction (see CompressedLinksT). That drops the link traffic by
+   * a third or more. The compressed links are made from the links of the
+   * FermState when the dslash is created and are owned by it.
+   *
+   * applyBlock() runs the same site loop on several sources at once.
+   * Each link is then read once per site for all of them. The halos of a
+   * block are always filled by shifts, also with setCommsOverlap(true).
+   */
+  template<typename T, typename P, typename Q, bool half_links = false>
+  class FusedWilsonDslashT : public WilsonDslashBase<T,P,Q>
+  {
+  public:
+    typedef typename WordType<T>::Type_t REALT;
+    typedef OLattice< PSpinVector< PColorVector< RComplex<REALT>, Nc>, 2> > HalfT;
+
+    //! Empty constructor. Must use create later
+    FusedWilsonDslashT();
+
+    //! Full constructor
+    FusedWilsonDslashT(Handle< FermState<T,P,Q> > state);
+
+    //! Full constructor with anisotropy
+    FusedWilsonDslashT(Handle< FermState<T,P,Q> > state,
+		       const AnisoParam_t& aniso_);
+
+    //! Full constructor with general coefficients
+    FusedWilsonDslashT(Handle< FermState<T,P,Q> > state,
+		       const multi1d<Real>& coeffs_);
+
+    //! Creation routine
+    void create(Handle< FermState<T,P,Q> > state);
+
+    //! Creation routine with anisotropy
+    void create(Handle< FermState<T,P,Q> > state,
+		const AnisoParam_t& aniso_);
+
+    //! Full constructor with general coefficients
+    void create(Handle< FermState<T,P,Q> > state,
+		const multi1d<Real>& coeffs_);
+
+    //! No real need for cleanup here
+    ~FusedWilsonDslashT() {}
+
+    /**
+     * Apply a dslash
+     *
+     * \param chi     result                                      (Write)
+     * \param psi     source                                      (Read)
+     * \param isign   D'^dag or D'  ( MINUS | PLUS ) resp.        (Read)
+     * \param cb      Checkerboard of OUTPUT std::vector               (Read)
+     *
+     * \return The output of applying dslash on psi
+     */
+    void apply (T& chi, const T& psi, enum PlusMinus isign, int cb) const;
+
+    //! Apply a dslash onto a block of sources with shared link loads
+    void applyBlock (multi1d<T>& chi, const multi1d<T>& psi, enum PlusMinus isign, int cb) const;
+
+    //! Return the fermion BC object for this linear operator
+    const FermBC<T,P,Q>& getFermBC() const {return *fbc;}
+
+    //! Read the links with recon reals, a LinkReconstruct
+    void setReconstruct(int recon_);
+
+    //! Reals per link actually read by the site loop
+    int getReconstruct() const;
+
+    //! Overlap the face exchange with the interior sites
+    void setCommsOverlap(bool overlap_) {comms_overlap = overlap_;}
+
+    //! Is the face exchange overlapped
+    bool getCommsOverlap() const {return comms_overlap && (comms.operator->() != 0);}
+
+  protected:
+    //! Get the anisotropy parameters
+    const multi1d<Real>& getCoeffs() const {return coeffs;}
+
+    //! Build the neighbour table and the tile ordering of the sites
+    void makeTables();
+
+    //! Build the face lists and messages of the overlapped mode
+    void makeFaces(const multi1d<int>& site_cb, const multi1d<bool>& boundary);
+
+    //! Run the site loop for nsrc sources on sites ordered in tiles
+    void applySites(T* const* chi, const T* const* psi, int nsrc,
+		    const multi1d<int>& sites_, const multi1d<int>& start_, int sign) const;
+
+    //! Fill the halos of source k of output checkerboard cb by shifts
+    void shiftHalos(const T& psi, int k, int sign, int cb) const;
+
+    //! Pack the faces of psi sent for output checkerboard cb
+    void packFaces(const T& psi, int sign, int cb) const;
+
+    //! Copy the received faces into the halos of output checkerboard cb
+    void unpackFaces(int cb) const;
+
+  private:
+    multi1d<Real> coeffs;  /*!< Nd array of coefficients of terms in the action */
+    Handle< FermBC<T,P,Q> >  fbc;
+    Q   u;
+    HalfPrecLinks u_half;               /*!< 16-bit copy of u, only with half_links */
+    Handle< CompressedLinksT<REALT> > u_comp;  /*!< compressed u, null for 18 reals */
+
+    multi1d<bool> local_dir;            /*!< direction is not split across nodes */
+    multi1d<int>  halo_dir;             /*!< index of each direction in the halos, -1 if local */
+    int           n_split;              /*!< number of split directions */
+    mutable multi1d<HalfT> halo_f;      /*!< forward halos of the split directions, per source */
+    mutable multi1d<HalfT> halo_b;      /*!< backward halos of the split directions, per source */
+    mutable multi1d<HalfT> halo_tmp;    /*!< two temporaries to fill the halos by shifts */
+    multi1d<int>  nbr;                  /*!< forward/backward neighbours of each site */
+    multi1d< multi1d<int> > sites;      /*!< checkerboard sites ordered by tile */
+    multi1d< multi1d<int> > tile_start; /*!< tile offsets into sites */
+
+    bool comms_overlap;                 /*!< overlap the faces with the interior */
+    Handle<DslashFaceComms> comms;      /*!< face messages, null without split directions */
+    multi1d< multi1d<int> > face_lo;    /*!< [2*mu+parity] sites at local x_mu = 0 in transverse order */
+    multi1d< multi1d<int> > face_hi;    /*!< [2*mu+parity] sites at local x_mu = L_mu-1 in transverse order */
+    multi1d< multi1d<int> > inner_sites; /*!< checkerboard sites with all neighbours on node, by tile */
+    multi1d< multi1d<int> > inner_start; /*!< tile offsets into inner_sites */
+    multi1d< multi1d<int> > bound_sites; /*!< the other checkerboard sites */
+    multi1d< multi1d<int> > bound_start; /*!< chunk offsets into bound_sites */
+  };
+
+
+  //! Empty constructor
+  template<typename T, typename P, typename Q, bool half_links>
+  FusedWilsonDslashT<T,P,Q,half_links>::FusedWilsonDslashT()
+    : comms_overlap(FusedWilsonDslashEnv::default_comms_overlap) {}
+
+  //! Full constructor
+  template<typename T, typename P, typename Q, bool half_links>
+  FusedWilsonDslashT<T,P,Q,half_links>::FusedWilsonDslashT(Handle< FermState<T,P,Q> > state)
+    : comms_overlap(FusedWilsonDslashEnv::default_comms_overlap)
+  {
+    create(state);
+  }
+
+  //! Full constructor with anisotropy
+  template<typename T, typename P, typename Q, bool half_links>
+  FusedWilsonDslashT<T,P,Q,half_links>::FusedWilsonDslashT(Handle< FermState<T,P,Q> > state,
+						const AnisoParam_t& aniso_)
+    : comms_overlap(FusedWilsonDslashEnv::default_comms_overlap)
+  {
+    create(state, aniso_);
+  }
+
+  //! Full constructor with general coefficients
+  template<typename T, typename P, typename Q, bool half_links>
+  FusedWilsonDslashT<T,P,Q,half_links>::FusedWilsonDslashT(Handle< FermState<T,P,Q> > state,
+						const multi1d<Real>& coeffs_)
+    : comms_overlap(FusedWilsonDslashEnv::default_comms_overlap)
+  {
+    create(state, coeffs_);
+  }
+
+  //! Creation routine
+  template<typename T, typename P, typename Q, bool half_links>
+  void FusedWilsonDslashT<T,P,Q,half_links>::create(Handle< FermState<T,P,Q> > state)
+  {
+    multi1d<Real> cf(Nd);
+    cf = 1.0;
+    create(state, cf);
+  }
+
+  //! Creation routine with anisotropy
+  template<typename T, typename P, typename Q, bool half_links>
+  void FusedWilsonDslashT<T,P,Q,half_links>::create(Handle< FermState<T,P,Q> > state,
+					 const AnisoParam_t& anisoParam)
+  {
+    START_CODE();
+
+    create(state, makeFermCoeffs(anisoParam));
+
+    END_CODE();
+  }
+
+  //! Full constructor with general coefficients
+  template<typename T, typename P, typename Q, bool half_links>
+  void FusedWilsonDslashT<T,P,Q,half_links>::create(Handle< FermState<T,P,Q> > state,
+					 const multi1d<Real>& coeffs_)
+  {
+    START_CODE();
+
+    // Save a copy of the aniso params original fields and with aniso folded in
+    coeffs = coeffs_;
+
+    // Save a copy of the fermbc
+    fbc = state->getFermBC();
+
+    // Sanity check
+    if (fbc.operator->() == 0)
+    {
+      QDPIO::cerr << "FusedWilsonDslash: error: fbc is null" << std::endl;
+      QDP_abort(1);
+    }
+
+    u.resize(Nd);
+
+    // Fold in anisotropy
+    for(int mu=0; mu < u.size(); ++mu) {
+      u[mu] = (state->getLinks())[mu];
+    }
+
+    // Rescale the u fields by the anisotropy
+    for(int mu=0; mu < u.size(); ++mu)
+    {
+      u[mu] *= coeffs[mu];
+    }
+
+    u_comp = 0;
+    if (half_links)
+      u_half.pack(u);
+    else if (FusedWilsonDslashEnv::default_reconstruct != RECONSTRUCT_NONE)
+      u_comp = new CompressedLinksT<REALT>(u, FusedWilsonDslashEnv::default_reconstruct);
+
+    // The tables only depend on the layout, but are cheap compared to a solve
+    makeTables();
+
+    END_CODE();
+  }
+
+
+  //! Read the links with recon reals
+  template<typename T, typename P, typename Q, bool half_links>
+  void FusedWilsonDslashT<T,P,Q,half_links>::setReconstruct(int recon_)
+  {
+    if (recon_ == RECONSTRUCT_NONE)
+      u_comp = 0;
+    else
+      u_comp = new CompressedLinksT<REALT>(u, recon_);
+  }
+
+  //! Reals per link actually read by the site loop
+  template<typename T, typename P, typename Q, bool half_links>
+  int FusedWilsonDslashT<T,P,Q,half_links>::getReconstruct() const
+  {
+    if (u_comp.operator->() == 0)
+      return RECONSTRUCT_NONE;
+    return u_comp->reconstruct();
+  }
+
+
+  //! Build the neighbour table and the tile ordering of the sites
+  template<typename T, typename P, typename Q, bool half_links>
+  void FusedWilsonDslashT<T,P,Q,half_links>::makeTables()
+  {
+    START_CODE();
+
+    const int nodeSites = Layout::sitesOnNode();
+    const int node = Layout::nodeNumber();
+    const multi1d<int>& latt_size = Layout::lattSize();
+    const multi1d<int>& subgrid = Layout::subgridLattSize();
+
+    // A direction is local if it is not split over the nodes
+    local_dir.resize(Nd);
+    halo_dir.resize(Nd);
+    n_split = 0;
+    for(int mu=0; mu < Nd; ++mu)
+    {
+      local_dir[mu] = (Layout::logicalSize()[mu] == 1);
+      halo_dir[mu] = local_dir[mu] ? -1 : n_split++;
+    }
+
+    // The halos are kept between applications, and are only needed for
+    // the split directions. applyBlock grows them to its largest block
+    halo_f.resize(n_split);
+    halo_b.resize(n_split);
+    halo_tmp.resize((n_split > 0) ? 2 : 0);
+
+    // Neighbour table, -1 where the neighbour is on another node
+    nbr.resize(2*Nd*nodeSites);
+    nbr = -1;
+
+    // Number of tiles in each direction of the subgrid
+    multi1d<int> ntile(Nd);
+    int num_tiles = 1;
+    for(int mu=0; mu < Nd; ++mu)
+    {
+      ntile[mu] = (subgrid[mu] + FusedWilsonDslashEnv::tile_extent - 1) / FusedWilsonDslashEnv::tile_extent;
+      num_tiles *= ntile[mu];
+    }
+
+    // Tile and checkerboard of each site
+    multi1d<int> site_tile(nodeSites);
+    multi1d<int> site_cb(nodeSites);
+    multi1d<bool> boundary(nodeSites);
+    multi2d<int> count(2, num_tiles);
+    count = 0;
+
+    for(int site=0; site < nodeSites; ++site)
+    {
+      multi1d<int> coord = Layout::siteCoords(node, site);
+
+      int tile = 0;
+      int parity = 0;
+      for(int mu=Nd-1; mu >= 0; --mu)
+      {
+	tile = tile*ntile[mu] + (coord[mu] % subgrid[mu]) / FusedWilsonDslashEnv::tile_extent;
+	parity += coord[mu];
+      }
+      site_tile[site] = tile;
+      site_cb[site] = parity & 1;
+      count[site_cb[site]][tile]++;
+
+      boundary[site] = false;
+      for(int mu=0; mu < Nd; ++mu)
+      {
+	multi1d<int> fc = coord;
+	fc[mu] = (coord[mu] + 1) % latt_size[mu];
+	if (local_dir[mu] || Layout::nodeNumber(fc) == node)
+	  nbr[2*(Nd*site + mu)] = Layout::linearSiteIndex(fc);
+	else
+	  boundary[site] = true;
+
+	multi1d<int> bc = coord;
+	bc[mu] = (coord[mu] - 1 + latt_size[mu]) % latt_size[mu];
+	if (local_dir[mu] || Layout::nodeNumber(bc) == node)
+	  nbr[2*(Nd*site + mu) + 1] = Layout::linearSiteIndex(bc);
+	else
+	  boundary[site] = true;
+      }
+    }
+
+    // Order the sites of each checkerboard by tile
+    sites.resize(2);
+    tile_start.resize(2);
+    for(int cb=0; cb < 2; ++cb)
+    {
+      tile_start[cb].resize(num_tiles+1);
+      tile_start[cb][0] = 0;
+      for(int tile=0; tile < num_tiles; ++tile)
+	tile_start[cb][tile+1] = tile_start[cb][tile] + count[cb][tile];
+
+      sites[cb].resize(tile_start[cb][num_tiles]);
+
+      multi1d<int> fill(num_tiles);
+      fill = 0;
+      for(int site=0; site < nodeSites; ++site)
+      {
+	if (site_cb[site] != cb)
+	  continue;
+
+	const int tile = site_tile[site];
+	sites[cb][tile_start[cb][tile] + fill[tile]] = site;
+	fill[tile]++;
+      }
+    }
+
+    makeFaces(site_cb, boundary);
+
+    END_CODE();
+  }
+
+
+  //! Build the face lists and messages of the overlapped mode
+  /*!
+   * The faces are ordered by the local coordinates transverse to mu, so
+   * the list sent from the x_mu = 0 face of one node matches the list of
+   * the x_mu = L_mu-1 face of its neighbour site by site.
+   */
+  template<typename T, typename P, typename Q, bool half_links>
+  void FusedWilsonDslashT<T,P,Q,half_links>::makeFaces(const multi1d<int>& site_cb,
+							const multi1d<bool>& boundary)
+  {
+    START_CODE();
+
+    const int nodeSites = Layout::sitesOnNode();
+    const int node = Layout::nodeNumber();
+    const multi1d<int>& subgrid = Layout::subgridLattSize();
+
+    face_lo.resize(2*Nd);
+    face_hi.resize(2*Nd);
+    inner_sites.resize(2);
+    inner_start.resize(2);
+    bound_sites.resize(2);
+    bound_start.resize(2);
+
+    bool split = false;
+    for(int mu=0; mu < Nd; ++mu)
+    {
+      for(int p=0; p < 2; ++p)
+      {
+	face_lo[2*mu+p].resize(0);
+	face_hi[2*mu+p].resize(0);
+      }
+
+      if (local_dir[mu])
+	continue;
+
+      split = true;
+
+      std::vector< std::pair<int,int> > lo[2], hi[2];
+      for(int site=0; site < nodeSites; ++site)
+      {
+	multi1d<int> coord = Layout::siteCoords(node, site);
+
+	int key = 0;
+	for(int nu=Nd-1; nu >= 0; --nu)
+	  if (nu != mu)
+	    key = key*subgrid[nu] + coord[nu] % subgrid[nu];
+
+	const int x = coord[mu] % subgrid[mu];
+	if (x == 0)
+	  lo[site_cb[site]].push_back(std::make_pair(key, site));
+	if (x == subgrid[mu]-1)
+	  hi[site_cb[site]].push_back(std::make_pair(key, site));
+      }
+
+      for(int p=0; p < 2; ++p)
+      {
+	std::sort(lo[p].begin(), lo[p].end());
+	std::sort(hi[p].begin(), hi[p].end());
+
+	face_lo[2*mu+p].resize(lo[p].size());
+	for(int i=0; i < lo[p].size(); ++i)
+	  face_lo[2*mu+p][i] = lo[p][i].second;
+
+	face_hi[2*mu+p].resize(hi[p].size());
+	for(int i=0; i < hi[p].size(); ++i)
+	  face_hi[2*mu+p][i] = hi[p][i].second;
+      }
+    }
+
+    comms = 0;
+    for(int cb=0; cb < 2; ++cb)
+    {
+      inner_sites[cb].resize(0);
+      inner_start[cb].resize(0);
+      bound_sites[cb].resize(0);
+      bound_start[cb].resize(0);
+    }
+
+    if (! split)
+    {
+      END_CODE();
+      return;
+    }
+
+    // Interior sites keep the tiles, boundary sites are cut into chunks
+    for(int cb=0; cb < 2; ++cb)
+    {
+      const int num_tiles = tile_start[cb].size()-1;
+      int ninner = 0;
+      for(int j=0; j < sites[cb].size(); ++j)
+	if (! boundary[sites[cb][j]])
+	  ++ninner;
+
+      const int nbound = sites[cb].size() - ninner;
+      const int nchunk = (nbound + FusedWilsonDslashEnv::face_chunk - 1) / FusedWilsonDslashEnv::face_chunk;
+
+      inner_sites[cb].resize(ninner);
+      inner_start[cb].resize(num_tiles+1);
+      bound_sites[cb].resize(nbound);
+      bound_start[cb].resize(nchunk+1);
+
+      int i = 0, b = 0;
+      for(int tile=0; tile < num_tiles; ++tile)
+      {
+	inner_start[cb][tile] = i;
+	for(int j = tile_start[cb][tile]; j < tile_start[cb][tile+1]; ++j)
+	{
+	  const int site = sites[cb][j];
+	  if (boundary[site])
+	    bound_sites[cb][b++] = site;
+	  else
+	    inner_sites[cb][i++] = site;
+	}
+      }
+      inner_start[cb][num_tiles] = i;
+
+      for(int c=0; c < nchunk; ++c)
+	bound_start[cb][c] = c*FusedWilsonDslashEnv::face_chunk;
+      bound_start[cb][nchunk] = nbound;
+    }
+
+    // Message sizes in bytes. The faces sent for output checkerboard cb
+    // hold the sites of the other checkerboard
+    const int hs_bytes = 2*Nc*2*sizeof(REALT);
+    multi2d<int> send_bytes(2, 2*Nd);
+    multi2d<int> recv_bytes(2, 2*Nd);
+    for(int cb=0; cb < 2; ++cb)
+    {
+      for(int mu=0; mu < Nd; ++mu)
+      {
+	send_bytes[cb][2*mu]   = hs_bytes*face_lo[2*mu+1-cb].size();
+	recv_bytes[cb][2*mu]   = hs_bytes*face_hi[2*mu+cb].size();
+	send_bytes[cb][2*mu+1] = hs_bytes*face_hi[2*mu+1-cb].size();
+	recv_bytes[cb][2*mu+1] = hs_bytes*face_lo[2*mu+cb].size();
+      }
+    }
+
+    comms = new DslashFaceComms(send_bytes, recv_bytes);
+
+    END_CODE();
+  }
+
+
+  //! Run the site loop for nsrc sources on sites ordered in tiles
+  template<typename T, typename P, typename Q, bool half_links>
+  void FusedWilsonDslashT<T,P,Q,half_links>::applySites(T* const* chi, const T* const* psi,
+							 int nsrc,
+							 const multi1d<int>& sites_,
+							 const multi1d<int>& start_,
+							 int sign) const
+  {
+    if (half_links)
+    {
+      FusedWilsonDslashEnv::ApplyArgs<T,HalfPrecLinks,HalfT> arg = {chi, psi, nsrc, u_half, halo_f, halo_b,
+								    halo_dir, n_split, nbr, sites_, start_, sign};
+      dispatch_to_threads(start_.size()-1, arg, FusedWilsonDslashEnv::applyTiles<T,HalfPrecLinks,HalfT>);
+    }
+    else if (u_comp.operator->() != 0)
+    {
+      typedef CompressedLinksT<REALT> CL;
+      FusedWilsonDslashEnv::ApplyArgs<T,CL,HalfT> arg = {chi, psi, nsrc, *u_comp, halo_f, halo_b,
+							 halo_dir, n_split, nbr, sites_, start_, sign};
+      dispatch_to_threads(start_.size()-1, arg, FusedWilsonDslashEnv::applyTiles<T,CL,HalfT>);
+    }
+    else
+    {
+      FusedWilsonDslashEnv::ApplyArgs<T,Q,HalfT> arg = {chi, psi, nsrc, u, halo_f, halo_b,
+							halo_dir, n_split, nbr, sites_, start_, sign};
+      dispatch_to_threads(start_.size()-1, arg, FusedWilsonDslashEnv::applyTiles<T,Q,HalfT>);
+    }
+  }
+
+
+  //! Fill the halos of source k of output checkerboard cb by shifts
+  template<typename T, typename P, typename Q, bool half_links>
+  void FusedWilsonDslashT<T,P,Q,half_links>::shiftHalos(const T& psi, int k, int sign, int cb) const
+  {
+    for(int mu=0; mu < Nd; ++mu)
+    {
+      if (local_dir[mu])
+	continue;
+
+      HalfT& tmp  = halo_tmp[0];
+      HalfT& utmp = halo_tmp[1];
+      const int h = k*n_split + halo_dir[mu];
+
+      //  psi(x+mu) projected with (1 - isign gamma_mu)
+      FusedWilsonDslashEnv::projectLattice(tmp, psi, mu, -sign, rb[1-cb]);
+      halo_f[h][rb[cb]] = shift(tmp, FORWARD, mu);
+
+      //  U^dag(x-mu) psi(x-mu) projected with (1 + isign gamma_mu)
+      FusedWilsonDslashEnv::projectLattice(tmp, psi, mu, sign, rb[1-cb]);
+      utmp[rb[1-cb]] = adj(u[mu]) * tmp;
+      halo_b[h][rb[cb]] = shift(utmp, BACKWARD, mu);
+    }
+  }
+
+
+  //! Pack the faces of psi sent for output checkerboard cb
+  /*!
+   * Kind 0 is  P(psi)  on the x_mu = 0 face for the node below, kind 1
+   * is  U^dag P(psi)  on the x_mu = L_mu-1 face for the node above.
+   */
+  template<typename T, typename P, typename Q, bool half_links>
+  void FusedWilsonDslashT<T,P,Q,half_links>::packFaces(const T& psi, int sign, int cb) const
+  {
+    typedef PSpinVector< PColorVector< RComplex<REALT>, Nc>, 2 > HalfSpinor;
+    typedef PColorMatrix< RComplex<REALT>, Nc>                   CM;
+
+    for(int mu=0; mu < Nd; ++mu)
+    {
+      if (local_dir[mu])
+	continue;
+
+      const multi1d<int>& lo = face_lo[2*mu+1-cb];
+      HalfSpinor* buf = static_cast<HalfSpinor*>(comms->sendBuffer(cb, mu, 0));
+      for(int i=0; i < lo.size(); ++i)
+	FusedWilsonDslashEnv::projectSite(buf[i], psi.elem(lo[i]), mu, -sign);
+
+      const multi1d<int>& hi = face_hi[2*mu+1-cb];
+      buf = static_cast<HalfSpinor*>(comms->sendBuffer(cb, mu, 1));
+      for(int i=0; i < hi.size(); ++i)
+      {
+	HalfSpinor h;
+	CM link;
+	FusedWilsonDslashEnv::projectSite(h, psi.elem(hi[i]), mu, sign);
+	link = u[mu].elem(hi[i]).elem();
+	for(int s = 0; s < 2; ++s)
+	  buf[i].elem(s) = adj(link) * h.elem(s);
+      }
+    }
+  }
+
+
+  //! Copy the received faces into the halos of output checkerboard cb
+  template<typename T, typename P, typename Q, bool half_links>
+  void FusedWilsonDslashT<T,P,Q,half_links>::unpackFaces(int cb) const
+  {
+    typedef PSpinVector< PColorVector< RComplex<REALT>, Nc>, 2 > HalfSpinor;
+
+    for(int mu=0; mu < Nd; ++mu)
+    {
+      if (local_dir[mu])
+	continue;
+
+      const multi1d<int>& hi = face_hi[2*mu+cb];
+      const HalfSpinor* buf = static_cast<const HalfSpinor*>(comms->recvBuffer(cb, mu, 0));
+      for(int i=0; i < hi.size(); ++i)
+	halo_f[halo_dir[mu]].elem(hi[i]) = buf[i];
+
+      const multi1d<int>& lo = face_lo[2*mu+cb];
+      buf = static_cast<const HalfSpinor*>(comms->recvBuffer(cb, mu, 1));
+      for(int i=0; i < lo.size(); ++i)
+	halo_b[halo_dir[mu]].elem(lo[i]) = buf[i];
+    }
+  }
+
+
+  //! General Wilson-Dirac dslash
+  /*! \ingroup linop
+   * Wilson dslash
+   *
+   * Arguments:
+   *
+   *  \param chi	      Result				                (Write)
+   *  \param psi	      Pseudofermion field				(Read)
+   *  \param isign      D'^dag or D' ( MINUS | PLUS ) resp.		(Read)
+   *  \param cb	      Checkerboard of OUTPUT std::vector			(Read)
+   */
+  template<typename T, typename P, typename Q, bool half_links>
+  void
+  FusedWilsonDslashT<T,P,Q,half_links>::apply (T& chi, const T& psi,
+				    enum PlusMinus isign, int cb) const
+  {
+    START_CODE();
+#if (QDP_NC == 2) || (QDP_NC == 3)
+    const int sign = (isign == PLUS) ? 1 : -1;
+    T* chis = &chi;
+    const T* psis = &psi;
+
+    if (getCommsOverlap())
+    {
+      // Start all faces, do the interior while they are in flight
+      packFaces(psi, sign, cb);
+      comms->start(cb);
+
+      applySites(&chis, &psis, 1, inner_sites[cb], inner_start[cb], sign);
+
+      comms->wait(cb);
+      unpackFaces(cb);
+
+      applySites(&chis, &psis, 1, bound_sites[cb], bound_start[cb], sign);
+    }
+    else
+    {
+      shiftHalos(psi, 0, sign, cb);
+      applySites(&chis, &psis, 1, sites[cb], tile_start[cb], sign);
+    }
+
+    FusedWilsonDslashT<T,P,Q,half_links>::getFermBC().modifyF(chi, QDP::rb[cb]);
+#else
+    QDPIO::cerr<<"lwldslash_fused_w: not implemented for NC!=3\n";
+    QDP_abort(13) ;
+#endif
+    END_CODE();
+  }
+
+
+  //! Wilson-Dirac dslash onto a block of sources
+  /*! \ingroup linop
+   *
+   * The same as apply() on each source, but every link is loaded once
+   * per site for the whole block.
+   *
+   *  \param chi	      Results				                (Write)
+   *  \param psi	      Sources						(Read)
+   *  \param isign      D'^dag or D' ( MINUS | PLUS ) resp.		(Read)
+   *  \param cb	      Checkerboard of OUTPUT std::vector			(Read)
+   */
+  template<typename T, typename P, typename Q, bool half_links>
+  void
+  FusedWilsonDslashT<T,P,Q,half_links>::applyBlock (multi1d<T>& chi, const multi1d<T>& psi,
+					 enum PlusMinus isign, int cb) const
+  {
+    START_CODE();
+
+    const int nsrc = psi.size();
+    chi.resize(nsrc);
+    if (nsrc == 0)
+    {
+      END_CODE();
+      return;
+    }
+
+#if (QDP_NC == 2) || (QDP_NC == 3)
+    const int sign = (isign == PLUS) ? 1 : -1;
+
+    if (halo_f.size() < nsrc*n_split)
+    {
+      halo_f.resize(nsrc*n_split);
+      halo_b.resize(nsrc*n_split);
+    }
+
+    std::vector<T*> chis(nsrc);
+    std::vector<const T*> psis(nsrc);
+    for(int k=0; k < nsrc; ++k)
+    {
+      chis[k] = &chi[k];
+      psis[k] = &psi[k];
+      shiftHalos(psi[k], k, sign, cb);
+    }
+
+    applySites(&chis[0], &psis[0], nsrc, sites[cb], tile_start[cb], sign);
+
+    for(int k=0; k < nsrc; ++k)
+      getFermBC().modifyF(chi[k], QDP::rb[cb]);
+#else
+    QDPIO::cerr<<"lwldslash_fused_w: not implemented for NC!=3\n";
+    QDP_abort(13) ;
+#endif
+    END_CODE();
+  }
+
+
+  //! Select the overlapped face exchange of a fused dslash
+  template<typename T, typename P, typename Q, bool half_links>
+  inline
+  void setDslashCommsOverlap(FusedWilsonDslashT<T,P,Q,half_links>& D, bool overlap)
+  {
+    D.setCommsOverlap(overlap);
+  }
+
+
+  typedef FusedWilsonDslashT<LatticeFermion,
+			     multi1d<LatticeColorMatrix>,
+			     multi1d<LatticeColorMatrix> > FusedWilsonDslash;
+
+  typedef FusedWilsonDslashT<LatticeFermionF,
+			     multi1d<LatticeColorMatrixF>,
+			     multi1d<LatticeColorMatrixF> > FusedWilsonDslashF;
+
+  typedef FusedWilsonDslashT<LatticeFermionD,
+			     multi1d<LatticeColorMatrixD>,
+			     multi1d<LatticeColorMatrixD> > FusedWilsonDslashD;
+
+  typedef FusedWilsonDslashT<LatticeFermionF,
+			     multi1d<LatticeColorMatrixF>,
+			     multi1d<LatticeColorMatrixF>, true> FusedWilsonDslashHalfLinksF;
+
+} // End Namespace Chroma
+
+
+#endif
@@ -23,6 +23,7 @@ namespace Chroma
 
     A.create(fs, param);
     D.create(fs, param.anisoParam);
+    setDslashCommsOverlap(D, param.comms_overlap);
 
     // QDPIO::cout << __PRETTY_FUNCTION__ << ": exit" << std::endl;
   }
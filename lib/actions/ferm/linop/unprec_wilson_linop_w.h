@@ -64,6 +64,9 @@ namespace Chroma
     //! Return the fermion BC object for this linear operator
     const FermBC<T,P,Q>& getFermBC() const {return D.getFermBC();}
 
+    //! Overlap the face exchange of the dslash with its interior sites
+    void setCommsOverlap(bool overlap) {setDslashCommsOverlap(D, overlap);}
+
     //! Creation routine
     void create(Handle< FermState<T,P,Q> > fs,
 		const Real& Mass_);
@@ -79,7 +79,7 @@ namespace Chroma
       return res;
     }
 
-  private:
+  protected:
     // Hide default constructor
     PrecFermActQprop() {}
 
@@ -88,6 +88,92 @@ namespace Chroma
   };
 
 
+  //! Propagator of a generic even-odd preconditioned fermion linear operator for blocks of sources
+  /*! \ingroup qprop
+   *
+   * Used when the underlying inverter can solve several right hand sides at once
+   */
+  template<typename T, typename P, typename Q>
+  class PrecFermActQpropBlock : public PrecFermActQprop<T,P,Q>, public SystemSolverBlock<T>
+  {
+  public:
+    //! Constructor
+    /*!
+     * \param A_         Linear operator ( Read )
+     * \param invA_      block capable inverter ( Read )
+     */
+    PrecFermActQpropBlock(Handle< EvenOddPrecLinearOperator<T,P,Q> > A_,
+			  Handle< LinOpSystemSolver<T> > invA_) : PrecFermActQprop<T,P,Q>(A_, invA_),
+      invAB(dynamic_cast<const SystemSolverBlock<T>*>(invA_.operator->()))
+      {}
+
+    //! Destructor is automatic
+    ~PrecFermActQpropBlock() {}
+
+    //! Return the subset on which the operator acts
+    const Subset& subset() const {return all;}
+
+    //! Single source solve
+    using PrecFermActQprop<T,P,Q>::operator();
+
+    //! Solve the linear systems for a block of sources
+    /*!
+     * \param psi      quark propagators ( Modify )
+     * \param chi      sources ( Read )
+     * \return results for each source
+     */
+    multi1d<SystemSolverResults_t> operator() (multi1d<T>& psi, const multi1d<T>& chi) const
+    {
+      START_CODE();
+
+      const EvenOddPrecLinearOperator<T,P,Q>& A = *(this->A);
+      const int N = chi.size();
+
+      /* Step (i) */
+      /* chi_tmp =  chi_o - D_oe * A_ee^-1 * chi_e */
+      multi1d<T> chi_tmp(N);
+      for(int i=0; i < N; ++i)
+      {
+	T tmp1, tmp2;
+
+	A.evenEvenInvLinOp(tmp1, chi[i], PLUS);
+	A.oddEvenLinOp(tmp2, tmp1, PLUS);
+	chi_tmp[i][rb[1]] = chi[i] - tmp2;
+      }
+
+      // Call inverter
+      multi1d<SystemSolverResults_t> res = (*invAB)(psi, chi_tmp);
+
+      /* Step (ii) */
+      /* psi_e = A_ee^-1 * [chi_e  -  D_eo * psi_o] */
+      for(int i=0; i < N; ++i)
+      {
+	T tmp1, tmp2;
+
+	A.evenOddLinOp(tmp1, psi[i], PLUS);
+	tmp2[rb[0]] = chi[i] - tmp1;
+	A.evenEvenInvLinOp(psi[i], tmp2, PLUS);
+      }
+  
+      // Compute residuals
+      for(int i=0; i < N; ++i)
+      {
+	T  r;
+	A.unprecLinOp(r, psi[i], PLUS);
+	r -= chi[i];
+	res[i].resid = sqrt(norm2(r));
+      }
+
+      END_CODE();
+
+      return res;
+    }
+
+  private:
+    const SystemSolverBlock<T>* invAB;   /*!< the block interface of invA */
+  };
+
+
   typedef LatticeFermion LF;
   typedef multi1d<LatticeColorMatrix> LCM;
 
@@ -114,7 +200,11 @@ namespace Chroma
   
     QDPIO::cout << "  ... constructing PrecFermActQprop " ;
     swatch2.reset(); swatch2.start();
-    PrecFermActQprop<LF,LCM,LCM>* ret_val = new PrecFermActQprop<LF,LCM,LCM>(lh , ilh);
+    SystemSolver<LF>* ret_val;
+    if (dynamic_cast<const SystemSolverBlock<LF>*>(ilh.operator->()) != 0)
+      ret_val = new PrecFermActQpropBlock<LF,LCM,LCM>(lh , ilh);
+    else
+      ret_val = new PrecFermActQprop<LF,LCM,LCM>(lh , ilh);
      swatch2.stop();
     QDPIO::cout << " ..." << swatch2.getTimeInSeconds() << " sec" << std::endl;
 
@@ -65,7 +65,7 @@ namespace Chroma
       return res;
     }
 
-  private:
+  protected:
     // Hide default constructor
     FermActQprop() {}
 
@@ -74,6 +74,80 @@ namespace Chroma
   };
 
 
+  //! Propagator of a generic non-preconditioned fermion linear operator for blocks of sources
+  /*! \ingroup qprop
+   *
+   * Used when the underlying inverter can solve several right hand sides at once
+   */
+  template<typename T>
+  class FermActQpropBlock : public FermActQprop<T>, public SystemSolverBlock<T>
+  {
+  public:
+    //! Constructor
+    /*!
+     * \param A_         Linear operator ( Read )
+     * \param invA_      block capable inverter ( Read )
+     */
+    FermActQpropBlock(Handle< LinearOperator<T> > A_,
+		      Handle< SystemSolver<T> > invA_) : FermActQprop<T>(A_, invA_),
+      invAB(dynamic_cast<const SystemSolverBlock<T>*>(invA_.operator->()))
+    {}
+
+    //! Destructor is automatic
+    ~FermActQpropBlock() {}
+
+    //! Return the subset on which the operator acts
+    const Subset& subset() const {return all;}
+
+    //! Single source solve
+    using FermActQprop<T>::operator();
+
+    //! Solve the linear systems for a block of sources
+    /*!
+     * \param psi      quark propagators ( Modify )
+     * \param chi      sources ( Read )
+     * \return results for each source
+     */
+    multi1d<SystemSolverResults_t> operator() (multi1d<T>& psi, const multi1d<T>& chi) const
+    {
+      START_CODE();
+
+      // Call inverter
+      multi1d<SystemSolverResults_t> res = (*invAB)(psi, chi);
+  
+      // Compute residuals
+      {
+	multi1d<T> r;
+	(*(this->A))(r, psi, PLUS);
+	for(int i=0; i < chi.size(); ++i)
+	{
+	  r[i] -= chi[i];
+	  res[i].resid = sqrt(norm2(r[i]));
+	}
+      }
+
+      END_CODE();
+
+      return res;
+    }
+
+  private:
+    const SystemSolverBlock<T>* invAB;   /*!< the block interface of invA */
+  };
+
+
+  //! Wrap an inverter, using the block version when the inverter supports it
+  template<typename T>
+  SystemSolver<T>* createFermActQprop(Handle< LinearOperator<T> > A,
+				      Handle< SystemSolver<T> > invA)
+  {
+    if (dynamic_cast<const SystemSolverBlock<T>*>(invA.operator->()) != 0)
+      return new FermActQpropBlock<T>(A, invA);
+    else
+      return new FermActQprop<T>(A, invA);
+  }
+
+
   /*! \ingroup qprop */
   template<>
   SystemSolver<LatticeFermion>*
@@ -89,8 +163,8 @@ namespace Chroma
     typedef multi1d<LatticeColorMatrix>  P;
     typedef multi1d<LatticeColorMatrix>  Q;
 
-    return new FermActQprop<T>(linOp(state),
-			       invLinOp(state,invParam));
+    return createFermActQprop<T>(linOp(state),
+				 invLinOp(state,invParam));
   }
 
 
@@ -109,8 +183,8 @@ namespace Chroma
     typedef multi1d<LatticeColorMatrix>  P;
     typedef multi1d<LatticeColorMatrix>  Q;
 
-    return new FermActQprop<T>(linOp(state),
-			       invLinOp(state,invParam));
+    return createFermActQprop<T>(linOp(state),
+				 invLinOp(state,invParam));
   }
 
 
@@ -12,6 +12,8 @@
 #include "actions/ferm/invert/multi_syssolver_linop_factory.h"
 #include "actions/ferm/invert/multi_syssolver_mdagm_factory.h"
 #include "actions/ferm/invert/multi_syssolver_mdagm_accumulate_factory.h"
+#include "actions/ferm/invert/multi_syssolver_mdagm_cg_block.h"
+#include "actions/ferm/invert/multi_syssolver_mdagm_block_loop.h"
 
 
 namespace Chroma 
@@ -66,55 +68,113 @@ namespace Chroma
 
 //  LatticeFermion psi = zero;  // note this is ``zero'' and not 0
 
-    // This version loops over all color and spin indices
-    for(int color_source = 0; color_source < Nc; ++color_source)
+    // Solvers that handle many sources at once get all color and spin sources together
+    const SystemSolverBlock<T>* qprop_block = dynamic_cast<const SystemSolverBlock<T>*>(qprop.operator->());
+
+    if (qprop_block != 0)
     {
-      for(int spin_source = start_spin; spin_source < end_spin; ++spin_source)
+      const int nspin = end_spin - start_spin;
+      multi1d<T> psi(Nc*nspin);
+      multi1d<T> chi(Nc*nspin);
+      multi1d<Real> fact(Nc*nspin);
+
+      for(int color_source = 0; color_source < Nc; ++color_source)
       {
-	LatticeFermion psi = zero;  // note this is ``zero'' and not 0
-	LatticeFermion chi;
+	for(int spin_source = start_spin; spin_source < end_spin; ++spin_source)
+	{
+	  int n = spin_source - start_spin + nspin*color_source;
 
-	// Extract a fermion source
-	PropToFerm(q_src, chi, color_source, spin_source);
+	  psi[n] = zero;
 
-	// Use the last initial guess as the current initial guess
+	  // Extract a fermion source
+	  PropToFerm(q_src, chi[n], color_source, spin_source);
 
-	/* 
-	 * Normalize the source in case it is really huge or small - 
-	 * a trick to avoid overflows or underflows
-	 */
-	Real fact = 1.0;
-	Real nrm = sqrt(norm2(chi));
-	if (toFloat(nrm) != 0.0)
-	  fact /= nrm;
+	  // Normalize the source as in the single source case below
+	  fact[n] = 1.0;
+	  Real nrm = sqrt(norm2(chi[n]));
+	  if (toFloat(nrm) != 0.0)
+	    fact[n] /= nrm;
 
-	// Rescale
-	chi *= fact;
+	  chi[n] *= fact[n];
+	}
+      }
+
+      // Compute the propagator for all source colors/spins
+      multi1d<SystemSolverResults_t> result = (*qprop_block)(psi,chi);
 
-	// Compute the propagator for given source color/spin.
+      for(int color_source = 0; color_source < Nc; ++color_source)
+      {
+	for(int spin_source = start_spin; spin_source < end_spin; ++spin_source)
 	{
-	  SystemSolverResults_t result = (*qprop)(psi,chi);
-	  ncg_had += result.n_count;
+	  int n = spin_source - start_spin + nspin*color_source;
+	  ncg_had += result[n].n_count;
 
 	  push(xml_out,"Qprop");
 	  write(xml_out, "color_source", color_source);
 	  write(xml_out, "spin_source", spin_source);
-	  write(xml_out, "n_count", result.n_count);
-	  write(xml_out, "resid", result.resid);
+	  write(xml_out, "n_count", result[n].n_count);
+	  write(xml_out, "resid", result[n].resid);
 	  pop(xml_out);
-	}
 
-	// Unnormalize the source following the inverse of the normalization above
-	fact = Real(1) / fact;
-	psi *= fact;
+	  // Unnormalize the source following the inverse of the normalization above
+	  psi[n] *= Real(1) / fact[n];
 
-	/*
-	 * Move the solution to the appropriate components
-	 * of quark propagator.
-	 */
-	FermToProp(psi, q_sol, color_source, spin_source);
-      }	/* end loop over spin_source */
-    } /* end loop over color_source */
+	  FermToProp(psi[n], q_sol, color_source, spin_source);
+	}
+      }
+    }
+    else
+    {
+      // This version loops over all color and spin indices
+      for(int color_source = 0; color_source < Nc; ++color_source)
+      {
+        for(int spin_source = start_spin; spin_source < end_spin; ++spin_source)
+        {
+	  LatticeFermion psi = zero;  // note this is ``zero'' and not 0
+	  LatticeFermion chi;
+
+	  // Extract a fermion source
+	  PropToFerm(q_src, chi, color_source, spin_source);
+
+	  // Use the last initial guess as the current initial guess
+
+	  /* 
+	   * Normalize the source in case it is really huge or small - 
+	   * a trick to avoid overflows or underflows
+	   */
+	  Real fact = 1.0;
+	  Real nrm = sqrt(norm2(chi));
+	  if (toFloat(nrm) != 0.0)
+	    fact /= nrm;
+
+	  // Rescale
+	  chi *= fact;
+
+	  // Compute the propagator for given source color/spin.
+	  {
+	    SystemSolverResults_t result = (*qprop)(psi,chi);
+	    ncg_had += result.n_count;
+
+	    push(xml_out,"Qprop");
+	    write(xml_out, "color_source", color_source);
+	    write(xml_out, "spin_source", spin_source);
+	    write(xml_out, "n_count", result.n_count);
+	    write(xml_out, "resid", result.resid);
+	    pop(xml_out);
+	  }
+
+	  // Unnormalize the source following the inverse of the normalization above
+	  fact = Real(1) / fact;
+	  psi *= fact;
+
+	  /*
+	   * Move the solution to the appropriate components
+	   * of quark propagator.
+	   */
+	  FermToProp(psi, q_sol, color_source, spin_source);
+        }	/* end loop over spin_source */
+      } /* end loop over color_source */
+    }
 
 
     switch (quarkSpinType)
@@ -361,6 +421,32 @@ namespace Chroma
 									 this->linOp(state));
   }
 
+  //! Return a solver for several sources to solve (MdagM+shift_i)*psi_{n,i} = chi_n 
+  /*! \ingroup qprop
+   *
+   * The CG multi-shift solver advances all sources together. Any other
+   * multi-shift solver is applied to the sources in turn.
+   */
+  template<>
+  MdagMMultiSystemSolverBlock<LF>*
+  WilsonTypeFermAct<LF,LCM,LCM>::mInvMdagMBlock(Handle< FermState<LF,LCM,LCM> > state,
+						const GroupXML_t& invParam) const
+  {
+#ifndef QDP_IS_QDPJIT
+    if (invParam.id == "CG_INVERTER")
+    {
+      std::istringstream  xml(invParam.xml);
+      XMLReader  paramtop(xml);
+
+      return new MdagMMultiSysSolverCGBlock<LF>(this->linOp(state),
+						MultiSysSolverCGParams(paramtop, invParam.path));
+    }
+#endif
+
+    Handle< MdagMMultiSystemSolver<LF> > invMdagM(this->mInvMdagM(state, invParam));
+    return new MdagMMultiSysSolverBlockLoop<LF>(invMdagM);
+  }
+
 
 
   //------------------------------------------------------------------------------------
@@ -6,6 +6,7 @@
 #include "actions/gauge/gaugeacts/pg_gaugeact.h"
 #include "actions/gauge/gaugeacts/gaugeact_factory.h"
 #include "actions/gauge/gaugestates/gauge_createstate_aggregate.h"
+#include "update/molecdyn/hamiltonian/repro_sum.h"
 
 namespace Chroma
 {
@@ -373,7 +374,7 @@ namespace Chroma
       }
     }
 
-    Double S_pg = sum(lgimp);
+    Double S_pg = reproSum(lgimp);
     S_pg *= -coeff / Real(Nc);      // note sign
   
     END_CODE();
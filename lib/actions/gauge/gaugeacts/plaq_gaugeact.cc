@@ -8,6 +8,7 @@
 #include "actions/gauge/gaugestates/gauge_createstate_factory.h"
 #include "actions/gauge/gaugestates/gauge_createstate_aggregate.h"
 #include "meas/glue/mesplq.h"
+#include "update/molecdyn/hamiltonian/repro_sum.h"
 
 
 namespace Chroma
@@ -548,7 +549,7 @@ namespace Chroma
 	/* tmp_1 = tmp_0*u_dag(x,nu)=u(x+mu,nu)*u_dag(x+nu,mu)*u_dag(x,nu) */
 	/* wplaq_tmp = tr(u(x,mu)*tmp_1=u(x,mu)*u(x+mu,nu)*u_dag(x+nu,mu)*u_dag(x,nu)) */
 	Double tmp = 
-	  sum(real(trace(u[mu]*shift(u[nu],FORWARD,mu)*adj(shift(u[mu],FORWARD,nu))*adj(u[nu]))));
+	  reproSum(LatticeReal(real(trace(u[mu]*shift(u[nu],FORWARD,mu)*adj(shift(u[mu],FORWARD,nu))*adj(u[nu])))));
 
 	S_pg += tmp * Double(param.coeffs[mu][nu]);
       }
@@ -585,7 +586,7 @@ namespace Chroma
 	if( (nu != t_dir) && (mu != t_dir) ) 
 	{
 	  Double tmp = 
-	    sum(real(trace(u[mu]*shift(u[nu],FORWARD,mu)*adj(shift(u[mu],FORWARD,nu))*adj(u[nu]))));
+	    reproSum(LatticeReal(real(trace(u[mu]*shift(u[nu],FORWARD,mu)*adj(shift(u[mu],FORWARD,nu))*adj(u[nu])))));
 	  
 	  S_pg += tmp * Double(param.coeffs[mu][nu]);
 	}
@@ -623,7 +624,7 @@ namespace Chroma
 	if( (nu == t_dir) || (mu == t_dir) ) 
 	{
 	  Double tmp = 
-	    sum(real(trace(u[mu]*shift(u[nu],FORWARD,mu)*adj(shift(u[mu],FORWARD,nu))*adj(u[nu]))));
+	    reproSum(LatticeReal(real(trace(u[mu]*shift(u[nu],FORWARD,mu)*adj(shift(u[mu],FORWARD,nu))*adj(u[nu])))));
 	  
 	  S_pg += tmp * Double(param.coeffs[mu][nu]);
 	}
@@ -6,6 +6,7 @@
 #include "actions/gauge/gaugeacts/rect_gaugeact.h"
 #include "actions/gauge/gaugeacts/gaugeact_factory.h"
 #include "actions/gauge/gaugestates/gauge_createstate_aggregate.h"
+#include "update/molecdyn/hamiltonian/repro_sum.h"
 
 namespace Chroma
 {
@@ -492,7 +493,7 @@ namespace Chroma
       }
     }
 
-    Double S_rect = sum(lgimp);
+    Double S_rect = reproSum(lgimp);
     S_rect *= -Double(1) / Double(Nc);   // note sign here
 
     END_CODE();
@@ -531,7 +532,7 @@ namespace Chroma
       }
     }
 
-    Double S_rect = sum(lgimp);
+    Double S_rect = reproSum(lgimp);
     S_rect *= -Double(1) / Double(Nc);   // note sign here
 
     END_CODE();
@@ -568,7 +569,7 @@ namespace Chroma
       }
     }
 
-    Double S_rect = sum(lgimp);
+    Double S_rect = reproSum(lgimp);
     S_rect *= -Double(1) / Double(Nc);   // note sign here
 
     END_CODE();
@@ -6,6 +6,7 @@
 
 #include "init/chroma_init.h"
 #include "io/xmllog_io.h"
+#include "io/staged_io.h"
 
 #if defined(BUILD_JIT_CLOVER_TERM)
 #if defined(QDPJIT_IS_QDPJITPTX)
@@ -244,6 +245,8 @@ namespace Chroma
     if (! QDP_isInitialized())
       return;
 
+    // Staged files must reach their destinations before exit
+    StagedIOEnv::finalize();
     
     /*
     if( xmlInputP ) { 
@@ -27,6 +27,7 @@
 #include "writeszin.h"
 
 #include "gauge_io.h"
+#include "staged_io.h"
 #include "milc_io.h"
 #include "kyugauge_io.h"
 #include "readmilc.h"
@@ -0,0 +1,222 @@
+/*! \file
+ *  \brief Staged file writing with a background mover
+ */
+
+#include "io/staged_io.h"
+
+#include <cstdio>
+#include <fstream>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+namespace Chroma
+{
+
+  namespace StagedIOEnv
+  {
+    namespace
+    {
+      //! Background thread moving the staged files
+      /*!
+       * The thread only does file system calls. It never talks to the
+       * other nodes, so it can run next to the communications of the
+       * main thread. Errors are kept and reported by the main thread.
+       */
+      class Mover
+      {
+      public:
+	Mover() : busy(false), stop(false)
+	{
+	  worker = std::thread(&Mover::run, this);
+	}
+
+	~Mover()
+	{
+	  {
+	    std::unique_lock<std::mutex> lock(mtx);
+	    stop = true;
+	  }
+	  cond.notify_all();
+	  worker.join();
+	}
+
+	//! Queue a batch, wait if two batches are pending
+	void push(const std::vector<Move_t>& moves)
+	{
+	  std::unique_lock<std::mutex> lock(mtx);
+	  while (queue.size() + (busy ? 1 : 0) >= 2)
+	    cond.wait(lock);
+
+	  checkError();
+	  queue.push_back(moves);
+	  cond.notify_all();
+	}
+
+	//! Wait until nothing is queued or moving
+	void drain()
+	{
+	  std::unique_lock<std::mutex> lock(mtx);
+	  while (! queue.empty() || busy)
+	    cond.wait(lock);
+
+	  checkError();
+	}
+
+      private:
+	//! Report an error of the thread, called with the lock held
+	void checkError()
+	{
+	  if (error.empty())
+	    return;
+
+	  QDPIO::cerr << "StagedIO: " << error << std::endl;
+	  QDP_abort(1);
+	}
+
+	//! Move one file, first by rename and otherwise by copying
+	static std::string move(const Move_t& m)
+	{
+	  if (std::rename(m.first.c_str(), m.second.c_str()) == 0)
+	    return "";
+
+	  // Different file systems. Copy to a temporary name first.
+	  std::string part = m.second + ".part";
+	  {
+	    std::ifstream in(m.first.c_str(), std::ios::binary);
+	    std::ofstream out(part.c_str(), std::ios::binary | std::ios::trunc);
+	    if (! in || ! out)
+	      return "cannot copy " + m.first + " to " + part;
+
+	    out << in.rdbuf();
+	    out.close();
+	    if (! out)
+	      return "error writing " + part;
+	  }
+
+	  if (std::rename(part.c_str(), m.second.c_str()) != 0)
+	    return "cannot rename " + part + " to " + m.second;
+
+	  std::remove(m.first.c_str());
+	  return "";
+	}
+
+	//! Thread body
+	void run()
+	{
+	  std::unique_lock<std::mutex> lock(mtx);
+	  for(;;)
+	  {
+	    while (queue.empty() && ! stop)
+	      cond.wait(lock);
+
+	    if (queue.empty())
+	      break;
+
+	    std::vector<Move_t> moves = queue.front();
+	    queue.pop_front();
+	    busy = true;
+
+	    lock.unlock();
+	    std::string err;
+	    for(int i=0; i < moves.size() && err.empty(); ++i)
+	      err = move(moves[i]);
+	    lock.lock();
+
+	    if (! err.empty() && error.empty())
+	      error = err;
+
+	    busy = false;
+	    cond.notify_all();
+	  }
+	}
+
+	std::thread  worker;
+	std::mutex   mtx;
+	std::condition_variable  cond;
+	std::deque< std::vector<Move_t> >  queue;
+	bool  busy;
+	bool  stop;
+	std::string  error;
+      };
+
+      //! Created on first use, only on the primary node
+      Mover* the_mover = 0;
+    }
+
+
+    //! Can a write with volfmt be staged in staging_dir
+    bool canStage(const std::string& staging_dir, QDP_volfmt_t volfmt)
+    {
+      if (staging_dir.empty())
+	return false;
+
+      if (volfmt != QDPIO_SINGLEFILE)
+      {
+	QDPIO::cout << "StagedIO: only single files are staged, writing directly" << std::endl;
+	return false;
+      }
+
+      return true;
+    }
+
+
+    //! Name of the staged copy of file
+    std::string stagedName(const std::string& staging_dir, const std::string& file)
+    {
+      std::string::size_type slash = file.rfind('/');
+      std::string base = (slash == std::string::npos) ? file : file.substr(slash+1);
+
+      return staging_dir + "/" + base;
+    }
+
+
+    //! Move a batch of staged files to their destinations in the background
+    void moveBatch(const std::vector<Move_t>& moves)
+    {
+      if (! Layout::primaryNode())
+	return;
+
+      if (the_mover == 0)
+	the_mover = new Mover();
+
+      for(int i=0; i < moves.size(); ++i)
+	QDPIO::cout << "StagedIO: queued " << moves[i].first << " -> " << moves[i].second << std::endl;
+
+      the_mover->push(moves);
+    }
+
+
+    //! Wait until all queued files are at their destinations
+    void fence()
+    {
+      if (the_mover == 0)
+	return;
+
+      StopWatch swatch;
+      swatch.reset();
+      swatch.start();
+
+      the_mover->drain();
+
+      swatch.stop();
+      QDPIO::cout << "StagedIO: fence waited " << swatch.getTimeInSeconds() << " secs" << std::endl;
+    }
+
+
+    //! Wait for the queued files and stop the mover thread
+    void finalize()
+    {
+      if (the_mover == 0)
+	return;
+
+      fence();
+
+      // Joins the thread
+      delete the_mover;
+      the_mover = 0;
+    }
+  }
+
+}
@@ -0,0 +1,60 @@
+// -*- C++ -*-
+/*! \file
+ *  \brief Staged file writing with a background mover
+ */
+
+#ifndef __staged_io_h__
+#define __staged_io_h__
+
+#include "chromabase.h"
+#include <vector>
+#include <utility>
+
+namespace Chroma
+{
+
+  //! Staged file writing
+  /*! \ingroup io
+   *
+   * A collective write to a slow parallel file system stalls every node
+   * until the file is on disk. A staged write puts the file in a fast
+   * staging directory instead, e.g. a node local ram disk or a burst
+   * buffer. A background thread on the primary node then moves it to
+   * its destination while the program goes on.
+   *
+   * Only single files can be staged. With parallel IO all nodes write
+   * to the staged file, so the staging directory must then be shared
+   * by all nodes.
+   *
+   * Files are moved in batches, in the order they were queued. One
+   * batch can wait while another one is moved. Queueing a third batch
+   * waits for the oldest one, so at most two batches occupy the staging
+   * area. A file is copied to a temporary name and renamed, so a file
+   * under its final name is always complete.
+   */
+  namespace StagedIOEnv
+  {
+    //! Pair of staged file and its destination
+    typedef std::pair<std::string, std::string>  Move_t;
+
+    //! Can a write with volfmt be staged in staging_dir
+    /*! An empty staging_dir means no staging */
+    bool canStage(const std::string& staging_dir, QDP_volfmt_t volfmt);
+
+    //! Name of the staged copy of file
+    std::string stagedName(const std::string& staging_dir, const std::string& file);
+
+    //! Move a batch of staged files to their destinations in the background
+    void moveBatch(const std::vector<Move_t>& moves);
+
+    //! Wait until all queued files are at their destinations
+    void fence();
+
+    //! Wait for the queued files and stop the mover thread
+    /*! Called from Chroma::finalize(). A later moveBatch() starts a new thread */
+    void finalize();
+  }
+
+} //end namespace chroma
+
+#endif
@@ -39,6 +39,20 @@ namespace Chroma
       (*this)(chi,psi,isign);
     }
 
+    //! Apply the operator onto a block of source vectors
+    /*!
+     * Default implementation applies the operator to one source at a time.
+     * Operators that can share the link loads between sources override
+     * this, see DslashLinearOperator::applyBlock.
+     */
+    virtual void operator() (multi1d<T>& chi, const multi1d<T>& psi,
+			     enum PlusMinus isign) const
+    {
+      chi.resize(psi.size());
+      for(int i=0; i < psi.size(); ++i)
+	(*this)(chi[i], psi[i], isign);
+    }
+
     //! Return the subset on which the operator acts
     virtual const Subset& subset() const = 0;
 
@@ -234,6 +248,13 @@ namespace Chroma
       apply(d, psi, isign, 1);
     }
 
+    //! Apply operator on both checkerboards onto a block of sources
+    virtual void operator() (multi1d<T>& d, const multi1d<T>& psi, enum PlusMinus isign) const
+    {
+      applyBlock(d, psi, isign, 0);
+      applyBlock(d, psi, isign, 1);
+    }
+
     //! Apply checkerboarded linear operator
     /*! 
      * To avoid confusion (especially of the compilers!), call the checkerboarded
@@ -241,6 +262,18 @@ namespace Chroma
      */
     virtual void apply (T& chi, const T& psi, enum PlusMinus isign, int cb) const = 0;
 
+    //! Apply checkerboarded linear operator onto a block of sources
+    /*!
+     * Default implementation applies one source at a time. Dslashes
+     * that can share the link loads between sources override this.
+     */
+    virtual void applyBlock (multi1d<T>& chi, const multi1d<T>& psi, enum PlusMinus isign, int cb) const
+    {
+      chi.resize(psi.size());
+      for(int i=0; i < psi.size(); ++i)
+	apply(chi[i], psi[i], isign, cb);
+    }
+
 
     //! Take deriv of D
     /*!
@@ -34,6 +34,10 @@
 #include "util/gauge/expmat.h"
 #include "util/gauge/taproj.h"
 
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
 //using namespace Chroma;
 namespace Chroma
 {
@@ -231,6 +235,420 @@ namespace Chroma
   }
 
 
+  //! Default adaptive flow: Wilson kernel, fixed step
+  GradientFlowParams::GradientFlowParams()
+  {
+    kernel = "WILSON";
+    wtime = 0;
+    eps = 0.01;
+    eps_max = 0;
+    tol = 0;
+    t0_ref = 0;
+    w0_ref = 0;
+    stop_at_scale = false;
+    t_dir = Nd-1;
+  }
+
+
+  namespace
+  {
+    //! Flow kernels
+    enum FlowKernel {FLOW_WILSON, FLOW_SYMANZIK, FLOW_ZEUTHEN};
+
+    FlowKernel flowKernel(const std::string& kernel)
+    {
+      if (kernel == "WILSON")
+	return FLOW_WILSON;
+      else if (kernel == "SYMANZIK")
+	return FLOW_SYMANZIK;
+      else if (kernel == "ZEUTHEN")
+	return FLOW_ZEUTHEN;
+
+      QDPIO::cerr << __func__ << ": unknown flow kernel " << kernel << std::endl;
+      QDP_abort(1);
+      return FLOW_WILSON;
+    }
+
+
+    //! Sum of the paths from x to x+mu, weighted by the kernel
+    /*!
+     * c0 weights the plaquette staples, c1 the six rectangle staples
+     * of each plane.
+     */
+    void flowStaples(LatticeColorMatrix& C, 
+		     const multi1d<LatticeColorMatrix>& u, int mu,
+		     const Real& c0, const Real& c1)
+    {
+      LatticeColorMatrix plaq = zero;
+      LatticeColorMatrix rect = zero;
+
+      LatticeColorMatrix u_mu_pmu = shift(u[mu], FORWARD, mu);
+
+      for(int nu=0; nu < Nd; ++nu)
+      {
+	if (nu == mu)
+	  continue;
+
+	LatticeColorMatrix u_nu_pmu = shift(u[nu], FORWARD, mu);
+
+	//  x -> x+nu -> x+nu+mu -> x+mu
+	LatticeColorMatrix up = u[nu]*shift(u[mu], FORWARD, nu)*adj(u_nu_pmu);
+
+	//  x -> x-nu -> x-nu+mu -> x+mu
+	LatticeColorMatrix dn = shift(adj(u[nu])*u[mu]*u_nu_pmu, BACKWARD, nu);
+
+	plaq += up;
+	plaq += dn;
+
+	if (toBool(c1 == Real(0)))
+	  continue;
+
+	//  y -> y+nu -> y+nu+2mu -> y+2mu  and  y -> y-nu -> y-nu+2mu -> y+2mu
+	//  (the second one starting at y+nu)
+	LatticeColorMatrix two_mu = u[mu]*u_mu_pmu;
+	LatticeColorMatrix u_nu_p2mu = shift(u_nu_pmu, FORWARD, mu);
+	LatticeColorMatrix long_up = u[nu]*shift(two_mu, FORWARD, nu)*adj(u_nu_p2mu);
+	LatticeColorMatrix long_dn = shift(adj(u[nu])*two_mu*u_nu_p2mu, BACKWARD, nu);
+
+	// Rectangles long in mu, ending with a step back to x+mu
+	rect += long_up*adj(u_mu_pmu);
+	rect += long_dn*adj(u_mu_pmu);
+
+	// Rectangles long in mu, starting with a step back to x-mu
+	rect += shift(adj(u[mu])*long_up, BACKWARD, mu);
+	rect += shift(adj(u[mu])*long_dn, BACKWARD, mu);
+
+	// Rectangles long in nu
+	rect += u[nu]*shift(up, FORWARD, nu)*adj(u_nu_pmu);
+	rect += shift(adj(u[nu])*dn*u_nu_pmu, BACKWARD, nu);
+      }
+
+      C = c0*plaq + c1*rect;
+    }
+
+
+    //! Z = eps * (flow force), a traceless antihermitian field
+    void flowForce(multi1d<LatticeColorMatrix>& Z,
+		   const multi1d<LatticeColorMatrix>& u,
+		   FlowKernel kernel, const Real& eps)
+    {
+      // Tree level Symanzik coefficients, c0 + 8 c1 = 1
+      Real c0 = 1;
+      Real c1 = 0;
+      if (kernel != FLOW_WILSON)
+      {
+	c0 = Real(5)/Real(3);
+	c1 = Real(-1)/Real(12);
+      }
+
+      Z.resize(Nd);
+      for(int mu=0; mu < Nd; ++mu)
+      {
+	LatticeColorMatrix C;
+	flowStaples(C, u, mu, c0, c1);
+
+	Z[mu] = C*adj(u[mu]);
+	taproj(Z[mu]);
+	Z[mu] *= eps;
+      }
+
+      // Zeuthen flow: apply 1 + (1/12) nabla*_mu nabla_mu to the force
+      if (kernel == FLOW_ZEUTHEN)
+      {
+	for(int mu=0; mu < Nd; ++mu)
+	{
+	  LatticeColorMatrix lap = u[mu]*shift(Z[mu], FORWARD, mu)*adj(u[mu]);
+	  lap += shift(adj(u[mu])*Z[mu]*u[mu], BACKWARD, mu);
+	  lap -= Real(2)*Z[mu];
+
+	  Z[mu] += Real(1)/Real(12)*lap;
+	}
+      }
+    }
+
+
+    //! w = exp(X) w  for a traceless antihermitian X
+    void expMult(LatticeColorMatrix& w, const LatticeColorMatrix& X)
+    {
+      LatticeColorMatrix Q = timesMinusI(X);
+      LatticeColorMatrix QQ = Q*Q;
+      multi1d<LatticeComplex> f;
+      Stouting::getFs(Q, QQ, f);
+
+      LatticeColorMatrix tmp = (f[0] + f[1]*Q + f[2]*QQ)*w;
+      w = tmp;
+    }
+
+
+    //! One Runge-Kutta step of size eps
+    /*!
+     * Returns the largest link distance between the third order result
+     * and the second order companion  exp(2 Z1 - 5/4 Z0) W1, whose
+     * generators add up to 2 Z1 - Z0, or 0 if no estimate is requested.
+     */
+    double flowStep(multi1d<LatticeColorMatrix>& u, FlowKernel kernel, 
+		    const Real& eps, bool estimate)
+    {
+      multi1d<LatticeColorMatrix> Z0, Z1, Z2;
+
+      flowForce(Z0, u, kernel, eps);
+      for(int mu=0; mu < Nd; ++mu)
+	expMult(u[mu], Real(0.25)*Z0[mu]);
+
+      flowForce(Z1, u, kernel, eps);
+
+      multi1d<LatticeColorMatrix> low;
+      if (estimate)
+      {
+	low = u;
+	for(int mu=0; mu < Nd; ++mu)
+	  expMult(low[mu], Real(2)*Z1[mu] - Real(1.25)*Z0[mu]);
+      }
+
+      for(int mu=0; mu < Nd; ++mu)
+      {
+	Z0[mu] = Real(8.0/9.0)*Z1[mu] - Real(17.0/36.0)*Z0[mu];
+	expMult(u[mu], Z0[mu]);
+      }
+
+      flowForce(Z2, u, kernel, eps);
+      for(int mu=0; mu < Nd; ++mu)
+	expMult(u[mu], Real(0.75)*Z2[mu] - Z0[mu]);
+
+      if (! estimate)
+	return 0;
+
+      double dist = 0;
+      for(int mu=0; mu < Nd; ++mu)
+      {
+	LatticeColorMatrix d = u[mu] - low[mu];
+	double dmu = toDouble(globalMax(LatticeReal(real(trace(adj(d)*d)))));
+	if (dmu > dist)
+	  dist = dmu;
+      }
+
+      return std::sqrt(dist) / Nc;
+    }
+
+
+    //! Clover leaf topological charge
+    Real flowTopCharge(const multi1d<LatticeColorMatrix>& u)
+    {
+      if (Nd != 4)
+	return Real(0);
+
+      multi1d<LatticeColorMatrix> f(Nd*(Nd-1)/2);
+      mesField(f, u);
+
+      // f is ordered 01 02 03 12 13 23 and holds i*F
+      LatticeColorMatrix tmp = f[0]*f[5] - f[1]*f[4] + f[2]*f[3];
+      Double q = sum(real(trace(tmp)));
+
+      return Real(-q / (Chroma::twopi*Chroma::twopi));
+    }
+
+
+    //! Write the energy density and topological charge at flow time t
+    void flowMeasurement(XMLWriter& xml, const multi1d<LatticeColorMatrix>& u, double t,
+			 const Real& gact4i, const Real& gactij)
+    {
+      Real e = gact4i + gactij;
+      Real q = flowTopCharge(u);
+      QDPIO::cout << "GFLOW_MEAS " << t << " " << e << " " << q << std::endl;
+
+      push(xml, "elem");
+      write(xml, "flow_time", Real(t));
+      write(xml, "E", e);
+      write(xml, "gact4i", gact4i);
+      write(xml, "gactij", gactij);
+      write(xml, "Qtop", q);
+      pop(xml);
+    }
+
+
+    //! Linear interpolation of the time where y crosses y_ref
+    double crossing(double t_a, double y_a, double t_b, double y_b, double y_ref)
+    {
+      return t_a + (y_ref - y_a) * (t_b - t_a) / (y_b - y_a);
+    }
+  }
+
+
+  //! Compute the gradient flow with an adaptive step
+  void gradient_flow(XMLWriter& xml,
+		     multi1d<LatticeColorMatrix> & u,
+		     const GradientFlowParams& p)
+  {
+    START_CODE();
+
+    FlowKernel kernel = flowKernel(p.kernel);
+
+    const double wtime = toDouble(p.wtime);
+    const double tol = toDouble(p.tol);
+    const double eps_max = toDouble(p.eps_max);
+    const double t0_ref = toDouble(p.t0_ref);
+    const double w0_ref = toDouble(p.w0_ref);
+    const bool adaptive = (tol > 0);
+    const double t_eps = 1.0e-10 * (wtime > 1 ? wtime : 1);
+
+    double eps = toDouble(p.eps);
+    if (eps <= 0 || wtime <= 0)
+    {
+      QDPIO::cerr << __func__ << ": wtime and eps must be positive" << std::endl;
+      QDP_abort(1);
+    }
+
+    std::vector<double> meas_t;
+    for(int i=0; i < p.meas_times.size(); ++i)
+      meas_t.push_back(toDouble(p.meas_times[i]));
+    std::sort(meas_t.begin(), meas_t.end());
+    int next_meas = 0;
+
+    std::vector<double> t_vec, eps_vec, e_vec, t2e_vec;
+
+    // Full measurements
+    XMLBufferWriter meas_xml;
+    push(meas_xml, "Measurements");
+
+    double t = 0;
+    double t0 = -1, w0 = -1;
+    double w_prev = 0, tw_prev = 0;
+    int n_steps = 0, n_rejected = 0;
+
+    Real gactij, gact4i;
+    measure_wilson_gauge(u, gactij, gact4i, p.t_dir);
+    double e = toDouble(gact4i + gactij);
+    t_vec.push_back(t); eps_vec.push_back(0); e_vec.push_back(e); t2e_vec.push_back(0);
+
+    StopWatch swatch;
+    swatch.reset();
+    swatch.start();
+
+    QDPIO::cout << "START_ANALYZE_gflow" << std::endl; 
+    QDPIO::cout << "GFLOW time eps E t2E" << std::endl; 
+
+    while (t < wtime - t_eps)
+    {
+      // Full measurement due at the current time
+      if (next_meas < int(meas_t.size()) && meas_t[next_meas] <= t + t_eps)
+      {
+	flowMeasurement(meas_xml, u, t, gact4i, gactij);
+	++next_meas;
+	continue;
+      }
+
+      // Land exactly on the next measurement and the end of the flow
+      double h = eps;
+      bool clamped = false;
+      double t_stop = wtime;
+      if (next_meas < int(meas_t.size()) && meas_t[next_meas] < t_stop)
+	t_stop = meas_t[next_meas];
+      if (t + h > t_stop - t_eps)
+      {
+	h = t_stop - t;
+	clamped = true;
+      }
+
+      multi1d<LatticeColorMatrix> u_save;
+      if (adaptive)
+	u_save = u;
+
+      double dist = flowStep(u, kernel, Real(h), adaptive);
+
+      if (adaptive)
+      {
+	// Error of the second order companion scales as h^3
+	double fac = (dist > 0) ? 0.9 * std::pow(tol/dist, 1.0/3.0) : 2.0;
+
+	if (dist > tol)
+	{
+	  u = u_save;
+	  eps = h * std::max(fac, 0.1);
+	  ++n_rejected;
+	  continue;
+	}
+
+	double eps_new = h * std::min(fac, 2.0);
+	if (! clamped || eps_new > eps)
+	  eps = eps_new;
+	if (eps_max > 0 && eps > eps_max)
+	  eps = eps_max;
+      }
+
+      double t_prev = t, t2e_prev = t2e_vec.back();
+      t += h;
+      ++n_steps;
+
+      measure_wilson_gauge(u, gactij, gact4i, p.t_dir);
+      e = toDouble(gact4i + gactij);
+      double t2e = t*t*e;
+
+      t_vec.push_back(t); eps_vec.push_back(h); e_vec.push_back(e); t2e_vec.push_back(t2e);
+      QDPIO::cout << "GFLOW " << t << " " << h << " " << e << " " << t2e << std::endl; 
+
+      // t0 from t^2 E(t0) = t0_ref
+      if (t0_ref > 0 && t0 < 0 && t2e_prev < t0_ref && t2e >= t0_ref)
+	t0 = crossing(t_prev, t2e_prev, t, t2e, t0_ref);
+
+      // w0 from W(w0^2) = w0_ref, with W(t) = t d/dt t^2 E at the midpoint
+      double tw = 0.5 * (t + t_prev);
+      double w = tw * (t2e - t2e_prev) / h;
+      if (w0_ref > 0 && w0 < 0 && n_steps > 1 && w_prev < w0_ref && w >= w0_ref)
+	w0 = std::sqrt(crossing(tw_prev, w_prev, tw, w, w0_ref));
+      w_prev = w;
+      tw_prev = tw;
+
+      if (p.stop_at_scale && next_meas >= int(meas_t.size())
+	  && (t0_ref <= 0 || t0 > 0) && (w0_ref <= 0 || w0 > 0))
+	break;
+    }
+
+    // A measurement at the end of the flow
+    if (next_meas < int(meas_t.size()) && meas_t[next_meas] <= t + t_eps)
+    {
+      flowMeasurement(meas_xml, u, t, gact4i, gactij);
+    }
+    pop(meas_xml);
+
+    swatch.stop();
+    QDPIO::cout << "END_ANALYZE_gflow" << std::endl; 
+    QDPIO::cout << "GFLOW: " << n_steps << " steps, " << n_rejected << " rejected, t = " << t
+		<< ", time = " << swatch.getTimeInSeconds() << " secs" << std::endl;
+    if (t0 > 0)
+      QDPIO::cout << "GFLOW: t0 = " << t0 << std::endl;
+    if (w0 > 0)
+      QDPIO::cout << "GFLOW: w0 = " << w0 << std::endl;
+
+    int dim = t_vec.size();
+    multi1d<Real> t_out(dim), eps_out(dim), e_out(dim), t2e_out(dim);
+    for(int i=0; i < dim; ++i)
+    {
+      t_out[i] = t_vec[i];
+      eps_out[i] = eps_vec[i];
+      e_out[i] = e_vec[i];
+      t2e_out[i] = t2e_vec[i];
+    }
+
+    push(xml, "gradient_flow_results");
+    write(xml, "kernel", p.kernel);
+    write(xml, "n_steps", n_steps);
+    write(xml, "n_rejected", n_rejected);
+    write(xml, "gflow_time", t_out);
+    write(xml, "gflow_eps", eps_out);
+    write(xml, "gflow_E", e_out);
+    write(xml, "gflow_t2E", t2e_out);
+    if (t0 > 0)
+      write(xml, "t0", Real(t0));
+    if (w0 > 0)
+      write(xml, "w0", Real(w0));
+    xml << meas_xml;
+    pop(xml);
+
+    END_CODE();
+  }
+
+
+
 }  // end namespace Chroma
 
 
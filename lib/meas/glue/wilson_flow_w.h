@@ -25,6 +25,50 @@ namespace Chroma
 		   Real  wflow_eps, int jomit)  ;
 
 
+  //! Parameters of the adaptive gradient flow
+  /*!
+   * \ingroup glue
+   */
+  struct GradientFlowParams
+  {
+    GradientFlowParams();
+
+    std::string kernel;         /*!< WILSON, SYMANZIK or ZEUTHEN */
+    Real wtime;                 /*!< largest flow time */
+    Real eps;                   /*!< first step, or the step if tol is 0 */
+    Real eps_max;               /*!< largest step, 0 for no limit */
+    Real tol;                   /*!< largest link change of the step error */
+    Real t0_ref;                /*!< t^2 E(t) at t0, 0 to skip */
+    Real w0_ref;                /*!< t d/dt t^2 E(t) at w0^2, 0 to skip */
+    bool stop_at_scale;         /*!< stop once t0 and w0 are found */
+    multi1d<Real> meas_times;   /*!< flow times of the full measurements */
+    int t_dir;                  /*!< time direction */
+  };
+
+
+  //! Compute the gradient flow with an adaptive step
+  /*!
+   * \ingroup glue
+   *
+   * Integrates the flow with the third order Runge-Kutta scheme of
+   * Luscher. A second order scheme built from the same stages estimates
+   * the error of every step, as proposed by Fritzsch and Ramos
+   * (arXiv:1301.4388). The step is rejected if the largest link change
+   * between the two exceeds tol, and resized for the next step.
+   *
+   * The energy density is measured after every step to locate t0 and
+   * w0. At the times in meas_times, which the step lands on exactly,
+   * the clover leaf energy density and topological charge are written.
+   *
+   * \param xml    flow results     (Write)
+   * \param u      gauge field      (Modify)
+   * \param p      flow parameters  (Read)
+   */
+  void gradient_flow(XMLWriter& xml,
+		     multi1d<LatticeColorMatrix> & u,
+		     const GradientFlowParams& p);
+
+
 }  // end namespace Chroma
 
 #endif
@@ -51,6 +51,35 @@ namespace Chroma
       read(inputtop, "wtime", input.wtime);
       read(inputtop, "t_dir",input.t_dir);
 
+      input.adaptive = false;
+      input.kernel = "WILSON";
+      input.tol = 0;
+      input.eps_max = 0;
+      input.t0_ref = 0;
+      input.w0_ref = 0;
+      input.stop_at_scale = false;
+      input.meas_times.resize(0);
+
+      if (inputtop.count("Adaptive") != 0)
+      {
+	XMLReader adapttop(inputtop, "Adaptive");
+
+	input.adaptive = true;
+	if (adapttop.count("kernel") != 0)
+	  read(adapttop, "kernel", input.kernel);
+	if (adapttop.count("tol") != 0)
+	  read(adapttop, "tol", input.tol);
+	if (adapttop.count("eps_max") != 0)
+	  read(adapttop, "eps_max", input.eps_max);
+	if (adapttop.count("t0_ref") != 0)
+	  read(adapttop, "t0_ref", input.t0_ref);
+	if (adapttop.count("w0_ref") != 0)
+	  read(adapttop, "w0_ref", input.w0_ref);
+	if (adapttop.count("stop_at_scale") != 0)
+	  read(adapttop, "stop_at_scale", input.stop_at_scale);
+	if (adapttop.count("meas_times") != 0)
+	  read(adapttop, "meas_times", input.meas_times);
+      }
     }
 
     //! write output
@@ -63,6 +92,19 @@ namespace Chroma
       write(xml, "wtime", input.wtime);
       write(xml, "t_dir",input.t_dir);
 
+      if (input.adaptive)
+      {
+	push(xml, "Adaptive");
+	write(xml, "kernel", input.kernel);
+	write(xml, "tol", input.tol);
+	write(xml, "eps_max", input.eps_max);
+	write(xml, "t0_ref", input.t0_ref);
+	write(xml, "w0_ref", input.w0_ref);
+	write(xml, "stop_at_scale", input.stop_at_scale);
+	write(xml, "meas_times", input.meas_times);
+	pop(xml);
+      }
+
       pop(xml);
     }
 
@@ -238,7 +280,24 @@ namespace Chroma
       multi1d<LatticeColorMatrix> wf_u = u ; 
       Real eps  = params.param.wtime/params.param.nstep ;
 
-      wilson_flow(xml_out, wf_u, params.param.nstep,eps ,params.param.t_dir) ;
+      if (params.param.adaptive)
+      {
+	GradientFlowParams flow;
+	flow.kernel = params.param.kernel;
+	flow.wtime = params.param.wtime;
+	flow.eps = eps;
+	flow.eps_max = params.param.eps_max;
+	flow.tol = params.param.tol;
+	flow.t0_ref = params.param.t0_ref;
+	flow.w0_ref = params.param.w0_ref;
+	flow.stop_at_scale = params.param.stop_at_scale;
+	flow.meas_times = params.param.meas_times;
+	flow.t_dir = params.param.t_dir;
+
+	gradient_flow(xml_out, wf_u, flow);
+      }
+      else
+	wilson_flow(xml_out, wf_u, params.param.nstep,eps ,params.param.t_dir) ;
 
 
       // Calculate some gauge invariant observables just for info.
@@ -35,6 +35,16 @@ namespace Chroma
 	int nstep ;
 	Real  wtime ;
 	int t_dir ; // the time direction of measurements 
+
+	// Optional adaptive flow, see GradientFlowParams
+	bool adaptive ;
+	std::string kernel ;
+	Real tol ;
+	Real eps_max ;
+	Real t0_ref ;
+	Real w0_ref ;
+	bool stop_at_scale ;
+	multi1d<Real> meas_times ;
       } param;
 
       struct NamedObject_t
@@ -17,6 +17,10 @@
 #include "meas/inline/make_xml_file.h"
 
 #include "meas/inline/io/named_objmap.h"
+#include "util/ft/time_slice_comm.h"
+
+#include <complex>
+#include <algorithm>
 
 #define COLORVEC_MATELEM_TYPE_ZERO       0
 #define COLORVEC_MATELEM_TYPE_ONE        1
@@ -433,6 +437,215 @@ namespace Chroma
     } // void normalizeDisplacements
 
 
+#if QDP_NC == 3
+#ifndef QDP_IS_QDPJIT
+    //----------------------------------------------------------------------------
+    namespace
+    {
+      //! Site data packed per time slice
+      /*!
+       * Block k holds the sites of the k-th packed time slice in the order
+       * of the subset site table.
+       */
+      typedef std::vector< std::vector< std::complex<double> > > PackedSlices;
+
+      //! Pack the displaced vectors on the local time slices, vector v at (v*num_sites + s)*Nc + c of each block
+      void packDispVecs(PackedSlices& pack, DispColorVectorMap& disp_vecs,
+			const multi1d<int>& displacement, int num_vecs,
+			const Set& set, const TimeSliceComm& tcomm)
+      {
+	pack.resize(tcomm.numLocalSlices());
+	for(int k=0; k < tcomm.numLocalSlices(); ++k)
+	  pack[k].resize(num_vecs*set[tcomm.globalSlice(tcomm.myLayer(), k)].numSiteTable()*Nc);
+
+	KeyDispColorVector_t key;
+	key.displacement = displacement;
+
+	for(int v=0; v < num_vecs; ++v)
+	{
+	  key.colvec = v;
+	  LatticeColorVector vec = disp_vecs.getDispVector(key);
+
+	  for(int k=0; k < tcomm.numLocalSlices(); ++k)
+	  {
+	    const Subset& sub = set[tcomm.globalSlice(tcomm.myLayer(), k)];
+	    const int* tab = sub.siteTable().slice();
+	    const int num_sites = sub.numSiteTable();
+
+	    for(int s=0; s < num_sites; ++s)
+	    {
+	      for(int c=0; c < Nc; ++c)
+	      {
+		const RComplex<REAL>& z = vec.elem(tab[s]).elem().elem(c);
+		pack[k][(v*num_sites + s)*Nc + c] = std::complex<double>(z.real(), z.imag());
+	      }
+	    }
+	  }
+	}
+      }
+
+      //! Pack momenta mom_lo to mom_hi-1 on time slice t, at s*(mom_hi-mom_lo) + m-mom_lo
+      /*! With bounded phases each one is made on this slice only */
+      void packPhases(std::vector< std::complex<double> >& pack, const SftMom& phases,
+		      int mom_lo, int mom_hi, int t)
+      {
+	const Subset& sub = phases.getSet()[t];
+	const int* tab = sub.siteTable().slice();
+	const int num_sites = sub.numSiteTable();
+	const int num_mom = mom_hi - mom_lo;
+	pack.resize(num_sites*num_mom);
+
+	LatticeComplex tmp;
+	for(int m=0; m < num_mom; ++m)
+	{
+	  const LatticeComplex& phase = phases.slicePhase(tmp, mom_lo + m, t);
+
+	  for(int s=0; s < num_sites; ++s)
+	  {
+	    const RComplex<REAL>& z = phase.elem(tab[s]).elem().elem();
+	    pack[s*num_mom + m] = std::complex<double>(z.real(), z.imag());
+	  }
+	}
+      }
+
+
+      //! Arguments of the baryon elemental contraction
+      struct BaryonContractArgs
+      {
+	const PackedSlices&                  left;       /*!< local time slices */
+	const PackedSlices&                  middle;     /*!< local time slices */
+	const PackedSlices&                  right;      /*!< local time slices */
+	const std::vector< std::complex<double> >& phase; /*!< phases of slice t */
+	const std::vector<int>&              trip_index; /*!< position of (i,j,k) in a chunk, -1 if not computed */
+	int                                  n_trip;
+	bool                                 antisymP;   /*!< only i < j < k */
+	int                                  num_vecs;
+	int                                  num_mom;    /*!< momenta in phase */
+	int                                  t;          /*!< local time slice */
+	int                                  kc;         /*!< its index in the chunk */
+	std::vector< std::complex<double> >& op;
+      };
+
+      //! All (j,k) of one left vector i on a time slice
+      void baryonContractLoop(int lo, int hi, int myId, BaryonContractArgs* a)
+      {
+	const int nv = a->num_vecs;
+	const int nm = a->num_mom;
+	const int t  = a->t;
+	const int kc = a->kc;
+	std::vector< std::complex<double> > acc(nm);
+
+	const int num_sites = a->phase.size() / nm;
+	const std::complex<double>* ph = &a->phase[0];
+	std::vector< std::complex<double> > x(num_sites*Nc);
+
+	for(int r=lo; r < hi; ++r)
+	{
+	  // Alternate heavy and light rows, the antisymmetric rows shrink with i
+	  const int i = (r % 2 == 0) ? r/2 : nv-1-r/2;
+
+	  const std::complex<double>* av = &a->left[t][i*num_sites*Nc];
+
+	  for(int j = (a->antisymP ? i+1 : 0); j < nv; ++j)
+	  {
+	    // eps_{abc} a^a b^b over the time slice, kept in cache for all k
+	    const std::complex<double>* bv = &a->middle[t][j*num_sites*Nc];
+	    for(int s=0; s < num_sites; ++s)
+	    {
+	      const std::complex<double>* as = av + s*Nc;
+	      const std::complex<double>* bs = bv + s*Nc;
+	      x[s*Nc + 0] = as[1]*bs[2] - as[2]*bs[1];
+	      x[s*Nc + 1] = as[2]*bs[0] - as[0]*bs[2];
+	      x[s*Nc + 2] = as[0]*bs[1] - as[1]*bs[0];
+	    }
+
+	    for(int k = (a->antisymP ? j+1 : 0); k < nv; ++k)
+	    {
+	      const std::complex<double>* cv = &a->right[t][k*num_sites*Nc];
+
+	      for(int m=0; m < nm; ++m)
+		acc[m] = 0;
+
+	      for(int s=0; s < num_sites; ++s)
+	      {
+		std::complex<double> d = x[s*Nc + 0]*cv[s*Nc + 0] 
+		  + x[s*Nc + 1]*cv[s*Nc + 1] 
+		  + x[s*Nc + 2]*cv[s*Nc + 2];
+
+		const std::complex<double>* ph_s = ph + s*nm;
+		for(int m=0; m < nm; ++m)
+		  acc[m] += ph_s[m] * d;
+	      }
+
+	      const int ijk = a->trip_index[(i*nv + j)*nv + k];
+	      for(int m=0; m < nm; ++m)
+		a->op[(size_t(kc)*nm + m)*a->n_trip + ijk] = acc[m];
+	    }
+	  }
+	}
+      }
+
+
+      //! Baryon elementals of a chunk of local time slices and momenta
+      /*!
+       * op[(kc*num_mom + m)*n_trip + trip_index[(i*nv + j)*nv + k]] is
+       * sum_x eps_{abc} left_i^a(x) middle_j^b(x) right_k^c(x) phase_m(x) over
+       * local time slice k_lo + kc and momentum mom_lo + m. The phases are
+       * packed one slice at a time. The slices are only summed over the
+       * nodes of the layer that holds them.
+       */
+      void contractBaryon(std::vector< std::complex<double> >& op,
+			  const PackedSlices& left,
+			  const PackedSlices& middle,
+			  const PackedSlices& right,
+			  const SftMom& phases,
+			  const TimeSliceComm& tcomm,
+			  const std::vector<int>& trip_index, int n_trip, bool antisymP,
+			  int num_vecs, int mom_lo, int mom_hi, int k_lo, int k_hi)
+      {
+	const int n_chunk = k_hi - k_lo;
+	const int num_mom = mom_hi - mom_lo;
+	op.assign(size_t(n_chunk)*num_mom*n_trip, std::complex<double>(0));
+
+	std::vector< std::complex<double> > phase;
+	for(int kc=0; kc < n_chunk; ++kc)
+	{
+	  const int t = k_lo + kc;
+	  packPhases(phase, phases, mom_lo, mom_hi, tcomm.globalSlice(tcomm.myLayer(), t));
+
+	  BaryonContractArgs args = {left, middle, right, phase, trip_index, n_trip, antisymP,
+				     num_vecs, num_mom, t, kc, op};
+	  dispatch_to_threads(num_vecs, args, baryonContractLoop);
+	}
+
+	if (op.size() > 0)
+	  tcomm.sumArray(reinterpret_cast<double*>(&op[0]), 2*op.size());
+      }
+
+
+      //! Element (i,j,k) of a contracted chunk, from i < j < k by antisymmetry if antisymP
+      std::complex<double> getTriple(const std::complex<double>* op, const std::vector<int>& trip_index,
+				     bool antisymP, int nv, int i, int j, int k)
+      {
+	if (! antisymP)
+	  return op[trip_index[(i*nv + j)*nv + k]];
+
+	if (i == j || j == k || i == k)
+	  return std::complex<double>(0);
+
+	// Sort, each swap is odd
+	double sign = 1;
+	if (i > j) {std::swap(i,j); sign = -sign;}
+	if (j > k) {std::swap(j,k); sign = -sign;}
+	if (i > j) {std::swap(i,j); sign = -sign;}
+
+	return sign * op[trip_index[(i*nv + j)*nv + k]];
+      }
+    }
+#endif
+#endif
+
+
     //-------------------------------------------------------------------------------
     // Function call
     void 
@@ -623,6 +836,13 @@ namespace Chroma
       // Loop over all time slices for the source. This is the same 
       // as the subsets for  phases
 
+#ifndef QDP_IS_QDPJIT
+      // The nodes holding the same time slices
+      TimeSliceComm tcomm(params.param.decay_dir);
+
+      const int nv = params.param.num_vecs;
+#endif
+
       // Loop over each operator 
       for(int l=0; l < displacement_list.size(); ++l)
       {
@@ -636,6 +856,106 @@ namespace Chroma
 	swiss.reset();
 	swiss.start();
 
+#ifndef QDP_IS_QDPJIT
+	// Pack the displaced vectors once for all momenta, equal displacements share
+	multi1d< multi1d<int> > disps(3);
+	disps[0] = displacement_list[l].left;
+	disps[1] = displacement_list[l].middle;
+	disps[2] = displacement_list[l].right;
+
+	PackedSlices packed[3];
+	const PackedSlices* disp_vecs[3];
+	for(int q=0; q < 3; ++q)
+	{
+	  disp_vecs[q] = &packed[q];
+	  for(int p=0; p < q; ++p)
+	  {
+	    if (disps[p] == disps[q]) {disp_vecs[q] = disp_vecs[p]; break;}
+	  }
+
+	  if (disp_vecs[q] == &packed[q])
+	    packDispVecs(packed[q], smrd_disp_vecs, disps[q], nv, phases.getSet(), tcomm);
+	}
+
+	// The same displacements make the elementals totally antisymmetric
+	const bool antisymP = (disp_vecs[0] == disp_vecs[1] && disp_vecs[1] == disp_vecs[2]);
+
+	std::vector<int> trip_index(nv*nv*nv, -1);
+	int n_trip = 0;
+	for(int i = 0 ; i < nv; ++i)
+	  for(int j = (antisymP ? i+1 : 0); j < nv; ++j)
+	    for(int k = (antisymP ? j+1 : 0); k < nv; ++k)
+	      trip_index[(i*nv + j)*nv + k] = n_trip++;
+
+	// Chunks of local time slices with all momenta, so that a contraction
+	// stays below 1 GB. Momenta are only split if a single slice is larger
+	const size_t chunk_bytes = size_t(1) << 30;
+	const size_t trip_bytes = std::max(size_t(1), size_t(n_trip)*sizeof(std::complex<double>));
+	const size_t slice_bytes = size_t(phases.numMom())*trip_bytes;
+	int slice_chunk = 1;
+	int mom_block = phases.numMom();
+	if (slice_bytes <= chunk_bytes)
+	  slice_chunk = std::min(size_t(tcomm.numLocalSlices()), chunk_bytes / slice_bytes);
+	else
+	  mom_block = std::max(size_t(1), chunk_bytes / trip_bytes);
+
+	for(int k_lo = 0; k_lo < tcomm.numLocalSlices(); k_lo += slice_chunk)
+	{
+	  const int k_hi = std::min(k_lo + slice_chunk, tcomm.numLocalSlices());
+
+	  for(int mom_lo = 0; mom_lo < phases.numMom(); mom_lo += mom_block)
+	  {
+	    const int mom_hi = std::min(mom_lo + mom_block, phases.numMom());
+	    const int nm = mom_hi - mom_lo;
+
+	    std::vector< std::complex<double> > op_chunk;
+	    contractBaryon(op_chunk, *disp_vecs[0], *disp_vecs[1], *disp_vecs[2], phases, tcomm,
+			   trip_index, n_trip, antisymP, nv, mom_lo, mom_hi, k_lo, k_hi);
+
+	    // The primary node writes the chunk of every layer in turn
+	    for(int layer = 0; layer < tcomm.numLayers(); ++layer)
+	    {
+	      if (op_chunk.size() > 0)
+		tcomm.toPrimary(reinterpret_cast<double*>(&op_chunk[0]), 2*op_chunk.size(), layer);
+
+	      for(int kc = 0; kc < k_hi - k_lo; ++kc)
+	      {
+		for(int m = 0; m < nm; ++m)
+		{
+		  KeyValBaryonElementalOperator_t buf;
+		  buf.key.key().t_slice       = tcomm.globalSlice(layer, k_lo + kc);
+		  buf.key.key().left          = displacement_list[l].left;
+		  buf.key.key().middle        = displacement_list[l].middle;
+		  buf.key.key().right         = displacement_list[l].right;
+		  buf.key.key().mom           = phases.numToMom(mom_lo + m);
+		  buf.val.data().op.resize(nv,nv,nv);
+		  buf.val.data().type_of_data = COLORVEC_MATELEM_TYPE_GENERIC;
+
+		  // Empty if all elementals vanish by antisymmetry
+		  const std::complex<double>* op = (n_trip > 0) ? &op_chunk[(size_t(kc)*nm + m)*n_trip] : 0;
+
+		  for(int i = 0 ; i < nv; ++i)
+		  {
+		    for(int j = 0 ; j < nv; ++j)
+		    {
+		      for(int k = 0 ; k < nv; ++k)
+		      {
+			std::complex<double> z = getTriple(op, trip_index, antisymP, nv, i, j, k);
+			buf.val.data().op(i,j,k) = cmplx(Double(z.real()), Double(z.imag()));
+		      }
+		    }
+		  }
+
+		  qdp_db.insert(buf.key, buf.val);
+		}
+	      }
+	    }
+	  }
+
+	  QDPIO::cout << "insert: time slices " << k_lo << " to " << k_hi-1 
+		      << " of each layer, all momenta, displacement num= " << l << std::endl; 
+	}
+#else
 	// Big loop over the momentum projection
 	for(int mom_num = 0 ; mom_num < phases.numMom() ; ++mom_num) 
 	{
@@ -656,7 +976,6 @@ namespace Chroma
 	    buf[t].val.data().type_of_data = COLORVEC_MATELEM_TYPE_GENERIC;
 	  }
 
-
 	  // The keys for the spin and displacements for this particular elemental operator
 	  multi1d<KeyDispColorVector_t> keyDispColorVector(3);
 
@@ -705,6 +1024,7 @@ namespace Chroma
 	  }
 
 	} // mom_num
+#endif
 	swiss.stop();
 
 	QDPIO::cout << "Baryon operator= " << l 
@@ -42,6 +42,8 @@
 #include "actions/ferm/fermacts/clover_fermact_params_w.h"
 #include "actions/ferm/fermacts/wilson_fermact_params_w.h"
 #include "actions/ferm/linop/linop_w.h"
+#include "actions/ferm/invert/deflation_space.h"
+#include "lmdagm.h"
 
 #include "util/ferm/key_val_db.h"
 
@@ -145,6 +147,17 @@ namespace Chroma{
 	input.evecs_file="";
 	
       read(inputtop, "op_db_file" , input.op_db_file ) ;
+
+      // A deflation space shared with the DEFLATED_INVERTER solves
+      input.use_space = (inputtop.count("DeflationSpace") != 0);
+      if (input.use_space)
+	read(inputtop, "DeflationSpace", input.space);
+
+      if (input.use_space && input.evecs_file != "")
+      {
+	QDPIO::cerr << name << ": give either evecs_file or DeflationSpace, not both" << std::endl;
+	QDP_abort(1);
+      }
     }
     
     //! Gauge field parameters
@@ -154,6 +167,8 @@ namespace Chroma{
       write(xml, "gauge_id"   , input.gauge_id   );
       write(xml, "evecs_file" , input.evecs_file );
       write(xml, "op_db_file" , input.op_db_file );
+      if (input.use_space)
+	write(xml, "DeflationSpace", input.space);
       pop(xml);
     }
     
@@ -161,6 +176,7 @@ namespace Chroma{
     // Param stuff
     Params::Params(){ 
       frequency = 0;
+      named_obj.use_space = false;
     }
     
     Params::Params(XMLReader& xml_in, const std::string& path) 
@@ -648,6 +664,48 @@ namespace Chroma{
 		 << swatch.getTimeInSeconds() <<" secs "<<std::endl ;
     }
 
+    //! Take the vectors from a shared deflation space
+    /*!
+     * The space is refined with the operator of this configuration, so
+     * the vectors carry over from the previous configurations instead of
+     * being rebuilt. The Ritz vectors diagonalise H = V^dag S^dag S V,
+     * its Cholesky factor is diagonal with the square roots of the
+     * Ritz values.
+     */
+    void GetDeflationSpaceVecs(multi1d<LatticeFermion>& vec,
+			       CholeskyFactors& Clsk,
+			       const DeflationSpaceParams& space_params,
+			       Handle<EvenOddPrecLinearOperator<T,P,Q> > Doo)
+    {
+      Handle<DeflationSpace> space = DeflationSpaceEnv::getSpace(space_params);
+
+      MdagMLinOp<T> MdagM(Doo.cast< LinearOperator<T> >());
+      space->refine(MdagM);
+
+      if (space_params.file.write && space->dirty())
+	space->writeDisk(space_params.file.file_name);
+
+      int Nvecs = space->size();
+      Clsk.Nvec = Nvecs;
+      Clsk.ldh = Nvecs;
+      vec.resize(Nvecs);
+      Clsk.evals.resize(Nvecs);
+      Clsk.H.resize(Nvecs*Nvecs);
+      Clsk.HU.resize(Nvecs*Nvecs);
+      Clsk.H = zero;
+      Clsk.HU = zero;
+
+      for(int v(0);v<Nvecs;v++){
+	vec[v] = space->vector(v);
+	Clsk.evals[v] = space->value(v);
+	Clsk.H[v*Nvecs+v]  = cmplx(Real(space->value(v)), Real(0));
+	Clsk.HU[v*Nvecs+v] = cmplx(Real(sqrt(space->value(v))), Real(0));
+      }
+
+      QDPIO::cout<<name<<" : "<<Nvecs<<" vectors from deflation space "
+		 <<space_params.space_id<<std::endl ;
+    }
+
     // PRchi returns chitilde = (1 - V Hinv Vdag Sdag S)chi given
     // an input chi std::vector, and of course the vectors and H. 
     void PRchi(multi1d<multi1d< multi1d<LatticeFermion> > >& quarkstilde,
@@ -906,11 +964,14 @@ namespace Chroma{
       // Instantiate the Dirac operator:
       Handle<EvenOddPrecLinearOperator<T,P,Q> > Doo=createOddOdd_Op(params.param,u);
 
-      //Now read evecs from disk, if file is specified.
+      //Now read evecs from disk, if file is specified, or take them
+      //from a deflation space
       multi1d<LatticeFermion> vec; // the vectors
       CholeskyFactors Clsk; // the Cholesky Factors 
       if (params.named_obj.evecs_file!="")
 	ReadOPTEigCGVecs(vec,Clsk,params.named_obj.evecs_file);
+      else if (params.named_obj.use_space)
+	GetDeflationSpaceVecs(vec,Clsk,params.named_obj.space,Doo);
       
       std::map< KeyOperator_t, ValOperator_t > data ;
       
@@ -925,8 +986,8 @@ namespace Chroma{
       /*** Everything is initialized, now to the real code ***/
       
       // chitilde = P_R S^-1 \eta_o
-      // If there is no evecs file, then PR = 1
-      if (params.named_obj.evecs_file!="")
+      // If there are no vectors, then PR = 1
+      if (vec.size() > 0)
 	PRchi(quarkstilde, quarks, Doo, Clsk, vec, params.param, u);
       else
 	PRchi(quarkstilde, quarks);
@@ -972,7 +1033,7 @@ namespace Chroma{
       // Note using just timeslices for quarks[0]...may be a problem
       // if quarks dilute on diff timeslices...
       
-      if (params.named_obj.evecs_file!=""){// Only if we have vectors...
+      if (vec.size() > 0){// Only if we have vectors...
 	for (int it(0) ; it < quarks[0]->getNumTimeSlices() ; it++){
 	  multi1d<short int> d ;
 	  int t = quarks[0]->getT0(it) ;
@@ -14,6 +14,7 @@
 #include "meas/inline/abs_inline_measurement.h"
 #include "io/qprop_io.h"
 #include "meas/hadron/barQll_w.h"
+#include "actions/ferm/invert/syssolver_deflated_params.h"
 
 //#include <map>
 
@@ -49,6 +50,8 @@ namespace Chroma
 	std::string         gauge_id    ;
 	std::string         evecs_file  ;
 	std::string         op_db_file  ;
+	bool                use_space   ; /*! take the vectors from a deflation space instead of evecs_file */
+	DeflationSpaceParams space      ;
       } named_obj;
       
       std::string xml_file;  // Alternate XML file pattern
@@ -18,6 +18,10 @@
 #include "meas/inline/make_xml_file.h"
 
 #include "meas/inline/io/named_objmap.h"
+#include "util/ft/time_slice_comm.h"
+
+#include <complex>
+#include <algorithm>
 
 #define COLORVEC_MATELEM_TYPE_ZERO       0
 #define COLORVEC_MATELEM_TYPE_ONE        1
@@ -368,6 +372,158 @@ namespace Chroma
     } // void normDisp
 
 
+#ifndef QDP_IS_QDPJIT
+    //----------------------------------------------------------------------------
+    namespace
+    {
+      //! Site data packed per time slice
+      /*!
+       * Block k holds the sites of the k-th packed time slice in the order
+       * of the subset site table.
+       */
+      typedef std::vector< std::vector< std::complex<double> > > PackedSlices;
+
+      //! Pack color vector i of num_vecs on the local time slices, at (i*num_sites + s)*Nc + c of each block
+      void packVec(PackedSlices& pack, const LatticeColorVector& vec, int i, int num_vecs,
+		   const Set& set, const TimeSliceComm& tcomm)
+      {
+	pack.resize(tcomm.numLocalSlices());
+
+	for(int k=0; k < tcomm.numLocalSlices(); ++k)
+	{
+	  const Subset& sub = set[tcomm.globalSlice(tcomm.myLayer(), k)];
+	  const int* tab = sub.siteTable().slice();
+	  const int num_sites = sub.numSiteTable();
+
+	  std::vector< std::complex<double> >& block = pack[k];
+	  block.resize(num_vecs*num_sites*Nc);
+
+	  for(int s=0; s < num_sites; ++s)
+	  {
+	    for(int c=0; c < Nc; ++c)
+	    {
+	      const RComplex<REAL>& z = vec.elem(tab[s]).elem().elem(c);
+	      block[(i*num_sites + s)*Nc + c] = std::complex<double>(z.real(), z.imag());
+	    }
+	  }
+	}
+      }
+
+      //! Pack the phases of a list of momenta on time slice t, at s*mom_nums.size() + m
+      /*! With bounded phases each one is made on this slice only */
+      void packPhases(std::vector< std::complex<double> >& pack, const SftMom& phases,
+		      const std::vector<int>& mom_nums, int t)
+      {
+	const Subset& sub = phases.getSet()[t];
+	const int* tab = sub.siteTable().slice();
+	const int num_sites = sub.numSiteTable();
+	const int num_mom = mom_nums.size();
+	pack.resize(num_sites*num_mom);
+
+	LatticeComplex tmp;
+	for(int m=0; m < num_mom; ++m)
+	{
+	  const LatticeComplex& phase = phases.slicePhase(tmp, mom_nums[m], t);
+
+	  for(int s=0; s < num_sites; ++s)
+	  {
+	    const RComplex<REAL>& z = phase.elem(tab[s]).elem().elem();
+	    pack[s*num_mom + m] = std::complex<double>(z.real(), z.imag());
+	  }
+	}
+      }
+
+
+      //! Arguments of the elemental contraction
+      struct MatElemContractArgs
+      {
+	const PackedSlices&                        left;       /*!< local time slices */
+	const PackedSlices&                        right;      /*!< local time slices */
+	const std::vector< std::complex<double> >& phase;      /*!< phases of slice k */
+	int                                        k;          /*!< local time slice */
+	int                                        kc;         /*!< its index in the chunk */
+	int                                        num_vecs;
+	int                                        num_mom;
+	std::vector< std::complex<double> >&       op;
+      };
+
+      //! Row i of all elementals of a time slice, for all momenta
+      void matElemContractLoop(int lo, int hi, int myId, MatElemContractArgs* a)
+      {
+	const int nv = a->num_vecs;
+	const int nm = a->num_mom;
+	const int kc = a->kc;
+	std::vector< std::complex<double> > acc(nm);
+
+	const int num_sites = a->phase.size() / nm;
+	const std::complex<double>* ph = &a->phase[0];
+
+	for(int i=lo; i < hi; ++i)
+	{
+	  const std::complex<double>* l = &a->left[a->k][i*num_sites*Nc];
+
+	  for(int j=0; j < nv; ++j)
+	  {
+	    const std::complex<double>* r = &a->right[a->k][j*num_sites*Nc];
+
+	    for(int m=0; m < nm; ++m)
+	      acc[m] = 0;
+
+	    for(int s=0; s < num_sites; ++s)
+	    {
+	      // Color inner product of the pair, then all momenta
+	      std::complex<double> d = 0;
+	      for(int c=0; c < Nc; ++c)
+		d += std::conj(l[s*Nc + c]) * r[s*Nc + c];
+
+	      const std::complex<double>* ph_s = ph + s*nm;
+	      for(int m=0; m < nm; ++m)
+		acc[m] += ph_s[m] * d;
+	    }
+
+	    for(int m=0; m < nm; ++m)
+	      a->op[((kc*nm + m)*nv + i)*nv + j] = acc[m];
+	  }
+	}
+      }
+
+
+      //! Elementals of all vector pairs and momenta on a chunk of local time slices
+      /*!
+       * op[((kc*num_mom + m)*num_vecs + i)*num_vecs + j] is
+       * sum_x conj(left_i(x)) phase_m(x) right_j(x) over local time slice
+       * k_lo + kc. The phases are packed one slice at a time. The slices
+       * are only summed over the nodes of the layer that holds them.
+       */
+      void contractMatElem(std::vector< std::complex<double> >& op,
+			   const PackedSlices& left,
+			   const PackedSlices& right,
+			   const SftMom& phases,
+			   const std::vector<int>& mom_nums,
+			   const TimeSliceComm& tcomm,
+			   int k_lo, int k_hi, int num_vecs)
+      {
+	const int n_chunk = k_hi - k_lo;
+	const int num_mom = mom_nums.size();
+	op.assign(n_chunk*num_mom*num_vecs*num_vecs, std::complex<double>(0));
+
+	std::vector< std::complex<double> > phase;
+	for(int kc=0; kc < n_chunk; ++kc)
+	{
+	  const int k = k_lo + kc;
+	  packPhases(phase, phases, mom_nums, tcomm.globalSlice(tcomm.myLayer(), k));
+
+	  MatElemContractArgs args = {left, right, phase, k, kc, num_vecs, num_mom, op};
+	  dispatch_to_threads(num_vecs, args, matElemContractLoop);
+	}
+
+	if (op.size() > 0)
+	  tcomm.sumArray(reinterpret_cast<double*>(&op[0]), 2*op.size());
+      }
+    }
+#endif
+
+
     //-------------------------------------------------------------------------------
     // Function call
     void 
@@ -568,6 +724,32 @@ namespace Chroma
       // Loop over all time slices for the source. This is the same 
       // as the subsets for  phases
 
+#ifndef QDP_IS_QDPJIT
+      // The momenta used
+      std::vector<int> mom_nums;
+      for(int mom_num = 0 ; mom_num < phases.numMom() ; ++mom_num) 
+      {
+	if ( norm2(phases.numToMom(mom_num)) < params.param.mom2_min ) continue;
+
+	mom_nums.push_back(mom_num);
+      }
+
+      // The nodes holding the same time slices
+      TimeSliceComm tcomm(params.param.decay_dir);
+
+      // The left vectors are never displaced
+      PackedSlices left_vecs;
+      for(int i = 0 ; i < params.param.num_vecs; ++i)
+      {
+	EVPair<LatticeColorVector> tmpvec; eigen_source.get(i,tmpvec);
+	packVec(left_vecs, tmpvec.eigenVector, i, params.param.num_vecs, phases.getSet(), tcomm);
+      }
+
+      // Local time slices per contraction, so that its result stays below 1 GB
+      const size_t slice_bytes = std::max(size_t(1), mom_nums.size()*params.param.num_vecs*params.param.num_vecs*sizeof(std::complex<double>));
+      const int slice_chunk = std::min(size_t(tcomm.numLocalSlices()), std::max(size_t(1), (size_t(1) << 30) / slice_bytes));
+#endif
+
       // Loop over each operator 
       for(int l=0; l < params.param.displacement_list.size(); ++l)
       {
@@ -584,6 +766,77 @@ namespace Chroma
 	swiss.reset();
 	swiss.start();
 
+#ifndef QDP_IS_QDPJIT
+	// Displace each right vector once for all momenta
+	PackedSlices right_vecs;
+	for(int j = 0 ; j < params.param.num_vecs; ++j)
+	{
+	  EVPair<LatticeColorVector> tmpvec; eigen_source.get(j,tmpvec);
+	  LatticeColorVector shift_vec = displace(u_smr, 
+						  tmpvec.eigenVector, 
+						  params.param.displacement_length, 
+						  disp);
+
+	  packVec(right_vecs, shift_vec, j, params.param.num_vecs, phases.getSet(), tcomm);
+	}
+
+	// All momenta of a chunk of local time slices at once
+	const int nm = mom_nums.size();
+	const int nv = params.param.num_vecs;
+	for(int k_lo = 0; k_lo < tcomm.numLocalSlices(); k_lo += slice_chunk)
+	{
+	  const int k_hi = std::min(k_lo + slice_chunk, tcomm.numLocalSlices());
+
+	  std::vector< std::complex<double> > op;
+	  contractMatElem(op, left_vecs, right_vecs, phases, mom_nums, tcomm, k_lo, k_hi, nv);
+
+	  // The primary node writes the chunk of every layer in turn
+	  for(int layer = 0; layer < tcomm.numLayers(); ++layer)
+	  {
+	    if (op.size() > 0)
+	      tcomm.toPrimary(reinterpret_cast<double*>(&op[0]), 2*op.size(), layer);
+
+	    for(int kc = 0; kc < k_hi - k_lo; ++kc)
+	    {
+	      for(int m = 0; m < nm; ++m)
+	      {
+		const int mom_num = mom_nums[m];
+
+		KeyValMesonElementalOperator_t buf;
+		buf.key.key().t_slice       = tcomm.globalSlice(layer, k_lo + kc);
+		buf.key.key().mom           = phases.numToMom(mom_num);
+		buf.key.key().displacement  = disp; // only right colorstd::vector
+		buf.val.data().op.resize(nv, nv);
+
+		if ( params.param.orthog_basis && 
+		     (phases.numToMom(mom_num)) == zero_mom && 
+		     (disp == no_displacement) )
+		{
+		  buf.val.data().type_of_data = COLORVEC_MATELEM_TYPE_ONE;
+		}
+		else
+		{
+		  buf.val.data().type_of_data = COLORVEC_MATELEM_TYPE_GENERIC;
+		}
+
+		for(int i = 0 ; i < nv; ++i)
+		{
+		  for(int j = 0 ; j < nv; ++j)
+		  {
+		    const std::complex<double>& z = op[((kc*nm + m)*nv + i)*nv + j];
+		    buf.val.data().op(i,j) = cmplx(Double(z.real()), Double(z.imag()));
+		  }
+		}
+
+		qdp_db.insert(buf.key, buf.val);
+	      }
+	    }
+	  }
+
+	  QDPIO::cout << "insert: time slices " << k_lo << " to " << k_hi-1 
+		      << " of each layer, all momenta, displacement= " << disp << std::endl; 
+	}
+#else
 	// Big loop over the momentum projection
 	for(int mom_num = 0 ; mom_num < phases.numMom() ; ++mom_num) 
 	{
@@ -652,6 +905,7 @@ namespace Chroma
 	  }
 
 	} // mom_num
+#endif
 
 	swiss.stop();
 
@@ -33,6 +33,9 @@
 
 #include "meas/inline/io/named_objmap.h"
 
+#include <complex>
+#include <map>
+
 #ifndef QDP_IS_QDPJIT
 
 namespace Chroma 
@@ -197,6 +200,10 @@ namespace Chroma
 	//! The set to be used in sumMulti
 	const Set& getSet() const {return time_slice_set.getSet();}
 
+	//! The first num_vecs vectors on the node-local sites of a time slice
+	/*! Vector v, site j and color c are at (v*num_sites + j)*Nc + c */
+	const std::vector< std::complex<float> >& getPacked(int t_slice, int num_vecs) const;
+
       private:
 	//! Eigenvectors
 	MODS_t& eigen_source;
@@ -207,6 +214,9 @@ namespace Chroma
       private:
 	//! Where we store the sublattice versions
 	mutable SUB_MOD_t sub_eigen;
+
+	//! Packed versions for the perambulator contraction
+	mutable std::map< int, std::vector< std::complex<float> > > packed_eigen;
       };
     
 
@@ -234,6 +244,138 @@ namespace Chroma
       }
 
 
+      //----------------------------------------------------------------------------
+      //! Packed vectors of a time slice
+      const std::vector< std::complex<float> >& SubEigenMap::getPacked(int t_slice, int num_vecs) const
+      {
+	// A node without sites on the slice packs an empty vector, which
+	// must not be taken for a missing one
+	std::map< int, std::vector< std::complex<float> > >::const_iterator p = packed_eigen.find(t_slice);
+	if (p != packed_eigen.end())
+	  return p->second;
+
+	std::vector< std::complex<float> >& pack = packed_eigen[t_slice];
+
+	const int num_sites = getSet()[t_slice].numSiteTable();
+	pack.resize(num_vecs*num_sites*Nc);
+
+	// The sublattice vectors hold the sites in the order of the site table
+	for(int v=0; v < num_vecs; ++v)
+	{
+	  const SubLatticeColorVectorF& vec = getVec(t_slice, v);
+
+	  for(int j=0; j < num_sites; ++j)
+	  {
+	    for(int c=0; c < Nc; ++c)
+	    {
+	      const RComplex<REAL32>& z = vec.elem(j).elem().elem(c);
+	      pack[(v*num_sites + j)*Nc + c] = std::complex<float>(z.real(), z.imag());
+	    }
+	  }
+	}
+
+	return pack;
+      }
+
+
+      //----------------------------------------------------------------------------
+      //! Arguments of the perambulator contraction
+      struct PeramContractArgs
+      {
+	const std::vector<const std::vector< std::complex<float> >*>& evecs;   /*!< packed vectors per sink time slice */
+	const std::vector< std::vector< std::complex<double> > >&     solns;   /*!< solution per sink time slice, [site*Nc+color][spin] */
+	int                                                           num_vecs;
+	std::vector< std::complex<double> >&                          peram;   /*!< [t][colorvec_sink][spin_sink] */
+      };
+
+      //! One row block of the contraction, peram_t = evecs_t^dag * solns_t
+      void peramContractLoop(int lo, int hi, int myId, PeramContractArgs* a)
+      {
+	for(int n=lo; n < hi; ++n)
+	{
+	  const int it = n / a->num_vecs;
+	  const int v  = n % a->num_vecs;
+
+	  const std::vector< std::complex<double> >& soln = a->solns[it];
+	  const int nk = soln.size() / Ns;
+
+	  std::complex<double> r[Ns];
+	  for(int s=0; s < Ns; ++s)
+	    r[s] = 0;
+
+	  if (nk > 0)
+	  {
+	    const std::complex<float>*  e = &(*a->evecs[it])[v*nk];
+	    const std::complex<double>* q = &soln[0];
+
+	    for(int k=0; k < nk; ++k)
+	    {
+	      std::complex<double> ce(e[k].real(), -e[k].imag());
+	      for(int s=0; s < Ns; ++s)
+		r[s] += ce * q[k*Ns + s];
+	    }
+	  }
+
+	  for(int s=0; s < Ns; ++s)
+	    a->peram[n*Ns + s] = r[s];
+	}
+      }
+
+
+      //----------------------------------------------------------------------------
+      //! Perambulator elements of one solution on a list of sink time slices
+      /*!
+       * peram[(it*num_vecs + colorvec_sink)*Ns + spin_sink] is the inner product of
+       * the sink vector on t_slices[it] with spin component spin_sink of the solution.
+       *
+       * The vectors and the solution are packed into node-local blocks and
+       * multiplied as one complex matrix product per time slice, Nc*sites x num_vecs
+       * times Nc*sites x Ns. There is a single global sum for all elements.
+       */
+      void contractPeram(std::vector< std::complex<double> >& peram,
+			 const SubEigenMap& sub_eigen_map,
+			 const std::vector<int>& t_slices,
+			 int num_vecs,
+			 const LatticeFermion& quark_soln)
+      {
+	const int n_t = t_slices.size();
+	peram.assign(n_t*num_vecs*Ns, std::complex<double>(0));
+
+	std::vector<const std::vector< std::complex<float> >*> evecs(n_t);
+	std::vector< std::vector< std::complex<double> > > solns(n_t);
+
+	for(int it=0; it < n_t; ++it)
+	{
+	  evecs[it] = &sub_eigen_map.getPacked(t_slices[it], num_vecs);
+
+	  const Subset& sub = sub_eigen_map.getSet()[t_slices[it]];
+	  const int* tab = sub.siteTable().slice();
+	  const int num_sites = sub.numSiteTable();
+
+	  std::vector< std::complex<double> >& soln = solns[it];
+	  soln.resize(num_sites*Nc*Ns);
+
+	  for(int j=0; j < num_sites; ++j)
+	  {
+	    for(int c=0; c < Nc; ++c)
+	    {
+	      for(int s=0; s < Ns; ++s)
+	      {
+		const RComplex<REAL>& z = quark_soln.elem(tab[j]).elem(s).elem(c);
+		soln[(j*Nc + c)*Ns + s] = std::complex<double>(z.real(), z.imag());
+	      }
+	    }
+	  }
+	}
+
+	PeramContractArgs args = {evecs, solns, num_vecs, peram};
+	dispatch_to_threads(n_t*num_vecs, args, peramContractLoop);
+
+	if (peram.size() > 0)
+	  QDPInternal::globalSumArray(reinterpret_cast<double*>(&peram[0]), 2*peram.size());
+      }
+
+
       //----------------------------------------------------------------------------
       //! Get active time-slices
       std::vector<bool> getActiveTSlices(int t_source, int Nt_forward, int Nt_backward)
@@ -612,6 +754,20 @@ namespace Chroma
 	  int t_source = t_sources[tt];  // This is the actual time-slice.
 	  QDPIO::cout << "t_source = " << t_source << std::endl; 
 
+	  // The sink time slices and their position in the contraction
+	  std::vector<bool> active_t_slices = getActiveTSlices(t_source,
+							       params.param.contract.Nt_forward,
+							       params.param.contract.Nt_backward);
+	  std::vector<int> sink_t_slices;
+	  std::vector<int> sink_t_index(Lt, -1);
+	  for(int t=0; t < Lt; ++t)
+	  {
+	    if (! active_t_slices[t]) {continue;}
+
+	    sink_t_index[t] = sink_t_slices.size();
+	    sink_t_slices.push_back(t);
+	  }
+
 	  // Loop over each spin source
 	  for(int spin_source=0; spin_source < Ns; ++spin_source)
 	  {
@@ -663,8 +819,6 @@ namespace Chroma
 	      // Loop over each spin source and invert. 
 	      // Use the same colorstd::vector source. No spin dilution will be used.
 	      //
-	      multi1d<LatticeColorVector> ferm_out(Ns);
-
 	      // Insert a ColorVector into spin index spin_source
 	      // This only overwrites sections, so need to initialize first
 	      LatticeFermion chi = zero;
@@ -707,37 +861,30 @@ namespace Chroma
 		QDP_abort(1);
 	      }
 
-	      // Extract into the temporary output array
-	      for(int spin_sink=0; spin_sink < Ns; ++spin_sink)
-	      {
-		ferm_out(spin_sink) = peekSpin(quark_soln, spin_sink);
-	      }
-
 	      snarss1.stop();
 	      QDPIO::cout << "Time to compute prop for spin_source= " << spin_source << "  colorvec_src= " << colorvec_src << "  time = " 
 			  << snarss1.getTimeInSeconds() 
 			  << " secs" << std::endl;
 
 	      // The perambulator part
-	      // Loop over time
-	      for(int t_slice = 0; t_slice < Lt; ++t_slice)
+	      // All sink time slices and spins at once
+	      std::vector< std::complex<double> > peram_vals;
+	      contractPeram(peram_vals, sub_eigen_map, sink_t_slices, num_vecs, quark_soln);
+
+	      // Loop over all the keys
+	      for(std::list<KeyPropElementalOperator_t>::const_iterator key= snk_keys.begin();
+		  key != snk_keys.end();
+		  ++key)
 	      {
-		// Loop over all the keys
-		for(std::list<KeyPropElementalOperator_t>::const_iterator key= snk_keys.begin();
-		    key != snk_keys.end();
-		    ++key)
+		const int it = sink_t_index[key->t_slice];
+
+		// Loop over the sink colorvec and the resulting perambulator
+		for(int colorvec_sink=0; colorvec_sink < num_vecs; ++colorvec_sink)
 		{
-		  if (key->t_slice != t_slice) {continue;}
-		  
-		  // Loop over the sink colorvec, form the innerproduct and the resulting perambulator
-		  for(int colorvec_sink=0; colorvec_sink < num_vecs; ++colorvec_sink)
-		  {
-		    peram[*key].mat(colorvec_sink,colorvec_src) = innerProduct(sub_eigen_map.getVec(t_slice, colorvec_sink), 
-									       ferm_out(key->spin_snk));
-
-		  } // for colorvec_sink
-		} // for key
-	      } // for t_slice
+		  const std::complex<double>& z = peram_vals[(it*num_vecs + colorvec_sink)*Ns + key->spin_snk];
+		  peram[*key].mat(colorvec_sink,colorvec_src) = cmplx(Double(z.real()), Double(z.imag()));
+		} // for colorvec_sink
+	      } // for key
 
 	      sniss1.stop();
 	      QDPIO::cout << "Time to compute and assemble peram for spin_source= " << spin_source << "  colorvec_src= " << colorvec_src << "  time = " 
@@ -9,6 +9,7 @@
 #include "meas/inline/io/named_objmap.h"
 #include "meas/inline/io/qio_write_obj_funcmap.h"
 #include "io/enum_io/enum_qdpvolfmt_io.h"
+#include "io/staged_io.h"
 
 namespace Chroma 
 { 
@@ -65,6 +66,8 @@ namespace Chroma
       write(xml, "file_name", input.file_name);
       write(xml, "file_volfmt", input.file_volfmt);
       write(xml, "parallel_io", input.parallel_io);
+      if (! input.staging_dir.empty())
+	write(xml, "staging_dir", input.staging_dir);
 
       pop(xml);
     }
@@ -93,6 +96,10 @@ namespace Chroma
 	input.parallel_io = false;
       }
 
+      if( inputtop.count("staging_dir") > 0 ) {
+	read(inputtop, "staging_dir", input.staging_dir);
+      }
+
     }
 
 
@@ -170,12 +177,21 @@ namespace Chroma
       {
 	swatch.reset();
 
+	// A staged file is written to the staging directory and
+	// moved to file_name in the background
+	bool stageP = StagedIOEnv::canStage(params.file.staging_dir, params.file.file_volfmt);
+	std::string file_name = params.file.file_name;
+	if (stageP)
+	  file_name = StagedIOEnv::stagedName(params.file.staging_dir, params.file.file_name);
+
 	// Write the object
 	swatch.start();
 	QIOWriteObjCallMapEnv::TheQIOWriteObjFuncMap::Instance().callFunction(params.named_obj.object_type,
 									      params.named_obj.object_id,
-									      params.file.file_name, 
+									      file_name, 
 									      params.file.file_volfmt, parallel_io_type);
+	if (stageP)
+	  StagedIOEnv::moveBatch(std::vector<StagedIOEnv::Move_t>(1, StagedIOEnv::Move_t(file_name, params.file.file_name)));
 	swatch.stop();
 
 	QDPIO::cout << "Object successfully written: time= " 
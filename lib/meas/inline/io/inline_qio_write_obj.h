@@ -40,6 +40,7 @@ namespace Chroma
 	std::string   file_name;
 	QDP_volfmt_t  file_volfmt;
 	bool          parallel_io;
+	std::string   staging_dir;   /*!< optional, write here and move in the background */
       } file;
     };
 
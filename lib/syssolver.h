@@ -51,6 +51,35 @@ namespace Chroma
 
 
 
+  //-----------------------------------------------------------------------------------
+  //! Linear system solvers for several right hand sides at once
+  /*! @ingroup solvers
+   *
+   * Solves the linear systems  A*psi[i] = chi[i]  for all sources together.
+   * Implementations share the operator applications between the sources,
+   * so the gauge field is streamed through memory once per block rather
+   * than once per source. The solver may only live on a subset.
+   */
+  template<typename T>
+  class SystemSolverBlock
+  {
+  public:
+    //! Virtual destructor to help with cleanup;
+    virtual ~SystemSolverBlock() {}
+
+    //! Apply the operator onto a block of source vectors
+    /*!
+     * Solves   A*psi[i] = chi[i]  for all i up to some accuracy.
+     * Returns the results for each of the sources.
+     */
+    virtual multi1d<SystemSolverResults_t> operator() (multi1d<T>& psi, const multi1d<T>& chi) const = 0;
+
+    //! Return the subset on which the operator acts
+    virtual const Subset& subset() const = 0;
+  };
+
+
+
   //-----------------------------------------------------------------------------------
   //! Linear system solvers of arrays
   /*! @ingroup solvers
@@ -115,6 +144,35 @@ namespace Chroma
 
 
 
+  //-----------------------------------------------------------------------------------
+  //! Linear multi-system solvers for several sources
+  /*! @ingroup solvers
+   *
+   * Solves multi-shift linear systems of equations for several sources
+   * at once. The solver may only live on a subset.
+   */
+  template<typename T>
+  class MultiSystemSolverBlock
+  {
+  public:
+    //! Virtual destructor to help with cleanup;
+    virtual ~MultiSystemSolverBlock() {}
+
+    //! Apply the operator onto the sources
+    /*! 
+     * Solves   (A + shifts[s])*psi[n][s] = chi[n]  for all sources n
+     * and shifts s.
+     */
+    virtual SystemSolverResults_t operator() (multi1d< multi1d<T> >& psi, 
+					      const multi1d<Real>& shifts, 
+					      const multi1d<T>& chi) const = 0;
+
+    //! Return the subset on which the operator acts
+    virtual const Subset& subset() const = 0;
+  };
+
+
+
   //-----------------------------------------------------------------------------------
   //! Linear multi-system solvers of arrays
   /*! @ingroup solvers
@@ -14,6 +14,8 @@ namespace Chroma
   /*! \ingroup heatbath */
   struct HBParams 
   {
+    HBParams() : nOverHits(1), siteLocalP(false) {}
+
     int nmax() const { return NmaxHB; }
     Double beta() const { return BetaMC; }
     Double xi() const { return xi_0; }
@@ -33,6 +35,11 @@ namespace Chroma
     int  t_dir;
     int  nOver;
     bool anisoP;
+    // passes over the SU(2) subgroups per overrelaxation of a link,
+    // only used by mciterSite()
+    int  nOverHits;
+    // update with mciterSite() instead of mciter()
+    bool siteLocalP;
   };
 
   
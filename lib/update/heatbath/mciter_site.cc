@@ -0,0 +1,507 @@
+/*! \file
+ *  \brief One heatbath interation of updating the gauge field, site by site
+ */
+
+#include "chromabase.h"
+#include "update/heatbath/mciter_site.h"
+#include "update/heatbath/mciter.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace Chroma
+{
+
+#ifndef QDP_IS_QDPJIT
+
+  //! Anonymous namespace
+  namespace
+  {
+    //! Number of SU(2) subgroups
+    const int n_su2 = (Nc > 1) ? Nc*(Nc-1)/2 : 1;
+
+    //! fuzz of chromabase.h
+    inline REAL siteFuzz()
+    {
+      return toFloat(fuzz);
+    }
+
+    //! Outcome of the heatbath of one subgroup
+    enum SU2Status {SU2_ACCEPTED, SU2_REJECTED, SU2_OUT_OF_RANDOM};
+
+    //! A link in local arrays
+    struct SiteLink
+    {
+      REAL re[Nc][Nc];
+      REAL im[Nc][Nc];
+    };
+
+
+    //! The SU(N) indices of SU(2) subgroup su2_index, as in su2Extract()
+    void su2Indices(int su2_index, int& i1, int& i2)
+    {
+      int found = 0;
+      int del_i = 0;
+      int index = -1;
+
+      while ( del_i < (Nc-1) && found == 0 )
+      {
+	del_i++;
+	for ( i1 = 0; i1 < (Nc-del_i); i1++ )
+	{
+	  index++;
+	  if ( index == su2_index )
+	  {
+	    found = 1;
+	    break;
+	  }
+	}
+      }
+      i2 = i1 + del_i;
+    }
+
+
+    inline void loadLink(const LatticeColorMatrix& u, int site, SiteLink& l)
+    {
+      for(int i=0; i < Nc; ++i)
+	for(int j=0; j < Nc; ++j)
+	{
+	  l.re[i][j] = u.elem(site).elem().elem(i,j).real();
+	  l.im[i][j] = u.elem(site).elem().elem(i,j).imag();
+	}
+    }
+
+
+    inline void storeLink(LatticeColorMatrix& u, int site, const SiteLink& l)
+    {
+      for(int i=0; i < Nc; ++i)
+	for(int j=0; j < Nc; ++j)
+	{
+	  u.elem(site).elem().elem(i,j).real() = l.re[i][j];
+	  u.elem(site).elem().elem(i,j).imag() = l.im[i][j];
+	}
+    }
+
+
+    //! c = a*b
+    inline void multLink(const SiteLink& a, const SiteLink& b, SiteLink& c)
+    {
+      for(int i=0; i < Nc; ++i)
+	for(int j=0; j < Nc; ++j)
+	{
+	  REAL re = 0;
+	  REAL im = 0;
+	  for(int k=0; k < Nc; ++k)
+	  {
+	    re += a.re[i][k]*b.re[k][j] - a.im[i][k]*b.im[k][j];
+	    im += a.re[i][k]*b.im[k][j] + a.im[i][k]*b.re[k][j];
+	  }
+	  c.re[i][j] = re;
+	  c.im[i][j] = im;
+	}
+    }
+
+
+    //! The r_k of V in the SU(2) subgroup (i1,i2), as su2Extract()
+    inline void extractSU2(const SiteLink& v, int i1, int i2, REAL r[4])
+    {
+      r[0] = v.re[i1][i1] + v.re[i2][i2];
+      r[1] = v.im[i1][i2] + v.im[i2][i1];
+      r[2] = v.re[i1][i2] - v.re[i2][i1];
+      r[3] = v.im[i1][i1] - v.im[i2][i2];
+    }
+
+
+    //! a <- B a with B = b_0 + i sum_k b_k sigma_k in the subgroup (i1,i2), as sunFill()
+    inline void leftMultSU2(const REAL b[4], int i1, int i2, SiteLink& a)
+    {
+      for(int j=0; j < Nc; ++j)
+      {
+	const REAL x_re = a.re[i1][j];
+	const REAL x_im = a.im[i1][j];
+	const REAL y_re = a.re[i2][j];
+	const REAL y_im = a.im[i2][j];
+
+	// (b0 + i b3) x + (b2 + i b1) y
+	a.re[i1][j] = b[0]*x_re - b[3]*x_im + b[2]*y_re - b[1]*y_im;
+	a.im[i1][j] = b[0]*x_im + b[3]*x_re + b[2]*y_im + b[1]*y_re;
+
+	// (-b2 + i b1) x + (b0 - i b3) y
+	a.re[i2][j] = -b[2]*x_re - b[1]*x_im + b[0]*y_re + b[3]*y_im;
+	a.im[i2][j] = -b[2]*x_im + b[1]*x_re + b[0]*y_im - b[3]*y_re;
+      }
+    }
+
+
+    //! Make the link special unitary again, as reunit()
+    inline void reunitLink(SiteLink& l)
+    {
+      // Normalise row 0
+      REAL n = 0;
+      for(int j=0; j < Nc; ++j)
+	n += l.re[0][j]*l.re[0][j] + l.im[0][j]*l.im[0][j];
+      n = REAL(1) / std::sqrt(n);
+      for(int j=0; j < Nc; ++j)
+      {
+	l.re[0][j] *= n;
+	l.im[0][j] *= n;
+      }
+
+      if (Nc == 2)
+      {
+	// row 1 = (-conj(u_01), conj(u_00))
+	l.re[1][0] = -l.re[0][1];
+	l.im[1][0] =  l.im[0][1];
+	l.re[1][1] =  l.re[0][0];
+	l.im[1][1] = -l.im[0][0];
+	return;
+      }
+
+      // Orthogonalise row 1 against row 0 and normalise it
+      REAL c_re = 0;
+      REAL c_im = 0;
+      for(int j=0; j < Nc; ++j)
+      {
+	c_re += l.re[0][j]*l.re[1][j] + l.im[0][j]*l.im[1][j];
+	c_im += l.re[0][j]*l.im[1][j] - l.im[0][j]*l.re[1][j];
+      }
+      n = 0;
+      for(int j=0; j < Nc; ++j)
+      {
+	l.re[1][j] -= c_re*l.re[0][j] - c_im*l.im[0][j];
+	l.im[1][j] -= c_re*l.im[0][j] + c_im*l.re[0][j];
+	n += l.re[1][j]*l.re[1][j] + l.im[1][j]*l.im[1][j];
+      }
+      n = REAL(1) / std::sqrt(n);
+      for(int j=0; j < Nc; ++j)
+      {
+	l.re[1][j] *= n;
+	l.im[1][j] *= n;
+      }
+
+      // row 2 = conj(row 0 x row 1)
+      for(int j=0; j < 3; ++j)
+      {
+	const int j1 = (j+1) % 3;
+	const int j2 = (j+2) % 3;
+	const REAL re = l.re[0][j1]*l.re[1][j2] - l.im[0][j1]*l.im[1][j2]
+	  - l.re[0][j2]*l.re[1][j1] + l.im[0][j2]*l.im[1][j1];
+	const REAL im = l.re[0][j1]*l.im[1][j2] + l.im[0][j1]*l.re[1][j2]
+	  - l.re[0][j2]*l.im[1][j1] - l.im[0][j2]*l.re[1][j1];
+	l.re[2][j] =  re;
+	l.im[2][j] = -im;
+      }
+    }
+
+
+    //! Heatbath of one SU(2) subgroup, as su2_hb_update()
+    /*!
+     * On SU2_ACCEPTED b holds the update of the subgroup. The random
+     * numbers are taken from rnd at site, starting at k.
+     */
+    inline SU2Status heatbathSU2(const REAL r_in[4], REAL beta, int nmax,
+				 int& tries, const multi1d<LatticeReal>& rnd,
+				 int site, int& k, REAL b[4])
+    {
+      // compensate for extra 2 !!! su(2)
+      REAL r[4];
+      for(int i=0; i < 4; ++i)
+	r[i] = REAL(0.5)*r_in[i];
+
+      const REAL sq_det = std::sqrt(r[0]*r[0] + r[1]*r[1] + r[2]*r[2] + r[3]*r[3]);
+      if (sq_det < siteFuzz())
+	return SU2_REJECTED;
+
+      // Inverse matrix u^-1
+      r[0] =  r[0] / sq_det;
+      r[1] = -r[1] / sq_det;
+      r[2] = -r[2] / sq_det;
+      r[3] = -r[3] / sq_det;
+
+      // Creutz: a_0 from exp(beta sq_det a_0) sqrt(1 - a_0^2)
+      const REAL weight = beta*sq_det;
+      const REAL w_exp = std::exp(-REAL(2)*weight);
+      const int n_rnd = rnd.size();
+
+      REAL a[4];
+      for(;;)
+      {
+	if (nmax > 0 && tries >= nmax)
+	  return SU2_REJECTED;
+
+	// Two for the trial, two for the angles
+	if (k + 4 > n_rnd)
+	  return SU2_OUT_OF_RANDOM;
+
+	const REAL x = rnd[k++].elem(site).elem().elem().elem();
+	a[0] = REAL(1) + std::log(w_exp*(REAL(1)-x) + x) / weight;
+
+	const REAL y = rnd[k++].elem(site).elem().elem().elem();
+	++tries;
+
+	if (y*y < REAL(1) - a[0]*a[0])
+	  break;
+      }
+
+      // other a components
+      const REAL a_r = std::sqrt(std::max(REAL(1) - a[0]*a[0], REAL(0)));
+      const REAL cos_theta = REAL(1) - REAL(2)*rnd[k++].elem(site).elem().elem().elem();
+      const REAL sin_theta = std::sqrt(REAL(1) - cos_theta*cos_theta);
+      const REAL phi = REAL(8)*std::atan(REAL(1))*rnd[k++].elem(site).elem().elem().elem();
+
+      a[3] = a_r*cos_theta;
+      a[1] = a_r*sin_theta*std::cos(phi);
+      a[2] = a_r*sin_theta*std::sin(phi);
+
+      // u'=uu^-1 -> b = a*r
+      b[0] = a[0]*r[0] - a[1]*r[1] - a[2]*r[2] - a[3]*r[3];
+      b[1] = a[0]*r[1] + a[1]*r[0] - a[2]*r[3] + a[3]*r[2];
+      b[2] = a[0]*r[2] + a[2]*r[0] - a[3]*r[1] + a[1]*r[3];
+      b[3] = a[0]*r[3] + a[3]*r[0] - a[1]*r[2] + a[2]*r[1];
+
+      return SU2_ACCEPTED;
+    }
+
+
+    //! Arguments of the threaded heatbath
+    struct HeatbathArgs
+    {
+      LatticeColorMatrix& u_mu;
+      const LatticeColorMatrix& w;
+      const multi1d<LatticeReal>& rnd;
+      const multi1d<int>& sites;
+      multi1d<int>& next_su2;      /*!< subgroup to go on with, n_su2 when done */
+      multi1d<int>& n_tries;       /*!< trials done in that subgroup */
+      REAL beta;
+      int nmax;
+    };
+
+    void heatbathSites(int lo, int hi, int myId, HeatbathArgs* a)
+    {
+      int i1[n_su2], i2[n_su2];
+      for(int s=0; s < n_su2; ++s)
+	su2Indices(s, i1[s], i2[s]);
+
+      for(int j=lo; j < hi; ++j)
+      {
+	const int site = a->sites[j];
+
+	SiteLink u, w, v;
+	loadLink(a->u_mu, site, u);
+	loadLink(a->w, site, w);
+
+	// V = U*W, kept up to date with U
+	multLink(u, w, v);
+
+	int k = 0;
+	int s = a->next_su2[site];
+	int tries = a->n_tries[site];
+	for(; s < n_su2; ++s, tries = 0)
+	{
+	  REAL r[4], b[4];
+	  extractSU2(v, i1[s], i2[s], r);
+
+	  SU2Status status = heatbathSU2(r, a->beta, a->nmax, tries, a->rnd, site, k, b);
+	  if (status == SU2_OUT_OF_RANDOM)
+	    break;
+
+	  if (status == SU2_ACCEPTED)
+	  {
+	    leftMultSU2(b, i1[s], i2[s], u);
+	    leftMultSU2(b, i1[s], i2[s], v);
+	  }
+	}
+
+	a->next_su2[site] = s;
+	a->n_tries[site] = tries;
+
+	if (s == n_su2)
+	  reunitLink(u);
+
+	storeLink(a->u_mu, site, u);
+      }
+    }
+
+
+    //! Arguments of the threaded overrelaxation
+    struct OverrelaxArgs
+    {
+      LatticeColorMatrix& u_mu;
+      const LatticeColorMatrix& w;
+      const multi1d<int>& sites;
+      int n_hits;
+    };
+
+    void overrelaxSites(int lo, int hi, int myId, OverrelaxArgs* a)
+    {
+      int i1[n_su2], i2[n_su2];
+      for(int s=0; s < n_su2; ++s)
+	su2Indices(s, i1[s], i2[s]);
+
+      const REAL r_fuzz = siteFuzz();
+
+      for(int j=lo; j < hi; ++j)
+      {
+	const int site = a->sites[j];
+
+	SiteLink u, w, v;
+	loadLink(a->u_mu, site, u);
+	loadLink(a->w, site, w);
+	multLink(u, w, v);
+
+	for(int hit=0; hit < a->n_hits; ++hit)
+	{
+	  for(int s=0; s < n_su2; ++s)
+	  {
+	    // Project onto SU(2), as su3over()
+	    REAL r[4];
+	    extractSU2(v, i1[s], i2[s], r);
+
+	    const REAL r_l = std::sqrt(r[0]*r[0] + r[1]*r[1] + r[2]*r[2] + r[3]*r[3]);
+
+	    REAL a_su2[4] = {1, 0, 0, 0};
+	    if (r_l > r_fuzz)
+	    {
+	      a_su2[0] =  r[0] / r_l;
+	      a_su2[1] = -r[1] / r_l;
+	      a_su2[2] = -r[2] / r_l;
+	      a_su2[3] = -r[3] / r_l;
+	    }
+
+	    // Microcanonical updating matrix is the square of this
+	    REAL b[4];
+	    b[0] = a_su2[0]*a_su2[0] - a_su2[1]*a_su2[1] - a_su2[2]*a_su2[2] - a_su2[3]*a_su2[3];
+	    b[1] = 2*a_su2[0]*a_su2[1];
+	    b[2] = 2*a_su2[0]*a_su2[2];
+	    b[3] = 2*a_su2[0]*a_su2[3];
+
+	    leftMultSU2(b, i1[s], i2[s], u);
+	    leftMultSU2(b, i1[s], i2[s], v);
+	  }
+	}
+
+	storeLink(a->u_mu, site, u);
+      }
+    }
+
+
+    //! Heatbath of the links u_mu on the subset sub with the staple w
+    void heatbathLinks(LatticeColorMatrix& u_mu,
+		       const LatticeColorMatrix& w,
+		       const Subset& sub,
+		       int nmax,
+		       multi1d<LatticeReal>& rnd,
+		       multi1d<int>& next_su2,
+		       multi1d<int>& n_tries)
+    {
+      multi1d<int> sites = sub.siteTable();
+      int n_sites = sub.numSiteTable();
+
+      for(int j=0; j < n_sites; ++j)
+      {
+	next_su2[sites[j]] = 0;
+	n_tries[sites[j]] = 0;
+      }
+
+      for(;;)
+      {
+	for(int k=0; k < rnd.size(); ++k)
+	  random(rnd[k], sub);
+
+	HeatbathArgs args = {u_mu, w, rnd, sites, next_su2, n_tries, REAL(2)/REAL(Nc), nmax};
+	dispatch_to_threads(n_sites, args, heatbathSites);
+
+	// Sites which ran out of random numbers go on with a new batch
+	int n_left = 0;
+	for(int j=0; j < n_sites; ++j)
+	{
+	  if (next_su2[sites[j]] < n_su2)
+	    sites[n_left++] = sites[j];
+	}
+	n_sites = n_left;
+
+	double n_left_all = n_left;
+	QDPInternal::globalSum(n_left_all);
+	if (n_left_all == 0)
+	  break;
+      }
+    }
+
+  }  // end anonymous namespace
+
+
+  //! One heatbath interation of updating the gauge field, site by site
+  void mciterSite(multi1d<LatticeColorMatrix>& u,
+		  const LinearGaugeAction& S_g,
+		  const HBParams& hbp)
+  {
+    START_CODE();
+
+    if (Nc != 2 && Nc != 3)
+    {
+      QDPIO::cerr << __func__ << ": only implemented for Nc = 2 and 3" << std::endl;
+      QDP_abort(1);
+    }
+
+    LatticeColorMatrix u_mu_staple;
+
+    const Set& gauge_set = S_g.getSet();
+    const int num_subsets = gauge_set.numSubsets();
+
+    // Per subgroup about two trials and the angles
+    multi1d<LatticeReal> rnd(6*n_su2);
+    multi1d<int> next_su2(Layout::sitesOnNode());
+    multi1d<int> n_tries(Layout::sitesOnNode());
+
+    for(int iter = 0; iter <= hbp.nOver; ++iter)
+    {
+      for(int cb = 0; cb < num_subsets; ++cb)
+      {
+	for(int mu = 0; mu < Nd; ++mu)
+	{
+	  // Calculate the staple
+	  {
+	    typedef multi1d<LatticeColorMatrix>  P;
+	    typedef multi1d<LatticeColorMatrix>  Q;
+
+	    Handle< GaugeState<P,Q> > state(S_g.createState(u));
+
+	    //staple
+	    S_g.staple(u_mu_staple, state, mu, cb);
+	  }
+
+	  if ( iter < hbp.nOver )
+	  {
+	    OverrelaxArgs args = {u[mu], u_mu_staple, gauge_set[cb].siteTable(), hbp.nOverHits};
+	    dispatch_to_threads(gauge_set[cb].numSiteTable(), args, overrelaxSites);
+	  }
+	  else
+	  {
+	    heatbathLinks(u[mu], u_mu_staple, gauge_set[cb], hbp.nmax(),
+			  rnd, next_su2, n_tries);
+	  }
+
+	  // If using Schroedinger functional, reset the boundaries
+	  // NOTE: this routine resets all links and not just those under mu,cb
+	  S_g.getGaugeBC().modify(u);
+
+	}    // closes mu loop
+      }      // closes cb loop
+    }
+
+    END_CODE();
+  }
+
+#else
+
+  //! No site access with QDP-JIT, use the lattice-wide update
+  void mciterSite(multi1d<LatticeColorMatrix>& u,
+		  const LinearGaugeAction& S_g,
+		  const HBParams& hbp)
+  {
+    mciter(u, S_g, hbp);
+  }
+
+#endif
+
+}  // end namespace Chroma
@@ -0,0 +1,47 @@
+// -*- C++ -*-
+/*! \file
+ *  \brief One heatbath interation of updating the gauge field, site by site
+ */
+
+#ifndef __mciter_site_h__
+#define __mciter_site_h__
+
+#include "actions/gauge/gaugeacts/wilson_gaugeact.h"
+#include "update/heatbath/hb_params.h"
+
+namespace Chroma
+{
+
+  //! One heatbath interation of updating the gauge field, site by site
+  /*!
+   * \ingroup heatbath
+   *
+   * Same update as mciter(): n_over overrelaxation sweeps followed
+   * by one heatbath sweep, all SU(2) subgroups of each link in turn.
+   *
+   * The staple of a checkerboard and direction is computed once with
+   * the gauge action. The links are then updated in threads, one site
+   * at a time: the link and U*staple are held in local arrays and all
+   * SU(2) subgroup updates are applied to them before the link is
+   * stored again. The overrelaxation does nOverHits passes over the
+   * subgroups with the same staple.
+   *
+   * The random numbers of the heatbath are drawn in advance on the
+   * checkerboard with the QDP++ generator. A site which runs out of
+   * them stops and goes on with a new batch, so the distribution is
+   * the one of mciter() for any NmaxHB.
+   *
+   * Warning: this works only for Nc = 2 and 3 !
+
+   * \param u        gauge field ( Modify )
+   * \param S_g      gauge action ( Read )
+   * \param hbp      heatbath parameters ( Read )
+   */
+
+  void mciterSite(multi1d<LatticeColorMatrix>& u,
+		  const LinearGaugeAction& S_g,
+		  const HBParams& hbp);
+
+}  // end namespace Chroma
+
+#endif
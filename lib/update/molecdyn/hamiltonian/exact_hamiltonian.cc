@@ -37,6 +37,8 @@ namespace Chroma {
    typedef Handle<Monomial< multi1d<LatticeColorMatrix>, 
                             multi1d<LatticeColorMatrix> > > MHandle;
 
+   this->monomial_ids = monomial_ids;
+
    monomials.resize(0);
    if ( monomial_ids.size() > 0 ) { 
 
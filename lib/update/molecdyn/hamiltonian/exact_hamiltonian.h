@@ -10,10 +10,12 @@
 #include "handle.h"
 
 #include "update/molecdyn/hamiltonian/abs_hamiltonian.h"
+#include "update/molecdyn/hamiltonian/repro_sum.h"
 
 #include "io/xmllog_io.h"
 #include "io/monomial_io.h"
 #include "meas/inline/io/named_objmap.h"
+#include "update/molecdyn/monomial/monomial_profiler.h"
 
 namespace Chroma 
 {
@@ -55,7 +57,7 @@ namespace Chroma
     }
 
     //! Copy constructor
-    ExactHamiltonian(const ExactHamiltonian& H) : monomials(H.monomials) {}
+    ExactHamiltonian(const ExactHamiltonian& H) : monomials(H.monomials), monomial_ids(H.monomial_ids) {}
 
     //! Destructor 
     ~ExactHamiltonian(void) {}
@@ -64,8 +66,11 @@ namespace Chroma
     void refreshInternalFields(const AbsFieldState<multi1d<LatticeColorMatrix>,multi1d<LatticeColorMatrix> >& s)  
     { 
       START_CODE();
+      MonomialProfiler& profiler = TheMonomialProfiler::Instance();
       for(int i=0; i < monomials.size(); i++) {
+	profiler.begin(monomial_ids[i], MonomialProfiler::REFRESH);
 	monomials[i]->refreshInternalFields(s);
+	profiler.end();
       }
       END_CODE();
     }
@@ -91,7 +96,7 @@ namespace Chroma
       /* Sum up the differences */
       Double KE=zero;
       for(int mu=0; mu < Nd; mu++) { 
-	KE += sum(ke_per_site[mu]);
+	KE += reproSum(ke_per_site[mu]);
       }
 
       XMLWriter& xml_out = TheXMLLogWriter::Instance();
@@ -119,6 +124,7 @@ namespace Chroma
 
       write(xml_out, "num_terms", num_terms);
       Double PE=zero;
+      MonomialProfiler& profiler = TheMonomialProfiler::Instance();
 
       // Caller writes elem rule
       push(xml_out, "PEByMonomials");
@@ -126,7 +132,9 @@ namespace Chroma
       {
 	push(xml_out, "elem");
 	Double tmp;
+	profiler.begin(monomial_ids[i], MonomialProfiler::ACTION);
 	tmp=monomials[i]->S(s);
+	profiler.end();
 	PE += tmp;
 	pop(xml_out); // elem
       }
@@ -147,6 +155,7 @@ namespace Chroma
     
 
     multi1d< Handle<ExactMon> >  monomials;
+    multi1d<std::string>  monomial_ids;   /*!< ids of the monomials, for profiling */
 
     
   };
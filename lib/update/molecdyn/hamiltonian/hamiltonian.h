@@ -17,5 +17,6 @@
 
 #include "update/molecdyn/hamiltonian/abs_hamiltonian.h"
 #include "update/molecdyn/hamiltonian/exact_hamiltonian.h"
+#include "update/molecdyn/hamiltonian/repro_sum.h"
 
 #endif 
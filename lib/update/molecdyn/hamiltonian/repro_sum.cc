@@ -0,0 +1,115 @@
+/*! \file
+ * \brief Global sums independent of the node layout
+ */
+
+#include "update/molecdyn/hamiltonian/repro_sum.h"
+
+namespace Chroma
+{
+
+  namespace ReproSumEnv
+  {
+    static bool reproSumsP = false;
+  }
+
+  void setReproducibleSums(bool reproP)
+  {
+    ReproSumEnv::reproSumsP = reproP;
+  }
+
+  bool reproducibleSums()
+  {
+    return ReproSumEnv::reproSumsP;
+  }
+
+
+  const double ReproSumAccumulator::limb_top = 18446744073709551616.0;  // 2^64
+
+
+  void ReproSumAccumulator::reset()
+  {
+    for(int i=0; i < n_limbs; ++i)
+      limb[i] = 0;
+
+    n_added   = 0;
+    overflowP = false;
+    plain     = 0;
+  }
+
+
+  void ReproSumAccumulator::normalise()
+  {
+    const int64_t mask = (int64_t(1) << 32) - 1;
+
+    // The shift rounds down, so negative limbs borrow from the next one
+    for(int i=0; i < n_limbs-1; ++i)
+    {
+      int64_t carry = limb[i] >> 32;
+      limb[i] &= mask;
+      limb[i+1] += carry;
+    }
+
+    n_added = 0;
+  }
+
+
+  void ReproSumAccumulator::add(const ReproSumAccumulator& a)
+  {
+    ReproSumAccumulator b = a;
+    b.normalise();
+    normalise();
+
+    for(int i=0; i < n_limbs; ++i)
+      limb[i] += b.limb[i];
+
+    // Each limb is now the sum of at most two normalised ones
+    n_added    = 2;
+    overflowP |= b.overflowP;
+    plain     += b.plain;
+  }
+
+
+  Double ReproSumAccumulator::globalSum() const
+  {
+    ReproSumAccumulator tot = *this;
+    tot.normalise();
+
+    // The limbs are now below 2^32, their sum over the nodes is exact as doubles
+    double buf[n_limbs+1];
+    for(int i=0; i < n_limbs; ++i)
+      buf[i] = double(tot.limb[i]);
+    buf[n_limbs] = overflowP ? 1.0 : 0.0;
+
+    QDPInternal::globalSumArray(buf, n_limbs+1);
+
+    double plain_sum = plain;
+    QDPInternal::globalSum(plain_sum);
+
+    if (buf[n_limbs] > 0)
+    {
+      QDPIO::cout << "ReproSumAccumulator: value out of range, using the ordinary sum" << std::endl;
+      return Double(plain_sum);
+    }
+
+    for(int i=0; i < n_limbs; ++i)
+      tot.limb[i] = int64_t(buf[i]);
+    tot.normalise();
+
+    // Sign and magnitude, so all limbs are positive
+    bool negP = tot.limb[n_limbs-1] < 0;
+    if (negP)
+    {
+      for(int i=0; i < n_limbs; ++i)
+	tot.limb[i] = -tot.limb[i];
+      tot.normalise();
+    }
+
+    // From the top down, so the large limbs are added first
+    double ret = 0;
+    for(int i=n_limbs-1; i >= 0; --i)
+      ret += std::ldexp(double(tot.limb[i]), 32*i + lowest_exp);
+
+    return Double(negP ? -ret : ret);
+  }
+
+}
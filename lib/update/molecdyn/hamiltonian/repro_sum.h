@@ -0,0 +1,252 @@
+// -*- C++ -*-
+/*! \file
+ * \brief Global sums independent of the node layout
+ *
+ * Sums for the Hamiltonian and the force monitors which give the same
+ * bits for any number of nodes and threads.
+ */
+
+#ifndef __repro_sum_h__
+#define __repro_sum_h__
+
+#include "chromabase.h"
+#include <stdint.h>
+#include <cmath>
+
+namespace Chroma
+{
+
+  //! Switch the reproducible sums on or off
+  /*! \ingroup hamilton */
+  void setReproducibleSums(bool reproP);
+
+  //! Are the reproducible sums on
+  /*! \ingroup hamilton */
+  bool reproducibleSums();
+
+
+  //! Fixed point accumulator for reproducible sums
+  /*! \ingroup hamilton
+   *
+   * Each value is cut into 32 bit limbs of a fixed point number with
+   * the unit 2^-128, the bits below are dropped, and added as
+   * integers. Integer sums do not depend on the order, so the local
+   * sums, the sum over the threads and the global sum over the nodes
+   * are exact. The limbs are summed over the nodes as doubles, which is
+   * exact for less than 2^21 nodes. The result is rounded to a double
+   * once at the end.
+   *
+   * Values of size 2^64 and above, infs and nans cannot be represented.
+   * If there is one on any node, globalSum() returns the ordinary sum.
+   */
+  class ReproSumAccumulator
+  {
+  public:
+    ReproSumAccumulator() {reset();}
+
+    //! Start from zero
+    void reset();
+
+    //! Add a value
+    void add(double x)
+    {
+      if (! (std::fabs(x) < limb_top))
+      {
+	overflowP = true;
+	plain += x;
+	return;
+      }
+
+      plain += x;
+      bool negP = x < 0;
+      double a = std::ldexp(std::fabs(x), -lowest_exp);
+
+      for(int i=n_limbs-1; i >= 0; --i)
+      {
+	double w = std::ldexp(1.0, 32*i);
+	double d = std::floor(a / w);
+	a -= d*w;
+	limb[i] += negP ? -int64_t(d) : int64_t(d);
+      }
+
+      // Carry before the limbs can overflow
+      if (++n_added == carry_interval)
+	normalise();
+    }
+
+    //! Add another accumulator
+    void add(const ReproSumAccumulator& a);
+
+    //! Sum over all nodes
+    Double globalSum() const;
+
+  private:
+    static const int n_limbs = 6;
+    static const int lowest_exp = -128;
+    static const int carry_interval = 1 << 30;
+    static const double limb_top;      /*!< 2^64, the range of the values */
+
+    //! Propagate the carries, all limbs but the top one are in [0,2^32)
+    void normalise();
+
+    int64_t limb[n_limbs];
+    int     n_added;
+    bool    overflowP;
+    double  plain;
+  };
+
+
+  namespace ReproSumEnv
+  {
+#ifndef QDP_IS_QDPJIT
+    template<typename R>
+    struct AddSitesArgs
+    {
+      const OLattice<R>& x;
+      const multi1d<int>& tab;
+      multi1d<ReproSumAccumulator>& acc;
+    };
+
+    template<typename R>
+    void addSitesLoop(int lo, int hi, int myId, AddSitesArgs<R>* a)
+    {
+      ReproSumAccumulator& acc = a->acc[myId];
+      for(int j=lo; j < hi; ++j)
+	acc.add(double(a->x.elem(a->tab[j]).elem().elem().elem()));
+    }
+#endif
+
+    //! Add the sites of a lattice scalar on s, threaded
+    template<typename R>
+    void addSites(ReproSumAccumulator& acc, const OLattice<R>& x, const Subset& s)
+    {
+#ifndef QDP_IS_QDPJIT
+      multi1d<ReproSumAccumulator> thread_acc(qdpNumThreads());
+      AddSitesArgs<R> args = {x, s.siteTable(), thread_acc};
+      dispatch_to_threads(s.numSiteTable(), args, addSitesLoop<R>);
+
+      // In the order of the threads, but integer sums are exact anyway
+      for(int t=0; t < thread_acc.size(); ++t)
+	acc.add(thread_acc[t]);
+#else
+      QDPIO::cerr << "ReproSumAccumulator: no site access with QDP-JIT" << std::endl;
+      QDP_abort(1);
+#endif
+    }
+
+    //! Add the sites of an expression on s, evaluated in its own precision first
+    template<typename RHS, typename R>
+    void addSites(ReproSumAccumulator& acc, const QDPExpr<RHS, OLattice<R> >& x, const Subset& s)
+    {
+      OLattice<R> tmp;
+      tmp[s] = x;
+      addSites(acc, tmp, s);
+    }
+  }
+
+
+  //! Sum of a real lattice field on s
+  /*! \ingroup hamilton
+   *
+   * Reproducible if switched on, otherwise the sum() of QDP++.
+   *
+   * Reproducible means: for the same field values the result has the
+   * same bits for any number of nodes, any layout and any number of
+   * threads. Each site value is truncated below 2^-128 first, so the
+   * result can differ from sum() in the last bits. The field itself is
+   * not made reproducible. If it comes from a solve with ordinary
+   * global sums, e.g. the pseudofermion actions, it still depends on
+   * the layout, and so does its sum.
+   */
+  template<typename R>
+  Double reproSum(const OLattice<R>& x, const Subset& s = all)
+  {
+#ifndef QDP_IS_QDPJIT
+    if (reproducibleSums())
+    {
+      ReproSumAccumulator acc;
+      ReproSumEnv::addSites(acc, x, s);
+      return acc.globalSum();
+    }
+#endif
+    Double ret = sum(x, s);
+    return ret;
+  }
+
+  //! Sum of a real lattice expression on s
+  /*! \ingroup hamilton
+   *
+   * The expression is evaluated in its own precision, then summed as
+   * reproSum() of a lattice field.
+   */
+  template<typename RHS, typename R>
+  Double reproSum(const QDPExpr<RHS, OLattice<R> >& x, const Subset& s = all)
+  {
+    if (! reproducibleSums())
+    {
+      Double ret = sum(x, s);
+      return ret;
+    }
+
+    OLattice<R> tmp;
+    tmp[s] = x;
+    return reproSum(tmp, s);
+  }
+
+
+  //! norm2(x, s), reproducible if switched on
+  /*! \ingroup hamilton */
+  template<typename T>
+  Double reproNorm2(const T& x, const Subset& s = all)
+  {
+    if (! reproducibleSums())
+      return norm2(x, s);
+
+    return reproSum(localNorm2(x), s);
+  }
+
+  //! norm2(x, s) of an array, reproducible if switched on
+  /*! \ingroup hamilton */
+  template<typename T>
+  Double reproNorm2(const multi1d<T>& x, const Subset& s = all)
+  {
+    if (! reproducibleSums())
+      return norm2(x, s);
+
+    ReproSumAccumulator acc;
+    for(int i=0; i < x.size(); ++i)
+      ReproSumEnv::addSites(acc, localNorm2(x[i]), s);
+
+    return acc.globalSum();
+  }
+
+
+  //! innerProductReal(x, y, s), reproducible if switched on
+  /*! \ingroup hamilton */
+  template<typename T>
+  Double reproInnerProductReal(const T& x, const T& y, const Subset& s = all)
+  {
+    if (! reproducibleSums())
+      return innerProductReal(x, y, s);
+
+    return reproSum(localInnerProductReal(x, y), s);
+  }
+
+  //! innerProductReal(x, y, s) of arrays, reproducible if switched on
+  /*! \ingroup hamilton */
+  template<typename T>
+  Double reproInnerProductReal(const multi1d<T>& x, const multi1d<T>& y, const Subset& s = all)
+  {
+    if (! reproducibleSums())
+      return innerProductReal(x, y, s);
+
+    ReproSumAccumulator acc;
+    for(int i=0; i < x.size(); ++i)
+      ReproSumEnv::addSites(acc, localInnerProductReal(x[i], y[i]), s);
+
+    return acc.globalSum();
+  }
+
+}
+
+#endif
@@ -27,6 +27,9 @@ namespace Chroma
     
     // Virtual destructor
     virtual ~AbsHMCTrj() {};
+
+    //! Energy violation of the last trajectory
+    const Double& getDeltaH(void) const { return last_DeltaH; }
     
 
     // Do the HMC trajectory
@@ -154,6 +157,7 @@ namespace Chroma
       Double DeltaPE = PE - PE_old;
       Double DeltaH  = DeltaKE + DeltaPE;
       Double AccProb = where(DeltaH < 0.0, Double(1), exp(-DeltaH));
+      last_DeltaH = DeltaH;
       write(xml_out, "deltaKE", DeltaKE);
       write(xml_log, "deltaKE", DeltaKE);
 
@@ -218,6 +222,9 @@ namespace Chroma
     virtual void reverseCheckMetrics(Double& deltaQ, Double& deltaP,
 				     const AbsFieldState<P,Q>& s, 
 				     const AbsFieldState<P,Q>& s_old) const = 0;
+
+  private:
+    Double last_DeltaH;
   };
 
 } // end namespace chroma 
@@ -18,5 +18,7 @@
 #include "update/molecdyn/hmc/abs_hmc.h"
 #include "update/molecdyn/hmc/lcm_hmc.h"
 #include "update/molecdyn/hmc/const_lcm_hmc.h"
+#include "update/molecdyn/hmc/hmc_checkpoint.h"
+#include "update/molecdyn/hmc/hmc_tuner.h"
 
 #endif
@@ -0,0 +1,231 @@
+/*! \file
+ * \brief Checkpoint of the HMC solver state
+ *
+ * Checkpoint of the HMC solver state
+ */
+
+#include <list>
+
+#include "chromabase.h"
+#include "update/molecdyn/hmc/hmc_checkpoint.h"
+#include "meas/inline/io/named_objmap.h"
+#include "meas/inline/io/inline_qio_write_obj.h"
+#include "meas/inline/io/inline_qio_read_obj.h"
+#include "actions/ferm/invert/deflation_space.h"
+
+namespace Chroma
+{
+
+  //! Object to write
+  void read(XMLReader& xml, const std::string& path, HMCCheckpointParams::NamedObject_t& p)
+  {
+    XMLReader inputtop(xml, path);
+
+    read(inputtop, "object_id", p.object_id);
+    read(inputtop, "object_type", p.object_type);
+  }
+
+  //! Object to write
+  void write(XMLWriter& xml, const std::string& path, const HMCCheckpointParams::NamedObject_t& p)
+  {
+    push(xml, path);
+
+    write(xml, "object_id", p.object_id);
+    write(xml, "object_type", p.object_type);
+
+    pop(xml);
+  }
+
+  //! Object to restore
+  void read(XMLReader& xml, const std::string& path, HMCCheckpointParams::Restore_t& p)
+  {
+    XMLReader inputtop(xml, path);
+
+    read(inputtop, "object_id", p.object_id);
+    read(inputtop, "object_type", p.object_type);
+    read(inputtop, "file_name", p.file_name);
+  }
+
+  //! Object to restore
+  void write(XMLWriter& xml, const std::string& path, const HMCCheckpointParams::Restore_t& p)
+  {
+    push(xml, path);
+
+    write(xml, "object_id", p.object_id);
+    write(xml, "object_type", p.object_type);
+    write(xml, "file_name", p.file_name);
+
+    pop(xml);
+  }
+
+
+  // Default: nothing to checkpoint
+  HMCCheckpointParams::HMCCheckpointParams()
+  {
+    named_obj.resize(0);
+    restore.resize(0);
+  }
+
+  // Read parameters
+  HMCCheckpointParams::HMCCheckpointParams(XMLReader& xml, const std::string& path)
+  {
+    XMLReader paramtop(xml, path);
+
+    if (paramtop.count("NamedObjects") > 0)
+      read(paramtop, "NamedObjects", named_obj);
+    else
+      named_obj.resize(0);
+
+    if (paramtop.count("Restore") > 0)
+      read(paramtop, "Restore", restore);
+    else
+      restore.resize(0);
+  }
+
+  // Reader
+  void read(XMLReader& xml, const std::string& path, HMCCheckpointParams& p)
+  {
+    HMCCheckpointParams tmp(xml, path);
+    p = tmp;
+  }
+
+  // Writer
+  void write(XMLWriter& xml, const std::string& path, const HMCCheckpointParams& p)
+  {
+    push(xml, path);
+
+    write(xml, "NamedObjects", p.named_obj);
+    if (p.restore.size() > 0)
+      write(xml, "Restore", p.restore);
+
+    pop(xml);
+  }
+
+
+  //! Write and restore the HMC checkpoint
+  namespace HMCCheckpointEnv
+  {
+    //! Write the listed named objects and replace the Restore list with them
+    void save(HMCCheckpointParams& p,
+	      const std::string& prefix,
+	      unsigned long update_no,
+	      QDP_volfmt_t volfmt,
+	      QDP_serialparallel_t serpar)
+    {
+      START_CODE();
+
+      std::list<HMCCheckpointParams::Restore_t> written;
+
+      for(int i=0; i < p.named_obj.size(); ++i)
+      {
+	const HMCCheckpointParams::NamedObject_t& obj = p.named_obj[i];
+
+	if (! TheNamedObjMap::Instance().check(obj.object_id))
+	{
+	  QDPIO::cout << "HMCCheckpoint: " << obj.object_id
+		      << " does not exist yet, not written" << std::endl;
+	  continue;
+	}
+
+	HMCCheckpointParams::Restore_t entry;
+	entry.object_id   = obj.object_id;
+	entry.object_type = obj.object_type;
+
+	std::ostringstream file_name;
+	file_name << prefix << "_ckpt_" << update_no << "_" << obj.object_id;
+
+	if (obj.object_type == "DeflationSpace")
+	{
+	  // The space writes its own database
+	  file_name << ".mod";
+	  entry.file_name = file_name.str();
+
+	  TheNamedObjMap::Instance().getData< Handle<DeflationSpace> >(obj.object_id)->writeDisk(entry.file_name);
+	}
+	else
+	{
+	  // Everything else goes through the QIO object writers
+	  file_name << ".lime";
+	  entry.file_name = file_name.str();
+
+	  InlineQIOWriteNamedObjEnv::Params wp;
+	  wp.frequency = 1;
+	  wp.named_obj.object_id   = obj.object_id;
+	  wp.named_obj.object_type = obj.object_type;
+	  wp.file.file_name   = entry.file_name;
+	  wp.file.file_volfmt = volfmt;
+	  wp.file.parallel_io = (serpar == QDPIO_PARALLEL);
+
+	  XMLBufferWriter xml_dummy;
+	  InlineQIOWriteNamedObjEnv::InlineMeas writer(wp);
+	  writer(update_no, xml_dummy);
+	}
+
+	written.push_back(entry);
+      }
+
+      p.restore.resize(written.size());
+      int n = 0;
+      for(std::list<HMCCheckpointParams::Restore_t>::const_iterator e = written.begin();
+	  e != written.end(); ++e)
+	p.restore[n++] = *e;
+
+      QDPIO::cout << "HMCCheckpoint: wrote " << p.restore.size() << " named objects" << std::endl;
+
+      END_CODE();
+    }
+
+
+    //! Read the objects of the Restore list into the named object map
+    void restore(const HMCCheckpointParams& p,
+		 QDP_serialparallel_t serpar)
+    {
+      START_CODE();
+
+      for(int i=0; i < p.restore.size(); ++i)
+      {
+	const HMCCheckpointParams::Restore_t& obj = p.restore[i];
+
+	if (TheNamedObjMap::Instance().check(obj.object_id))
+	{
+	  QDPIO::cerr << "HMCCheckpoint: " << obj.object_id
+		      << " exists already, cannot restore it" << std::endl;
+	  QDP_abort(1);
+	}
+
+	QDPIO::cout << "HMCCheckpoint: restoring " << obj.object_id
+		    << " from " << obj.file_name << std::endl;
+
+	if (obj.object_type == "DeflationSpace")
+	{
+	  DeflationSpaceEnv::readSpace(obj.object_id, obj.file_name);
+	}
+	else
+	{
+	  // Go through XML, the reader also wants the group of the object
+	  XMLBufferWriter xml_buf;
+	  push(xml_buf, "Params");
+	  push(xml_buf, "NamedObject");
+	  write(xml_buf, "object_id", obj.object_id);
+	  write(xml_buf, "object_type", obj.object_type);
+	  pop(xml_buf);
+	  push(xml_buf, "File");
+	  write(xml_buf, "file_name", obj.file_name);
+	  write(xml_buf, "parallel_io", bool(serpar == QDPIO_PARALLEL));
+	  pop(xml_buf);
+	  pop(xml_buf);
+
+	  XMLReader xml_in(xml_buf);
+	  InlineQIOReadNamedObjEnv::Params rp(xml_in, "/Params");
+
+	  XMLBufferWriter xml_dummy;
+	  InlineQIOReadNamedObjEnv::InlineMeas reader(rp);
+	  reader(0, xml_dummy);
+	}
+      }
+
+      END_CODE();
+    }
+  }
+
+}
@@ -0,0 +1,89 @@
+// -*- C++ -*-
+/*! \file
+ * \brief Checkpoint of the HMC solver state
+ *
+ * Checkpoint of the HMC solver state
+ */
+
+#ifndef __hmc_checkpoint_h__
+#define __hmc_checkpoint_h__
+
+#include "chromabase.h"
+
+namespace Chroma
+{
+  //! Parameters of the HMC checkpoint
+  /*! @ingroup hmc
+   *
+   * The gauge field and the RNG seed are already part of every restart
+   * pair written by the HMC. The checkpoint adds the named objects that
+   * carry solver state from one trajectory to the next, for example the
+   * RitzPairsLatticeFermion of an eigCG solver or a DeflationSpace of the
+   * DEFLATED_INVERTER. Without them a restarted job starts with empty
+   * spaces and the first trajectories need many more iterations.
+   *
+   * Each listed object is written next to the configuration when the
+   * HMC saves its state. The restart file then holds the Restore list,
+   * and the objects on it are read back into the named object map
+   * before the first trajectory of the next run.
+   */
+  struct HMCCheckpointParams
+  {
+    HMCCheckpointParams();
+    HMCCheckpointParams(XMLReader& xml, const std::string& path);
+
+    struct NamedObject_t
+    {
+      std::string   object_id;
+      std::string   object_type;
+    };
+
+    struct Restore_t
+    {
+      std::string   object_id;
+      std::string   object_type;
+      std::string   file_name;
+    };
+
+    multi1d<NamedObject_t> named_obj;   /*!< objects to write */
+    multi1d<Restore_t>     restore;     /*!< objects written by the last save */
+  };
+
+  //! Reader
+  /*! @ingroup hmc */
+  void read(XMLReader& xml, const std::string& path, HMCCheckpointParams& p);
+
+  //! Writer
+  /*! @ingroup hmc */
+  void write(XMLWriter& xml, const std::string& path, const HMCCheckpointParams& p);
+
+
+  //! Write and restore the HMC checkpoint
+  /*! @ingroup hmc */
+  namespace HMCCheckpointEnv
+  {
+    //! Write the listed named objects and replace the Restore list with them
+    /*!
+     * Objects that do not exist yet, e.g. because the solver creating them
+     * has not run, are skipped.
+     *
+     * \param p          checkpoint parameters          ( Modify )
+     * \param prefix     file name prefix               ( Read )
+     * \param update_no  current update number          ( Read )
+     * \param volfmt     QIO volume format              ( Read )
+     * \param serpar     serial or parallel IO          ( Read )
+     */
+    void save(HMCCheckpointParams& p,
+	      const std::string& prefix,
+	      unsigned long update_no,
+	      QDP_volfmt_t volfmt,
+	      QDP_serialparallel_t serpar);
+
+    //! Read the objects of the Restore list into the named object map
+    void restore(const HMCCheckpointParams& p,
+		 QDP_serialparallel_t serpar);
+  }
+
+}
+
+#endif
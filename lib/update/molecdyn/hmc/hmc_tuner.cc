@@ -0,0 +1,509 @@
+/*! \file
+ * \brief Tuning of Hasenbusch masses and integrator step counts
+ *
+ * Tuning of Hasenbusch masses and integrator step counts
+ */
+
+#include "update/molecdyn/hmc/hmc_tuner.h"
+#include "update/molecdyn/monomial/monomial_profiler.h"
+#include "io/param_io.h"
+
+#include <cmath>
+#include <vector>
+#include <algorithm>
+
+namespace Chroma
+{
+
+  // Defaults
+  HMCTuneParams::HMCTuneParams()
+  {
+    n_therm    = 0;
+    n_traj     = 0;
+    target_acc = 0.8;
+    mass_shift = 0;
+  }
+
+  // Read parameters
+  HMCTuneParams::HMCTuneParams(XMLReader& xml, const std::string& path)
+  {
+    XMLReader paramtop(xml, path);
+
+    *this = HMCTuneParams();
+
+    read(paramtop, "NTraj", n_traj);
+
+    if (paramtop.count("NTherm") > 0)
+      read(paramtop, "NTherm", n_therm);
+
+    if (paramtop.count("TargetAcceptance") > 0)
+      read(paramtop, "TargetAcceptance", target_acc);
+
+    if (paramtop.count("MassShift") > 0)
+      read(paramtop, "MassShift", mass_shift);
+
+    if (n_traj < 2 || toBool(target_acc <= 0) || toBool(target_acc >= 1))
+    {
+      QDPIO::cerr << "HMCTune: need NTraj >= 2 and 0 < TargetAcceptance < 1" << std::endl;
+      QDP_abort(1);
+    }
+  }
+
+  // Reader
+  void read(XMLReader& xml, const std::string& path, HMCTuneParams& p)
+  {
+    HMCTuneParams tmp(xml, path);
+    p = tmp;
+  }
+
+  // Writer
+  void write(XMLWriter& xml, const std::string& path, const HMCTuneParams& p)
+  {
+    push(xml, path);
+
+    write(xml, "NTherm", p.n_therm);
+    write(xml, "NTraj", p.n_traj);
+    write(xml, "TargetAcceptance", p.target_acc);
+    write(xml, "MassShift", p.mass_shift);
+
+    pop(xml);
+  }
+
+
+  namespace HMCTunerEnv
+  {
+    namespace
+    {
+      typedef MonomialProfiler::MonMap_t    MonMap_t;
+      typedef MonomialProfiler::LevelMap_t  LevelMap_t;
+
+      //! One level of the integrator tree
+      struct Level
+      {
+	int                        n_steps;
+	std::vector<std::string>   ids;
+	std::string                key;      /*!< name of the level in the profiler */
+	double                     h;        /*!< step size */
+	double                     c;        /*!< secs per step */
+      };
+
+      //! One step of the Hasenbusch ladder
+      struct Rung
+      {
+	std::string  id;
+	double       m_num;    /*!< lighter mass */
+	double       m_den;    /*!< heavier mass, unused for the plain monomial */
+	bool         plainP;   /*!< plain two flavor monomial closing the ladder */
+      };
+
+      bool byMass(const Rung& a, const Rung& b)
+      {
+	return a.m_num < b.m_num;
+      }
+
+
+      //! Inverse of erfc on (0,1) by bisection
+      double erfcInv(double y)
+      {
+	double lo = 0, hi = 10;
+	for(int i=0; i < 100; ++i)
+	{
+	  double mid = 0.5*(lo + hi);
+	  if (std::erfc(mid) > y)
+	    lo = mid;
+	  else
+	    hi = mid;
+	}
+	return 0.5*(lo + hi);
+      }
+
+
+      //! Walk down the SubIntegrator tree
+      void readLevels(const std::string& integrator_xml,
+		      double& tau0,
+		      std::vector<Level>& levels)
+      {
+	std::istringstream is(integrator_xml);
+	XMLReader top(is);
+	XMLReader mdtop(top, "/MDIntegrator");
+
+	Real tau0_r;
+	read(mdtop, "tau0", tau0_r);
+	tau0 = toDouble(tau0_r);
+
+	double h = tau0;
+	std::string path = "./Integrator";
+	while (mdtop.count(path) > 0)
+	{
+	  XMLReader lt(mdtop, path);
+
+	  multi1d<std::string> ids;
+	  if (lt.count("./monomial_ids") > 0)
+	    read(lt, "./monomial_ids", ids);
+	  else if (lt.count("./monomial_list") > 0)
+	    read(lt, "./monomial_list", ids);
+
+	  if (ids.size() > 0)
+	  {
+	    if (lt.count("./n_steps") == 0)
+	    {
+	      QDPIO::cerr << "HMCTune: only integrators with n_steps can be tuned" << std::endl;
+	      QDP_abort(1);
+	    }
+
+	    Level l;
+	    read(lt, "./n_steps", l.n_steps);
+	    for(int i=0; i < ids.size(); ++i)
+	    {
+	      l.ids.push_back(ids[i]);
+	      l.key += (i > 0 ? " " : "") + ids[i];
+	    }
+
+	    h /= l.n_steps;
+	    l.h = h;
+	    l.c = 0;
+	    levels.push_back(l);
+	  }
+
+	  path += "/SubIntegrator";
+	}
+      }
+
+
+      //! Mass or kappa of a fermion action
+      bool readMass(XMLReader& top, const std::string& path, double& mass)
+      {
+	if (top.count(path + "/Mass") > 0)
+	{
+	  Real m;
+	  read(top, path + "/Mass", m);
+	  mass = toDouble(m);
+	  return true;
+	}
+
+	if (top.count(path + "/Kappa") > 0)
+	{
+	  Real kappa;
+	  read(top, path + "/Kappa", kappa);
+	  mass = toDouble(kappaToMass(kappa));
+	  return true;
+	}
+
+	return false;
+      }
+
+
+      //! Ratio and plain two flavor monomials
+      void readLadder(const std::string& monomials_xml,
+		      std::vector<Rung>& ratios,
+		      std::vector<Rung>& plains)
+      {
+	std::istringstream is(monomials_xml);
+	XMLReader top(is);
+	XMLReader mtop(top, "/Monomials");
+
+	int n = mtop.count("./elem");
+	for(int i=1; i <= n; ++i)
+	{
+	  std::ostringstream os;
+	  os << "./elem[" << i << "]";
+	  XMLReader et(mtop, os.str());
+
+	  std::string name;
+	  Rung r;
+	  read(et, "./Name", name);
+	  read(et, "./NamedObject/monomial_id", r.id);
+
+	  if (name.find("RATIO_CONV_CONV") != std::string::npos)
+	  {
+	    r.plainP = false;
+	    if (readMass(et, "./Action/FermionAction", r.m_num)
+		&& readMass(et, "./PrecAction/FermionAction", r.m_den))
+	      ratios.push_back(r);
+	  }
+	  else if (name.find("TWO_FLAVOR_") == 0 && name.find("RATIO") == std::string::npos)
+	  {
+	    r.plainP = true;
+	    r.m_den = 0;
+	    if (readMass(et, "./FermionAction", r.m_num))
+	      plains.push_back(r);
+	  }
+	}
+      }
+
+
+      //! Propose step counts for mean square forces F_sq per level
+      void proposeSteps(XMLWriter& xml, const std::string& path,
+			const std::vector<Level>& levels,
+			const std::vector<double>& F_sq,
+			double tau0, double K, double dH_sq_target)
+      {
+	std::vector<double> w(levels.size());
+	double sum = 0;
+	for(int l=0; l < levels.size(); ++l)
+	{
+	  w[l] = std::pow(levels[l].c / F_sq[l], 0.2);
+	  sum += F_sq[l] * std::pow(w[l], 4);
+	}
+	double a = std::pow(dH_sq_target / (K * sum), 0.25);
+
+	push(xml, path);
+	double h_outer = tau0;
+	double cost = 0;
+	for(int l=0; l < levels.size(); ++l)
+	{
+	  double h_opt = a * w[l];
+	  int n = std::max(1, int(std::ceil(h_outer / h_opt - 1.0e-6)));
+	  h_outer /= n;
+	  cost += levels[l].c * tau0 / h_outer;
+
+	  push(xml, "elem");
+	  write(xml, "monomial_ids", levels[l].key);
+	  write(xml, "n_steps", n);
+	  write(xml, "step_size", h_outer);
+	  write(xml, "F_rms", std::sqrt(F_sq[l]));
+	  pop(xml);
+
+	  QDPIO::cout << "HMCTune:   level [" << levels[l].key << "]  n_steps = " << n
+		      << "  step size = " << h_outer << std::endl;
+	}
+	pop(xml);
+
+	write(xml, "predicted_secs_per_traj", cost);
+	QDPIO::cout << "HMCTune:   predicted force time per trajectory = " << cost << " secs" << std::endl;
+      }
+    }
+
+
+    //! Write the proposals
+    void propose(XMLWriter& xml, const std::string& path,
+		 const HMCTuneParams& p,
+		 const std::string& monomials_xml,
+		 const std::string& integrator_xml,
+		 const multi1d<Double>& delta_H)
+    {
+      START_CODE();
+
+      const MonomialProfiler& profiler = TheMonomialProfiler::Instance();
+      const MonMap_t& mons = profiler.getMonomialTotals();
+      const LevelMap_t& level_totals = profiler.getLevelTotals();
+      const int n_traj = profiler.getNTraj();
+
+      if (n_traj == 0 || delta_H.size() == 0)
+      {
+	QDPIO::cerr << "HMCTune: no trajectories were profiled" << std::endl;
+	QDP_abort(1);
+      }
+
+      // Measured energy violation
+      double dH_sq = 0;
+      double acc = 0;
+      for(int i=0; i < delta_H.size(); ++i)
+      {
+	double dH = toDouble(delta_H[i]);
+	dH_sq += dH*dH;
+	acc += std::min(1.0, std::exp(-dH));
+      }
+      dH_sq /= delta_H.size();
+      acc /= delta_H.size();
+
+      double target = toDouble(p.target_acc);
+      double x = erfcInv(target);
+      double dH_sq_target = 8*x*x;
+
+      // Forces and costs per level
+      double tau0;
+      std::vector<Level> levels;
+      readLevels(integrator_xml, tau0, levels);
+
+      std::vector<double> F_sq(levels.size(), 0.0);
+      double model = 0;
+      for(int l=0; l < levels.size(); ++l)
+      {
+	LevelMap_t::const_iterator lt = level_totals.find(levels[l].key);
+	if (lt == level_totals.end())
+	{
+	  QDPIO::cerr << "HMCTune: no profile of level [" << levels[l].key << "]" << std::endl;
+	  QDP_abort(1);
+	}
+	levels[l].c = lt->second.secs / n_traj * levels[l].h / tau0;
+
+	for(int i=0; i < levels[l].ids.size(); ++i)
+	{
+	  MonMap_t::const_iterator m = mons.find(levels[l].ids[i]);
+	  if (m != mons.end() && m->second.force.n > 0)
+	    F_sq[l] += m->second.force.rms_sq / m->second.force.n;
+	}
+
+	if (F_sq[l] <= 0)
+	{
+	  QDPIO::cerr << "HMCTune: no force measured on level [" << levels[l].key << "]" << std::endl;
+	  QDP_abort(1);
+	}
+
+	model += F_sq[l] * std::pow(levels[l].h, 4);
+      }
+      double K = dH_sq / model;
+
+      push(xml, path);
+      write(xml, "TuneParams", p);
+      write(xml, "n_traj", n_traj);
+      write(xml, "dH_sq", dH_sq);
+      write(xml, "acceptance", acc);
+      write(xml, "model_K", K);
+
+      QDPIO::cout << "HMCTune: <dH^2> = " << dH_sq << "  acceptance = " << acc
+		  << "  target = " << target << std::endl;
+
+      push(xml, "MeasuredLevels");
+      for(int l=0; l < levels.size(); ++l)
+      {
+	push(xml, "elem");
+	write(xml, "monomial_ids", levels[l].key);
+	write(xml, "n_steps", levels[l].n_steps);
+	write(xml, "step_size", levels[l].h);
+	write(xml, "secs_per_step", levels[l].c);
+	write(xml, "F_rms", std::sqrt(F_sq[l]));
+	pop(xml);
+      }
+      pop(xml);
+
+      QDPIO::cout << "HMCTune: step counts for the present monomials" << std::endl;
+      proposeSteps(xml, "ProposedLevels", levels, F_sq, tau0, K, dH_sq_target);
+
+      // Hasenbusch ladder
+      std::vector<Rung> ratios, plains;
+      readLadder(monomials_xml, ratios, plains);
+      std::sort(ratios.begin(), ratios.end(), byMass);
+
+      push(xml, "Hasenbusch");
+      if (ratios.size() == 0)
+      {
+	QDPIO::cout << "HMCTune: no ratio monomials, no Hasenbusch masses proposed" << std::endl;
+	write(xml, "status", std::string("no ratio monomials"));
+      }
+      else
+      {
+	const double shift = toDouble(p.mass_shift);
+	const double tol = 1.0e-8;
+
+	std::vector<Rung> ladder = ratios;
+	bool chainP = true;
+	for(int i=0; i+1 < ladder.size(); ++i)
+	  chainP &= std::fabs(ladder[i].m_den - ladder[i+1].m_num) < tol;
+
+	for(int i=0; i < plains.size(); ++i)
+	{
+	  if (std::fabs(plains[i].m_num - ladder.back().m_den) < tol)
+	  {
+	    ladder.push_back(plains[i]);
+	    break;
+	  }
+	}
+	const bool plainP = ladder.back().plainP;
+
+	bool positiveP = true;
+	for(int i=0; i < ladder.size(); ++i)
+	  positiveP &= (ladder[i].m_num + shift > 0) && (plainP || ladder[i].m_den + shift > 0);
+
+	if (! chainP || ! positiveP)
+	{
+	  QDPIO::cout << "HMCTune: the ratio monomials do not form a ladder of positive shifted masses, "
+		      << "no Hasenbusch masses proposed" << std::endl;
+	  write(xml, "status", std::string("no ladder"));
+	}
+	else
+	{
+	  // Fit F = A (1/m_i - 1/m_(i+1)) in the shifted masses
+	  const int n = ladder.size();
+	  std::vector<double> x_old(n), F_old(n);
+	  double sxx = 0, sxf = 0;
+	  for(int i=0; i < n; ++i)
+	  {
+	    x_old[i] = 1/(ladder[i].m_num + shift)
+	      - (ladder[i].plainP ? 0 : 1/(ladder[i].m_den + shift));
+
+	    MonMap_t::const_iterator m = mons.find(ladder[i].id);
+	    F_old[i] = (m != mons.end() && m->second.force.n > 0) ?
+	      std::sqrt(m->second.force.rms_sq / m->second.force.n) : 0;
+
+	    sxx += x_old[i]*x_old[i];
+	    sxf += x_old[i]*F_old[i];
+	  }
+	  const double A = sxf / sxx;
+	  if (A <= 0)
+	  {
+	    QDPIO::cerr << "HMCTune: the Hasenbusch force model does not fit, A = " << A << std::endl;
+	    QDP_abort(1);
+	  }
+
+	  // Even spacing in 1/m between the fixed ends
+	  const double inv_lo = 1/(ladder[0].m_num + shift);
+	  const double inv_hi = plainP ? 0 : 1/(ladder.back().m_den + shift);
+	  const double dx = (inv_lo - inv_hi) / n;
+
+	  write(xml, "status", std::string("ok"));
+	  write(xml, "fit_A", A);
+	  QDPIO::cout << "HMCTune: Hasenbusch force model A = " << A << std::endl;
+
+	  std::map<std::string, double> F_new;
+	  push(xml, "Ladder");
+	  for(int i=0; i < n; ++i)
+	  {
+	    double m_num = 1/(inv_lo - i*dx) - shift;
+	    double m_den = (i+1 < n || ! plainP) ? 1/(inv_lo - (i+1)*dx) - shift : 0;
+	    F_new[ladder[i].id] = A * dx;
+
+	    push(xml, "elem");
+	    write(xml, "monomial_id", ladder[i].id);
+	    write(xml, "plain", ladder[i].plainP);
+	    write(xml, "mass", ladder[i].m_num);
+	    if (! ladder[i].plainP)
+	      write(xml, "prec_mass", ladder[i].m_den);
+	    write(xml, "F_rms", F_old[i]);
+	    write(xml, "F_rms_model", A * x_old[i]);
+	    write(xml, "proposed_mass", m_num);
+	    if (! ladder[i].plainP)
+	      write(xml, "proposed_prec_mass", m_den);
+	    write(xml, "proposed_F_rms_model", A * dx);
+	    pop(xml);
+
+	    QDPIO::cout << "HMCTune:   " << ladder[i].id << "  mass " << ladder[i].m_num
+			<< " -> " << m_num;
+	    if (! ladder[i].plainP)
+	      QDPIO::cout << "  prec mass " << ladder[i].m_den << " -> " << m_den;
+	    QDPIO::cout << std::endl;
+	  }
+	  pop(xml);
+
+	  // Step counts with the modelled forces of the new ladder
+	  std::vector<double> F_sq_new(levels.size(), 0.0);
+	  for(int l=0; l < levels.size(); ++l)
+	  {
+	    for(int i=0; i < levels[l].ids.size(); ++i)
+	    {
+	      const std::string& id = levels[l].ids[i];
+	      if (F_new.count(id) > 0)
+		F_sq_new[l] += F_new[id] * F_new[id];
+	      else
+	      {
+		MonMap_t::const_iterator m = mons.find(id);
+		if (m != mons.end() && m->second.force.n > 0)
+		  F_sq_new[l] += m->second.force.rms_sq / m->second.force.n;
+	      }
+	    }
+	  }
+
+	  QDPIO::cout << "HMCTune: step counts for the proposed masses" << std::endl;
+	  proposeSteps(xml, "ProposedLevels", levels, F_sq_new, tau0, K, dH_sq_target);
+	}
+      }
+      pop(xml); // Hasenbusch
+
+      pop(xml);
+
+      END_CODE();
+    }
+  }
+
+}
@@ -0,0 +1,83 @@
+// -*- C++ -*-
+/*! \file
+ * \brief Tuning of Hasenbusch masses and integrator step counts
+ *
+ * Tuning of Hasenbusch masses and integrator step counts
+ */
+
+#ifndef __hmc_tuner_h__
+#define __hmc_tuner_h__
+
+#include "chromabase.h"
+
+namespace Chroma
+{
+
+  //! Parameters of the tuning mode of hmc
+  /*! \ingroup hmc */
+  struct HMCTuneParams
+  {
+    HMCTuneParams();
+    HMCTuneParams(XMLReader& xml, const std::string& path);
+
+    int    n_therm;       /*!< trajectories before measuring */
+    int    n_traj;        /*!< trajectories measured */
+    Real   target_acc;    /*!< acceptance the step counts are tuned to */
+    Real   mass_shift;    /*!< added to the masses of the Hasenbusch model, e.g. -m_crit */
+  };
+
+  //! Read the tuning parameters
+  /*! \ingroup hmc */
+  void read(XMLReader& xml, const std::string& path, HMCTuneParams& p);
+
+  //! Write the tuning parameters
+  /*! \ingroup hmc */
+  void write(XMLWriter& xml, const std::string& path, const HMCTuneParams& p);
+
+
+  //! Tuning of Hasenbusch masses and integrator step counts
+  /*! \ingroup hmc
+   *
+   * Works on the totals of TheMonomialProfiler over the tuning
+   * trajectories, run with the force sizes switched on.
+   *
+   * Step counts: to second order the energy violation is modelled as
+   * <dH^2> = K sum_l F_l^2 h_l^4 for the levels l of the integrator
+   * tree, with F_l^2 the summed mean square forces of the monomials on
+   * the level and h_l its step size. K is fixed by the measured <dH^2>.
+   * The cost c_l tau/h_l with the measured time c_l of a step is
+   * minimal for h_l ~ (c_l/F_l^2)^(1/5). The overall scale is set by
+   * the target acceptance erfc(sqrt(<dH>)/2) with <dH> = <dH^2>/2.
+   * Step counts are rounded up, so the acceptance comes out above the
+   * target.
+   *
+   * Hasenbusch masses: the ratio monomials are ordered into a ladder
+   * m_0 < m_1 < ... by their masses, closed by a plain two flavor
+   * monomial at the heaviest mass if there is one. The force of the
+   * step from m_i to m_(i+1) is modelled as A (1/m_i - 1/m_(i+1)),
+   * with A fitted to the measured forces. The proposed ladder keeps the
+   * lightest and, without a plain monomial, the heaviest mass, and
+   * spaces 1/m evenly, which makes the modelled forces equal. The step
+   * counts are proposed again with the modelled forces of that ladder.
+   */
+  namespace HMCTunerEnv
+  {
+    //! Write the proposals
+    /*!
+     * \param xml            where the proposals go
+     * \param path           group of the proposals
+     * \param p              tuning parameters
+     * \param monomials_xml  the Monomials of the HMC input
+     * \param integrator_xml the MDIntegrator of the HMC input
+     * \param delta_H        energy violations of the tuning trajectories
+     */
+    void propose(XMLWriter& xml, const std::string& path,
+		 const HMCTuneParams& p,
+		 const std::string& monomials_xml,
+		 const std::string& integrator_xml,
+		 const multi1d<Double>& delta_H);
+  }
+
+}
+
+#endif
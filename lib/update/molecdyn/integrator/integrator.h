@@ -29,6 +29,7 @@
 #include "update/molecdyn/integrator/lcm_4mn4fp_recursive.h"
 #include "update/molecdyn/integrator/lcm_4mn5fp_recursive.h"
 #include "update/molecdyn/integrator/lcm_4mn5fv_recursive.h"
+#include "update/molecdyn/integrator/lcm_sts_force_grad_recursive.h"
 
 #include "update/molecdyn/integrator/integrator_aggregate.h"
 #endif
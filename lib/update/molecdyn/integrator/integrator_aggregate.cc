@@ -11,6 +11,7 @@
 #include "update/molecdyn/integrator/lcm_4mn5fp_recursive.h"
 #include "update/molecdyn/integrator/lcm_4mn4fp_recursive.h"
 #include "update/molecdyn/integrator/lcm_creutz_gocksch_4_recursive.h"
+#include "update/molecdyn/integrator/lcm_sts_force_grad_recursive.h"
 namespace Chroma 
 {
 
@@ -40,6 +41,7 @@ namespace Chroma
 	success &=  LatColMat4MN5FVRecursiveIntegratorEnv::registerAll();
 	success &=  LatColMat4MN5FPRecursiveIntegratorEnv::registerAll();
 	success &=  LatColMatCreutzGocksch4RecursiveIntegratorEnv::registerAll();
+	success &=  LatColMatSTSForceGradRecursiveIntegratorEnv::registerAll();
 	registered = true;
       }
       return success;
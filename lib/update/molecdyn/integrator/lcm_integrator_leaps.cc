@@ -3,6 +3,7 @@
 #include "util/gauge/reunit.h"
 #include "util/gauge/expmat.h"
 #include "update/molecdyn/monomial/force_monitors.h"
+#include "update/molecdyn/monomial/monomial_profiler.h"
 
 namespace Chroma 
 { 
@@ -10,33 +11,86 @@ namespace Chroma
   namespace LCMMDIntegratorSteps 
   { 
 
-    //! LeapP for just a selected list of monomials
-    void leapP(const multi1d< IntegratorShared::MonomialPair >& monomials,
-	                                       
-	       const Real& dt, 
-	       	       
-	       AbsFieldState<multi1d<LatticeColorMatrix>,
-	       multi1d<LatticeColorMatrix> >& s)
+    namespace
+    {
+      //! Counts the changes of the gauge field by the integrator steps
+      unsigned long q_version = 0;
+
+      //! Step sizes per direction, including the anisotropy factors
+      void stepSizes(const Real& dt, multi1d<Real>& real_step_size)
+      {
+	real_step_size.resize(Nd);
+	for(int mu =0; mu < Nd; mu++) 
+	{
+	  real_step_size[mu] = dt * theAnisoStepSizeArray::Instance().getStepSizeFactor(mu);
+	}
+      }
+
+      //! P += dt dsdQ
+      void kickP(const multi1d<LatticeColorMatrix>& dsdQ,
+		 const multi1d<Real>& real_step_size,
+		 AbsFieldState<multi1d<LatticeColorMatrix>,
+		 multi1d<LatticeColorMatrix> >& s)
+      {
+	for(int mu =0; mu < Nd; mu++) {
+
+	  (s.getP())[mu] += real_step_size[mu] * dsdQ[mu];
+	
+	  // taproj it...
+	  taproj( (s.getP())[mu] );
+	}
+      }
+
+      //! U = exp(dt F) U for every direction
+      void moveQ(const multi1d<LatticeColorMatrix>& F,
+		 const multi1d<Real>& real_step_size,
+		 multi1d<LatticeColorMatrix>& u)
+      {
+	LatticeColorMatrix tmp_1;
+	LatticeColorMatrix tmp_2;
+
+	for(int mu = 0; mu < Nd; mu++) 
+	{
+	  //  dt*F[mu]
+	  tmp_1 = real_step_size[mu]*F[mu];
+	
+	  // tmp_1 = exp(dt*F[mu])  
+	  // expmat(tmp_1, EXP_TWELFTH_ORDER);
+	  expmat(tmp_1, EXP_EXACT);
+	
+	  // tmp_2 = exp(dt*F[mu]) u[mu] = tmp_1 * u[mu]
+	  tmp_2 = tmp_1*u[mu];
+	
+	  // u[mu] =  tmp_1 * u[mu] =  tmp_2 
+	  u[mu] = tmp_2;
+	
+	  // Reunitarize u[mu]
+	  int numbad;
+	  reunit(u[mu], numbad, REUNITARIZE_ERROR);
+	}
+
+	++q_version;
+      }
+    }
+
+
+    //! Force of a selected list of monomials
+    void computeForce(const multi1d< IntegratorShared::MonomialPair >& monomials,
+		      const AbsFieldState<multi1d<LatticeColorMatrix>,
+		      multi1d<LatticeColorMatrix> >& s,
+		      multi1d<LatticeColorMatrix>& dsdQ)
     {
       START_CODE();
       StopWatch swatch;
+      StopWatch level_swatch;
+      level_swatch.reset(); level_swatch.start();
 
+      MonomialProfiler& profiler = TheMonomialProfiler::Instance();
 
       XMLWriter& xml_out = TheXMLLogWriter::Instance();
-      // Self Description rule
-      push(xml_out, "leapP");
-      write(xml_out, "dt", dt);
-      multi1d<Real> real_step_size(Nd);
 
-      // Work out the array of step sizes (including all scaling factors
-      for(int mu =0; mu < Nd; mu++) 
-      {
-	real_step_size[mu] = dt * theAnisoStepSizeArray::Instance().getStepSizeFactor(mu);
-      }
-      write(xml_out, "dt_actual_per_dir", real_step_size);
-      
       // Force Term
-      multi1d<LatticeColorMatrix> dsdQ(Nd);
+      dsdQ.resize(Nd);
       push(xml_out, "AbsHamiltonianForce"); // Backward compatibility
       write(xml_out, "num_terms", monomials.size());
       push(xml_out, "ForcesByMonomial");
@@ -44,16 +98,24 @@ namespace Chroma
       if( monomials.size() > 0 ) { 
 	push(xml_out, "elem");
 	swatch.reset(); swatch.start();
+	profiler.begin(monomials[0].id, MonomialProfiler::FORCE);
 	monomials[0].mon->dsdq(dsdQ,s);
+	profiler.end();
 	swatch.stop();
+	if (profiler.measureForces())
+	  profiler.addForce(monomials[0].id, dsdQ);
 	QDPIO::cout << "FORCE TIME: " << monomials[0].id <<  " : " << swatch.getTimeInSeconds() << std::endl;
 	pop(xml_out); //elem
 	for(int i=1; i < monomials.size(); i++) { 
 	  push(xml_out, "elem");
 	  multi1d<LatticeColorMatrix> cur_F(Nd);
 	  swatch.reset(); swatch.start();
+	  profiler.begin(monomials[i].id, MonomialProfiler::FORCE);
 	  monomials[i].mon->dsdq(cur_F, s);
+	  profiler.end();
 	  swatch.stop();
+	  if (profiler.measureForces())
+	    profiler.addForce(monomials[i].id, cur_F);
 	  dsdQ += cur_F;
 
 	  QDPIO::cout << "FORCE TIME: " << monomials[i].id << " : " << swatch.getTimeInSeconds() << "\n";
@@ -65,67 +127,151 @@ namespace Chroma
       //monitorForces(xml_out, "TotalForcesThisLevel", dsdQ);
       pop(xml_out); // AbsHamiltonianForce 
 
+      // The level is named by the monomials it updates
+      level_swatch.stop();
+      std::string level_ids;
+      for(int i=0; i < monomials.size(); i++) {
+	if (i > 0) level_ids += " ";
+	level_ids += monomials[i].id;
+      }
+      profiler.addLevelStep(level_ids, level_swatch.getTimeInSeconds());
 
-      for(int mu =0; mu < Nd; mu++) {
+      END_CODE();
+    }
 
-	(s.getP())[mu] += real_step_size[mu] * dsdQ[mu];
-	
-	// taproj it...
-	taproj( (s.getP())[mu] );
-      }
+
+    //! LeapP for just a selected list of monomials
+    void leapP(const multi1d< IntegratorShared::MonomialPair >& monomials,
+	                                       
+	       const Real& dt, 
+	       	       
+	       AbsFieldState<multi1d<LatticeColorMatrix>,
+	       multi1d<LatticeColorMatrix> >& s)
+    {
+      START_CODE();
+
+      XMLWriter& xml_out = TheXMLLogWriter::Instance();
+      // Self Description rule
+      push(xml_out, "leapP");
+      write(xml_out, "dt", dt);
+      multi1d<Real> real_step_size;
+
+      // Work out the array of step sizes (including all scaling factors
+      stepSizes(dt, real_step_size);
+      write(xml_out, "dt_actual_per_dir", real_step_size);
+      
+      multi1d<LatticeColorMatrix> dsdQ;
+      computeForce(monomials, s, dsdQ);
+      kickP(dsdQ, real_step_size, s);
       
       pop(xml_out); // pop("leapP");
     
       END_CODE();
     }
 
+
+    //! LeapP with a force computed before
+    void leapP(const multi1d<LatticeColorMatrix>& dsdQ,
+	       const Real& dt, 
+	       AbsFieldState<multi1d<LatticeColorMatrix>,
+	       multi1d<LatticeColorMatrix> >& s)
+    {
+      START_CODE();
+
+      XMLWriter& xml_out = TheXMLLogWriter::Instance();
+      push(xml_out, "leapP");
+      write(xml_out, "dt", dt);
+      write(xml_out, "cached_force", true);
+      multi1d<Real> real_step_size;
+      stepSizes(dt, real_step_size);
+      write(xml_out, "dt_actual_per_dir", real_step_size);
+
+      kickP(dsdQ, real_step_size, s);
+
+      pop(xml_out); // pop("leapP");
+
+      END_CODE();
+    }
+
+
+    //! LeapP with the force at a displaced gauge field
+    void leapPForceGradient(const multi1d< IntegratorShared::MonomialPair >& monomials,
+			    const Real& dt, 
+			    const Real& eps,
+			    AbsFieldState<multi1d<LatticeColorMatrix>,
+			    multi1d<LatticeColorMatrix> >& s)
+    {
+      START_CODE();
+
+      XMLWriter& xml_out = TheXMLLogWriter::Instance();
+      push(xml_out, "leapPForceGradient");
+      write(xml_out, "dt", dt);
+      write(xml_out, "eps", eps);
+      multi1d<Real> real_step_size;
+      stepSizes(dt, real_step_size);
+      write(xml_out, "dt_actual_per_dir", real_step_size);
+
+      // The displacement is a Q step with the force as momentum, so
+      // both step size factors go in
+      multi1d<Real> eps_per_dir(Nd);
+      for(int mu=0; mu < Nd; mu++) 
+      {
+	Real f = theAnisoStepSizeArray::Instance().getStepSizeFactor(mu);
+	eps_per_dir[mu] = eps * f * f;
+      }
+
+      // Force at U, made antihermitian traceless to move along
+      multi1d<LatticeColorMatrix> F;
+      push(xml_out, "ForceAtU");
+      computeForce(monomials, s, F);
+      pop(xml_out);
+      for(int mu=0; mu < Nd; mu++) 
+	taproj(F[mu]);
+
+      // U' = exp(eps F) U, the force at U' gives the force gradient term
+      multi1d<LatticeColorMatrix> u_save = s.getQ();
+      moveQ(F, eps_per_dir, s.getQ());
+
+      push(xml_out, "ForceAtDisplacedU");
+      computeForce(monomials, s, F);
+      pop(xml_out);
+
+      s.getQ() = u_save;
+      ++q_version;
+
+      kickP(F, real_step_size, s);
+
+      pop(xml_out); // pop("leapPForceGradient");
+
+      END_CODE();
+    }
+
+
+    //! Number of changes of the gauge field by the integrator steps
+    unsigned long getQVersion()
+    {
+      return q_version;
+    }
+
+
     void leapQ(const Real& dt, 
 	       AbsFieldState<multi1d<LatticeColorMatrix>,
 	       multi1d<LatticeColorMatrix> >& s) 
     {
       START_CODE();
 
-      LatticeColorMatrix tmp_1;
-      LatticeColorMatrix tmp_2;
-      
       XMLWriter& xml_out= TheXMLLogWriter::Instance();
       // Self description rule
       push(xml_out, "leapQ");
       write(xml_out, "dt", dt);
-      multi1d<Real> real_step_size(Nd);
+      multi1d<Real> real_step_size;
 
       // Work out the array of step sizes (including all scaling factors
-      for(int mu =0; mu < Nd; mu++) 
-      {
-	real_step_size[mu] = dt * theAnisoStepSizeArray::Instance().getStepSizeFactor(mu);
-      }
+      stepSizes(dt, real_step_size);
       write(xml_out, "dt_actual_per_dir", real_step_size);
       
-      // Constant
-      const multi1d<LatticeColorMatrix>& p_mom = s.getP();
-      
-      // Mutable
-      multi1d<LatticeColorMatrix>& u = s.getQ();
-      
-      for(int mu = 0; mu < Nd; mu++) 
-      {
-	//  dt*p[mu]
-	tmp_1 = real_step_size[mu]*(s.getP())[mu];
-	
-	// tmp_1 = exp(dt*p[mu])  
-	// expmat(tmp_1, EXP_TWELFTH_ORDER);
-	expmat(tmp_1, EXP_EXACT);
-	
-	// tmp_2 = exp(dt*p[mu]) u[mu] = tmp_1 * u[mu]
-	tmp_2 = tmp_1*(s.getQ())[mu];
-	
-	// u[mu] =  tmp_1 * u[mu] =  tmp_2 
-	(s.getQ())[mu] = tmp_2;
-	
-	// Reunitarize u[mu]
-	int numbad;
-	reunit((s.getQ())[mu], numbad, REUNITARIZE_ERROR);
-      }
+      // u[mu] = exp(dt*p[mu]) u[mu]
+      moveQ(s.getP(), real_step_size, s.getQ());
 
       pop(xml_out);
     
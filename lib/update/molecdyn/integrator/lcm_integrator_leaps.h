@@ -68,6 +68,42 @@ namespace Chroma
 	       AbsFieldState<multi1d<LatticeColorMatrix>,
 			     multi1d<LatticeColorMatrix> >& s);
 
+    //! Force of a list of monomials
+    /*! @ingroup integrator */
+    void computeForce(const multi1d< IntegratorShared::MonomialPair >& monomials,
+		      const AbsFieldState<multi1d<LatticeColorMatrix>,
+		                          multi1d<LatticeColorMatrix> >& s,
+		      multi1d<LatticeColorMatrix>& dsdQ);
+
+    //! LeapP with a force computed before, e.g. by computeForce()
+    /*! @ingroup integrator */
+    void leapP(const multi1d<LatticeColorMatrix>& dsdQ,
+	       const Real& dt, 
+	       AbsFieldState<multi1d<LatticeColorMatrix>,
+			     multi1d<LatticeColorMatrix> >& s);
+
+    //! LeapP with the approximate force gradient
+    /*! @ingroup integrator
+     *
+     * The force F of the monomials moves the gauge field to
+     * U' = exp(eps F) U, and P is updated with the force at U'.
+     * To first order in eps this adds the force gradient term
+     * eps dt (F.d)F to the force. U is put back afterwards.
+     */
+    void leapPForceGradient(const multi1d< IntegratorShared::MonomialPair >& monomials,
+			    const Real& dt, 
+			    const Real& eps,
+			    AbsFieldState<multi1d<LatticeColorMatrix>,
+			                  multi1d<LatticeColorMatrix> >& s);
+
+    //! Number of changes of the gauge field by the integrator steps
+    /*! @ingroup integrator
+     *
+     * A force computed when this was the same is still the force at
+     * the present gauge field.
+     */
+    unsigned long getQVersion();
+
 
 
 
@@ -0,0 +1,162 @@
+#include "chromabase.h"
+#include "update/molecdyn/integrator/md_integrator_factory.h"
+#include "update/molecdyn/integrator/lcm_sts_force_grad_recursive.h"
+#include "update/molecdyn/integrator/lcm_integrator_leaps.h"
+#include "io/xmllog_io.h"
+
+#include <string>
+
+namespace Chroma 
+{ 
+  
+  namespace LatColMatSTSForceGradRecursiveIntegratorEnv 
+  {
+    namespace
+    {
+      AbsComponentIntegrator<multi1d<LatticeColorMatrix>, 
+			     multi1d<LatticeColorMatrix> >* 
+      createMDIntegrator(
+			 XMLReader& xml, 
+			 const std::string& path)
+      {
+	// Read the integrator params
+	LatColMatSTSForceGradRecursiveIntegratorParams p(xml, path);
+    
+	return new LatColMatSTSForceGradRecursiveIntegrator(p);
+      }
+      
+      //! Local registration flag
+      bool registered = false;
+    }
+
+    const std::string name = "LCM_STS_FORCE_GRAD";
+
+    //! Register all the factories
+    bool registerAll() 
+    {
+      bool success = true; 
+      if (! registered)
+      {
+	success &= TheMDComponentIntegratorFactory::Instance().registerObject(name, createMDIntegrator); 
+	registered = true;
+      }
+      return success;
+    }
+  }
+  
+  
+  LatColMatSTSForceGradRecursiveIntegratorParams::LatColMatSTSForceGradRecursiveIntegratorParams(XMLReader& xml_in, const std::string& path) 
+  {
+    XMLReader paramtop(xml_in, path);
+    try {
+      read(paramtop, "./n_steps", n_steps);
+      read(paramtop, "./monomial_ids", monomial_ids);
+      if( paramtop.count("./SubIntegrator") == 0 ) {
+	// BASE CASE: User does not supply sub-integrator 
+	//
+	// Sneaky way - create an XML document for EXP_T
+	XMLBufferWriter subintegrator_writer;
+	int one_sub_step=1;
+
+	push(subintegrator_writer, "SubIntegrator");
+	write(subintegrator_writer, "Name", "LCM_EXP_T");
+	write(subintegrator_writer, "n_steps", one_sub_step);
+	pop(subintegrator_writer);
+
+	subintegrator_xml = subintegrator_writer.str();
+
+      }
+      else {
+	// RECURSIVE CASE: User Does Supply Sub Integrator
+	//
+	// Read it
+	XMLReader subint_reader(paramtop, "./SubIntegrator");
+	std::ostringstream subintegrator_os;
+	subint_reader.print(subintegrator_os);
+	subintegrator_xml = subintegrator_os.str();
+	QDPIO::cout << "Subintegrator XML is: " << std::endl;
+	QDPIO::cout << subintegrator_xml << std::endl;
+      }
+    }
+    catch ( const std::string& e ) { 
+      QDPIO::cout << "Error reading XML in LatColMatSTSForceGradRecursiveIntegratorParams " << e << std::endl;
+      QDP_abort(1);
+    }
+  }
+  
+  void read(XMLReader& xml, 
+	    const std::string& path, 
+	    LatColMatSTSForceGradRecursiveIntegratorParams& p) {
+    LatColMatSTSForceGradRecursiveIntegratorParams tmp(xml, path);
+    p = tmp;
+  }
+
+  void write(XMLWriter& xml, 
+	     const std::string& path, 
+	     const LatColMatSTSForceGradRecursiveIntegratorParams& p) {
+    push(xml, path);
+    write(xml, "n_steps", p.n_steps);
+    write(xml, "monomial_ids", p.monomial_ids);
+    xml << p.subintegrator_xml;
+    pop(xml);
+  }
+
+  
+
+  void LatColMatSTSForceGradRecursiveIntegrator::operator()( 
+					     AbsFieldState<multi1d<LatticeColorMatrix>,
+					     multi1d<LatticeColorMatrix> >& s, 
+					     const Real& traj_length) const
+  {
+   
+    START_CODE();
+
+    const AbsComponentIntegrator< multi1d<LatticeColorMatrix>,
+      multi1d<LatticeColorMatrix> >& subIntegrator = getSubIntegrator();
+
+    Real dtau = traj_length / Real(n_steps);
+    Real dtauby2 = dtau / Real(2);
+    Real dtauby6 = dtau / Real(6);
+    Real dtauby3 = dtau / Real(3);
+    Real two_dtauby3 = Real(2)*dtau / Real(3);
+    Real eps = dtau*dtau / Real(24);
+
+    // First force update. The force of the last call is still good
+    // if the gauge field did not move since.
+    if( cache_validP 
+	&& cache_state == &s 
+	&& cache_q_version == LCMMDIntegratorSteps::getQVersion() ) { 
+      QDPIO::cout << "LCM_STS_FORCE_GRAD: reusing the force of the last call" << std::endl;
+      LCMMDIntegratorSteps::leapP(cache_force, dtauby6, s);
+    }
+    else { 
+      LCMMDIntegratorSteps::leapP(monomials, dtauby6, s);
+    }
+
+    for(int i=0; i < n_steps-1; i++) {  // N-1 full steps
+      subIntegrator(s, dtauby2);
+      LCMMDIntegratorSteps::leapPForceGradient(monomials, two_dtauby3, eps, s);
+      subIntegrator(s, dtauby2);
+
+      // Roll the last force update of this step and the first 
+      // of the next into one
+      LCMMDIntegratorSteps::leapP(monomials, dtauby3, s);
+    }
+
+    // Last step, keep its last force for the next call
+    subIntegrator(s, dtauby2);
+    LCMMDIntegratorSteps::leapPForceGradient(monomials, two_dtauby3, eps, s);
+    subIntegrator(s, dtauby2);
+
+    LCMMDIntegratorSteps::computeForce(monomials, s, cache_force);
+    LCMMDIntegratorSteps::leapP(cache_force, dtauby6, s);
+
+    cache_validP = true;
+    cache_state = &s;
+    cache_q_version = LCMMDIntegratorSteps::getQVersion();
+
+    END_CODE();
+  }
+
+
+};
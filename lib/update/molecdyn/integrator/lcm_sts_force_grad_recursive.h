@@ -0,0 +1,146 @@
+// -*- C++ -*-
+
+/*! @file
+ * @brief Lat Col Mat 4th order force gradient integrator
+ *
+ * The 4th order force gradient integrator of Omelyan, Mryglod and Folk
+ * with the force gradient term approximated by the force at a displaced
+ * gauge field, following Yin and Mawhinney. Made recursive through
+ * replacing the gauge field update with a subIntegrator call.
+ */
+
+#ifndef LCM_STS_FORCE_GRAD_RECURSIVE_H
+#define LCM_STS_FORCE_GRAD_RECURSIVE_H
+
+
+#include "chromabase.h"
+#include "update/molecdyn/hamiltonian/abs_hamiltonian.h"
+#include "update/molecdyn/integrator/abs_integrator.h"
+#include "update/molecdyn/integrator/integrator_shared.h"
+
+namespace Chroma
+{
+
+  /*! @ingroup integrator */
+  namespace LatColMatSTSForceGradRecursiveIntegratorEnv
+  {
+    extern const std::string name;
+    bool registerAll();
+  }
+
+
+  /*! @ingroup integrator */
+  struct  LatColMatSTSForceGradRecursiveIntegratorParams
+  {
+    LatColMatSTSForceGradRecursiveIntegratorParams();
+    LatColMatSTSForceGradRecursiveIntegratorParams(XMLReader& xml, const std::string& path);
+    int  n_steps;
+    multi1d<std::string> monomial_ids;
+    std::string subintegrator_xml;
+  };
+
+  /*! @ingroup integrator */
+  void read(XMLReader& xml_in,
+	    const std::string& path,
+	    LatColMatSTSForceGradRecursiveIntegratorParams& p);
+
+  /*! @ingroup integrator */
+  void write(XMLWriter& xml_out,
+	     const std::string& path,
+	     const LatColMatSTSForceGradRecursiveIntegratorParams& p);
+
+  //! MD integrator interface for the force gradient integrator
+  /*! @ingroup integrator
+   *  Specialised to multi1d<LatticeColorMatrix>
+   *
+   *  One step of size h is
+   *
+   *  exp(h/6 S) exp(h/2 T) exp(2h/3 S - h^3/72 C) exp(h/2 T) exp(h/6 S)
+   *
+   *  with C = [S,[S,T]]. The middle step uses the force at
+   *  exp(h^2/24 F) U. The outer force updates of neighbouring steps are
+   *  done as one, so a step costs three force evaluations.
+   *
+   *  As a sub integrator, the gauge field is not changed between the
+   *  last force update of one call and the first one of the next call.
+   *  That force is kept and used again, then a step costs two force
+   *  evaluations. It is dropped when the predictors are reset at the
+   *  start of each trajectory.
+   */
+  class LatColMatSTSForceGradRecursiveIntegrator
+    : public AbsRecursiveIntegrator<multi1d<LatticeColorMatrix>,
+				    multi1d<LatticeColorMatrix> >
+  {
+  public:
+
+    // Simplest Constructor
+    LatColMatSTSForceGradRecursiveIntegrator(int  n_steps_,
+					     const multi1d<std::string>& monomial_ids_,
+					     Handle< AbsComponentIntegrator< multi1d<LatticeColorMatrix>, multi1d<LatticeColorMatrix> > >& SubIntegrator_) : n_steps(n_steps_), SubIntegrator(SubIntegrator_), cache_validP(false) {
+
+      IntegratorShared::bindMonomials(monomial_ids_, monomials);
+    };
+
+    // Construct from params struct and Hamiltonian
+    LatColMatSTSForceGradRecursiveIntegrator(
+					     const LatColMatSTSForceGradRecursiveIntegratorParams& p) : n_steps(p.n_steps), SubIntegrator(IntegratorShared::createSubIntegrator(p.subintegrator_xml)), cache_validP(false) {
+
+      IntegratorShared::bindMonomials(p.monomial_ids, monomials);
+    }
+
+
+    // Copy constructor
+    LatColMatSTSForceGradRecursiveIntegrator(const LatColMatSTSForceGradRecursiveIntegrator& l) :
+      n_steps(l.n_steps), monomials(l.monomials), SubIntegrator(l.SubIntegrator), cache_validP(false) {}
+
+    // ! Destruction is automagic
+    ~LatColMatSTSForceGradRecursiveIntegrator(void) {};
+
+
+    void operator()( AbsFieldState<multi1d<LatticeColorMatrix>,
+		                   multi1d<LatticeColorMatrix> >& s,
+		     const Real& traj_length) const;
+
+    AbsComponentIntegrator<multi1d<LatticeColorMatrix>,
+			   multi1d<LatticeColorMatrix> >& getSubIntegrator() const {
+      return (*SubIntegrator);
+    }
+
+  protected:
+    //! Refresh fields in just this level
+    void refreshFieldsThisLevel(AbsFieldState<multi1d<LatticeColorMatrix>,
+				multi1d<LatticeColorMatrix> >& s) const {
+      cache_validP = false;
+      for(int i=0; i < monomials.size(); i++) {
+	monomials[i].mon->refreshInternalFields(s);
+      }
+    }
+
+    //! Reset Predictors in just this level
+    void resetPredictorsThisLevel(void) const {
+      cache_validP = false;
+      for(int i=0; i < monomials.size(); ++i) {
+	monomials[i].mon->resetPredictors();
+      }
+    }
+
+  private:
+
+    int  n_steps;
+
+    multi1d< IntegratorShared::MonomialPair > monomials;
+
+    Handle< AbsComponentIntegrator<multi1d<LatticeColorMatrix>,
+				   multi1d<LatticeColorMatrix> > > SubIntegrator;
+
+    // Force of the last force update of the previous call
+    mutable bool  cache_validP;
+    mutable unsigned long  cache_q_version;
+    mutable const void*  cache_state;
+    mutable multi1d<LatticeColorMatrix>  cache_force;
+  };
+
+}
+
+
+#endif
@@ -9,6 +9,8 @@
 #include "update/molecdyn/field_state.h"
 #include "update/molecdyn/monomial/two_flavor_monomial_w.h"
 #include "update/molecdyn/monomial/two_flavor_monomial_params_w.h"
+#include "update/molecdyn/monomial/monomial_profiler.h"
+#include "update/molecdyn/hamiltonian/repro_sum.h"
 
 namespace Chroma 
 {
@@ -79,6 +81,7 @@ namespace Chroma
       (getMDSolutionPredictor()).reset();
 
       SystemSolverResults_t res = (*invMdagM)(X, getPhi());
+      TheMonomialProfiler::Instance().addSolve(res.n_count);
       QDPIO::cout << "2Flav::invert,  n_count = " << res.n_count << std::endl;
 
       LatticeDouble site_action=zero;
@@ -86,7 +89,7 @@ namespace Chroma
       site_action[ lin->subset() ] += localInnerProductReal(getPhi(),X);
      
       //Double action = innerProductReal(getPhi(), X, lin->subset());
-      Double action = sum(site_action, lin->subset());
+      Double action = reproSum(site_action, lin->subset());
 
       write(xml_out, "n_count", res.n_count);
       write(xml_out, "S_oo", action);
@@ -4,6 +4,7 @@
 
 #include "update/molecdyn/monomial/force_monitors.h"
 #include "util/gauge/taproj.h"
+#include "update/molecdyn/hamiltonian/repro_sum.h"
 
 namespace Chroma 
 { 
@@ -70,10 +71,10 @@ namespace Chroma
     for(int mu=0; mu < F.size(); ++mu)
     {
       // Get Square norms for direction mu - divide to get 'per site'
-      forces.F_sq_dir[mu] = sum(f2[mu])/num_sites;
+      forces.F_sq_dir[mu] = reproSum(f2[mu])/num_sites;
 
       // Get average norm for direction mu - divide to get 'per site'
-      forces.F_avg_dir[mu] = sum(f1[mu])/num_sites;
+      forces.F_avg_dir[mu] = reproSum(f1[mu])/num_sites;
 
       // Get max force for direction mu - this is already 'per site'
       forces.F_max_dir[mu] = globalMax(f1[mu]);
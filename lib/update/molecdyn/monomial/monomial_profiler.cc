@@ -0,0 +1,224 @@
+/*! @file
+ * @brief Cost accounting per monomial and integrator level
+ */
+
+#include "update/molecdyn/monomial/monomial_profiler.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace Chroma
+{
+
+  namespace
+  {
+    const char* kind_names[3] = {"Force", "Action", "Refresh"};
+  }
+
+
+  //! Start charging to monomial id
+  void MonomialProfiler::begin(const std::string& id, Kind kind)
+  {
+    // A monomial calling another one is charged as a whole
+    if (depth++ > 0)
+      return;
+
+    current_id = id;
+    current_kind = kind;
+    swatch.reset();
+    swatch.start();
+  }
+
+
+  //! Stop charging, the time since begin() goes to the monomial
+  void MonomialProfiler::end()
+  {
+    if (depth == 0)
+    {
+      QDPIO::cerr << "MonomialProfiler: end() without begin()" << std::endl;
+      QDP_abort(1);
+    }
+
+    if (--depth > 0)
+      return;
+
+    swatch.stop();
+
+    Counts& c = traj_mons[current_id].kind[current_kind];
+    c.calls++;
+    c.secs += swatch.getTimeInSeconds();
+  }
+
+
+  //! Charge a solve with n_count iterations to the current monomial
+  void MonomialProfiler::addSolve(int n_count)
+  {
+    // Solves outside a bracket, e.g. in measurements, are not charged
+    if (depth == 0)
+      return;
+
+    Counts& c = traj_mons[current_id].kind[current_kind];
+    c.solves++;
+    c.iters += n_count;
+  }
+
+
+  //! Add the size of a force of monomial id
+  void MonomialProfiler::addForce(const std::string& id, const multi1d<LatticeColorMatrix>& F)
+  {
+    Double f_sq = zero;
+    Double f_max = zero;
+    for(int mu=0; mu < F.size(); ++mu)
+    {
+      f_sq += norm2(F[mu]);
+
+      Double f_max_mu = globalMax(localNorm2(F[mu]));
+      if ( toBool(f_max_mu > f_max) )
+	f_max = f_max_mu;
+    }
+
+    ForceNorms& f = traj_mons[id].force;
+    f.n++;
+    f.rms_sq += toDouble(f_sq) / double(F.size() * Layout::vol());
+    f.max = std::max(f.max, std::sqrt(toDouble(f_max)));
+  }
+
+
+  //! Count a force step of the integrator level with monomials ids
+  void MonomialProfiler::addLevelStep(const std::string& ids, double secs)
+  {
+    LevelCounts& l = traj_levels[ids];
+    l.steps++;
+    l.secs += secs;
+  }
+
+
+  //! Write a set of counters
+  void MonomialProfiler::writeCounts(XMLWriter& xml, const std::string& path,
+				     const MonMap_t& mons, const LevelMap_t& levels)
+  {
+    push(xml, path);
+
+    push(xml, "Monomials");
+    for(MonMap_t::const_iterator m = mons.begin(); m != mons.end(); ++m)
+    {
+      push(xml, "elem");
+      write(xml, "monomial_id", m->first);
+
+      double secs = 0;
+      for(int k=0; k < 3; ++k)
+      {
+	const Counts& c = m->second.kind[k];
+	secs += c.secs;
+
+	push(xml, kind_names[k]);
+	write(xml, "calls", c.calls);
+	write(xml, "secs", c.secs);
+	write(xml, "solves", c.solves);
+	write(xml, "iters", int(c.iters));
+	pop(xml);
+      }
+      write(xml, "total_secs", secs);
+
+      const ForceNorms& f = m->second.force;
+      if (f.n > 0)
+      {
+	push(xml, "ForceNorms");
+	write(xml, "n", f.n);
+	write(xml, "F_rms", std::sqrt(f.rms_sq / f.n));
+	write(xml, "F_max", f.max);
+	pop(xml);
+      }
+      pop(xml);
+    }
+    pop(xml);
+
+    push(xml, "IntegratorLevels");
+    for(LevelMap_t::const_iterator l = levels.begin(); l != levels.end(); ++l)
+    {
+      push(xml, "elem");
+      write(xml, "monomial_ids", l->first);
+      write(xml, "steps", l->second.steps);
+      write(xml, "secs", l->second.secs);
+      pop(xml);
+    }
+    pop(xml);
+
+    pop(xml);
+  }
+
+
+  //! Write the counts of this trajectory and add them to the totals
+  void MonomialProfiler::endTrajectory(XMLWriter& xml, const std::string& path)
+  {
+    writeCounts(xml, path, traj_mons, traj_levels);
+
+    for(MonMap_t::const_iterator m = traj_mons.begin(); m != traj_mons.end(); ++m)
+    {
+      for(int k=0; k < 3; ++k)
+      {
+	const Counts& c = m->second.kind[k];
+	Counts& t = total_mons[m->first].kind[k];
+	t.calls  += c.calls;
+	t.secs   += c.secs;
+	t.solves += c.solves;
+	t.iters  += c.iters;
+      }
+
+      const ForceNorms& f = m->second.force;
+      ForceNorms& t = total_mons[m->first].force;
+      t.n      += f.n;
+      t.rms_sq += f.rms_sq;
+      t.max     = std::max(t.max, f.max);
+    }
+
+    for(LevelMap_t::const_iterator l = traj_levels.begin(); l != traj_levels.end(); ++l)
+    {
+      LevelCounts& t = total_levels[l->first];
+      t.steps += l->second.steps;
+      t.secs  += l->second.secs;
+    }
+
+    traj_mons.clear();
+    traj_levels.clear();
+    n_traj++;
+  }
+
+
+  //! Drop the totals, e.g. after thermalisation
+  void MonomialProfiler::resetTotals()
+  {
+    total_mons.clear();
+    total_levels.clear();
+    n_traj = 0;
+  }
+
+
+  //! Write the totals of the run
+  void MonomialProfiler::writeSummary(XMLWriter& xml, const std::string& path) const
+  {
+    push(xml, path);
+    write(xml, "n_traj", n_traj);
+    writeCounts(xml, "Totals", total_mons, total_levels);
+    pop(xml);
+
+    QDPIO::cout << "MonomialProfiler: totals over " << n_traj << " trajectories" << std::endl;
+    for(MonMap_t::const_iterator m = total_mons.begin(); m != total_mons.end(); ++m)
+    {
+      QDPIO::cout << "  " << m->first;
+      for(int k=0; k < 3; ++k)
+      {
+	const Counts& c = m->second.kind[k];
+	QDPIO::cout << "  " << kind_names[k] << ": " << c.calls << " calls "
+		    << c.secs << " secs " << c.iters << " iters";
+      }
+      QDPIO::cout << std::endl;
+    }
+    for(LevelMap_t::const_iterator l = total_levels.begin(); l != total_levels.end(); ++l)
+    {
+      QDPIO::cout << "  level [" << l->first << "]: " << l->second.steps << " steps "
+		  << l->second.secs << " secs" << std::endl;
+    }
+  }
+
+}
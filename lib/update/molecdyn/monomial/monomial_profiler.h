@@ -0,0 +1,139 @@
+// -*- C++ -*-
+/*! @file
+ * @brief Cost accounting per monomial and integrator level
+ */
+
+#ifndef __monomial_profiler_h__
+#define __monomial_profiler_h__
+
+#include "chromabase.h"
+#include "singleton.h"
+#include <map>
+
+namespace Chroma
+{
+  //! Cost accounting per monomial and integrator level
+  /*! @ingroup monomial
+   *
+   * The integrator and the Hamiltonian bracket every force, action and
+   * pseudofermion refresh of a monomial with begin() and end(). The
+   * monomials report the iterations of their solves with addSolve(),
+   * which are charged to the bracketed monomial and kind. Each force
+   * step of an integrator level is counted with addLevelStep(), the
+   * level is named by the ids of its monomials. If switched on, the
+   * integrator also records the size of every force with addForce().
+   *
+   * endTrajectory() writes the counts of one trajectory and adds them
+   * to the totals of the run, writeSummary() writes the totals.
+   */
+  class MonomialProfiler
+  {
+  public:
+    //! What a monomial is doing
+    enum Kind {FORCE = 0, ACTION = 1, REFRESH = 2};
+
+    //! Counters of one monomial and kind
+    struct Counts
+    {
+      Counts() : calls(0), secs(0), solves(0), iters(0) {}
+
+      int     calls;     /*!< number of calls */
+      double  secs;      /*!< wall time of the calls */
+      int     solves;    /*!< solver calls */
+      long    iters;     /*!< solver iterations */
+    };
+
+    //! Force sizes of one monomial, see addForce()
+    struct ForceNorms
+    {
+      ForceNorms() : n(0), rms_sq(0), max(0) {}
+
+      int     n;         /*!< forces measured */
+      double  rms_sq;    /*!< sum of the mean square force per link */
+      double  max;       /*!< largest force on a link */
+    };
+
+    //! Counters of one monomial
+    struct MonomialCounts
+    {
+      Counts      kind[3];
+      ForceNorms  force;
+    };
+
+    //! Counters of one integrator level
+    struct LevelCounts
+    {
+      LevelCounts() : steps(0), secs(0) {}
+
+      int     steps;     /*!< force steps */
+      double  secs;      /*!< wall time of the force steps */
+    };
+
+    typedef std::map<std::string, MonomialCounts>  MonMap_t;
+    typedef std::map<std::string, LevelCounts>     LevelMap_t;
+
+    MonomialProfiler() : depth(0), n_traj(0), force_normsP(false) {}
+
+    //! Start charging to monomial id
+    void begin(const std::string& id, Kind kind);
+
+    //! Stop charging, the time since begin() goes to the monomial
+    void end();
+
+    //! Charge a solve with n_count iterations to the current monomial
+    void addSolve(int n_count);
+
+    //! Are the sizes of the forces measured
+    bool measureForces() const {return force_normsP;}
+
+    //! Switch the measurement of the force sizes on or off
+    void setMeasureForces(bool on) {force_normsP = on;}
+
+    //! Add the size of a force of monomial id
+    void addForce(const std::string& id, const multi1d<LatticeColorMatrix>& F);
+
+    //! Count a force step of the integrator level with monomials ids
+    void addLevelStep(const std::string& ids, double secs);
+
+    //! Write the counts of this trajectory and add them to the totals
+    void endTrajectory(XMLWriter& xml, const std::string& path);
+
+    //! Write the totals of the run
+    void writeSummary(XMLWriter& xml, const std::string& path) const;
+
+    //! Totals of the monomials
+    const MonMap_t& getMonomialTotals() const {return total_mons;}
+
+    //! Totals of the integrator levels
+    const LevelMap_t& getLevelTotals() const {return total_levels;}
+
+    //! Number of trajectories in the totals
+    int getNTraj() const {return n_traj;}
+
+    //! Drop the totals, e.g. after thermalisation
+    void resetTotals();
+
+  private:
+    //! Write a set of counters
+    static void writeCounts(XMLWriter& xml, const std::string& path,
+			    const MonMap_t& mons, const LevelMap_t& levels);
+
+    MonMap_t    traj_mons;
+    LevelMap_t  traj_levels;
+    MonMap_t    total_mons;
+    LevelMap_t  total_levels;
+
+    int          depth;        /*!< nesting of begin() */
+    std::string  current_id;
+    Kind         current_kind;
+    StopWatch    swatch;
+    int          n_traj;
+    bool         force_normsP;
+  };
+
+  //! The profiler of the run
+  /*! @ingroup monomial */
+  typedef SingletonHolder<MonomialProfiler> TheMonomialProfiler;
+
+}
+#endif
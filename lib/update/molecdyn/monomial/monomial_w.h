@@ -16,6 +16,7 @@
 #define __monomial_w_h__
 
 #include "monomial_aggregate_w.h"
+#include "monomial_profiler.h"
 
 #include "two_flavor_monomial_w.h"
 #include "unprec_two_flavor_monomial_w.h"
@@ -12,6 +12,8 @@
 #include "update/molecdyn/monomial/abs_monomial.h"
 #include "update/molecdyn/monomial/force_monitors.h"
 #include "update/molecdyn/monomial/remez_coeff.h"
+#include "update/molecdyn/monomial/monomial_profiler.h"
+#include "update/molecdyn/hamiltonian/repro_sum.h"
 
 #include <typeinfo>
 
@@ -93,6 +95,7 @@ namespace Chroma
 	{
 	  // The multi-shift inversion
 	  SystemSolverResults_t res = (*invMdagM)(X, fpfe.pole, getPhi()[n]);
+	  TheMonomialProfiler::Instance().addSolve(res.n_count);
 	  n_m_count[n] = res.n_count;
 
 	  // Loop over solns and accumulate force contributions
@@ -205,6 +208,7 @@ namespace Chroma
 	  // The multi-shift inversion
 	  multi1d< multi1d<Phi> > X;
 	  SystemSolverResults_t res = (*invMdagM)(X, sipfe.pole, eta);
+	  TheMonomialProfiler::Instance().addSolve(res.n_count);
 	  n_m_count[n] = res.n_count;
 
 	  // Sanity checks
@@ -312,6 +316,7 @@ namespace Chroma
 	{
 	  // The multi-shift inversion
 	  SystemSolverResults_t res = (*invMdagM)(X, spfe.pole, getPhi()[n]);
+	  TheMonomialProfiler::Instance().addSolve(res.n_count);
 	  n_m_count[n] = res.n_count;
 
 	  // Sanity checks
@@ -331,7 +336,7 @@ namespace Chroma
 	  }
 
 	  // Action on the subset
-	  action_m += norm2(tmp, M->subset());
+	  action_m += reproNorm2(tmp, M->subset());
 	}
       }
 
@@ -12,6 +12,8 @@
 #include "update/molecdyn/monomial/abs_monomial.h"
 #include "update/molecdyn/monomial/force_monitors.h"
 #include "update/molecdyn/monomial/remez_coeff.h"
+#include "update/molecdyn/monomial/monomial_profiler.h"
+#include "update/molecdyn/hamiltonian/repro_sum.h"
 #include <typeinfo>
 
 namespace Chroma
@@ -76,13 +78,12 @@ namespace Chroma
       // Need way to get gauge state from AbsFieldState<P,Q>
       Handle< DiffLinearOperator<Phi,P,Q> > lin(FA.linOp(state));
 
-      // Get multi-shift system solver
-      Handle< MdagMMultiSystemSolver<Phi> > invMdagM(FA.mInvMdagM(state, getForceInvParams()));
+      // Get multi-shift system solver for all the pseudoferms at once
+      Handle< MdagMMultiSystemSolverBlock<Phi> > invMdagM(FA.mInvMdagMBlock(state, getForceInvParams()));
 
       // Partial Fraction Expansion coeffs for force
       const RemezCoeff_t& fpfe = getFPFE();
 
-      multi1d<Phi> X;
       Phi Y;
 
       P  F_1;
@@ -90,14 +91,17 @@ namespace Chroma
       F = zero;
 
       // Loop over all the pseudoferms
-      multi1d<int> n_count(getNPF());
       QDPIO::cout << "num_pf = " << getNPF() << std::endl;
 
+      // The multi-shift inversions of all the pseudoferms share one solve,
+      // so there is one iteration count for all of them
+      multi1d< multi1d<Phi> > X_pf;
+      SystemSolverResults_t res = (*invMdagM)(X_pf, fpfe.pole, getPhi());
+      TheMonomialProfiler::Instance().addSolve(res.n_count);
+
       for(int n=0; n < getNPF(); ++n)
       {
-	// The multi-shift inversion
-	SystemSolverResults_t res = (*invMdagM)(X, fpfe.pole, getPhi()[n]);
-	n_count[n] = res.n_count;
+	const multi1d<Phi>& X = X_pf[n];
 
 	// Loop over solns and accumulate force contributions
 
@@ -144,7 +148,7 @@ namespace Chroma
       }
 
       state->deriv(F);
-      write(xml_out, "n_count", n_count);
+      write(xml_out, "n_count", res.n_count);
       monitorForces(xml_out, "Forces", F);
       pop(xml_out);
 
@@ -223,6 +227,7 @@ namespace Chroma
 #else
 	SystemSolverResults_t res = (*invMdagM)(getPhi()[n], sipfe.norm, sipfe.res,sipfe.pole, eta);
 #endif
+	TheMonomialProfiler::Instance().addSolve(res.n_count);
 	n_count[n] = res.n_count;
 
 	// Weight solns to make final PF field
@@ -316,6 +321,7 @@ namespace Chroma
 	// The multi-shift inversion
 	SystemSolverResults_t res = (*invMdagM)(X, spfe.pole, getPhi()[n]);
 #endif
+	TheMonomialProfiler::Instance().addSolve(res.n_count);
 	n_count[n] = res.n_count;
 	LatticeDouble site_S=zero;
 
@@ -336,7 +342,7 @@ namespace Chroma
 	// action += norm2(psi, lin->subset());
 
 	// Sum
-	action += sum(site_S, lin->subset());
+	action += reproSum(site_S, lin->subset());
       }
 
       write(xml_out, "n_count", n_count);
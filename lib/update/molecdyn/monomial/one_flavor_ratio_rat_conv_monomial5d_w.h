@@ -12,6 +12,8 @@
 #include "update/molecdyn/monomial/abs_monomial.h"
 #include "update/molecdyn/monomial/force_monitors.h"
 #include "update/molecdyn/monomial/remez_coeff.h"
+#include "update/molecdyn/monomial/monomial_profiler.h"
+#include "update/molecdyn/hamiltonian/repro_sum.h"
 
 #include <typeinfo>
 
@@ -92,6 +94,7 @@ namespace Chroma
 	{
 	  // The multi-shift inversion
 	  SystemSolverResults_t res = (*invMdagM)(X, fpfe.pole, getPhi()[n]);
+	  TheMonomialProfiler::Instance().addSolve(res.n_count);
 	  n_m_count[n] = res.n_count;
 
 	  // Loop over solns and accumulate force contributions
@@ -203,6 +206,7 @@ namespace Chroma
 	  // The multi-shift inversion
 	  multi1d< multi1d<Phi> > X;
 	  SystemSolverResults_t res = (*invMdagM)(X, sipfe.pole, eta);
+	  TheMonomialProfiler::Instance().addSolve(res.n_count);
 	  n_m_count[n] = res.n_count;
 
 	  // Sanity checks
@@ -311,6 +315,7 @@ namespace Chroma
 	{
 	  // The multi-shift inversion
 	  SystemSolverResults_t res = (*invMdagM)(X, spfe.pole, getPhi()[n]);
+	  TheMonomialProfiler::Instance().addSolve(res.n_count);
 	  n_m_count[n] = res.n_count;
 
 	  // Sanity checks
@@ -330,7 +335,7 @@ namespace Chroma
 	  }
 
 	  // Action on the subset
-	  action_m += norm2(tmp, M->subset());
+	  action_m += reproNorm2(tmp, M->subset());
 	}
 
 
@@ -12,6 +12,8 @@
 #include "update/molecdyn/monomial/abs_monomial.h"
 #include "update/molecdyn/monomial/force_monitors.h"
 #include "update/molecdyn/monomial/remez_coeff.h"
+#include "update/molecdyn/monomial/monomial_profiler.h"
+#include "update/molecdyn/hamiltonian/repro_sum.h"
 #include <typeinfo>
 
 namespace Chroma
@@ -112,6 +114,7 @@ namespace Chroma
       {
 	// The multi-shift inversion
 	SystemSolverResults_t res = (*invMdagM_num)(X, fpfe_num.pole, getPhi()[n]);
+	TheMonomialProfiler::Instance().addSolve(res.n_count);
 	n_count[n] = res.n_count;
 
 	// Loop over solns and accumulate force contributions
@@ -213,6 +216,7 @@ namespace Chroma
 	// The multi-shift inversion
 	multi1d<Phi> X;
 	SystemSolverResults_t res = (*invMdagM_num)(X, sipfe_num.pole, eta);
+	TheMonomialProfiler::Instance().addSolve(res.n_count);
 	n_count[n] = res.n_count;
 
 	// Weight solns to make final PF field
@@ -294,6 +298,7 @@ namespace Chroma
       {
 	// The multi-shift inversion
 	SystemSolverResults_t res = (*invMdagM_num)(X, spfe_num.pole, getPhi()[n]);
+	TheMonomialProfiler::Instance().addSolve(res.n_count);
 	n_count[n] = res.n_count;
 
 	// Weight solns to make final PF field
@@ -301,7 +306,7 @@ namespace Chroma
 	for(int i=0; i < X.size(); ++i)
 	  psi[M_num->subset()] += spfe_num.res[i] * X[i];
 
-	action += norm2(psi, M_num->subset());
+	action += reproNorm2(psi, M_num->subset());
       }
 
       write(xml_out, "n_count", n_count);
@@ -12,6 +12,8 @@
 #include "update/molecdyn/monomial/abs_monomial.h"
 #include "update/molecdyn/monomial/force_monitors.h"
 #include "update/molecdyn/predictor/chrono_predictor.h"
+#include "update/molecdyn/monomial/monomial_profiler.h"
+#include "update/molecdyn/hamiltonian/repro_sum.h"
 
 #include <typeinfo>
 
@@ -85,6 +87,7 @@ namespace Chroma
 
 	// Do the inversion
 	SystemSolverResults_t res = (*invMdagM)(X, getPhi());
+	TheMonomialProfiler::Instance().addSolve(res.n_count);
 	n_count = res.n_count;
 
 	// Register the new std::vector
@@ -248,12 +251,13 @@ namespace Chroma
 
       // Do the inversion
       SystemSolverResults_t res = (*invMdagM)(X, getPhi());
+      TheMonomialProfiler::Instance().addSolve(res.n_count);
       int n_count = res.n_count;
 
       // Action on the entire lattice
       Double action = zero;
       for(int s=0; s < FA.size(); ++s)
-	action += innerProductReal(getPhi()[s], X[s]);
+	action += reproInnerProductReal(getPhi()[s], X[s]);
 
       write(xml_out, "n_count", n_count);
       write(xml_out, "S", action);
@@ -330,10 +334,11 @@ namespace Chroma
 
       // Do the inversion
       SystemSolverResults_t res = (*invMdagM)(X, getPhi());
+      TheMonomialProfiler::Instance().addSolve(res.n_count);
       int n_count = res.n_count;
 
       // Total odd-subset action. NOTE: QDP has norm2(multi1d) but not innerProd
-      Double action = innerProductReal(getPhi(), X, M->subset());
+      Double action = reproInnerProductReal(getPhi(), X, M->subset());
 
       write(xml_out, "n_count", n_count);
       write(xml_out, "S_oo", action);
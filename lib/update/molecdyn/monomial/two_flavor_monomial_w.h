@@ -13,6 +13,8 @@
 #include "update/molecdyn/monomial/abs_monomial.h"
 #include "update/molecdyn/monomial/force_monitors.h"
 #include "update/molecdyn/predictor/chrono_predictor.h"
+#include "update/molecdyn/monomial/monomial_profiler.h"
+#include "update/molecdyn/hamiltonian/repro_sum.h"
 
 #include <typeinfo>
 
@@ -83,6 +85,7 @@ namespace Chroma
 
       // Solve MdagM X = eta
       SystemSolverResults_t res = (*invMdagM)(X, getPhi(), getMDSolutionPredictor());
+      TheMonomialProfiler::Instance().addSolve(res.n_count);
       QDPIO::cout << "2Flav::invert,  n_count = " << res.n_count << std::endl;
 
       // Insert std::vector --  Now done in the syssolver_mdagm
@@ -235,10 +238,11 @@ namespace Chroma
 
       // Solve MdagM X = eta
       SystemSolverResults_t res = (*invMdagM)(X, getPhi());
+      TheMonomialProfiler::Instance().addSolve(res.n_count);
       QDPIO::cout << "2Flav::invert,  n_count = " << res.n_count << std::endl;
 
       // Action on the entire lattice
-      Double action = innerProductReal(getPhi(), X);
+      Double action = reproInnerProductReal(getPhi(), X);
       
       write(xml_out, "n_count", res.n_count);
       write(xml_out, "S", action);
@@ -314,10 +318,11 @@ namespace Chroma
 
       // Solve MdagM X = eta
       SystemSolverResults_t res = (*invMdagM)(X, getPhi());
+      TheMonomialProfiler::Instance().addSolve(res.n_count);
       QDPIO::cout << "2Flav::invert,  n_count = " << res.n_count << std::endl;
 
       // Action
-      Double action = innerProductReal(getPhi(), X, M->subset());
+      Double action = reproInnerProductReal(getPhi(), X, M->subset());
       
       write(xml_out, "n_count", res.n_count);
       write(xml_out, "S_oo", action);
@@ -495,6 +500,7 @@ namespace Chroma
 
       // Solve MdagM X = eta
       SystemSolverResults_t res = (*invMdagM)(X, getPhi(),getMDSolutionPredictor());
+      TheMonomialProfiler::Instance().addSolve(res.n_count);
       QDPIO::cout << "2Flav::invert,  n_count = " << res.n_count << std::endl;
 
       // Insert std::vector -- now done in syssolver
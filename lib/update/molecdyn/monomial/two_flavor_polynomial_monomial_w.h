@@ -11,6 +11,8 @@
 #include "update/molecdyn/monomial/abs_monomial.h"
 #include "update/molecdyn/monomial/force_monitors.h"
 #include "update/molecdyn/predictor/chrono_predictor.h"
+#include "update/molecdyn/monomial/monomial_profiler.h"
+#include "update/molecdyn/hamiltonian/repro_sum.h"
 
 #include <typeinfo>
 
@@ -124,6 +126,7 @@ namespace Chroma
 
       // Do the inversion
       SystemSolverResults_t res = (*invPolyPrec)(getPhi(), tmp2);
+      TheMonomialProfiler::Instance().addSolve(res.n_count);
 
       write(xml_out, "n_count", res.n_count);
       pop(xml_out);
@@ -204,7 +207,7 @@ namespace Chroma
       // Action on the entire lattice
       (*Poly)(X, getPhi(), PLUS);
 
-      Double action = innerProductReal(getPhi(), X);
+      Double action = reproInnerProductReal(getPhi(), X);
       
       int n_count = 0;
       write(xml_out, "n_count", n_count);
@@ -270,7 +273,7 @@ namespace Chroma
       // Action on the entire lattice
       (*Poly)(X, getPhi(), PLUS);
 
-      Double action = innerProductReal(getPhi(), X, Poly->subset());
+      Double action = reproInnerProductReal(getPhi(), X, Poly->subset());
       
       int n_count = 0;
       write(xml_out, "n_count", n_count);
@@ -11,6 +11,8 @@
 #include "update/molecdyn/monomial/abs_monomial.h"
 #include "update/molecdyn/monomial/force_monitors.h"
 #include "update/molecdyn/predictor/chrono_predictor.h"
+#include "update/molecdyn/monomial/monomial_profiler.h"
+#include "update/molecdyn/hamiltonian/repro_sum.h"
 
 #include <typeinfo>
 
@@ -192,6 +194,7 @@ namespace Chroma
       // Do the inversion...
       (getMDSolutionPredictor())(X, *M, getPhi());
       SystemSolverResults_t res = (*invPolyPrec)(X, getPhi());
+      TheMonomialProfiler::Instance().addSolve(res.n_count);
       (getMDSolutionPredictor()).newVector(X);
 
       END_CODE();
@@ -236,7 +239,7 @@ namespace Chroma
       int n_count = this->getX(X,s);
 
       // Action on the entire lattice
-      Double action = innerProductReal(getPhi(), X);
+      Double action = reproInnerProductReal(getPhi(), X);
       
       write(xml_out, "n_count", n_count);
       write(xml_out, "S", action);
@@ -307,7 +310,7 @@ namespace Chroma
       QDPIO::cout << "TwoFlavPolyWilson4DMonomial: resetting Predictor before energy calc solve" << std::endl;
       (getMDSolutionPredictor()).reset();
       int n_count = this->getX(X, s);
-      Double action = innerProductReal(getPhi(), X, lin->subset());
+      Double action = reproInnerProductReal(getPhi(), X, lin->subset());
       
       write(xml_out, "n_count", n_count);
       write(xml_out, "S_oo", action);
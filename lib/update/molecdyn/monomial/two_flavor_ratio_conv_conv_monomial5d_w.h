@@ -12,6 +12,8 @@
 #include "update/molecdyn/monomial/abs_monomial.h"
 #include "update/molecdyn/monomial/force_monitors.h"
 #include "update/molecdyn/predictor/chrono_predictor.h"
+#include "update/molecdyn/monomial/monomial_profiler.h"
+#include "update/molecdyn/hamiltonian/repro_sum.h"
 #include <typeinfo> // For std::bad_cast
 namespace Chroma
 {
@@ -176,6 +178,7 @@ namespace Chroma
 
       // Do the inversion
       SystemSolverResults_t res = (*invMdagM)(eta, tmp);
+      TheMonomialProfiler::Instance().addSolve(res.n_count);
 
       // Finally, get phi
       (*M_2)(getPhi(), eta, PLUS);
@@ -270,6 +273,7 @@ namespace Chroma
 
       // Do the inversion
       SystemSolverResults_t res = (*invMdagM)(X, MPrecDagPhi);
+      TheMonomialProfiler::Instance().addSolve(res.n_count);
 
       // Register the new std::vector
       (getMDSolutionPredictor()).newVector(X);
@@ -337,7 +341,7 @@ namespace Chroma
       // Action on the entire lattice
       Double action = zero;
       for(int s=0; s < FA_prec.size(); ++s)
-	action += innerProductReal(getPhi()[s], tmp[s]);
+	action += reproInnerProductReal(getPhi()[s], tmp[s]);
 
       write(xml_out, "n_count", n_count);
       write(xml_out, "S", action);
@@ -423,7 +427,7 @@ namespace Chroma
       Double action = zero;
       // Total odd-subset action. NOTE: QDP has norm2(multi1d) but not innerProd
       for(int s=0; s < FA.size(); ++s)
-	action += innerProductReal(getPhi()[s], tmp[s], lin->subset());
+	action += reproInnerProductReal(getPhi()[s], tmp[s], lin->subset());
 
 
       write(xml_out, "n_count", n_count);
@@ -12,6 +12,8 @@
 #include "update/molecdyn/monomial/abs_monomial.h"
 #include "update/molecdyn/monomial/force_monitors.h"
 #include "update/molecdyn/predictor/chrono_predictor.h"
+#include "update/molecdyn/monomial/monomial_profiler.h"
+#include "update/molecdyn/hamiltonian/repro_sum.h"
 
 #include <typeinfo>
 
@@ -94,6 +96,7 @@ namespace Chroma
 
       // Solve MdagM X = eta
       SystemSolverResults_t res = (*invMdagM)(X, M_dag_prec_phi, getMDSolutionPredictor());
+      TheMonomialProfiler::Instance().addSolve(res.n_count);
 
       // (getMDSolutionPredictor()).newVector(X);
       
@@ -188,6 +191,7 @@ namespace Chroma
 
       // Solve MdagM_prec X = eta
       SystemSolverResults_t res = (*invMdagM)(phi_tmp, eta_tmp);
+      TheMonomialProfiler::Instance().addSolve(res.n_count);
 
       (*M_prec)(getPhi(), phi_tmp, PLUS); // (Now get phi = M_prec (M_prec^{-1}\phi)
 
@@ -315,12 +319,13 @@ namespace Chroma
 
       // Solve MdagM X = eta
       SystemSolverResults_t res = (*invMdagM)(X, M_dag_prec_phi);
+      TheMonomialProfiler::Instance().addSolve(res.n_count);
 
       Phi phi_tmp=zero;
       (*M_prec)(phi_tmp, X, PLUS);
 
       // Action on the entire lattice
-      Double action = innerProductReal(getPhi(), phi_tmp);
+      Double action = reproInnerProductReal(getPhi(), phi_tmp);
 
       write(xml_out, "n_count", res.n_count);
       write(xml_out, "S", action);
@@ -408,11 +413,12 @@ namespace Chroma
 
       // Solve MdagM X = eta
       SystemSolverResults_t res = (*invMdagM)(X, M_dag_prec_phi);
+      TheMonomialProfiler::Instance().addSolve(res.n_count);
 
       Phi phi_tmp=zero;
       (*M_prec)(phi_tmp, X, PLUS);
 
-      Double action = innerProductReal(getPhi(), phi_tmp, M->subset());
+      Double action = reproInnerProductReal(getPhi(), phi_tmp, M->subset());
       
       write(xml_out, "n_count", res.n_count);
       write(xml_out, "S_oo", action);
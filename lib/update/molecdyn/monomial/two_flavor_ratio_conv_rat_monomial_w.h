@@ -13,6 +13,8 @@
 #include "update/molecdyn/monomial/force_monitors.h"
 #include "update/molecdyn/monomial/remez_coeff.h"
 #include "update/molecdyn/predictor/chrono_predictor.h"
+#include "update/molecdyn/monomial/monomial_profiler.h"
+#include "update/molecdyn/hamiltonian/repro_sum.h"
 
 #include <typeinfo>
 
@@ -177,6 +179,7 @@ namespace Chroma
 
       // Solve MdagM_prec X = eta
       SystemSolverResults_t res = (*invMdagM)(phi_tmp, eta_tmp);
+      TheMonomialProfiler::Instance().addSolve(res.n_count);
 
       (*M_prec)(getPhi(), phi_tmp, PLUS); // (Now get phi = M_prec (M_prec^{-1}\phi)
 
@@ -259,6 +262,7 @@ namespace Chroma
 
 	// Solve MdagM X = eta
 	res = (*invMdagM)(X, M_dag_prec_phi, getMDSolutionPredictor());
+	TheMonomialProfiler::Instance().addSolve(res.n_count);
 	// Now done in the solver
 	// (getMDSolutionPredictor()).newVector(X);
       }
@@ -356,7 +360,7 @@ namespace Chroma
       (*M_prec)(phi_tmp, X, PLUS);
 
       // Action on the entire lattice
-      Double action = innerProductReal(getPhi(), phi_tmp);
+      Double action = reproInnerProductReal(getPhi(), phi_tmp);
 
       
       write(xml_out, "n_count", n_count);
@@ -438,7 +442,7 @@ namespace Chroma
       (*M_prec)(phi_tmp, X, PLUS);
 
 
-      Double action = innerProductReal(getPhi(), phi_tmp, lin->subset());
+      Double action = reproInnerProductReal(getPhi(), phi_tmp, lin->subset());
       
       write(xml_out, "n_count", n_count);
       write(xml_out, "S_oo", action);
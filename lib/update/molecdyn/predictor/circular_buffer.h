@@ -102,6 +102,16 @@ namespace Chroma
       END_CODE();
     }
     
+    //! the ith most recent item, without a copy
+    const T& getRef(const unsigned int i) const 
+    {
+      if( i >= size_internal ) { 
+	throw OutOfBoundsException(std::string("Index Out of bounds"), i, size_internal);
+      }
+
+      return q[(start + i) % size_max];
+    }
+    
     //! Is empty check
     bool isEmpty(void) const { 
       return (size_internal == 0);
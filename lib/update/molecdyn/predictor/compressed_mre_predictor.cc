@@ -0,0 +1,252 @@
+/*! \file
+ * \brief Minimal residual predictor with a compressed history
+ *
+ * Predictors for HMC
+ */
+
+#include "chromabase.h"
+#include "update/molecdyn/predictor/compressed_mre_predictor.h"
+#include "update/molecdyn/predictor/lu_solve.h"
+
+
+namespace Chroma
+{
+
+  namespace CompressedMRE4DChronoPredictorEnv
+  {
+    namespace
+    {
+      // Create a new 4D compressed MRE Predictor
+      AbsChronologicalPredictor4D<LatticeFermion>* createPredictor(XMLReader& xml,
+								   const std::string& path)
+      {
+	unsigned int max_chrono = 1;
+	Real compress_tol = 1.0e-5;
+	bool sharedP = true;
+
+	try
+	{
+	  XMLReader paramtop(xml, path);
+	  read( paramtop, "./MaxChrono", max_chrono);
+
+	  if( paramtop.count("./CompressTol") == 1 )
+	    read( paramtop, "./CompressTol", compress_tol);
+
+	  if( paramtop.count("./SharedXY") == 1 )
+	    read( paramtop, "./SharedXY", sharedP);
+	}
+	catch( const std::string& e ) {
+	  QDPIO::cerr << "Caught exception reading XML: " << e << std::endl;
+	  QDP_abort(1);
+	}
+
+	return new CompressedMRE4DChronoPredictor<LatticeFermion,LatticeFermionF>(max_chrono,
+										  compress_tol,
+										  sharedP);
+      }
+
+      //! Local registration flag
+      bool registered = false;
+
+
+      //! x = L^{-1} y for the used vectors
+      void forwardSolve(multi1d<DComplex>& x,
+			const multi2d<DComplex>& L,
+			const multi1d<bool>& keep,
+			const multi1d<DComplex>& y)
+      {
+	int N = y.size();
+	x.resize(N);
+
+	for(int i=0; i < N; i++) {
+	  x[i] = zero;
+	  if( ! keep[i] )
+	    continue;
+
+	  DComplex t = y[i];
+	  for(int k=0; k < i; k++) {
+	    t -= L(i,k)*x[k];
+	  }
+	  x[i] = t / L(i,i);
+	}
+      }
+
+
+      //! x = L^{-dag} y for the used vectors
+      void backwardSolveDag(multi1d<DComplex>& x,
+			    const multi2d<DComplex>& L,
+			    const multi1d<bool>& keep,
+			    const multi1d<DComplex>& y)
+      {
+	int N = y.size();
+	x.resize(N);
+
+	for(int i=N-1; i >= 0; i--) {
+	  x[i] = zero;
+	  if( ! keep[i] )
+	    continue;
+
+	  DComplex t = y[i];
+	  for(int k=i+1; k < N; k++) {
+	    t -= conj(L(k,i))*x[k];
+	  }
+	  x[i] = t / L(i,i);
+	}
+      }
+    }
+
+    const std::string name = "COMPRESSED_MRE_4D_PREDICTOR";
+
+    //! Register all the factories
+    bool registerAll()
+    {
+      bool success = true;
+      if (! registered)
+      {
+	success &= The4DChronologicalPredictorFactory::Instance().registerObject(name, createPredictor);
+  	registered = true;
+      }
+      return success;
+    }
+
+
+    //! Cholesky factor S = L L^dag of the Gram matrix of a history
+    void gramCholesky(multi2d<DComplex>& L,
+		      multi1d<bool>& keep,
+		      const multi2d<DComplex>& S,
+		      const Real& tol)
+    {
+      int N = S.size1();
+      L.resize(N,N);
+      keep.resize(N);
+
+      for(int j=0; j < N; j++) {
+	for(int i=0; i < N; i++) {
+	  L(i,j) = zero;
+	}
+      }
+
+      for(int i=0; i < N; i++) {
+	// Pivot: what is left of v_i after projecting out v_0 .. v_(i-1)
+	Double d = real(S(i,i));
+	for(int k=0; k < i; k++) {
+	  d -= norm2(L(i,k));
+	}
+
+	keep[i] = toBool( d > tol*tol*real(S(i,i)) );
+	if( ! keep[i] )
+	  continue;
+
+	Double l_ii = sqrt(d);
+	L(i,i) = cmplx(l_ii, Double(0));
+
+	for(int j=i+1; j < N; j++) {
+	  DComplex t = S(j,i);
+	  for(int k=0; k < i; k++) {
+	    t -= L(j,k)*conj(L(i,k));
+	  }
+	  L(j,i) = t / l_ii;
+	}
+      }
+    }
+
+
+    //! Square norm of the part of x outside of the span of a history
+    Double outOfSpan(const multi2d<DComplex>& L,
+		     const multi1d<bool>& keep,
+		     const multi1d<DComplex>& s,
+		     const Double& xx)
+    {
+      // |P x|^2 = s^dag S^{-1} s = |L^{-1} s|^2
+      multi1d<DComplex> y;
+      forwardSolve(y, L, keep, s);
+
+      Double rr = xx;
+      for(int i=0; i < y.size(); i++) {
+	rr -= norm2(y[i]);
+      }
+
+      return rr;
+    }
+
+
+    //! Solve the projected system G a = b in the orthonormalised history
+    void solveOrthonormal(multi1d<DComplex>& a,
+			  const multi2d<DComplex>& L,
+			  const multi1d<bool>& keep,
+			  const multi2d<DComplex>& G,
+			  const multi1d<DComplex>& b)
+    {
+      int N = b.size();
+
+      // The used vectors
+      multi1d<int> idx(N);
+      int Nkeep = 0;
+      for(int i=0; i < N; i++) {
+	if( keep[i] )
+	  idx[Nkeep++] = i;
+      }
+
+      // In the orthonormal basis u = v L^{-dag}:
+      // G_u = L^{-1} G L^{-dag},  b_u = L^{-1} b
+      multi2d<DComplex> LinvG(N,N);
+      for(int m=0; m < N; m++) {
+	multi1d<DComplex> col(N);
+	for(int n=0; n < N; n++) {
+	  col[n] = G(n,m);
+	}
+
+	multi1d<DComplex> x;
+	forwardSolve(x, L, keep, col);
+	for(int n=0; n < N; n++) {
+	  LinvG(n,m) = x[n];
+	}
+      }
+
+      // L^{-1} G L^{-dag} = (L^{-1} (L^{-1} G)^dag)^dag
+      multi2d<DComplex> Gu(Nkeep,Nkeep);
+      int nn = 0;
+      for(int n=0; n < N; n++) {
+	multi1d<DComplex> row(N);
+	for(int m=0; m < N; m++) {
+	  row[m] = conj(LinvG(n,m));
+	}
+
+	multi1d<DComplex> x;
+	forwardSolve(x, L, keep, row);
+
+	if( ! keep[n] )
+	  continue;
+
+	for(int j=0; j < Nkeep; j++) {
+	  Gu(nn,j) = conj(x[idx[j]]);
+	}
+	nn++;
+      }
+
+      multi1d<DComplex> bu_full;
+      forwardSolve(bu_full, L, keep, b);
+
+      multi1d<DComplex> bu(Nkeep);
+      for(int j=0; j < Nkeep; j++) {
+	bu[j] = bu_full[idx[j]];
+      }
+
+      multi1d<DComplex> cu(Nkeep);
+      LUSolve(cu, Gu, bu);
+
+      multi1d<DComplex> c(N);
+      for(int i=0; i < N; i++) {
+	c[i] = zero;
+      }
+      for(int j=0; j < Nkeep; j++) {
+	c[idx[j]] = cu[j];
+      }
+
+      // Back to the history vectors, a = L^{-dag} c
+      backwardSolveDag(a, L, keep, c);
+    }
+
+  }
+
+}
@@ -0,0 +1,432 @@
+// -*- C++ -*-
+/*! \file
+ * \brief Minimal residual predictor with a compressed history
+ *
+ * Predictors for HMC
+ */
+
+#ifndef __compressed_mre_predictor_h__
+#define __compressed_mre_predictor_h__
+
+#include "chromabase.h"
+#include "handle.h"
+#include "update/molecdyn/predictor/chrono_predictor.h"
+#include "update/molecdyn/predictor/chrono_predictor_factory.h"
+#include "update/molecdyn/predictor/circular_buffer.h"
+
+namespace Chroma
+{
+
+  /*! @ingroup predictor */
+  namespace CompressedMRE4DChronoPredictorEnv
+  {
+    extern const std::string name;
+    bool registerAll();
+
+    //! Cholesky factor S = L L^dag of the Gram matrix of a history
+    /*!
+     * Vectors whose pivot is below tol^2 S(i,i) are linearly dependent
+     * on the ones before them. They are marked in keep and get a zero
+     * column in L.
+     */
+    void gramCholesky(multi2d<DComplex>& L,
+		      multi1d<bool>& keep,
+		      const multi2d<DComplex>& S,
+		      const Real& tol);
+
+    //! Square norm of the part of x outside of the span of a history
+    /*!
+     * \param L   Cholesky factor of the Gram matrix of the history
+     * \param keep used vectors of the history
+     * \param s   s_i = v_i^dag x
+     * \param xx  x^dag x
+     */
+    Double outOfSpan(const multi2d<DComplex>& L,
+		     const multi1d<bool>& keep,
+		     const multi1d<DComplex>& s,
+		     const Double& xx);
+
+    //! Solve the projected system G a = b in the orthonormalised history
+    /*!
+     * G_nm = v_n^dag A v_m and b_n = v_n^dag chi are in the basis of
+     * the history vectors v. The system is solved in the orthonormal
+     * basis v L^{-dag}, which is well conditioned, and a is
+     * transformed back. Unused vectors get a zero coefficient.
+     */
+    void solveOrthonormal(multi1d<DComplex>& a,
+			  const multi2d<DComplex>& L,
+			  const multi1d<bool>& keep,
+			  const multi2d<DComplex>& G,
+			  const multi1d<DComplex>& b);
+  }
+
+
+  //! Minimal residual predictor with a compressed history
+  /*! @ingroup predictor
+   *
+   * A variant of the MRE predictor for deep histories on large lattices:
+   *
+   * - The history is stored in the reduced precision TF.
+   *
+   * - The Gram matrix v_i^dag v_j of the history is kept and updated
+   *   with one row of inner products when a vector is added. The
+   *   history is orthonormalised through the Cholesky factor of this
+   *   matrix, instead of a Gram-Schmidt over all the vectors at every
+   *   prediction. The projected matrix v_n^dag A v_m still has to be
+   *   formed for each prediction, as the gauge field changes between
+   *   two of them.
+   *
+   * - A new vector whose part outside the span of the history is
+   *   below CompressTol replaces the latest vector instead of being
+   *   added. The history so stays well conditioned and holds no
+   *   vectors which add nothing to the prediction.
+   *
+   * - With SharedXY the X and Y solves of a two step solver share the
+   *   history of X. With Y = M X the Y system M^dag Y = chi is
+   *   M^dag M X = chi. Its projection is G = W^dag W with W = M v,
+   *   and Y is predicted as W a. The following predictX with the
+   *   same chi reuses a, so it costs no operator applications, and no
+   *   Y history is stored.
+   */
+  template<typename T, typename TF>
+  class CompressedMRE4DChronoPredictor
+    : public AbsTwoStepChronologicalPredictor4D<T>
+  {
+  private:
+    //! A history in reduced precision with its Gram matrix
+    struct History
+    {
+      History(int max_chrono) : buf(new CircularBuffer<TF>(max_chrono)) {}
+
+      Handle< CircularBuffer<TF> > buf;
+      multi2d<DComplex> gram;        /*!< gram(i,j) = v_i^dag v_j */
+      multi2d<DComplex> chol;        /*!< Cholesky factor of gram */
+      multi1d<bool>     keep;        /*!< used vectors */
+    };
+
+    History histX;
+    History histY;
+    Real    compress_tol;
+    bool    sharedP;
+
+    // Subset of the last prediction, the solutions live on it
+    const Subset* sub;
+
+    // Coefficients of the last shared Y prediction
+    bool               pendingP;
+    const T*           pending_chi;
+    multi1d<DComplex>  pending_a;
+
+
+    //! Add a vector to a history
+    void push(History& h, const T& x, const std::string& which)
+    {
+      START_CODE();
+
+      const Subset& s = *sub;
+      int Nvec = h.buf->size();
+
+      TF x_f = zero;
+      x_f[s] = x;
+
+      Double xx = norm2(x_f, s);
+
+      multi1d<DComplex> sv(Nvec);
+      for(int j=0; j < Nvec; j++) {
+	sv[j] = innerProduct(h.buf->getRef(j), x_f, s);
+      }
+
+      bool replaceP = false;
+      if( Nvec > 0 ) {
+	Double rr = CompressedMRE4DChronoPredictorEnv::outOfSpan(h.chol, h.keep, sv, xx);
+	replaceP = toBool( rr < compress_tol*compress_tol*xx );
+      }
+
+      // Row and column 0 belong to the new vector
+      int Nnew = replaceP ? Nvec : std::min(Nvec+1, h.buf->sizeMax());
+      int shift = replaceP ? 0 : 1;
+      multi2d<DComplex> gram(Nnew,Nnew);
+
+      gram(0,0) = cmplx(xx, Double(0));
+      for(int j=1; j < Nnew; j++) {
+	int jold = j - shift;
+	gram(j,0) = sv[jold];
+	gram(0,j) = conj(sv[jold]);
+
+	for(int i=1; i < Nnew; i++) {
+	  gram(i,j) = h.gram(i-shift, jold);
+	}
+      }
+
+      if( replaceP ) {
+	QDPIO::cout << "CompressedMREPredictor: new " << which
+		    << " solution is in the span of the history, replacing the latest" << std::endl;
+	h.buf->replaceHead(x_f);
+      }
+      else {
+	h.buf->push(x_f);
+      }
+
+      h.gram.resize(Nnew,Nnew);
+      h.gram = gram;
+      CompressedMRE4DChronoPredictorEnv::gramCholesky(h.chol, h.keep, h.gram, compress_tol);
+
+      QDPIO::cout << "CompressedMREPredictor: number of " << which
+		  << " vectors stored is = " << h.buf->size() << std::endl;
+
+      END_CODE();
+    }
+
+
+    //! Right hand side of the projected system, b_n = v_n^dag chi
+    void projectSource(multi1d<DComplex>& b, const History& h, const T& chi)
+    {
+      const Subset& s = *sub;
+      int Nvec = h.buf->size();
+
+      TF chi_f = zero;
+      chi_f[s] = chi;
+
+      b.resize(Nvec);
+      for(int n=0; n < Nvec; n++) {
+	b[n] = innerProduct(h.buf->getRef(n), chi_f, s);
+      }
+    }
+
+
+    //! psi = sum_n a_n v_n over a history
+    void combine(T& psi, const History& h, const multi1d<DComplex>& a)
+    {
+      const Subset& s = *sub;
+      psi = zero;
+
+      for(int n=0; n < a.size(); n++) {
+	if( ! h.keep[n] )
+	  continue;
+
+	T tmpvec = zero;
+	tmpvec[s] = h.buf->getRef(n);
+	psi[s] += Complex(a[n])*tmpvec;
+      }
+    }
+
+
+    //! Minimise the residual of A psi = chi over the span of a history
+    void find_extrap_solution(T& psi,
+			      const LinearOperator<T>& A,
+			      const T& chi,
+			      const History& h,
+			      enum PlusMinus isign)
+    {
+      START_CODE();
+
+      const Subset& s = *sub;
+      int Nvec = h.buf->size();
+
+      // G_nm = v_n^dag A v_m, one vector in full precision at a time
+      multi2d<DComplex> G(Nvec,Nvec);
+      for(int m=0; m < Nvec; m++) {
+	if( ! h.keep[m] ) {
+	  for(int n=0; n < Nvec; n++) {
+	    G(n,m) = zero;
+	  }
+	  continue;
+	}
+
+	T v_m = zero;
+	v_m[s] = h.buf->getRef(m);
+
+	T tmpvec;
+	A(tmpvec, v_m, isign);
+
+	TF tmpvec_f = zero;
+	tmpvec_f[s] = tmpvec;
+
+	for(int n=0; n < Nvec; n++) {
+	  G(n,m) = innerProduct(h.buf->getRef(n), tmpvec_f, s);
+	}
+      }
+
+      multi1d<DComplex> b;
+      projectSource(b, h, chi);
+
+      multi1d<DComplex> a;
+      CompressedMRE4DChronoPredictorEnv::solveOrthonormal(a, h.chol, h.keep, G, b);
+
+      combine(psi, h, a);
+
+      END_CODE();
+    }
+
+
+    //! Predict Y = M X for M^dag M X = chi over the span of the X history
+    void find_shared_solution(T& Y,
+			      const LinearOperator<T>& M,
+			      const T& chi)
+    {
+      START_CODE();
+
+      const Subset& s = *sub;
+      const History& h = histX;
+      int Nvec = h.buf->size();
+
+      // W = M v, G = W^dag W is hermitian
+      multi1d<TF> W(Nvec);
+      for(int m=0; m < Nvec; m++) {
+	W[m] = zero;
+	if( ! h.keep[m] )
+	  continue;
+
+	T v_m = zero;
+	v_m[s] = h.buf->getRef(m);
+
+	T tmpvec;
+	M(tmpvec, v_m, PLUS);
+	W[m][s] = tmpvec;
+      }
+
+      multi2d<DComplex> G(Nvec,Nvec);
+      for(int m=0; m < Nvec; m++) {
+	for(int n=0; n <= m; n++) {
+	  G(n,m) = innerProduct(W[n], W[m], s);
+	  G(m,n) = conj(G(n,m));
+	}
+      }
+
+      multi1d<DComplex> b;
+      projectSource(b, h, chi);
+
+      CompressedMRE4DChronoPredictorEnv::solveOrthonormal(pending_a, h.chol, h.keep, G, b);
+
+      Y = zero;
+      for(int n=0; n < Nvec; n++) {
+	if( ! h.keep[n] )
+	  continue;
+
+	T tmpvec = zero;
+	tmpvec[s] = W[n];
+	Y[s] += Complex(pending_a[n])*tmpvec;
+      }
+
+      pendingP = true;
+      pending_chi = &chi;
+
+      END_CODE();
+    }
+
+
+  public:
+
+    CompressedMRE4DChronoPredictor(unsigned int max_chrono,
+				   const Real& compress_tol_,
+				   bool sharedP_) :
+      histX(max_chrono), histY(max_chrono),
+      compress_tol(compress_tol_), sharedP(sharedP_),
+      sub(&all), pendingP(false), pending_chi(0) {}
+
+    // Destructor is automagic
+    ~CompressedMRE4DChronoPredictor(void) {}
+
+    void predictX(T& X,
+		  const LinearOperator<T>& A,
+		  const T& chi)
+    {
+      START_CODE();
+      StopWatch swatch;
+      swatch.reset();
+      swatch.start();
+
+      sub = &A.subset();
+
+      int Nvec = histX.buf->size();
+      if( Nvec == 0 ) {
+	QDPIO::cout << "CompressedMREPredictor: Zero vectors stored. Giving you zero guess" << std::endl;
+	X = zero;
+      }
+      else if( pendingP && pending_chi == &chi ) {
+	// Same system as the last Y prediction, X is spanned by the
+	// history with the same coefficients
+	QDPIO::cout << "CompressedMREPredictor: X extrapolation from the Y prediction with " << Nvec << " vectors" << std::endl;
+	combine(X, histX, pending_a);
+      }
+      else {
+	QDPIO::cout << "CompressedMREPredictor: Finding X extrapolation with "<< Nvec << " vectors" << std::endl;
+	find_extrap_solution(X, A, chi, histX, PLUS);
+      }
+      pendingP = false;
+
+      swatch.stop();
+      QDPIO::cout << "COMPRESSED_MRE_PREDICT_X_TIME = " << swatch.getTimeInSeconds() << " s" << std::endl;
+
+      END_CODE();
+    }
+
+    void predictY(T& Y,
+		  const LinearOperator<T>& M,
+		  const T& chi)
+    {
+      START_CODE();
+      StopWatch swatch;
+      swatch.reset();
+      swatch.start();
+
+      sub = &M.subset();
+      pendingP = false;
+
+      const History& h = sharedP ? histX : histY;
+      int Nvec = h.buf->size();
+      if( Nvec == 0 ) {
+	QDPIO::cout << "CompressedMREPredictor: Zero vectors stored. Giving you zero guess" << std::endl;
+	Y = zero;
+      }
+      else if( sharedP ) {
+	QDPIO::cout << "CompressedMREPredictor: Finding Y extrapolation from the X history with "<< Nvec << " vectors" << std::endl;
+	find_shared_solution(Y, M, chi);
+      }
+      else {
+	QDPIO::cout << "CompressedMREPredictor: Finding Y extrapolation with "<< Nvec << " vectors" << std::endl;
+	// Should have M as just M (not M^\dagger M) here.
+	find_extrap_solution(Y, M, chi, histY, MINUS);
+      }
+
+      swatch.stop();
+      QDPIO::cout << "COMPRESSED_MRE_PREDICT_Y_TIME = " << swatch.getTimeInSeconds() << " s" << std::endl;
+      END_CODE();
+    }
+
+    void reset(void) {
+      histX.buf->reset();
+      histY.buf->reset();
+      histX.gram.resize(0,0);
+      histY.gram.resize(0,0);
+      histX.chol.resize(0,0);
+      histY.chol.resize(0,0);
+      histX.keep.resize(0);
+      histY.keep.resize(0);
+      pendingP = false;
+    }
+
+
+    void newXVector(const T& X)
+    {
+      QDPIO::cout << "CompressedMREPredictor: registering new X solution. " << std::endl;
+      push(histX, X, "X");
+      pendingP = false;
+    }
+
+
+    void newYVector(const T& Y)
+    {
+      // With a shared history Y is predicted from the X history
+      if( sharedP )
+	return;
+
+      QDPIO::cout << "CompressedMREPredictor: registering new Y solution. " << std::endl;
+      push(histY, Y, "Y");
+    }
+
+  };
+
+} // End Namespace Chroma
+
+#endif
@@ -12,6 +12,7 @@
 #include "update/molecdyn/predictor/linear_extrap_predictor.h"
 #include "update/molecdyn/predictor/mre_extrap_predictor.h"
 #include "update/molecdyn/predictor/mre_initcg_extrap_predictor.h"
+#include "update/molecdyn/predictor/compressed_mre_predictor.h"
 
 namespace Chroma
 {
@@ -44,6 +45,7 @@ namespace Chroma
 	success &= MinimalResidualExtrapolation4DChronoPredictorEnv::registerAll();
 	success &= MinimalResidualExtrapolation5DChronoPredictorEnv::registerAll();
 	success &= MREInitCG4DChronoPredictorEnv::registerAll();
+	success &= CompressedMRE4DChronoPredictorEnv::registerAll();
 
 	registered = true;
       }
@@ -0,0 +1,85 @@
+/*! \file
+ *  \brief 16-bit fixed point storage of fermions and gauge links
+ */
+
+#include "util/ferm/half_storage.h"
+
+#ifndef QDP_IS_QDPJIT
+
+namespace Chroma
+{
+
+  //! Anonymous namespace
+  namespace
+  {
+    //! Arguments of the threaded pack/unpack loops
+    struct HalfPackArgs
+    {
+      HalfPrecFermion& h;
+      LatticeFermionF& f;
+      const multi1d<int>& tab;
+    };
+
+    void packSites(int lo, int hi, int myId, HalfPackArgs* a)
+    {
+      for(int j=lo; j < hi; ++j)
+      {
+	const int site = a->tab[j];
+	a->h.storeSite(&(a->f.elem(site).elem(0).elem(0).real()), site);
+      }
+    }
+
+    void unpackSites(int lo, int hi, int myId, HalfPackArgs* a)
+    {
+      for(int j=lo; j < hi; ++j)
+      {
+	const int site = a->tab[j];
+	a->h.loadSite(&(a->f.elem(site).elem(0).elem(0).real()), site);
+      }
+    }
+  }
+
+
+  // Storage for all sites on this node
+  HalfPrecFermion::HalfPrecFermion()
+  {
+    const int nodeSites = Layout::sitesOnNode();
+    data.resize(nreal*nodeSites);
+    norm.resize(nodeSites);
+  }
+
+
+  // Compress f on the subset s
+  void HalfPrecFermion::pack(const LatticeFermionF& f, const Subset& s)
+  {
+    // The kernels only read f when packing
+    HalfPackArgs arg = {*this, const_cast<LatticeFermionF&>(f), s.siteTable()};
+    dispatch_to_threads(s.numSiteTable(), arg, packSites);
+  }
+
+
+  // Decompress into f on the subset s
+  void HalfPrecFermion::unpack(LatticeFermionF& f, const Subset& s) const
+  {
+    // The kernels only read the compressed data when unpacking
+    HalfPackArgs arg = {const_cast<HalfPrecFermion&>(*this), f, s.siteTable()};
+    dispatch_to_threads(s.numSiteTable(), arg, unpackSites);
+  }
+
+
+  // Zero on the subset s
+  void HalfPrecFermion::zero(const Subset& s)
+  {
+    const multi1d<int>& tab = s.siteTable();
+    for(int j=0; j < s.numSiteTable(); ++j)
+    {
+      const int site = tab[j];
+      norm[site] = 0;
+      for(int i=0; i < nreal; ++i)
+	data[nreal*site + i] = 0;
+    }
+  }
+
+}  // end namespace Chroma
+
+#endif
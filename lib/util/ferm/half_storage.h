@@ -0,0 +1,147 @@
+// -*- C++ -*-
+/*! \file
+ *  \brief 16-bit fixed point storage of fermions and gauge links
+ */
+
+#ifndef __half_storage_h__
+#define __half_storage_h__
+
+#include "chromabase.h"
+
+#include <vector>
+#include <cmath>
+
+namespace Chroma
+{
+  //! Helpers for the 16-bit fixed point storage
+  namespace HalfStorageEnv
+  {
+    //! Largest stored integer
+    const float max_short = 32767.0;
+
+    //! Compress n reals into 16-bit integers, returning the per-site norm
+    template<typename R>
+    inline
+    float compress(short* dst, const R* src, int n)
+    {
+      float nrm = 0;
+      for(int i=0; i < n; ++i)
+      {
+	float t = std::fabs(float(src[i]));
+	if (t > nrm)
+	  nrm = t;
+      }
+
+      const float scale = (nrm > 0) ? max_short / nrm : 0;
+      for(int i=0; i < n; ++i)
+	dst[i] = short(std::floor(float(src[i])*scale + 0.5f));
+
+      return nrm;
+    }
+
+    //! Decompress n 16-bit integers with the per-site norm
+    template<typename R>
+    inline
+    void decompress(R* dst, const short* src, float nrm, int n)
+    {
+      const float scale = nrm / max_short;
+      for(int i=0; i < n; ++i)
+	dst[i] = R(scale * float(src[i]));
+    }
+  }
+
+
+  //! Fermion stored as 16-bit fixed point numbers with a norm per site
+  /*!
+   * \ingroup ferm
+   *
+   * Each site holds 2*Ns*Nc shorts scaled by the largest component of
+   * the site, so the relative precision is about 3e-5 per site. This halves
+   * the memory traffic compared to single precision and is intended for
+   * the sloppy vectors of mixed precision solvers, whose errors are
+   * removed by the reliable updates in higher precision.
+   */
+  class HalfPrecFermion
+  {
+  public:
+    //! Number of reals per site
+    enum {nreal = 2*Ns*Nc};
+
+    //! Storage for all sites on this node
+    HalfPrecFermion();
+
+    //! Compress f on the subset s
+    void pack(const LatticeFermionF& f, const Subset& s);
+
+    //! Decompress into f on the subset s
+    void unpack(LatticeFermionF& f, const Subset& s) const;
+
+    //! Zero on the subset s
+    void zero(const Subset& s);
+
+    //! Decompress a single site into nreal reals
+    inline void loadSite(REAL32* v, int site) const
+    {
+      HalfStorageEnv::decompress(v, &data[nreal*site], norm[site], nreal);
+    }
+
+    //! Compress nreal reals into a single site
+    inline void storeSite(const REAL32* v, int site)
+    {
+      norm[site] = HalfStorageEnv::compress(&data[nreal*site], v, nreal);
+    }
+
+  private:
+    std::vector<short> data;
+    std::vector<float> norm;
+  };
+
+
+  //! Gauge links stored as 16-bit fixed point numbers with a norm per link
+  /*!
+   * \ingroup ferm
+   *
+   * Used by dslash kernels that decompress the links on the fly. The norm
+   * is kept per link so anisotropy factors and boundary phases folded into
+   * the links do not cost precision.
+   */
+  class HalfPrecLinks
+  {
+  public:
+    //! Number of reals per link
+    enum {nreal = 2*Nc*Nc};
+
+    //! Compress the Nd links
+    template<typename Q>
+    void pack(const Q& u)
+    {
+      const int nodeSites = Layout::sitesOnNode();
+      data.resize(nreal*Nd*nodeSites);
+      norm.resize(Nd*nodeSites);
+
+      for(int site=0; site < nodeSites; ++site)
+	for(int mu=0; mu < Nd; ++mu)
+	{
+	  const int l = Nd*site + mu;
+	  norm[l] = HalfStorageEnv::compress(&data[nreal*l],
+					     &(u[mu].elem(site).elem().elem(0,0).real()),
+					     nreal);
+	}
+    }
+
+    //! Decompress the link in direction mu at site into a colour matrix
+    template<typename CM>
+    inline void load(CM& m, int mu, int site) const
+    {
+      const int l = Nd*site + mu;
+      HalfStorageEnv::decompress(&(m.elem(0,0).real()), &data[nreal*l], norm[l], nreal);
+    }
+
+  private:
+    std::vector<short> data;
+    std::vector<float> norm;
+  };
+
+}  // end namespace Chroma
+
+#endif
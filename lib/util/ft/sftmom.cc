@@ -27,7 +27,7 @@
 //  Added a default constructor.
 //
 //  Revision 3.2  2006/08/30 02:10:19  edwards
-//  Technically a bug fix. The test for a zero_offset should only be in directions
+//  Technically a bug fix. The test for a zero_offset should only be in directions
 //  not in the fourier transform. E.g., there was a missing test of mu==decay_dir.
 //
 //  Revision 3.1  2006/08/19 19:29:33  flemingg
@@ -101,9 +101,31 @@
 #include "util/ft/single_phase.h"
 #include "qdp_util.h"                 // part of QDP++, for crtesn()
 
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <vector>
+
 namespace Chroma 
 {
 
+  namespace SftMomEnv
+  {
+    static bool fftP = false;
+    static int maxPhases = 0;
+  }
+
+  void setSftMomFFT(bool fftP)
+  {
+    SftMomEnv::fftP = fftP;
+  }
+
+  void setSftMomMaxPhases(int max_phases)
+  {
+    SftMomEnv::maxPhases = max_phases;
+  }
+
+
   // Param struct for SftMom
   SftMomParams_t::SftMomParams_t()
   {
@@ -190,13 +212,12 @@ namespace Chroma
     num_mom = moms.size2();
     mom_list = moms;
 
-    phases.resize(num_mom);
-
-
+    fft_mom = mom_list;
+    fft_mom_num.resize(num_mom);
     for (int m = 0 ; m < num_mom ; ++m)
-    {
-      phases[m] = singlePhase(orig, mom_list[m], decay_dir);
-    }
+      fft_mom_num[m] = m;
+
+    initPhases();
 
   }
 
@@ -238,6 +259,7 @@ namespace Chroma
   {
     decay_dir     = j_decay;    // private copy
     origin_offset = origin_off; // private copy
+    max_phases    = SftMomEnv::maxPhases;
     mom_offset    = mom_off;    // private copy
     avg_equiv_mom = avg_mom;    // private copy
 
@@ -331,15 +353,8 @@ namespace Chroma
       }
     }
 
-    // Now resize and initialize the Fourier phase table.  Then, loop over
-    // allowed momenta, optionally averaging over equivalent momenta.
-    phases.resize(num_mom) ;
-    phases = 0. ;
-
-    // Coordinates for sink momenta
-    multi1d<LatticeInteger> my_coord(Nd);
-    for (int mu=0; mu < Nd; ++mu)
-      my_coord[mu] = Layout::latticeCoordinate(mu);
+    // Now loop over allowed momenta, and find the ones averaged over
+    // for the Fourier phase table.
 
     // Keep track of |mom| degeneracy for averaging
     mom_degen.resize(num_mom);
@@ -359,6 +374,10 @@ namespace Chroma
     // reset mom_num
     mom_num = 0 ;
 
+    // All momenta in the phases, for the transform in sft()
+    std::vector< multi1d<int> > all_mom;
+    std::vector<int> all_mom_num;
+
     for (int n=0; n < mom_vol; ++n) {
       multi1d<int> mom = crtesn(n, mom_size) ;
 
@@ -424,37 +443,128 @@ namespace Chroma
 	}
       } // end if (avg_equiv_mom)
 
+      all_mom.push_back(mom);
+      all_mom_num.push_back(mom_num);
+
+      // increment mom_num for next valid momenta
+      ++mom_num ;
+
+    } // end for (int n=0; n < mom_vol; ++n)
+
+    fft_mom.resize(all_mom.size(), mom_size.size());
+    fft_mom_num.resize(all_mom.size());
+    for (int n=0; n < all_mom.size(); ++n) {
+      fft_mom[n] = all_mom[n];
+      fft_mom_num[n] = all_mom_num[n];
+    }
+
+    initPhases();
+  }
+
+
+  void
+  SftMom::initPhases()
+  {
+    int n = num_mom;
+    if (max_phases > 0)
+      n = std::min(max_phases, num_mom);
+
+    phases.resize(n);
+    phase_num.resize(n);
+    phase_used.resize(n);
+    phase_clock = 0;
+
+    for (int k=0; k < n; ++k) {
+      phase_num[k]  = -1;
+      phase_used[k] = 0;
+    }
+
+    if (max_phases > 0)
+      return;
+
+    for (int mom_num=0; mom_num < num_mom; ++mom_num) {
+      makePhase(phases[mom_num], mom_num, all);
+      phase_num[mom_num] = mom_num;
+    }
+  }
+
+
+  void
+  SftMom::makePhase(LatticeComplex& ph, int mom_num, const Subset& s) const
+  {
+    ph[s] = zero;
+
+    for (int n=0; n < fft_mom.size2(); ++n) {
+      if (fft_mom_num[n] != mom_num) continue;
+
       //
       // Build the phase. 
       // RGE: the origin_offset works with or without momentum averaging
       //
       LatticeReal p_dot_x ;
-      p_dot_x = 0. ;
+      p_dot_x[s] = zero;
 
       int j = 0;
       for(int mu = 0; mu < Nd; ++mu) {
 	const Real twopi = 6.283185307179586476925286;
 
-	if (mu == j_decay) continue ;
+	if (mu == decay_dir) continue ;
 
-	p_dot_x += LatticeReal(my_coord[mu] - origin_offset[mu]) * twopi *
-          Real(mom[j]) / Layout::lattSize()[mu];
+	p_dot_x[s] += LatticeReal(Layout::latticeCoordinate(mu) - origin_offset[mu]) * twopi *
+          Real(fft_mom[n][j]) / Layout::lattSize()[mu];
 	++j ;
       } // end for(mu)
 
-      phases[mom_num] += cmplx(cos(p_dot_x), sin(p_dot_x)) ;
-
-      // increment mom_num for next valid momenta
-      ++mom_num ;
-
-    } // end for (int n=0; n < mom_vol; ++n)
+      ph[s] += cmplx(cos(p_dot_x), sin(p_dot_x)) ;
+    }
 
     // Finish averaging
     // Momentum averaging works even in the presence of an origin_offset
-    if (avg_equiv_mom) {
-      for (int mom_num=0; mom_num < num_mom; ++mom_num)
-	phases[mom_num] /= mom_degen[mom_num] ;
+    if (avg_equiv_mom)
+      ph[s] /= Real(mom_degen[mom_num]) ;
+  }
+
+
+  const LatticeComplex&
+  SftMom::cachedPhase(int mom_num) const
+  {
+    ++phase_clock;
+
+    int slot = -1;
+    for (int k=0; k < phase_num.size(); ++k) {
+      if (phase_num[k] == mom_num) {
+	slot = k;
+	break;
+      }
+    }
+
+    // Replace the least recently used one
+    if (slot < 0) {
+      slot = 0;
+      for (int k=1; k < phase_used.size(); ++k)
+	if (phase_used[k] < phase_used[slot]) slot = k;
+
+      makePhase(phases[slot], mom_num, all);
+      phase_num[slot] = mom_num;
     }
+
+    phase_used[slot] = phase_clock;
+    return phases[slot];
+  }
+
+
+  const LatticeComplex&
+  SftMom::slicePhase(LatticeComplex& tmp, int mom_num, int subset_color) const
+  {
+    if (max_phases == 0)
+      return phases[mom_num];
+
+    // Made outside the cache, so the cached phases are not evicted
+    if (subset_color < 0)
+      makePhase(tmp, mom_num, all);
+    else
+      makePhase(tmp, mom_num, sft_set[subset_color]);
+    return tmp;
   }
 
 
@@ -520,13 +630,239 @@ namespace Chroma
     return -1;
   }
 
+
+#ifndef QDP_IS_QDPJIT
+  // Anonymous namespace
+  namespace
+  {
+    typedef std::complex<double> SftComplex;
+
+    //! Site value of a real field
+    inline SftComplex siteValue(const LatticeReal& cf, int i)
+    {
+      return SftComplex(cf.elem(i).elem().elem().elem(), 0);
+    }
+
+    //! Site value of a complex field
+    inline SftComplex siteValue(const LatticeComplex& cf, int i)
+    {
+      const RComplex<REAL>& z = cf.elem(i).elem().elem();
+      return SftComplex(z.real(), z.imag());
+    }
+
+#if BASE_PRECISION==32
+    //! Site value of a double precision complex field
+    inline SftComplex siteValue(const LatticeComplexD& cf, int i)
+    {
+      const RComplex<REAL64>& z = cf.elem(i).elem().elem();
+      return SftComplex(z.real(), z.imag());
+    }
+#endif
+
+    //! Arguments of a partial transform
+    struct PartialFTArgs
+    {
+      const std::vector<SftComplex>& in;
+      const std::vector<SftComplex>& ph;
+      int                            n_x;
+      int                            n_p;
+      int                            n_inner;
+      std::vector<SftComplex>&       out;
+    };
+
+    //! out[o][p][i] = sum_x ph[p][x] in[o][x][i], for a range of (o,p)
+    void partialFTLoop(int lo, int hi, int myId, PartialFTArgs* a)
+    {
+      const int n_inner = a->n_inner;
+
+      for(int op=lo; op < hi; ++op)
+      {
+	const int o = op / a->n_p;
+	const int p = op % a->n_p;
+
+	SftComplex* dst = &a->out[size_t(op)*n_inner];
+	for(int i=0; i < n_inner; ++i)
+	  dst[i] = 0;
+
+	for(int x=0; x < a->n_x; ++x)
+	{
+	  const SftComplex  w   = a->ph[p*a->n_x + x];
+	  const SftComplex* src = &a->in[(size_t(o)*a->n_x + x)*n_inner];
+
+	  for(int i=0; i < n_inner; ++i)
+	    dst[i] += w * src[i];
+	}
+      }
+    }
+
+    //! Transform the middle index of in[n_outer][n_x][n_inner] with the phases ph[n_p][n_x]
+    void partialFT(std::vector<SftComplex>& out, const std::vector<SftComplex>& in,
+		   const std::vector<SftComplex>& ph, int n_outer, int n_x, int n_p, int n_inner)
+    {
+      out.resize(size_t(n_outer)*n_p*n_inner);
+
+      PartialFTArgs args = {in, ph, n_x, n_p, n_inner, out};
+      dispatch_to_threads(n_outer*n_p, args, partialFTLoop);
+    }
+  }
+
+
+  //! sft() by partial transforms in each direction
+  /*!
+   * The phases factorize over the directions, so the sum over the
+   * node-local box is done one direction at a time, each time replacing
+   * a coordinate by the needed range of that momentum component. This is
+   * the row-column scheme of a multidimensional FFT, pruned to the
+   * momenta in the list. The local sums of all momenta and time slices
+   * are then added over the nodes in one global sum.
+   */
+  template<typename T>
+  multi2d<DComplex>
+  SftMom::fftSft(const T& cf, int subset_color) const
+  {
+    const int length = sft_set.numSubsets();
+    const bool sliceP = (decay_dir >= 0) && (decay_dir < Nd);
+
+    const multi1d<int>& sub = Layout::subgridLattSize();
+    const multi1d<int>& node_coord = Layout::nodeCoord();
+
+    // The transformed directions, outermost first
+    multi1d<int> dirs(Nd);
+    int nd = 0;
+    for(int mu=0; mu < Nd; ++mu)
+      if (mu != decay_dir) dirs[nd++] = mu;
+
+    // Local extents of the box: the time slices and then the directions
+    const int lt = sliceP ? sub[decay_dir] : 1;
+    const int t0 = sliceP ? node_coord[decay_dir]*sub[decay_dir] : 0;
+    int box_vol = lt;
+    for(int k=0; k < nd; ++k)
+      box_vol *= sub[dirs[k]];
+
+    // Site of each point of the box, once
+    if (fft_sites.size() != box_vol)
+    {
+      fft_sites.resize(box_vol);
+      for(int i=0; i < Layout::sitesOnNode(); ++i)
+      {
+	multi1d<int> coord = Layout::siteCoords(Layout::nodeNumber(), i);
+
+	int b = sliceP ? coord[decay_dir] - t0 : 0;
+	for(int k=0; k < nd; ++k)
+	  b = b*sub[dirs[k]] + coord[dirs[k]] - node_coord[dirs[k]]*sub[dirs[k]];
+
+	fft_sites[b] = i;
+      }
+    }
+
+    // The time slices to do
+    int tl_lo = 0;
+    int tl_hi = lt;
+    if (subset_color >= 0)
+    {
+      tl_lo = sliceP ? subset_color - t0 : 0;
+      tl_hi = tl_lo + 1;
+      if (tl_lo < 0 || tl_lo >= lt)
+	tl_hi = tl_lo;
+    }
+    const int n_t = tl_hi - tl_lo;
+    const int slice_vol = box_vol / lt;
+
+    std::vector<SftComplex> cur(size_t(n_t)*slice_vol);
+    for(int n=0; n < cur.size(); ++n)
+      cur[n] = siteValue(cf, fft_sites[tl_lo*slice_vol + n]);
+
+    // Range of each momentum component
+    const int n_fft = fft_mom.size2();
+    multi1d<int> p_min(nd), n_p(nd);
+    for(int k=0; k < nd; ++k)
+    {
+      int lo = 0, hi = 0;
+      for(int n=0; n < n_fft; ++n)
+      {
+	if (n == 0 || fft_mom[n][k] < lo) lo = fft_mom[n][k];
+	if (n == 0 || fft_mom[n][k] > hi) hi = fft_mom[n][k];
+      }
+      p_min[k] = lo;
+      n_p[k]   = hi - lo + 1;
+    }
+
+    // One direction after the other
+    int n_outer = n_t;
+    int n_inner = slice_vol;
+    for(int k=0; k < nd; ++k)
+    {
+      const int mu  = dirs[k];
+      const int L   = Layout::lattSize()[mu];
+      const int n_x = sub[mu];
+      n_inner /= n_x;
+
+      // exp(2 pi i p (x - x_0) / L), with the product reduced mod L
+      std::vector<SftComplex> ph(n_p[k]*n_x);
+      for(int p=0; p < n_p[k]; ++p)
+      {
+	for(int x=0; x < n_x; ++x)
+	{
+	  const int xg = node_coord[mu]*sub[mu] + x;
+	  long px = (long(p_min[k] + p) * (xg - origin_offset[mu])) % L;
+	  if (px < 0) px += L;
+
+	  const double arg = 6.283185307179586476925286 * double(px) / double(L);
+	  ph[p*n_x + x] = SftComplex(std::cos(arg), std::sin(arg));
+	}
+      }
+
+      std::vector<SftComplex> next;
+      partialFT(next, cur, ph, n_outer, n_x, n_p[k], n_inner);
+      cur.swap(next);
+
+      n_outer *= n_p[k];
+    }
+
+    // Collect the momenta, averaged if needed, and sum over the nodes
+    const int n_box_p = n_outer / std::max(n_t, 1);
+    std::vector<SftComplex> hs(size_t(num_mom)*length, SftComplex(0));
+
+    for(int n=0; n < n_fft; ++n)
+    {
+      const int m = fft_mom_num[n];
+      const double w = avg_equiv_mom ? 1.0 / mom_degen[m] : 1.0;
+
+      int pidx = 0;
+      for(int k=0; k < nd; ++k)
+	pidx = pidx*n_p[k] + fft_mom[n][k] - p_min[k];
+
+      for(int tl=0; tl < n_t; ++tl)
+	hs[size_t(m)*length + t0 + tl_lo + tl] += w * cur[size_t(tl)*n_box_p + pidx];
+    }
+
+    if (hs.size() > 0)
+      QDPInternal::globalSumArray(reinterpret_cast<double*>(&hs[0]), 2*hs.size());
+
+    multi2d<DComplex> hsum(num_mom, length);
+    for(int m=0; m < num_mom; ++m)
+      for(int t=0; t < length; ++t)
+	hsum[m][t] = cmplx(Double(hs[size_t(m)*length + t].real()), Double(hs[size_t(m)*length + t].imag()));
+
+    return hsum;
+  }
+#endif
+
+
   multi2d<DComplex>
   SftMom::sft(const LatticeComplex& cf) const
   {
+#ifndef QDP_IS_QDPJIT
+    // With bounded phases a loop over operator[] would remake every phase
+    if (SftMomEnv::fftP || max_phases > 0)
+      return fftSft(cf, -1);
+#endif
+
     multi2d<DComplex> hsum(num_mom, sft_set.numSubsets()) ;
+    LatticeComplex tmp;
 
     for (int mom_num=0; mom_num < num_mom; ++mom_num)
-      hsum[mom_num] = sumMulti(phases[mom_num]*cf, sft_set) ;
+      hsum[mom_num] = sumMulti(slicePhase(tmp, mom_num, -1)*cf, sft_set) ;
 
     return hsum ;
   }
@@ -534,13 +870,19 @@ namespace Chroma
   multi2d<DComplex>
   SftMom::sft(const LatticeComplex& cf, int subset_color) const
   {
+#ifndef QDP_IS_QDPJIT
+    if (SftMomEnv::fftP)
+      return fftSft(cf, subset_color);
+#endif
+
     int length = sft_set.numSubsets();
     multi2d<DComplex> hsum(num_mom, length);
+    LatticeComplex tmp;
 
     for (int mom_num=0; mom_num < num_mom; ++mom_num)
     {
       hsum[mom_num] = zero;
-      hsum[mom_num][subset_color] = sum(phases[mom_num]*cf, sft_set[subset_color]);
+      hsum[mom_num][subset_color] = sum(slicePhase(tmp, mom_num, subset_color)*cf, sft_set[subset_color]);
     }
 
     return hsum ;
@@ -549,10 +891,17 @@ namespace Chroma
   multi2d<DComplex>
   SftMom::sft(const LatticeReal& cf) const
   {
+#ifndef QDP_IS_QDPJIT
+    // With bounded phases a loop over operator[] would remake every phase
+    if (SftMomEnv::fftP || max_phases > 0)
+      return fftSft(cf, -1);
+#endif
+
     multi2d<DComplex> hsum(num_mom, sft_set.numSubsets()) ;
+    LatticeComplex tmp;
 
     for (int mom_num=0; mom_num < num_mom; ++mom_num)
-      hsum[mom_num] = sumMulti(phases[mom_num]*cf, sft_set) ;
+      hsum[mom_num] = sumMulti(slicePhase(tmp, mom_num, -1)*cf, sft_set) ;
 
     return hsum ;
   }
@@ -560,13 +909,19 @@ namespace Chroma
   multi2d<DComplex>
   SftMom::sft(const LatticeReal& cf, int subset_color) const
   {
+#ifndef QDP_IS_QDPJIT
+    if (SftMomEnv::fftP)
+      return fftSft(cf, subset_color);
+#endif
+
     int length = sft_set.numSubsets();
     multi2d<DComplex> hsum(num_mom, length);
+    LatticeComplex tmp;
 
     for (int mom_num=0; mom_num < num_mom; ++mom_num)
     {
       hsum[mom_num] = zero;
-      hsum[mom_num][subset_color] = sum(phases[mom_num]*cf, sft_set[subset_color]);
+      hsum[mom_num][subset_color] = sum(slicePhase(tmp, mom_num, subset_color)*cf, sft_set[subset_color]);
     }
 
     return hsum ;
@@ -576,10 +931,17 @@ namespace Chroma
   multi2d<DComplex>
   SftMom::sft(const LatticeComplexD& cf) const
   {
+#ifndef QDP_IS_QDPJIT
+    // With bounded phases a loop over operator[] would remake every phase
+    if (SftMomEnv::fftP || max_phases > 0)
+      return fftSft(cf, -1);
+#endif
+
     multi2d<DComplex> hsum(num_mom, sft_set.numSubsets()) ;
+    LatticeComplex tmp;
 
     for (int mom_num=0; mom_num < num_mom; ++mom_num)
-      hsum[mom_num] = sumMulti(phases[mom_num]*cf, sft_set) ;
+      hsum[mom_num] = sumMulti(slicePhase(tmp, mom_num, -1)*cf, sft_set) ;
 
     return hsum ;
   }
@@ -587,13 +949,19 @@ namespace Chroma
   multi2d<DComplex>
   SftMom::sft(const LatticeComplexD& cf, int subset_color) const
   {
+#ifndef QDP_IS_QDPJIT
+    if (SftMomEnv::fftP)
+      return fftSft(cf, subset_color);
+#endif
+
     int length = sft_set.numSubsets();
     multi2d<DComplex> hsum(num_mom, length);
+    LatticeComplex tmp;
 
     for (int mom_num=0; mom_num < num_mom; ++mom_num)
     {
       hsum[mom_num] = zero;
-      hsum[mom_num][subset_color] = sum(phases[mom_num]*cf, sft_set[subset_color]);
+      hsum[mom_num][subset_color] = sum(slicePhase(tmp, mom_num, subset_color)*cf, sft_set[subset_color]);
     }
 
     return hsum ;
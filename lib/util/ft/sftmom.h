@@ -27,6 +27,34 @@ namespace Chroma
   };
 
 
+  //! Use the transform by directions in SftMom::sft
+  /*!
+   * \ingroup ft
+   *
+   * The projection onto all momenta is done by one partial Fourier
+   * transform per direction on the node-local sites, followed by a
+   * single global sum, instead of a sumMulti per momentum phase.
+   * Off by default.
+   */
+  void setSftMomFFT(bool fftP);
+
+  //! Bound the number of phase fields kept by each SftMom
+  /*!
+   * \ingroup ft
+   *
+   * With max_phases > 0, SftMom objects constructed afterwards keep at
+   * most max_phases phase fields and make the others on demand from the
+   * momenta. sft() then uses the partial transforms of
+   * setSftMomFFT(), or with QDP-JIT makes the phases outside the kept
+   * ones. The subset versions of sft() and slicePhase() make the phases
+   * only on that time slice. 0, the default, keeps all phases.
+   *
+   * operator[] returns a copy, so a phase from it stays valid however
+   * many other momenta are asked for later.
+   */
+  void setSftMomMaxPhases(int max_phases);
+
+
   //! Fourier transform phase factor support
   /*!
    * \ingroup ft
@@ -86,8 +114,16 @@ namespace Chroma
     multi1d<int> canonicalOrder(const multi1d<int>& mom) const;
 
     //! Return the phase for this particular momenta id
-    const LatticeComplex& operator[](int mom_num) const
-      { return phases[mom_num]; }
+    /*! A copy. With bounded phases it comes from the kept ones, made on demand */
+    LatticeComplex operator[](int mom_num) const
+      { return (max_phases > 0) ? cachedPhase(mom_num) : phases[mom_num]; }
+
+    //! The phase of a momentum id on time slice subset_color, or everywhere if it is -1
+    /*!
+     * With bounded phases it is made in tmp on that slice only, and the
+     * kept phases are left alone. The result is only defined on the slice.
+     */
+    const LatticeComplex& slicePhase(LatticeComplex& tmp, int mom_num, int subset_color) const;
 
     //! Return the the multiplicity for this momenta id.
     /*! Only nonzero if momentum averaging is turned on */
@@ -118,15 +154,37 @@ namespace Chroma
     void init(int mom2_max, multi1d<int> origin_offset, multi1d<int> mom_offset,
 	      bool avg_mom_=false, int j_decay=-1);
 
+    //! sft() by partial transforms in each direction
+    template<typename T>
+    multi2d<DComplex> fftSft(const T& cf, int subset_color) const;
+
+    //! Make the phases, or the cache for them
+    void initPhases();
+
+    //! Make the phase of a momentum id on a subset
+    void makePhase(LatticeComplex& ph, int mom_num, const Subset& s) const;
+
+    //! The phase of a momentum id from the cache
+    const LatticeComplex& cachedPhase(int mom_num) const;
+
     multi2d<int> mom_list;
     bool         avg_equiv_mom;
     int          decay_dir;
     int          num_mom;
     multi1d<int> origin_offset;
     multi1d<int> mom_offset;
-    multi1d<LatticeComplex> phases;
+    mutable multi1d<LatticeComplex> phases;
     multi1d<int> mom_degen;
     Set sft_set;
+
+    multi2d<int> fft_mom;              /*!< all momenta summed in the phases */
+    multi1d<int> fft_mom_num;          /*!< the momentum id of each */
+    mutable multi1d<int> fft_sites;    /*!< site of each point of the node-local box */
+
+    int max_phases;                    /*!< 0 if all phases are kept */
+    mutable multi1d<int> phase_num;    /*!< momentum id in each cache slot */
+    mutable multi1d<int> phase_used;   /*!< last use of each cache slot */
+    mutable int phase_clock;
   };
 
 }  // end namespace Chroma
@@ -0,0 +1,82 @@
+/*! \file
+ *  \brief Sums over the nodes that share the same time slices
+ */
+
+#include "util/ft/time_slice_comm.h"
+
+namespace Chroma 
+{
+
+  //! Layers along decay_dir
+  TimeSliceComm::TimeSliceComm(int decay_dir_) : decay_dir(decay_dir_)
+  {
+    if (decay_dir < 0 || decay_dir >= Nd)
+    {
+      QDPIO::cerr << "TimeSliceComm: invalid decay direction " << decay_dir << std::endl;
+      QDP_abort(1);
+    }
+
+    n_layers = Layout::logicalSize()[decay_dir];
+    layer    = Layout::nodeCoord()[decay_dir];
+    n_local  = Layout::subgridLattSize()[decay_dir];
+
+#ifdef ARCH_PARSCALAR
+    // The root of a layer holds its corner site
+    layer_root.resize(n_layers);
+    for(int l=0; l < n_layers; ++l)
+    {
+      multi1d<int> coord(Nd);
+      coord = 0;
+      coord[decay_dir] = l*n_local;
+      layer_root[l] = Layout::nodeNumber(coord);
+    }
+
+    if (QMP_comm_split(QMP_comm_get_default(), layer, Layout::nodeNumber(), &layer_comm) != QMP_SUCCESS)
+    {
+      QDPIO::cerr << "TimeSliceComm: QMP_comm_split failed" << std::endl;
+      QDP_abort(1);
+    }
+#endif
+  }
+
+
+  //! Release the layer communicator
+  TimeSliceComm::~TimeSliceComm()
+  {
+#ifdef ARCH_PARSCALAR
+    QMP_comm_free(layer_comm);
+#endif
+  }
+
+
+  //! Sum over the nodes of this layer
+  void TimeSliceComm::sumArray(double* d, int n) const
+  {
+#ifdef ARCH_PARSCALAR
+    if (n > 0 && QMP_comm_sum_double_array(layer_comm, d, n) != QMP_SUCCESS)
+    {
+      QDPIO::cerr << "TimeSliceComm: QMP_comm_sum_double_array failed" << std::endl;
+      QDP_abort(1);
+    }
+#endif
+  }
+
+
+  //! Copy the array of the root of layer l to the primary node
+  void TimeSliceComm::toPrimary(double* d, int n, int l) const
+  {
+#ifdef ARCH_PARSCALAR
+    // The primary node is in the layer of its own root
+    const int root = layer_root[l];
+    const int bytes = n*sizeof(double);
+    if (root == 0 || bytes == 0)
+      return;
+
+    if (Layout::nodeNumber() == root)
+      QDPInternal::sendToWait(d, 0, bytes);
+    if (Layout::primaryNode())
+      QDPInternal::recvFromWait(d, root, bytes);
+#endif
+  }
+
+}  // end namespace Chroma
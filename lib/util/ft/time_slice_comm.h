@@ -0,0 +1,75 @@
+// -*- C++ -*-
+/*! \file
+ *  \brief Sums over the nodes that share the same time slices
+ */
+
+#ifndef __time_slice_comm_h__
+#define __time_slice_comm_h__
+
+#include "chromabase.h"
+
+namespace Chroma 
+{
+
+  //! Sums over the nodes that share the same time slices
+  /*!
+   * \ingroup ft
+   *
+   * The nodes with the same coordinate in the decay direction form a
+   * layer and hold the same range of time slices. A quantity summed over
+   * the sites of the local time slices only needs to be summed within
+   * the layer, and only its root has to send the result on to the
+   * primary node. Every layer holds the same number of time slices, so
+   * all nodes can loop over their local slices in step.
+   */
+  class TimeSliceComm
+  {
+  public:
+    //! Layers along decay_dir
+    TimeSliceComm(int decay_dir);
+
+    //! Release the layer communicator
+    ~TimeSliceComm();
+
+    //! Number of layers
+    int numLayers() const {return n_layers;}
+
+    //! Layer of this node
+    int myLayer() const {return layer;}
+
+    //! Number of time slices in each layer
+    int numLocalSlices() const {return n_local;}
+
+    //! Global time slice of local slice k of layer l
+    int globalSlice(int l, int k) const {return l*n_local + k;}
+
+    //! Sum over the nodes of this layer
+    void sumArray(double* d, int n) const;
+
+    //! Copy the array of the root of layer l to the primary node
+    /*!
+     * Collective. The array d of length n, already summed over the
+     * layer, is overwritten on the primary node by the one of layer l.
+     * The other nodes keep theirs.
+     */
+    void toPrimary(double* d, int n, int l) const;
+
+  private:
+    //! Hide copies, the communicator is owned
+    TimeSliceComm(const TimeSliceComm&);
+    TimeSliceComm& operator=(const TimeSliceComm&);
+
+    int  decay_dir;
+    int  n_layers;
+    int  layer;
+    int  n_local;
+
+#ifdef ARCH_PARSCALAR
+    QMP_comm_t   layer_comm;    /*!< the nodes of this layer */
+    multi1d<int> layer_root;    /*!< root node of each layer */
+#endif
+  };
+
+}  // end namespace Chroma
+
+#endif
@@ -0,0 +1,298 @@
+// -*- C++ -*-
+/*! \file
+ *  \brief Gauge links stored with 12- or 8-real reconstruction
+ */
+
+#ifndef __compressed_links_h__
+#define __compressed_links_h__
+
+#include "chromabase.h"
+
+#include <vector>
+#include <complex>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+
+namespace Chroma
+{
+  //! Number of reals stored per link
+  /*! \ingroup gauge */
+  enum LinkReconstruct
+  {
+    RECONSTRUCT_NONE = 18,   /*!< full matrix */
+    RECONSTRUCT_12 = 12,     /*!< first two rows */
+    RECONSTRUCT_8 = 8        /*!< minimal SU(3) parametrisation */
+  };
+
+
+  //! Gauge links stored with 12- or 8-real reconstruction
+  /*!
+   * \ingroup gauge
+   *
+   * Every link is written as  U = f V  with V in SU(3) and f a complex
+   * factor. The factor carries the anisotropy, the boundary phases and
+   * other rescalings folded into the links. Lattices only have a few
+   * distinct factors, so each link stores just an index into a small
+   * table of them.
+   *
+   * V is stored as its first two rows (12 reals) or as 8 reals:
+   * V(0,1), V(0,2), V(1,0) and the phases of V(0,0) and V(2,0).
+   * The rest is rebuilt from unitarity when the link is loaded.
+   *
+   * The links are checked after compression, to a small multiple of the
+   * rounding error of R. If the reconstruction does not reproduce them on
+   * some node, all nodes fall back to 18 reals. 8 reals also fall back to
+   * 12 if a link is too close to the singular point of the
+   * parametrisation.
+   */
+  template<typename R>
+  class CompressedLinksT
+  {
+  public:
+    typedef std::complex<R> C;
+
+    //! Compress the Nd links
+    /*!
+     * \param u       links                                   (Read)
+     * \param recon_  requested LinkReconstruct                (Read)
+     */
+    template<typename Q>
+    CompressedLinksT(const Q& u, int recon_) : requested_recon(recon_)
+    {
+      START_CODE();
+
+      recon = (Nc == 3) ? recon_ : int(RECONSTRUCT_NONE);
+      for(;;)
+      {
+	const PackStatus st = tryPack(u);
+	if (st == PACK_OK)
+	  break;
+
+	if (st == PACK_SINGULAR)
+	  QDPIO::cout << "CompressedLinks: a link is singular for 8 reals, trying 12" << std::endl;
+	else
+	  QDPIO::cout << "CompressedLinks: links are not SU(3) up to a common factor to the precision of "
+		      << 8*sizeof(R) << " bit reals" << std::endl;
+
+	recon = (st == PACK_SINGULAR) ? int(RECONSTRUCT_12) : int(RECONSTRUCT_NONE);
+      }
+
+      if (recon != requested_recon)
+	QDPIO::cout << "CompressedLinks: using " << recon << " reals per link instead of " 
+		    << requested_recon << std::endl;
+
+      END_CODE();
+    }
+
+    //! The reconstruction asked for
+    int requested() const {return requested_recon;}
+
+    //! The reconstruction actually used
+    int reconstruct() const {return recon;}
+
+    //! Load the link in direction mu at site into a colour matrix
+    template<typename CM>
+    inline void load(CM& m, int mu, int site) const
+    {
+      const int l = Nd*site + mu;
+      C v[3][3];
+      unpackLink(v, &data[recon*l]);
+
+      const C f = fac[fac_idx[l]];
+      for(int i=0; i < Nc; ++i)
+	for(int j=0; j < Nc; ++j)
+	{
+	  const C t = (recon == RECONSTRUCT_NONE) ? v[i][j] : f*v[i][j];
+	  m.elem(i,j).real() = t.real();
+	  m.elem(i,j).imag() = t.imag();
+	}
+    }
+
+  private:
+    //! Outcome of a compression attempt
+    enum PackStatus
+    {
+      PACK_OK,         /*!< all links reproduced */
+      PACK_SINGULAR,   /*!< a link cannot be parametrised with 8 reals */
+      PACK_FAILED      /*!< a link is not reproduced to the tolerance */
+    };
+
+    //! Rounding errors allowed in the reconstruction check, in units of epsilon
+    static const int check_ulps = 256;
+
+    //! Tolerance of the reconstruction relative to the size of a link
+    static R tolerance() {return R(check_ulps) * std::numeric_limits<R>::epsilon();}
+
+    //! Rebuild a full matrix from the stored reals
+    inline void unpackLink(C v[3][3], const R* d) const
+    {
+      if (recon == RECONSTRUCT_NONE)
+      {
+	for(int i=0; i < Nc; ++i)
+	  for(int j=0; j < Nc; ++j)
+	    v[i][j] = C(d[2*(Nc*i+j)], d[2*(Nc*i+j)+1]);
+	return;
+      }
+
+      if (recon == RECONSTRUCT_12)
+      {
+	for(int i=0; i < 2; ++i)
+	  for(int j=0; j < 3; ++j)
+	    v[i][j] = C(d[2*(3*i+j)], d[2*(3*i+j)+1]);
+      }
+      else
+      {
+	// 8 reals: a1, a2, b0 and the phases of a0 and c0
+	const C a1(d[0], d[1]);
+	const C a2(d[2], d[3]);
+	const C b0(d[4], d[5]);
+	const R nrm = std::norm(a1) + std::norm(a2);
+	const C a0 = std::polar(R(std::sqrt(std::max(R(0), R(1) - nrm))), d[6]);
+	const C c0 = std::polar(R(std::sqrt(std::max(R(0), nrm - std::norm(b0)))), d[7]);
+
+	// The rest of columns 1 and 2 from orthogonality to column 0
+	// and  conj(V) = cofactor(V)
+	const R rn = R(1) / nrm;
+	v[0][0] = a0;  v[0][1] = a1;  v[0][2] = a2;
+	v[1][0] = b0;
+	v[1][1] = -(std::conj(a0)*a1*b0 + std::conj(c0)*std::conj(a2)) * rn;
+	v[1][2] = (std::conj(c0)*std::conj(a1) - std::conj(a0)*a2*b0) * rn;
+      }
+
+      // Third row is the conjugate cross product of the first two
+      v[2][0] = std::conj(v[0][1]*v[1][2] - v[0][2]*v[1][1]);
+      v[2][1] = std::conj(v[0][2]*v[1][0] - v[0][0]*v[1][2]);
+      v[2][2] = std::conj(v[0][0]*v[1][1] - v[0][1]*v[1][0]);
+    }
+
+    //! Index of f in the factor table, adding it if new. Returns -1 if full
+    int factorIndex(const C& f)
+    {
+      for(int k=0; k < fac.size(); ++k)
+	if (std::abs(fac[k] - f) <= tolerance() * std::abs(f))
+	  return k;
+
+      if (fac.size() > 255)
+	return -1;
+
+      fac.push_back(f);
+      return fac.size() - 1;
+    }
+
+    //! Compress with the current recon. Returns the worst status of all nodes
+    template<typename Q>
+    PackStatus tryPack(const Q& u)
+    {
+      const int nodeSites = Layout::sitesOnNode();
+      data.resize(recon*Nd*nodeSites);
+      fac_idx.resize(Nd*nodeSites);
+      fac.resize(0);
+      fac.push_back(C(1,0));
+
+      int bad = 0;
+      int singular = 0;
+      for(int site=0; site < nodeSites && bad == 0 && singular == 0; ++site)
+	for(int mu=0; mu < Nd; ++mu)
+	{
+	  const int l = Nd*site + mu;
+	  R* d = &data[recon*l];
+
+	  C w[3][3];
+	  for(int i=0; i < Nc; ++i)
+	    for(int j=0; j < Nc; ++j)
+	      w[i][j] = C(u[mu].elem(site).elem().elem(i,j).real(),
+			  u[mu].elem(site).elem().elem(i,j).imag());
+
+	  if (recon == RECONSTRUCT_NONE)
+	  {
+	    fac_idx[l] = 0;
+	    for(int i=0; i < Nc; ++i)
+	      for(int j=0; j < Nc; ++j)
+	      {
+		d[2*(Nc*i+j)]   = w[i][j].real();
+		d[2*(Nc*i+j)+1] = w[i][j].imag();
+	      }
+	    continue;
+	  }
+
+	  // Common factor  f = det(U)^(1/3)
+	  const C det = w[0][0]*(w[1][1]*w[2][2] - w[1][2]*w[2][1])
+	    - w[0][1]*(w[1][0]*w[2][2] - w[1][2]*w[2][0])
+	    + w[0][2]*(w[1][0]*w[2][1] - w[1][1]*w[2][0]);
+	  if (std::abs(det) == R(0))
+	  {
+	    ++bad;
+	    break;
+	  }
+
+	  const int k = factorIndex(std::polar(R(std::pow(std::abs(det), R(1)/R(3))), std::arg(det)/R(3)));
+	  if (k < 0)
+	  {
+	    ++bad;
+	    break;
+	  }
+	  fac_idx[l] = k;
+
+	  C v[3][3];
+	  for(int i=0; i < 3; ++i)
+	    for(int j=0; j < 3; ++j)
+	      v[i][j] = w[i][j] / fac[k];
+
+	  if (recon == RECONSTRUCT_12)
+	  {
+	    for(int i=0; i < 2; ++i)
+	      for(int j=0; j < 3; ++j)
+	      {
+		d[2*(3*i+j)]   = v[i][j].real();
+		d[2*(3*i+j)+1] = v[i][j].imag();
+	      }
+	  }
+	  else
+	  {
+	    d[0] = v[0][1].real();  d[1] = v[0][1].imag();
+	    d[2] = v[0][2].real();  d[3] = v[0][2].imag();
+	    d[4] = v[1][0].real();  d[5] = v[1][0].imag();
+	    d[6] = std::arg(v[0][0]);
+	    d[7] = std::arg(v[2][0]);
+
+	    // The parametrisation is singular when V(0,0) has modulus one.
+	    // The rebuild divides by  |V(0,1)|^2 + |V(0,2)|^2,  which must
+	    // not lift the rounding errors above the tolerance
+	    const R nrm = std::norm(v[0][1]) + std::norm(v[0][2]);
+	    if (std::numeric_limits<R>::epsilon() > tolerance() * nrm)
+	    {
+	      ++singular;
+	      break;
+	    }
+	  }
+
+	  // Check the reconstruction
+	  C r[3][3];
+	  unpackLink(r, d);
+	  for(int i=0; i < 3; ++i)
+	    for(int j=0; j < 3; ++j)
+	      if (std::abs(fac[k]*r[i][j] - w[i][j]) > tolerance() * std::abs(fac[k]))
+		++bad;
+	}
+
+      double nbad[2] = {double(bad), double(singular)};
+      QDPInternal::globalSumArray(nbad, 2);
+
+      if (nbad[0] > 0)
+	return PACK_FAILED;
+      if (nbad[1] > 0)
+	return PACK_SINGULAR;
+      return PACK_OK;
+    }
+
+    int requested_recon;                    /*!< reconstruction asked for */
+    int recon;                              /*!< reals stored per link */
+    std::vector<R> data;                    /*!< recon reals per link */
+    std::vector<unsigned char> fac_idx;     /*!< factor of each link */
+    std::vector<C> fac;                     /*!< table of factors */
+  };
+
+}  // end namespace Chroma
+
+#endif
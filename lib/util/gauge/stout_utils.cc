@@ -85,6 +85,21 @@ namespace Chroma
   namespace Stouting 
   {
 
+#ifndef QDP_IS_QDPJIT
+    namespace StoutUtils { 
+      // Fused site kernels, defined below with the other thread dispatchers
+      void stoutExp(LatticeColorMatrix& next,
+		    const LatticeColorMatrix& C,
+		    const LatticeColorMatrix& U);
+
+      void stoutForce(LatticeColorMatrix& Lambda,
+		      LatticeColorMatrix& F,
+		      const LatticeColorMatrix& C,
+		      const LatticeColorMatrix& U,
+		      const LatticeColorMatrix& F_plus);
+    }
+#endif
+
     /*! \ingroup gauge */
     void getQs(const multi1d<LatticeColorMatrix>& u, LatticeColorMatrix& Q, 
 	       LatticeColorMatrix& QQ,
@@ -102,8 +117,7 @@ namespace Chroma
 
 
     /*! \ingroup gauge */
-    void getQsandCs(const multi1d<LatticeColorMatrix>& u, LatticeColorMatrix& Q, 
-		    LatticeColorMatrix& QQ,
+    void getStaples(const multi1d<LatticeColorMatrix>& u,
 		    LatticeColorMatrix& C, 
 		    int mu,
 		    const multi1d<bool>& smear_in_this_dirP,
@@ -165,6 +179,22 @@ namespace Chroma
 	}
       }
       
+      END_CODE();
+    }
+
+
+    /*! \ingroup gauge */
+    void getQsandCs(const multi1d<LatticeColorMatrix>& u, LatticeColorMatrix& Q, 
+		    LatticeColorMatrix& QQ,
+		    LatticeColorMatrix& C, 
+		    int mu,
+		    const multi1d<bool>& smear_in_this_dirP,
+		    const multi2d<Real>& rho)
+    {
+      START_CODE();
+      
+      getStaples(u, C, mu, smear_in_this_dirP, rho);
+      
       // Now I can form the Q
       LatticeColorMatrix Omega;
       Omega = C*adj(u[mu]); // Q_mu is Omega mu here (eq 2 part 2)
@@ -189,6 +219,9 @@ namespace Chroma
 		       const multi1d<LatticeColorMatrix>& u)
     {
       START_CODE();
+      QDP::StopWatch swatch;
+      swatch.reset();
+      swatch.start();
       
       // Things I need
       // C_{\mu} = staple multiplied appropriately by the rho
@@ -209,6 +242,12 @@ namespace Chroma
       {
 	if( smear_in_this_dirP[mu] ) 
 	{ 
+#ifndef QDP_IS_QDPJIT
+	  // Q, the f-s and b-s, Lambda_mu and F_plus*exp(iQ) in one pass over the sites.
+	  // Only the staples need the neighbours.
+	  getStaples(u, C[mu], mu, smear_in_this_dirP, rho);
+	  StoutUtils::stoutForce(Lambda[mu], F[mu], C[mu], u[mu], F_plus[mu]);
+#else
 	  LatticeColorMatrix Q,QQ;   // This is the C U^{dag}_mu suitably antisymmetrized
 	  
 	  // Get Q, Q^2, C, c0 and c1 -- this code is the same as used in stout_smear()
@@ -257,6 +296,8 @@ namespace Chroma
 		      << std::endl;
 #endif
 	  
+#endif // QDP_IS_QDPJIT
+	  
 	} // End of if( smear_in_this_dirP[mu] )
 	// else what is in F_mu is the right force
       }
@@ -375,6 +416,9 @@ namespace Chroma
       
       
       
+      swatch.stop();
+      StoutLinkTimings::force_secs += swatch.getTimeInSeconds();
+
       // Done
       END_CODE();
     }
@@ -411,23 +455,20 @@ namespace Chroma
 
 
       
-    inline 
-    void getFsAndBsSiteLoop(int lo, int hi, int myId, 
-			      GetFsAndBsArgs* arg)
-    {
 #ifndef QDP_IS_QDPJIT
-      const LatticeColorMatrix& Q = arg->Q;
-      const LatticeColorMatrix& QQ = arg->QQ;
-      multi1d<LatticeComplex>& f = arg->f;
-      multi1d<LatticeComplex>& b1 = arg->b1;
-      multi1d<LatticeComplex>& b2 = arg->b2;
-      bool dobs=arg->dobs;
-      
-      for(int site=lo; site < hi; site++)  
-      { 
+    typedef PColorMatrix<QDP::RComplex<REAL>, Nc> SiteColorMatrix;
+
+    //! The f-s and, if dobs is set, the b-s of exp(iQ) on one site
+    inline
+    void getFsAndBsSite(const SiteColorMatrix& Q_site,
+			const SiteColorMatrix& QQ_site,
+			REAL f_site_re[3], REAL f_site_im[3],
+			REAL b1_site_re[3], REAL b1_site_im[3],
+			REAL b2_site_re[3], REAL b2_site_im[3],
+			bool dobs)
+    {
+      {
 	// Get the traces
-	PColorMatrix<QDP::RComplex<REAL>, Nc>  Q_site = Q.elem(site).elem();
-	PColorMatrix<QDP::RComplex<REAL>, Nc>  QQ_site = QQ.elem(site).elem();
 	PColorMatrix<QDP::RComplex<REAL>, Nc>  QQQ = QQ_site*Q_site;
 	
 	Real trQQQ; 
@@ -513,63 +554,43 @@ namespace Chroma
 	  //  differences to be zero. At this point in time std::maple seems happy.
 	  //  ==================================================================================
 	  
-	  f[0].elem(site).elem().elem().real() = 1.0-c0*c0/720.0;
-	  f[0].elem(site).elem().elem().imag() =  -(c0/6.0)*(1.0-(c1/20.0)*(1.0-(c1/42.0))) ;
+	  f_site_re[0] = 1.0-c0*c0/720.0;
+	  f_site_im[0] =  -(c0/6.0)*(1.0-(c1/20.0)*(1.0-(c1/42.0))) ;
 	  
-	  f[1].elem(site).elem().elem().real() =  c0/24.0*(1.0-c1/15.0*(1.0-3.0*c1/112.0)) ;
-	  f[1].elem(site).elem().elem().imag() =  1.0-c1/6.0*(1.0-c1/20.0*(1.0-c1/42.0))-c0*c0/5040.0 ;
+	  f_site_re[1] =  c0/24.0*(1.0-c1/15.0*(1.0-3.0*c1/112.0)) ;
+	  f_site_im[1] =  1.0-c1/6.0*(1.0-c1/20.0*(1.0-c1/42.0))-c0*c0/5040.0 ;
 	  
-	  f[2].elem(site).elem().elem().real() = 0.5*(-1.0+c1/12.0*(1.0-c1/30.0*(1.0-c1/56.0))+c0*c0/20160.0);
-	  f[2].elem(site).elem().elem().imag() = 0.5*(c0/60.0*(1.0-c1/21.0*(1.0-c1/48.0)));
+	  f_site_re[2] = 0.5*(-1.0+c1/12.0*(1.0-c1/30.0*(1.0-c1/56.0))+c0*c0/20160.0);
+	  f_site_im[2] = 0.5*(c0/60.0*(1.0-c1/21.0*(1.0-c1/48.0)));
 	  
 	  if( dobs == true ) {
 	    //  partial f0/ partial c0
-	    b2[0].elem(site).elem().elem().real() = -c0/360.0;
-	    b2[0].elem(site).elem().elem().imag() =  -(1.0/6.0)*(1.0-(c1/20.0)*(1.0-c1/42.0));
+	    b2_site_re[0] = -c0/360.0;
+	    b2_site_im[0] =  -(1.0/6.0)*(1.0-(c1/20.0)*(1.0-c1/42.0));
 	    
 	    // partial f0 / partial c1
 	    //
-	    b1[0].elem(site).elem().elem().real() = 0;
-	    b1[0].elem(site).elem().elem().imag() = (c0/120.0)*(1.0-c1/21.0);
+	    b1_site_re[0] = 0;
+	    b1_site_im[0] = (c0/120.0)*(1.0-c1/21.0);
 	    
 	    // partial f1 / partial c0
 	    //
-	    b2[1].elem(site).elem().elem().real() = (1.0/24.0)*(1.0-c1/15.0*(1.0-3.0*c1/112.0));
-	    b2[1].elem(site).elem().elem().imag() = -c0/2520.0;
+	    b2_site_re[1] = (1.0/24.0)*(1.0-c1/15.0*(1.0-3.0*c1/112.0));
+	    b2_site_im[1] = -c0/2520.0;
 	    
 	    
 	    // partial f1 / partial c1
-	    b1[1].elem(site).elem().elem().real() = -c0/360.0*(1.0 - 3.0*c1/56.0 );
-	    b1[1].elem(site).elem().elem().imag() = -1.0/6.0*(1.0-c1/10.0*(1.0-c1/28.0));
+	    b1_site_re[1] = -c0/360.0*(1.0 - 3.0*c1/56.0 );
+	    b1_site_im[1] = -1.0/6.0*(1.0-c1/10.0*(1.0-c1/28.0));
 	    
 	    // partial f2/ partial c0
-	    b2[2].elem(site).elem().elem().real() = 0.5*c0/10080.0;
-	    b2[2].elem(site).elem().elem().imag() = 0.5*(  1.0/60.0*(1.0-c1/21.0*(1.0-c1/48.0)) );
+	    b2_site_re[2] = 0.5*c0/10080.0;
+	    b2_site_im[2] = 0.5*(  1.0/60.0*(1.0-c1/21.0*(1.0-c1/48.0)) );
 	    
 	    // partial f2/ partial c1
-	    b1[2].elem(site).elem().elem().real() = 0.5*(  1.0/12.0*(1.0-(2.0*c1/30.0)*(1.0-3.0*c1/112.0)) ); 
-	    b1[2].elem(site).elem().elem().imag() = 0.5*( -c0/1260.0*(1.0-c1/24.0) );
+	    b1_site_re[2] = 0.5*(  1.0/12.0*(1.0-(2.0*c1/30.0)*(1.0-3.0*c1/112.0)) ); 
+	    b1_site_im[2] = 0.5*( -c0/1260.0*(1.0-c1/24.0) );
 	    
-#if 0
-	    {
-	      multi1d<int> coord = Layout::siteCoords(Layout::nodeNumber(), site);
-	      
-	      QMP_fprintf(stdout, 
-			  "%s: corner; site=%d coord=[%d,%d,%d,%d] f[0]=%g f[1]=%g f[2]=%g b1[0]=%g b1[1]=%g b1[2]=%g b2[0]=%g b2[1]=%g b2[2]=%g c0=%g c1=%g",
-			  
-			  __func__, site, coord[0], coord[1], coord[2], coord[3],
-			  toDouble(localNorm2(f[0].elem(site))),
-			  toDouble(localNorm2(f[1].elem(site))),
-			  toDouble(localNorm2(f[2].elem(site))),
-			  toDouble(localNorm2(b1[0].elem(site))),
-			  toDouble(localNorm2(b1[1].elem(site))),
-			  toDouble(localNorm2(b1[2].elem(site))),
-			  toDouble(localNorm2(b2[0].elem(site))),
-			  toDouble(localNorm2(b2[1].elem(site))),
-			  toDouble(localNorm2(b2[2].elem(site))),
-			  c0, c1);
-	    }
-#endif
 	  } // Dobs==true
 	}
 	else 
@@ -596,14 +617,6 @@ namespace Chroma
 	    // This can happen only when there is a rounding error in the ratio, and that the 
 	    // ratio is really 1. This implies theta = 0 which we'll just set.
 	    // ===============================================================================
-	    {
-	      multi1d<int> coord = Layout::siteCoords(Layout::nodeNumber(), site);
-
-//	      fprintf(stdout, 
-//		      "%s: corner2; site=%d coord=[%d,%d,%d,%d] c0max=%g c0abs=%d eps=%g\n Setting theta=0",
-//		      __func__, site, coord[0], coord[1], coord[2], coord[3],
-//		      c0abs, c0max,eps);
-	    }
 	    theta = 0;
 	  }
 	  else if ( eps < 1.0e-3 ) {
@@ -625,17 +638,6 @@ namespace Chroma
 	    theta = acos( c0abs/c0max );
 	  }
 	  
-	  multi1d<REAL> f_site_re(3);
-	  multi1d<REAL> f_site_im(3);
-	  
-	  multi1d<REAL> b1_site_re(3);
-	  multi1d<REAL> b1_site_im(3);
-	  
-	  multi1d<REAL> b2_site_re(3);
-	  multi1d<REAL> b2_site_im(3);
-	  
-	  
-	  
 	  REAL u = sqrt(c1/3)*cos(theta/3);
 	  REAL w = sqrt(c1)*sin(theta/3);
 	  
@@ -701,10 +703,10 @@ namespace Chroma
 	  
 	  if( dobs == true ) 
 	    {
-	      multi1d<REAL> r_1_re(3);
-	      multi1d<REAL> r_1_im(3);
-	      multi1d<REAL> r_2_re(3);
-	      multi1d<REAL> r_2_im(3);
+	      REAL r_1_re[3];
+	      REAL r_1_im[3];
+	      REAL r_2_re[3];
+	      REAL r_2_im[3];
 	      
 	      //	  r_1[0]=Double(2)*cmplx(u, u_sq-w_sq)*exp2iu
 	      //          + 2.0*expmiu*( cmplx(8.0*u*cosw, -4.0*u_sq*cosw)
@@ -806,38 +808,6 @@ namespace Chroma
 		b2_site_re[2] *= -1;
 	      }
 	      
-	      // Load back into the lattice sized object
-	      for(int j=0; j < 3; j++) {
-		
-		b1[j].elem(site).elem().elem().real() = b1_site_re[j];
-		b1[j].elem(site).elem().elem().imag() = b1_site_im[j];
-		
-		b2[j].elem(site).elem().elem().real() = b2_site_re[j];
-		b2[j].elem(site).elem().elem().imag() = b2_site_im[j];
-	      }
-#if 0
-	      {
-		multi1d<int> coord = Layout::siteCoords(Layout::nodeNumber(), site);
-		REAL rat = c0abs/c0max;
-		
-		QMP_fprintf(stdout, 
-			    "%s: site=%d coord=[%d,%d,%d,%d] f_site[0]=%g f_site[1]=%g f_site[2]=%g 1[0]=%g b1[1]=%g b1[2]=%g b2[0]=%g b2[1]=%g b2[2]=%g denum=%g c0=%g c1=%g c0max=%g rat=%g theta=%g",
-			    
-			    __func__, site, coord[0], coord[1], coord[2], coord[3],
-			    toDouble(localNorm2(cmplx(Real(f_site_re[0]),Real(f_site_im[0])))),
-			    toDouble(localNorm2(cmplx(Real(f_site_re[1]),Real(f_site_im[1])))),
-			    toDouble(localNorm2(cmplx(Real(f_site_re[2]),Real(f_site_im[2])))),
-			    toDouble(localNorm2(b1[0].elem(site))),
-			    toDouble(localNorm2(b1[1].elem(site))),
-			    toDouble(localNorm2(b1[2].elem(site))),
-			    toDouble(localNorm2(b2[0].elem(site))),
-			    toDouble(localNorm2(b2[1].elem(site))),
-			    toDouble(localNorm2(b2[2].elem(site))),
-			    denum, 
-			    c0, c1, c0max,
-			    rat, theta);
-	      }
-#endif
 	      
 	    } // end of if (dobs==true)
 	  
@@ -856,18 +826,300 @@ namespace Chroma
 	    f_site_im[2] *= -1;
 	    
 	  }
-	
-	  // Load back into the lattice sized object
-	  for(int j=0; j < 3; j++) { 
-	    f[j].elem(site).elem().elem().real() = f_site_re[j];
-	    f[j].elem(site).elem().elem().imag() = f_site_im[j];
-	  }
 	  
 	} // End of if( corner_caseP ) else {}
+      }
+    }
+#endif
+
+
+    inline 
+    void getFsAndBsSiteLoop(int lo, int hi, int myId, 
+			      GetFsAndBsArgs* arg)
+    {
+#ifndef QDP_IS_QDPJIT
+      const LatticeColorMatrix& Q = arg->Q;
+      const LatticeColorMatrix& QQ = arg->QQ;
+      multi1d<LatticeComplex>& f = arg->f;
+      multi1d<LatticeComplex>& b1 = arg->b1;
+      multi1d<LatticeComplex>& b2 = arg->b2;
+      bool dobs=arg->dobs;
+      
+      for(int site=lo; site < hi; site++)  
+      { 
+	REAL f_re[3], f_im[3], b1_re[3], b1_im[3], b2_re[3], b2_im[3];
+
+	getFsAndBsSite(Q.elem(site).elem(), QQ.elem(site).elem(),
+		       f_re, f_im, b1_re, b1_im, b2_re, b2_im, dobs);
+
+	// Load back into the lattice sized objects
+	for(int j=0; j < 3; j++) 
+	{
+	  f[j].elem(site).elem().elem().real() = f_re[j];
+	  f[j].elem(site).elem().elem().imag() = f_im[j];
+
+	  if( dobs == true ) 
+	  {
+	    b1[j].elem(site).elem().elem().real() = b1_re[j];
+	    b1[j].elem(site).elem().elem().imag() = b1_im[j];
+
+	    b2[j].elem(site).elem().elem().real() = b2_re[j];
+	    b2[j].elem(site).elem().elem().imag() = b2_im[j];
+	  }
+	}
       } // End site loop
 #endif
     } // End Function
 
+
+#ifndef QDP_IS_QDPJIT
+    //! c = a*b on one site. c may alias a or b.
+    inline
+    void siteMult(const SiteColorMatrix& a, const SiteColorMatrix& b, SiteColorMatrix& c)
+    {
+      SiteColorMatrix r;
+      for(int i=0; i < Nc; i++) 
+      {
+	for(int j=0; j < Nc; j++) 
+	{
+	  REAL re = 0;
+	  REAL im = 0;
+	  for(int k=0; k < Nc; k++) 
+	  {
+	    re += a.elem(i,k).real()*b.elem(k,j).real() - a.elem(i,k).imag()*b.elem(k,j).imag();
+	    im += a.elem(i,k).real()*b.elem(k,j).imag() + a.elem(i,k).imag()*b.elem(k,j).real();
+	  }
+	  r.elem(i,j).real() = re;
+	  r.elem(i,j).imag() = im;
+	}
+      }
+      c = r;
+    }
+
+    //! Tr(a*b) on one site
+    inline
+    void siteTraceMult(const SiteColorMatrix& a, const SiteColorMatrix& b, REAL& re, REAL& im)
+    {
+      re = im = 0;
+      for(int i=0; i < Nc; i++) 
+      {
+	for(int k=0; k < Nc; k++) 
+	{
+	  re += a.elem(i,k).real()*b.elem(k,i).real() - a.elem(i,k).imag()*b.elem(k,i).imag();
+	  im += a.elem(i,k).real()*b.elem(k,i).imag() + a.elem(i,k).imag()*b.elem(k,i).real();
+	}
+      }
+    }
+
+    //! c = s[0] + s[1]*Q + s[2]*QQ with complex coefficients s on one site
+    inline
+    void siteCombo(const REAL s_re[3], const REAL s_im[3],
+		   const SiteColorMatrix& Q, const SiteColorMatrix& QQ, 
+		   SiteColorMatrix& c)
+    {
+      for(int i=0; i < Nc; i++) 
+      {
+	for(int j=0; j < Nc; j++) 
+	{
+	  c.elem(i,j).real() = s_re[1]*Q.elem(i,j).real() - s_im[1]*Q.elem(i,j).imag()
+	    + s_re[2]*QQ.elem(i,j).real() - s_im[2]*QQ.elem(i,j).imag();
+	  c.elem(i,j).imag() = s_re[1]*Q.elem(i,j).imag() + s_im[1]*Q.elem(i,j).real()
+	    + s_re[2]*QQ.elem(i,j).imag() + s_im[2]*QQ.elem(i,j).real();
+	}
+	c.elem(i,i).real() += s_re[0];
+	c.elem(i,i).imag() += s_im[0];
+      }
+    }
+
+    //! Q = i/2 (Omega^dag - Omega) minus its trace, with Omega = C U^dag, and Q^2 on one site
+    inline
+    void siteQs(const SiteColorMatrix& C, const SiteColorMatrix& U, 
+		SiteColorMatrix& Q, SiteColorMatrix& QQ)
+    {
+      SiteColorMatrix Omega;
+      for(int i=0; i < Nc; i++) 
+      {
+	for(int j=0; j < Nc; j++) 
+	{
+	  REAL re = 0;
+	  REAL im = 0;
+	  for(int k=0; k < Nc; k++) 
+	  {
+	    re += C.elem(i,k).real()*U.elem(j,k).real() + C.elem(i,k).imag()*U.elem(j,k).imag();
+	    im += C.elem(i,k).imag()*U.elem(j,k).real() - C.elem(i,k).real()*U.elem(j,k).imag();
+	  }
+	  Omega.elem(i,j).real() = re;
+	  Omega.elem(i,j).imag() = im;
+	}
+      }
+
+      REAL tr_im = 0;
+      for(int i=0; i < Nc; i++) 
+	tr_im += Omega.elem(i,i).imag();
+      tr_im /= REAL(Nc);
+
+      for(int i=0; i < Nc; i++) 
+      {
+	for(int j=0; j < Nc; j++) 
+	{
+	  Q.elem(i,j).real() = REAL(0.5)*(Omega.elem(j,i).imag() + Omega.elem(i,j).imag());
+	  Q.elem(i,j).imag() = REAL(0.5)*(Omega.elem(j,i).real() - Omega.elem(i,j).real());
+	}
+	Q.elem(i,i).real() -= tr_im;
+      }
+
+      siteMult(Q, Q, QQ);
+    }
+#endif
+
+
+    struct StoutExpArgs { 
+      const LatticeColorMatrix& C;
+      const LatticeColorMatrix& U;
+      LatticeColorMatrix& next;
+    };
+
+    //! next = exp(iQ) U, with Q built from the staples C, in one pass per site
+    inline 
+    void stoutExpSiteLoop(int lo, int hi, int myId, 
+			  StoutExpArgs* arg)
+    {
+#ifndef QDP_IS_QDPJIT
+      for(int site=lo; site < hi; site++)  
+      { 
+	const SiteColorMatrix& U = arg->U.elem(site).elem();
+	SiteColorMatrix Q, QQ, expQ;
+
+	siteQs(arg->C.elem(site).elem(), U, Q, QQ);
+
+	REAL f_re[3], f_im[3], b1_re[3], b1_im[3], b2_re[3], b2_im[3];
+	getFsAndBsSite(Q, QQ, f_re, f_im, b1_re, b1_im, b2_re, b2_im, false);
+
+	siteCombo(f_re, f_im, Q, QQ, expQ);
+	siteMult(expQ, U, arg->next.elem(site).elem());
+      }
+#endif
+    }
+
+
+    struct StoutForceArgs { 
+      const LatticeColorMatrix& C;
+      const LatticeColorMatrix& U;
+      const LatticeColorMatrix& F_plus;
+      LatticeColorMatrix& Lambda;
+      LatticeColorMatrix& F;
+    };
+
+    //! Lambda (eq 72-74) and F = F_plus exp(iQ) (first terms of eq 75) in one pass per site
+    inline 
+    void stoutForceSiteLoop(int lo, int hi, int myId, 
+			    StoutForceArgs* arg)
+    {
+#ifndef QDP_IS_QDPJIT
+      for(int site=lo; site < hi; site++)  
+      { 
+	const SiteColorMatrix& U = arg->U.elem(site).elem();
+	const SiteColorMatrix& F_plus = arg->F_plus.elem(site).elem();
+	SiteColorMatrix Q, QQ;
+
+	siteQs(arg->C.elem(site).elem(), U, Q, QQ);
+
+	REAL f_re[3], f_im[3], b1_re[3], b1_im[3], b2_re[3], b2_im[3];
+	getFsAndBsSite(Q, QQ, f_re, f_im, b1_re, b1_im, b2_re, b2_im, true);
+
+	SiteColorMatrix B_1, B_2, USigma, USQ, QUS;
+	siteCombo(b1_re, b1_im, Q, QQ, B_1);
+	siteCombo(b2_re, b2_im, Q, QQ, B_2);
+
+	siteMult(U, F_plus, USigma);
+	siteMult(USigma, Q, USQ);
+	siteMult(Q, USigma, QUS);
+
+	REAL t1_re, t1_im, t2_re, t2_im;
+	siteTraceMult(B_1, USigma, t1_re, t1_im);
+	siteTraceMult(B_2, USigma, t2_re, t2_im);
+
+	// Gamma = f1 USigma + f2 (USigma Q + Q USigma) + Tr(B_1 USigma) Q + Tr(B_2 USigma) QQ
+	SiteColorMatrix Gamma;
+	for(int i=0; i < Nc; i++) 
+	{
+	  for(int j=0; j < Nc; j++) 
+	  {
+	    REAL s_re = USQ.elem(i,j).real() + QUS.elem(i,j).real();
+	    REAL s_im = USQ.elem(i,j).imag() + QUS.elem(i,j).imag();
+
+	    Gamma.elem(i,j).real() = f_re[1]*USigma.elem(i,j).real() - f_im[1]*USigma.elem(i,j).imag()
+	      + f_re[2]*s_re - f_im[2]*s_im
+	      + t1_re*Q.elem(i,j).real() - t1_im*Q.elem(i,j).imag()
+	      + t2_re*QQ.elem(i,j).real() - t2_im*QQ.elem(i,j).imag();
+	    Gamma.elem(i,j).imag() = f_re[1]*USigma.elem(i,j).imag() + f_im[1]*USigma.elem(i,j).real()
+	      + f_re[2]*s_im + f_im[2]*s_re
+	      + t1_re*Q.elem(i,j).imag() + t1_im*Q.elem(i,j).real()
+	      + t2_re*QQ.elem(i,j).imag() + t2_im*QQ.elem(i,j).real();
+	  }
+	}
+
+	// Lambda = 1/2 (Gamma + Gamma^dag) minus its trace. The trace is real.
+	SiteColorMatrix& Lambda = arg->Lambda.elem(site).elem();
+	REAL tr_re = 0;
+	for(int i=0; i < Nc; i++) 
+	  tr_re += Gamma.elem(i,i).real();
+	tr_re /= REAL(Nc);
+
+	for(int i=0; i < Nc; i++) 
+	{
+	  for(int j=0; j < Nc; j++) 
+	  {
+	    Lambda.elem(i,j).real() = REAL(0.5)*(Gamma.elem(i,j).real() + Gamma.elem(j,i).real());
+	    Lambda.elem(i,j).imag() = REAL(0.5)*(Gamma.elem(i,j).imag() - Gamma.elem(j,i).imag());
+	  }
+	  Lambda.elem(i,i).real() -= tr_re;
+	}
+
+	SiteColorMatrix expQ;
+	siteCombo(f_re, f_im, Q, QQ, expQ);
+	siteMult(F_plus, expQ, arg->F.elem(site).elem());
+      }
+#endif
+    }
+
+
+#ifndef QDP_IS_QDPJIT
+    //! next = exp(iQ) U for the staples C of U
+    void stoutExp(LatticeColorMatrix& next,
+		  const LatticeColorMatrix& C,
+		  const LatticeColorMatrix& U)
+    {
+      QDP::StopWatch swatch;
+      swatch.reset();
+      swatch.start();
+
+      StoutExpArgs args = {C, U, next};
+      dispatch_to_threads(Layout::sitesOnNode(), args, stoutExpSiteLoop);
+
+      swatch.stop();
+      StoutLinkTimings::functions_secs += swatch.getTimeInSeconds();
+    }
+
+    //! Lambda and F = F_plus exp(iQ) for the staples C of U
+    void stoutForce(LatticeColorMatrix& Lambda,
+		    LatticeColorMatrix& F,
+		    const LatticeColorMatrix& C,
+		    const LatticeColorMatrix& U,
+		    const LatticeColorMatrix& F_plus)
+    {
+      QDP::StopWatch swatch;
+      swatch.reset();
+      swatch.start();
+
+      StoutForceArgs args = {C, U, F_plus, Lambda, F};
+      dispatch_to_threads(Layout::sitesOnNode(), args, stoutForceSiteLoop);
+
+      swatch.stop();
+      StoutLinkTimings::functions_secs += swatch.getTimeInSeconds();
+    }
+#endif
+
     } // End Namespace
 	
     /*! \ingroup gauge */
@@ -939,22 +1191,15 @@ namespace Chroma
 		     const multi2d<Real>& rho)
     {
       START_CODE();
+      QDP::StopWatch swatch;
+      swatch.reset();
+      swatch.start();
       
       for(int mu = 0; mu < Nd; mu++) 
       {
 	if( smear_in_this_dirP[mu] ) 
 	{
-	  LatticeColorMatrix Q, QQ;
-	  
-	  // Q contains the staple term. C is a throwaway
-	  getQs(current, Q, QQ, mu, smear_in_this_dirP, rho);
-	  
-	  // Now compute the f's
-	  multi1d<LatticeComplex> f;   // routine will resize these
-	  getFs(Q,QQ,f);   // This routine computes the f-s
-	  
-	  // Assemble the stout links exp(iQ)U_{mu} 
-	  next[mu]=(f[0] + f[1]*Q + f[2]*QQ)*current[mu];      
+	  stout_smear(next[mu], current, mu, smear_in_this_dirP, rho);
 	}
 	else { 
 	  next[mu]=current[mu];  // Unsmeared
@@ -962,6 +1207,8 @@ namespace Chroma
 	
       }
       
+      swatch.stop();
+      StoutLinkTimings::smearing_secs += swatch.getTimeInSeconds();
       END_CODE();
     }
     
@@ -975,6 +1222,13 @@ namespace Chroma
     {
       START_CODE();
       
+#ifndef QDP_IS_QDPJIT
+      // Only the staples need the neighbours. Q, the f-s and exp(iQ) U
+      // are then formed site by site in one threaded pass.
+      LatticeColorMatrix C;
+      getStaples(current, C, mu, smear_in_this_dirP, rho);
+      StoutUtils::stoutExp(next, C, current[mu]);
+#else
       LatticeColorMatrix Q, QQ;
 	  
       // Q contains the staple term. C is a throwaway
@@ -986,6 +1240,7 @@ namespace Chroma
 	  
       // Assemble the stout links exp(iQ)U_{mu} 
       next = (f[0] + f[1]*Q + f[2]*QQ)*current[mu];      
+#endif
       
       END_CODE();
     }
@@ -57,6 +57,13 @@ namespace Chroma
 	       const multi1d<bool>& smear_in_this_dirP,
 	       const multi2d<Real>& rho);
 
+    //! Given field U, construct the rho weighted staples of direction mu into C
+    void getStaples(const multi1d<LatticeColorMatrix>& u,
+		    LatticeColorMatrix& C,
+		    int mu,
+		    const multi1d<bool>& smear_in_this_dirP,
+		    const multi2d<Real>& rho);
+
     //! Given field U, construct the staples into C, form Q and Q^2 and compute  c0 and c1
     void getQsandCs(const multi1d<LatticeColorMatrix>& u, 
 		    LatticeColorMatrix& Q, 
@@ -60,6 +60,11 @@ namespace Chroma
     virtual MdagMMultiSystemSolverAccumulate<T>* mInvMdagMAcc(Handle< FermState<T,P,Q> > state,
 						 const GroupXML_t& invParam) const;
 
+    //! Return a multi-shift solver for several sources to solve (MdagM+shift)*psi=chi 
+    /*! Default implementation */
+    virtual MdagMMultiSystemSolverBlock<T>* mInvMdagMBlock(Handle< FermState<T,P,Q> > state,
+							   const GroupXML_t& invParam) const;
+
     //! Given a complete propagator as a source, this does all the inversions needed
     /*!
      * Provides a default version
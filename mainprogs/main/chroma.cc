@@ -15,6 +15,8 @@ extern "C" {
 struct Params_t
 {
   multi1d<int>    nrow;
+  bool            sft_fftP;
+  int             sft_max_phases;
   std::string     inline_measurement_xml;
 };
 
@@ -31,6 +33,16 @@ void read(XMLReader& xml, const std::string& path, Params_t& p)
   XMLReader paramtop(xml, path);
   read(paramtop, "nrow", p.nrow);
 
+  // Momentum projections by partial transforms
+  p.sft_fftP = false;
+  if (paramtop.count("SftMomFFT") > 0)
+    read(paramtop, "SftMomFFT", p.sft_fftP);
+
+  // Phase fields kept by each SftMom, 0 for all
+  p.sft_max_phases = 0;
+  if (paramtop.count("SftMomMaxPhases") > 0)
+    read(paramtop, "SftMomMaxPhases", p.sft_max_phases);
+
   XMLReader measurements_xml(paramtop, "InlineMeasurements");
   std::ostringstream inline_os;
   measurements_xml.print(inline_os);
@@ -127,6 +139,9 @@ int main(int argc, char *argv[])
   Layout::setLattSize(input.param.nrow);
   Layout::create();
 
+  setSftMomFFT(input.param.sft_fftP);
+  setSftMomMaxPhases(input.param.sft_max_phases);
+
   proginfo(xml_out);    // Print out basic program info
 
   // Initialise the RNG
@@ -22,13 +22,17 @@ namespace Chroma
     std::string   save_prefix;
     QDP_volfmt_t  save_volfmt;
     QDP_serialparallel_t save_pario;
+    std::string   save_staging_dir;
     std::string   inline_measurement_xml;
     bool          repro_checkP;
     int           repro_check_frequency;
     bool          rev_checkP;
     int           rev_check_frequency;
     bool          monitorForcesP;
-
+    bool          reproSumsP;
+    HMCCheckpointParams checkpoint;
+    bool          tuneP;
+    HMCTuneParams tune;
   };
   
   void read(XMLReader& xml, const std::string& path, MCControl& p) 
@@ -61,6 +65,11 @@ namespace Chroma
 	}
       }
 
+      // Optional fast directory the saves are written to first
+      if ( paramtop.count("./SaveStagingDir") > 0 ) {
+	read(paramtop, "./SaveStagingDir", p.save_staging_dir);
+      }
+
       // Default values: repro check is on, frequency is 10%
       p.repro_checkP = true;
       p.repro_check_frequency = 10;
@@ -105,6 +114,24 @@ namespace Chroma
 	p.monitorForcesP = true;
       }
 
+      // Global sums of the energies independent of the node layout
+      p.reproSumsP = false;
+      if( paramtop.count("./ReproducibleSums") == 1 ) {
+	read(paramtop, "./ReproducibleSums", p.reproSumsP);
+      }
+
+      // Solver state written with the configurations
+      if( paramtop.count("./Checkpoint") == 1 ) {
+	read(paramtop, "./Checkpoint", p.checkpoint);
+      }
+
+      // Tuning mode instead of updates
+      p.tuneP = false;
+      if( paramtop.count("./Tune") == 1 ) {
+	read(paramtop, "./Tune", p.tune);
+	p.tuneP = true;
+      }
+
       if( paramtop.count("./InlineMeasurements") == 0 ) {
 	XMLBufferWriter dummy;
 	push(dummy, "InlineMeasurements");
@@ -150,6 +177,9 @@ namespace Chroma
 	bool pario = ( p.save_pario == QDPIO_PARALLEL );
 	write(xml, "ParallelIO", pario);
       }
+      if( ! p.save_staging_dir.empty() ) { 
+	write(xml, "SaveStagingDir", p.save_staging_dir);
+      }
       write(xml, "ReproCheckP", p.repro_checkP);
       if( p.repro_checkP ) { 
 	write(xml, "ReproCheckFrequency", p.repro_check_frequency);
@@ -159,6 +189,11 @@ namespace Chroma
 	write(xml, "ReverseCheckFrequency", p.rev_check_frequency);
       }
       write(xml, "MonitorForces", p.monitorForcesP);
+      write(xml, "ReproducibleSums", p.reproSumsP);
+      write(xml, "Checkpoint", p.checkpoint);
+      if( p.tuneP ) { 
+	write(xml, "Tune", p.tune);
+      }
 
       xml << p.inline_measurement_xml;
       
@@ -264,12 +299,23 @@ namespace Chroma
   {
     START_CODE();
     
+    // With a staging directory all files are written there first and
+    // moved to the save prefix in the background
+    bool stageP = StagedIOEnv::canStage(mc_control.save_staging_dir, mc_control.save_volfmt);
+    std::string write_prefix = mc_control.save_prefix;
+    if ( stageP ) { 
+      write_prefix = StagedIOEnv::stagedName(mc_control.save_staging_dir, mc_control.save_prefix);
+    }
+    std::vector<StagedIOEnv::Move_t> moves;
+
     // File names
-    std::ostringstream restart_data_filename;
-    restart_data_filename << mc_control.save_prefix << "_restart_" << update_no << ".xml" ;
+    std::ostringstream restart_data_suffix;
+    restart_data_suffix << "_restart_" << update_no << ".xml" ;
+    std::string restart_data_filename = mc_control.save_prefix + restart_data_suffix.str();
     
-    std::ostringstream restart_config_filename;
-    restart_config_filename << mc_control.save_prefix << "_cfg_" << update_no << ".lime";
+    std::ostringstream restart_config_suffix;
+    restart_config_suffix << "_cfg_" << update_no << ".lime";
+    std::string restart_config_filename = mc_control.save_prefix + restart_config_suffix.str();
       
     XMLBufferWriter restart_data_buffer;
 
@@ -297,13 +343,29 @@ namespace Chroma
       SZINQIOGaugeInitEnv::Params  cfg;
 
       // Reset the filename in it
-      cfg.cfg_file = restart_config_filename.str();
+      cfg.cfg_file = restart_config_filename;
       cfg.cfg_pario = mc_control.save_pario;
 
       // Prepare to write out
       p_new.cfg = SZINQIOGaugeInitEnv::createXMLGroup(cfg);
     }
 
+    // Write the solver state and record it for the restart
+    HMCCheckpointEnv::save(p_new.checkpoint, 
+			   write_prefix, 
+			   update_no,
+			   p_new.save_volfmt,
+			   p_new.save_pario);
+
+    if ( stageP ) { 
+      for(int i=0; i < p_new.checkpoint.restore.size(); i++) { 
+	std::string& file = p_new.checkpoint.restore[i].file_name;
+	std::string final_file = p_new.save_prefix + file.substr(write_prefix.size());
+	moves.push_back(StagedIOEnv::Move_t(file, final_file));
+	file = final_file;
+      }
+    }
+
 
     push(restart_data_buffer, "Params");
     write(restart_data_buffer, "MCControl", p_new);
@@ -324,7 +386,7 @@ namespace Chroma
     writeGauge(file_xml, 
 	       restart_data_buffer,
 	       u,
-	       restart_config_filename.str(),
+	       write_prefix + restart_config_suffix.str(),
 	       p_new.save_volfmt,
 	       p_new.save_pario);    
 
@@ -334,10 +396,19 @@ namespace Chroma
     // write fails, there is no restart file...
     //
     // production will then likely fall back to last good pair.
+    // A staged restart file is moved after the config for the same reason.
 
-    XMLFileWriter restart_xml(restart_data_filename.str().c_str());
+    XMLFileWriter restart_xml(write_prefix + restart_data_suffix.str());
     restart_xml << restart_data_buffer;
     restart_xml.close();
+
+    if ( stageP ) { 
+      moves.push_back(StagedIOEnv::Move_t(write_prefix + restart_config_suffix.str(), 
+					  restart_config_filename));
+      moves.push_back(StagedIOEnv::Move_t(write_prefix + restart_data_suffix.str(), 
+					  restart_data_filename));
+      StagedIOEnv::moveBatch(moves);
+    }
     
     END_CODE();
   }
@@ -366,6 +437,9 @@ namespace Chroma
     // Turn monitoring off/on
     QDPIO::cout << "Setting Force monitoring to " << mc_control.monitorForcesP  << std::endl;
     setForceMonitoring(mc_control.monitorForcesP) ;
+
+    QDPIO::cout << "Setting reproducible sums to " << mc_control.reproSumsP  << std::endl;
+    setReproducibleSums(mc_control.reproSumsP);
     QDP::StopWatch swatch;
 
     XMLWriter& xml_out = TheXMLOutputWriter::Instance();
@@ -543,6 +617,10 @@ namespace Chroma
 	  write(xml_log, "seconds_for_trajectory", swatch.getTimeInSeconds());
 
 	}
+
+	// Cost of each monomial in this update
+	TheMonomialProfiler::Instance().endTrajectory(xml_log, "MonomialProfile");
+
 	swatch.reset();
 	swatch.start();
 
@@ -651,12 +729,75 @@ namespace Chroma
       pop(xml_out); // pop("MCUpdates")
     }
 
+    // Cost of each monomial over all updates
+    TheMonomialProfiler::Instance().writeSummary(xml_out, "MonomialProfileSummary");
+
     pop(xml_log); // pop("doHMC")
     pop(xml_out); // pop("doHMC")
     
     END_CODE();
   }
   
+  //! Tuning mode: measure forces and costs and propose masses and step counts
+  /*! Nothing is saved, the configuration is left as it was read */
+  void doTune(const multi1d<LatticeColorMatrix>& u,
+	      AbsHMCTrj<multi1d<LatticeColorMatrix>,
+	                multi1d<LatticeColorMatrix> >& theHMCTrj,
+	      const MCControl& mc_control, 
+	      const HMCTrjParams& update_params)
+  {
+    START_CODE();
+
+    XMLWriter& xml_out = TheXMLOutputWriter::Instance();
+    XMLWriter& xml_log = TheXMLLogWriter::Instance();
+
+    push(xml_out, "doTune");
+    push(xml_log, "doTune");
+
+    MonomialProfiler& profiler = TheMonomialProfiler::Instance();
+    profiler.setMeasureForces(true);
+
+    QDP::RNG::setrn(mc_control.rng_seed);
+
+    multi1d<LatticeColorMatrix> p(Nd);
+    GaugeFieldState gauge_state(p,u);
+
+    const HMCTuneParams& tune = mc_control.tune;
+    multi1d<Double> delta_H(tune.n_traj);
+
+    push(xml_log, "Trajectories");
+    for(int i=0; i < tune.n_therm + tune.n_traj; i++) 
+    {
+      push(xml_log, "elem");
+
+      QDPIO::cout << "HMCTune: trajectory " << i << std::endl;
+      theHMCTrj( gauge_state, false, false );
+      profiler.endTrajectory(xml_log, "MonomialProfile");
+
+      if( i < tune.n_therm ) { 
+	profiler.resetTotals();
+      }
+      else { 
+	delta_H[i - tune.n_therm] = theHMCTrj.getDeltaH();
+      }
+
+      pop(xml_log); // elem
+    }
+    pop(xml_log); // Trajectories
+
+    HMCTunerEnv::propose(xml_out, "HMCTune", tune, 
+			 update_params.Monomials_xml, 
+			 update_params.Integrator_xml, 
+			 delta_H);
+
+    profiler.setMeasureForces(false);
+
+    pop(xml_log); // doTune
+    pop(xml_out); // doTune
+
+    END_CODE();
+  }
+  
   bool linkageHack(void)
   {
     bool foo = true;
@@ -789,6 +930,9 @@ int main(int argc, char *argv[])
     // Write out the config header
     write(xml_out, "Config_info", config_xml);
     write(xml_log, "Config_info", config_xml);
+
+    // Solver state saved with this config, if any
+    HMCCheckpointEnv::restore(mc_control.checkpoint, mc_control.save_pario);
   }
   catch(std::bad_cast) 
   {
@@ -868,7 +1012,12 @@ int main(int argc, char *argv[])
   
   // Run
   try { 
-    doHMC<HMCTrjParams>(u, theHMCTrj, mc_control, trj_params, the_measurements);
+    if( mc_control.tuneP ) { 
+      doTune(u, theHMCTrj, mc_control, trj_params);
+    }
+    else { 
+      doHMC<HMCTrjParams>(u, theHMCTrj, mc_control, trj_params, the_measurements);
+    }
   } 
   catch(std::bad_cast) 
   {
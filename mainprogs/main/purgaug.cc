@@ -50,6 +50,12 @@ namespace Chroma
       XMLReader paramtop(xml, path);
       read(paramtop, "NmaxHB", p.NmaxHB);
       read(paramtop, "nOver", p.nOver);
+
+      if (paramtop.count("nOverHits") == 1)
+	read(paramtop, "nOverHits", p.nOverHits);
+
+      if (paramtop.count("SiteLocal") == 1)
+	read(paramtop, "SiteLocal", p.siteLocalP);
     }
     catch(const std::string& e ) { 
       QDPIO::cerr << "Caught Exception reading HBParams: " << e << std::endl;
@@ -64,6 +70,8 @@ namespace Chroma
 
     write(xml, "NmaxHB", p.NmaxHB);
     write(xml, "nOver", p.nOver);
+    write(xml, "nOverHits", p.nOverHits);
+    write(xml, "SiteLocal", p.siteLocalP);
 
     pop(xml);
   }
@@ -381,6 +389,19 @@ namespace Chroma
   
 
 
+  //--------------------------------------------------------------------------
+  //! One heatbath sweep with the chosen engine
+  void hbSweep(multi1d<LatticeColorMatrix>& u,
+	       const LinearGaugeAction& S_g,
+	       const HBParams& hbp)
+  {
+    if (hbp.siteLocalP)
+      mciterSite(u, S_g, hbp);
+    else
+      mciter(u, S_g, hbp);
+  }
+
+
   //--------------------------------------------------------------------------
   void doWarmUp(XMLWriter& xml_out,
 		multi1d<LatticeColorMatrix>& u,
@@ -415,7 +436,7 @@ namespace Chroma
       write(xml_out, "WarmUpP", true);
 
       // Do the update, but with no measurements
-      mciter(u, S_g, hb_control.hbitr_params.hb_params); //one hb sweep
+      hbSweep(u, S_g, hb_control.hbitr_params.hb_params); //one hb sweep
 
       // Do measurements
       doMeas(xml_out, u, hb_control, true, cur_update,
@@ -476,7 +497,7 @@ namespace Chroma
       write(xml_out, "WarmUpP", false);
 
       // Do the update
-      mciter(u, S_g, hb_control.hbitr_params.hb_params); //one hb sweep
+      hbSweep(u, S_g, hb_control.hbitr_params.hb_params); //one hb sweep
 
       // Do measurements
       doMeas(xml_out, u, hb_control, false, cur_update,
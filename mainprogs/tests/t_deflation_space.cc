@@ -0,0 +1,113 @@
+#include "chroma.h"
+#include "actions/ferm/invert/syssolver_mdagm_factory.h"
+#include "actions/ferm/invert/syssolver_mdagm_aggregate.h"
+#include "actions/ferm/invert/deflation_space.h"
+#include "meas/inline/io/named_objmap.h"
+#include "actions/ferm/linop/unprec_wilson_linop_w.h"
+#include <iostream>
+#include <cstdio>
+
+
+using namespace Chroma;
+
+
+int main(int argc, char **argv)
+{
+  // Put the machine into a known state
+  Chroma::initialize(&argc, &argv);
+
+  // Lattice Size
+  multi1d<int> nrow(Nd);
+  for(int mu=0; mu < Nd; ++mu)
+    nrow[mu] = 4;
+  
+  // Setup the layout
+  Layout::setLattSize(nrow);
+  Layout::create();
+
+  XMLFileWriter xml(Chroma::getXMLOutputFileName());
+  push(xml,"t_deflation_space");
+  proginfo(xml);    // Print out basic program info
+
+  // Make up a random SU(3) gauge field.
+  multi1d<LatticeColorMatrix> u(Nd);
+  for(int m=0; m < u.size(); ++m)
+  {
+    gaussian(u[m]);
+    reunit(u[m]);
+  }
+
+  Handle< FermState<LatticeFermion,
+    multi1d<LatticeColorMatrix>,
+    multi1d<LatticeColorMatrix> > > state(new PeriodicFermState<LatticeFermion,
+					  multi1d<LatticeColorMatrix>,
+					  multi1d<LatticeColorMatrix> >(u));
+
+  Handle< LinearOperator<LatticeFermion> > M(new UnprecWilsonLinOp(state, Real(0.1)));
+
+  // Deflated CG and the same CG without deflation
+  std::string cg_xml = 
+    "<InvertParam><invType>CG_INVERTER</invType>"
+    "<RsdCG>1.0e-8</RsdCG><MaxCG>2000</MaxCG></InvertParam>";
+
+  std::string deflated_xml = 
+    "<InvertParam><invType>DEFLATED_INVERTER</invType>"
+    "<DeflationSpace><space_id>t_deflation_space</space_id>"
+    "<Nvec>16</Nvec><RefineEvery>2</RefineEvery></DeflationSpace>"
+    "<SubInvParam><invType>CG_INVERTER</invType>"
+    "<RsdCG>1.0e-8</RsdCG><MaxCG>2000</MaxCG></SubInvParam></InvertParam>";
+
+  MdagMSysSolverEnv::registerAll();
+
+  std::istringstream cg_is(cg_xml);
+  XMLReader cg_top(cg_is);
+  Handle< MdagMSystemSolver<LatticeFermion> > cg(
+    TheMdagMFermSystemSolverFactory::Instance().createObject("CG_INVERTER", cg_top, "/InvertParam", state, M));
+
+  const int n_solves = 16;
+  {
+    std::istringstream defl_is(deflated_xml);
+    XMLReader defl_top(defl_is);
+    Handle< MdagMSystemSolver<LatticeFermion> > deflated(
+      TheMdagMFermSystemSolverFactory::Instance().createObject("DEFLATED_INVERTER", defl_top, "/InvertParam", state, M));
+
+    for(int n=0; n < n_solves; ++n)
+    {
+      LatticeFermion chi;
+      gaussian(chi);
+
+      LatticeFermion psi_ref = zero;
+      SystemSolverResults_t res_ref = (*cg)(psi_ref, chi);
+
+      LatticeFermion psi = zero;
+      SystemSolverResults_t res = (*deflated)(psi, chi);
+
+      Double rel = sqrt(norm2(psi - psi_ref) / norm2(psi_ref));
+
+      QDPIO::cout << "DEFLATION test: solve = " << n 
+		  << " iterations = " << res.n_count << " (CG: " << res_ref.n_count << ")"
+		  << " || psi - psi_cg || / || psi_cg || = " << rel << std::endl;
+
+      push(xml,"DEFLATION_correctness_test");
+      write(xml,"solve", n);
+      write(xml,"n_count", res.n_count);
+      write(xml,"n_count_cg", res_ref.n_count);
+      write(xml,"rel_diff", rel);
+      pop(xml);
+    }
+  }
+
+  // The space outlives the solver in the named object map
+  Handle<DeflationSpace> space = 
+    TheNamedObjMap::Instance().getData< Handle<DeflationSpace> >("t_deflation_space");
+
+  QDPIO::cout << "DEFLATION test: vectors kept = " << space->size() << std::endl;
+  write(xml, "vectors_kept", space->size());
+
+  pop(xml);
+  
+  // Time to bolt
+  Chroma::finalize();
+
+  exit(0);
+}
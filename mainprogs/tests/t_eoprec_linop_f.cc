@@ -0,0 +1,131 @@
+#include "chroma.h"
+#include "actions/ferm/linop/eoprec_linop_f_factory_w.h"
+#include "actions/ferm/linop/eoprec_wilson_linop_w.h"
+#include "actions/ferm/linop/eoprec_clover_linop_w.h"
+#include <iostream>
+#include <cstdio>
+
+
+using namespace Chroma;
+
+
+const std::string xml_for_param = 
+  "<?xml version='1.0'?>			\
+  <Params>					\
+    <Wilson>					\
+      <FermAct>WILSON</FermAct>			\
+      <Mass>0.1</Mass>				\
+    </Wilson>					\
+    <Clover>					\
+      <FermAct>CLOVER</FermAct>			\
+      <Mass>0.1</Mass>				\
+      <clovCoeff>1.17</clovCoeff>		\
+    </Clover>					\
+  </Params>";
+
+
+//! Relative difference of the single and double precision operators on psi
+Double compareLinOp(const LinearOperator<LatticeFermion>& M, 
+		    const LinearOperator<LatticeFermionF>& M_f,
+		    const LatticeFermion& psi, enum PlusMinus isign)
+{
+  LatticeFermion chi = zero;
+  M(chi, psi, isign);
+
+  LatticeFermionF psi_f = psi;
+  LatticeFermionF chi_f = zero;
+  M_f(chi_f, psi_f, isign);
+
+  LatticeFermion chi2 = chi_f;
+  const Subset& s = M.subset();
+  return sqrt(norm2(chi2 - chi, s) / norm2(chi, s));
+}
+
+
+int main(int argc, char **argv)
+{
+  // Put the machine into a known state
+  Chroma::initialize(&argc, &argv);
+
+  // Lattice Size
+  multi1d<int> nrow(Nd);
+  for(int mu=0; mu < Nd; ++mu)
+    nrow[mu] = 8;
+  
+  // Setup the layout
+  Layout::setLattSize(nrow);
+  Layout::create();
+
+  XMLFileWriter xml(Chroma::getXMLOutputFileName());
+  push(xml,"t_eoprec_linop_f");
+  proginfo(xml);    // Print out basic program info
+
+  EvenOddPrecLinOpFEnv::registerAll();
+
+  // Make up a random SU(3) gauge field.
+  multi1d<LatticeColorMatrix> u(Nd);
+  multi1d<LatticeColorMatrixF> u_f(Nd);
+  for(int m=0; m < u.size(); ++m)
+  {
+    gaussian(u[m]);
+    reunit(u[m]);
+    u_f[m] = u[m];
+  }
+
+  Handle< FermState<LatticeFermion,
+    multi1d<LatticeColorMatrix>,
+    multi1d<LatticeColorMatrix> > > state(new PeriodicFermState<LatticeFermion,
+					  multi1d<LatticeColorMatrix>,
+					  multi1d<LatticeColorMatrix> >(u));
+
+  Handle< FermState<LatticeFermionF,
+    multi1d<LatticeColorMatrixF>,
+    multi1d<LatticeColorMatrixF> > > state_f(new PeriodicFermState<LatticeFermionF,
+					     multi1d<LatticeColorMatrixF>,
+					     multi1d<LatticeColorMatrixF> >(u_f));
+
+  std::istringstream input(xml_for_param);
+  XMLReader xml_in(input);
+
+  // The double precision reference operators
+  Handle< LinearOperator<LatticeFermion> > M_wils(new EvenOddPrecWilsonLinOp(state, Real(0.1)));
+  Handle< LinearOperator<LatticeFermion> > M_clov(new EvenOddPrecCloverLinOp(state, 
+									     CloverFermActParams(xml_in, "/Params/Clover")));
+
+  const std::string names[2] = {"WILSON", "CLOVER"};
+  const std::string paths[2] = {"/Params/Wilson", "/Params/Clover"};
+  const LinearOperator<LatticeFermion>* M[2] = {&(*M_wils), &(*M_clov)};
+
+  LatticeFermion psi;
+  gaussian(psi);
+
+  for(int n=0; n < 2; ++n)
+  {
+    Handle< LinearOperator<LatticeFermionF> > 
+      M_f(TheEvenOddPrecLinOpFFactory::Instance().createObject(names[n], xml_in, paths[n], state_f));
+
+    for(int isign = 1; isign >= -1; isign -= 2) 
+    {
+      Double rel = compareLinOp(*M[n], *M_f, psi, (isign > 0 ? PLUS : MINUS));
+
+      QDPIO::cout << names[n] << " test: isign = " << isign
+		  << " || M_f psi - M psi || / || M psi || = " << rel << std::endl;
+
+      if ( toBool(rel > Real(1.0e-5)) )
+	QDPIO::cout << names[n] << " test: isign = " << isign << " FAILED" << std::endl;
+
+      push(xml,"EOPREC_LINOP_F_test");
+      write(xml,"FermAct", names[n]);
+      write(xml,"isign", isign);
+      write(xml,"rel_diff", rel);
+      pop(xml);
+    }
+  }
+
+  pop(xml);
+  
+  // Time to bolt
+  Chroma::finalize();
+
+  exit(0);
+}
@@ -0,0 +1,104 @@
+#include "chroma.h"
+#include "actions/ferm/invert/invblockcg.h"
+#include "actions/ferm/invert/invcg2.h"
+#include "actions/ferm/linop/unprec_wilson_linop_w.h"
+#include <iostream>
+#include <cstdio>
+
+
+using namespace Chroma;
+
+
+int main(int argc, char **argv)
+{
+  // Put the machine into a known state
+  Chroma::initialize(&argc, &argv);
+
+  // Lattice Size
+  multi1d<int> nrow(Nd);
+  for(int mu=0; mu < Nd; ++mu)
+    nrow[mu] = 8;
+  
+  // Setup the layout
+  Layout::setLattSize(nrow);
+  Layout::create();
+
+  XMLFileWriter xml(Chroma::getXMLOutputFileName());
+  push(xml,"t_invblockcg");
+  proginfo(xml);    // Print out basic program info
+
+  // Make up a random SU(3) gauge field.
+  multi1d<LatticeColorMatrix> u(Nd);
+  for(int m=0; m < u.size(); ++m)
+  {
+    gaussian(u[m]);
+    reunit(u[m]);
+  }
+
+  Handle< FermState<LatticeFermion,
+    multi1d<LatticeColorMatrix>,
+    multi1d<LatticeColorMatrix> > > state(new PeriodicFermState<LatticeFermion,
+					  multi1d<LatticeColorMatrix>,
+					  multi1d<LatticeColorMatrix> >(u));
+
+  UnprecWilsonLinOp M(state, Real(0.5));
+
+  // Sources of different size, so the columns converge at different iterations
+  const int n_src = 4;
+  multi1d<LatticeFermion> chi(n_src), psi(n_src);
+  for(int n=0; n < n_src; ++n)
+  {
+    gaussian(chi[n]);
+    chi[n] *= Real(n+1);
+    psi[n] = zero;
+  }
+
+  const Real RsdCG = 1.0e-8;
+  const int MaxCG = 1000;
+
+  multi1d<SystemSolverResults_t> res = InvBlockCG(M, chi, psi, RsdCG, MaxCG);
+
+  for(int n=0; n < n_src; ++n)
+  {
+    // True residual of the block solution
+    LatticeFermion tmp, r;
+    M(tmp, psi[n], PLUS);
+    M(r, tmp, MINUS);
+    r -= chi[n];
+    Double resid = sqrt(norm2(r) / norm2(chi[n]));
+
+    // Reference solution, one source at a time
+    LatticeFermion psi_ref = zero;
+    SystemSolverResults_t res_ref = InvCG2(M, chi[n], psi_ref, RsdCG, MaxCG);
+    M(tmp, psi_ref, PLUS);
+    M(r, tmp, MINUS);
+    r -= chi[n];
+    Double resid_ref = sqrt(norm2(r) / norm2(chi[n]));
+
+    Double rel = sqrt(norm2(psi[n] - psi_ref) / norm2(psi_ref));
+
+    QDPIO::cout << "BLOCKCG test: source = " << n
+		<< " iterations = " << res[n].n_count << " (CG2: " << res_ref.n_count << ")"
+		<< " true resid = " << resid << " (CG2: " << resid_ref << ")"
+		<< " || psi - psi_cg2 || / || psi_cg2 || = " << rel << std::endl;
+
+    if ( toBool(resid > Real(10)*RsdCG) )
+      QDPIO::cout << "BLOCKCG test: source = " << n << " FAILED" << std::endl;
+
+    push(xml,"BLOCKCG_correctness_test");
+    write(xml,"source", n);
+    write(xml,"n_count", res[n].n_count);
+    write(xml,"n_count_cg2", res_ref.n_count);
+    write(xml,"true_resid", resid);
+    write(xml,"true_resid_cg2", resid_ref);
+    write(xml,"rel_diff",rel);
+    pop(xml);
+  }
+
+  pop(xml);
+  
+  // Time to bolt
+  Chroma::finalize();
+
+  exit(0);
+}
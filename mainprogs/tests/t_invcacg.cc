@@ -0,0 +1,83 @@
+#include "chroma.h"
+#include "actions/ferm/invert/invcacg.h"
+#include "actions/ferm/linop/unprec_wilson_linop_w.h"
+#include <iostream>
+#include <cstdio>
+
+
+using namespace Chroma;
+
+
+int main(int argc, char **argv)
+{
+  // Put the machine into a known state
+  Chroma::initialize(&argc, &argv);
+
+  // Lattice Size
+  multi1d<int> nrow(Nd);
+  for(int mu=0; mu < Nd; ++mu)
+    nrow[mu] = 8;
+  
+  // Setup the layout
+  Layout::setLattSize(nrow);
+  Layout::create();
+
+  XMLFileWriter xml(Chroma::getXMLOutputFileName());
+  push(xml,"t_invcacg");
+  proginfo(xml);    // Print out basic program info
+
+  // Make up a random SU(3) gauge field.
+  multi1d<LatticeColorMatrix> u(Nd);
+  for(int m=0; m < u.size(); ++m)
+  {
+    gaussian(u[m]);
+    reunit(u[m]);
+  }
+
+  Handle< FermState<LatticeFermion,
+    multi1d<LatticeColorMatrix>,
+    multi1d<LatticeColorMatrix> > > state(new PeriodicFermState<LatticeFermion,
+					  multi1d<LatticeColorMatrix>,
+					  multi1d<LatticeColorMatrix> >(u));
+
+  UnprecWilsonLinOp M(state, Real(0.5));
+
+  LatticeFermion chi, psi, psi_ref;
+  gaussian(chi);
+
+  const Real RsdCG = 1.0e-10;
+  const int MaxCG = 1000;
+
+  // Reference solution of  M^dag M psi = chi
+  psi_ref = zero;
+  SystemSolverResults_t res_ref = InvCG2(M, chi, psi_ref, RsdCG, MaxCG);
+
+  for(int s = 0; s <= 4; s += 2) { 
+    psi = zero;
+    SystemSolverResults_t res;
+    if (s == 0)
+      res = InvPipeCG(M, chi, psi, RsdCG, MaxCG);
+    else
+      res = InvSStepCG(M, chi, psi, RsdCG, MaxCG, s);
+
+    Double rel = sqrt(norm2(psi - psi_ref) / norm2(psi_ref));
+
+    QDPIO::cout << (s == 0 ? "PIPELINED" : "SSTEP") << " test: s = " << s 
+		<< " iterations = " << res.n_count << " (CG2: " << res_ref.n_count << ")"
+		<< " || psi - psi_cg2 || / || psi_cg2 || = " << rel << std::endl;
+
+    push(xml,"CACG_correctness_test");
+    write(xml,"sstep", s);
+    write(xml,"n_count", res.n_count);
+    write(xml,"n_count_cg2", res_ref.n_count);
+    write(xml,"rel_diff",rel);
+    pop(xml);
+  }
+
+  pop(xml);
+  
+  // Time to bolt
+  Chroma::finalize();
+
+  exit(0);
+}
@@ -0,0 +1,123 @@
+#include "chroma.h"
+#include "actions/ferm/invert/syssolver_linop_aggregate.h"
+#include "actions/ferm/invert/syssolver_linop_factory.h"
+#include "actions/ferm/invert/invcg2.h"
+#include "actions/ferm/linop/unprec_wilson_linop_w.h"
+#include <iostream>
+#include <cstdio>
+
+
+using namespace Chroma;
+
+
+// FGMRES-DR with the aggregation multigrid as its preconditioner
+const std::string xml_for_param = 
+  "<?xml version='1.0'?>				\
+  <Params>						\
+    <InvertParam>					\
+      <invType>FGMRESDR_INVERTER</invType>		\
+      <RsdTarget>1.0e-8</RsdTarget>			\
+      <NKrylov>8</NKrylov>				\
+      <NDefl>2</NDefl>					\
+      <MaxIter>200</MaxIter>				\
+      <PrecondParams>					\
+        <invType>MULTIGRID</invType>			\
+        <Blocking>4 4 4 4</Blocking>			\
+        <NullVecs>4</NullVecs>				\
+        <NullVecSetupIter>20</NullVecSetupIter>		\
+        <PostSmooth>4</PostSmooth>			\
+        <CoarseRsdTarget>0.05</CoarseRsdTarget>		\
+      </PrecondParams>					\
+    </InvertParam>					\
+  </Params>";
+
+
+int main(int argc, char **argv)
+{
+  // Put the machine into a known state
+  Chroma::initialize(&argc, &argv);
+
+  // Lattice Size
+  multi1d<int> nrow(Nd);
+  for(int mu=0; mu < Nd; ++mu)
+    nrow[mu] = 8;
+  
+  // Setup the layout
+  Layout::setLattSize(nrow);
+  Layout::create();
+
+  XMLFileWriter xml(Chroma::getXMLOutputFileName());
+  push(xml,"t_invmg");
+  proginfo(xml);    // Print out basic program info
+
+  LinOpSysSolverEnv::registerAll();
+
+  // Make up a random SU(3) gauge field.
+  multi1d<LatticeColorMatrix> u(Nd);
+  for(int m=0; m < u.size(); ++m)
+  {
+    gaussian(u[m]);
+    reunit(u[m]);
+  }
+
+  Handle< FermState<LatticeFermion,
+    multi1d<LatticeColorMatrix>,
+    multi1d<LatticeColorMatrix> > > state(new PeriodicFermState<LatticeFermion,
+					  multi1d<LatticeColorMatrix>,
+					  multi1d<LatticeColorMatrix> >(u));
+
+  Handle< LinearOperator<LatticeFermion> > M(new UnprecWilsonLinOp(state, Real(0.1)));
+
+  std::istringstream input(xml_for_param);
+  XMLReader xml_in(input);
+  Handle< LinOpSystemSolver<LatticeFermion> > 
+    solver(TheLinOpFermSystemSolverFactory::Instance().createObject("FGMRESDR_INVERTER", xml_in, 
+								     "/Params/InvertParam", state, M));
+
+  const Real RsdTarget = 1.0e-8;
+  const int MaxCG = 2000;
+
+  LatticeFermion chi, psi, psi_ref, tmp, r;
+  gaussian(chi);
+
+  // Multigrid preconditioned solve of  M psi = chi
+  psi = zero;
+  SystemSolverResults_t res = (*solver)(psi, chi);
+
+  (*M)(r, psi, PLUS);
+  r -= chi;
+  Double resid = sqrt(norm2(r) / norm2(chi));
+
+  // Reference solution  psi = (M^dag M)^-1 M^dag chi  by plain CG
+  (*M)(tmp, chi, MINUS);
+  psi_ref = zero;
+  SystemSolverResults_t res_ref = InvCG2(*M, tmp, psi_ref, RsdTarget, MaxCG);
+
+  (*M)(r, psi_ref, PLUS);
+  r -= chi;
+  Double resid_ref = sqrt(norm2(r) / norm2(chi));
+
+  Double rel = sqrt(norm2(psi - psi_ref) / norm2(psi_ref));
+
+  QDPIO::cout << "MULTIGRID test: iterations = " << res.n_count << " (CG2: " << res_ref.n_count << ")"
+	      << " true resid = " << resid << " (CG2: " << resid_ref << ")"
+	      << " || psi - psi_cg2 || / || psi_cg2 || = " << rel << std::endl;
+
+  if ( toBool(resid > Real(10)*RsdTarget) )
+    QDPIO::cout << "MULTIGRID test: FAILED" << std::endl;
+
+  push(xml,"MULTIGRID_correctness_test");
+  write(xml,"n_count", res.n_count);
+  write(xml,"n_count_cg2", res_ref.n_count);
+  write(xml,"true_resid", resid);
+  write(xml,"true_resid_cg2", resid_ref);
+  write(xml,"rel_diff",rel);
+  pop(xml);
+
+  pop(xml);
+  
+  // Time to bolt
+  Chroma::finalize();
+
+  exit(0);
+}
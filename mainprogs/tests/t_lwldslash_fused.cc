@@ -0,0 +1,285 @@
+
+
+#include "chroma.h"
+#include "actions/ferm/linop/lwldslash_fused_w.h"
+#include <iostream>
+#include <cstdio>
+
+
+using namespace Chroma;
+
+
+//! Time a dslash on one checkerboard and sign, returning Mflops
+template<typename D>
+float timeDslash(const D& dslash, LatticeFermion& chi, const LatticeFermion& psi,
+		 enum PlusMinus isign, int cb, int iter)
+{
+  QDP::StopWatch swatch;
+  swatch.reset();
+  swatch.start(); 
+  for(int i=iter; i-- > 0; ) {
+    dslash.apply(chi, psi, isign, cb);
+  }
+  swatch.stop();
+      
+  double mydt=swatch.getTimeInSeconds();
+  mydt=1.0e6*mydt/double(iter*(Layout::sitesOnNode()/2));
+  QDPInternal::globalSum(mydt);
+  mydt /= Layout::numNodes();
+ 
+  return float(1320.0f/mydt);
+}
+
+
+int main(int argc, char **argv)
+{
+  // Put the machine into a known state
+  Chroma::initialize(&argc, &argv);
+
+  // Lattice Size
+  multi1d<int> nrow(Nd);
+  for(int mu=0; mu < Nd; ++mu)
+    nrow[mu] = 8;
+  
+  // Setup the layout
+  Layout::setLattSize(nrow);
+  Layout::create();
+
+  XMLFileWriter xml(Chroma::getXMLOutputFileName());
+  push(xml,"t_lwldslash_fused");
+  proginfo(xml);    // Print out basic program info
+
+  // Make up a random gauge field.
+  multi1d<LatticeColorMatrix> u(Nd);
+  for(int m=0; m < u.size(); ++m)
+    gaussian(u[m]);
+
+  // Make up a gaussian source and a zero result std::vector
+  LatticeFermion psi, chi, chi2, chi3;
+  gaussian(psi);
+  gaussian(chi3);
+
+  Handle< FermState<LatticeFermion,
+    multi1d<LatticeColorMatrix>,
+    multi1d<LatticeColorMatrix> > > state(new PeriodicFermState<LatticeFermion,
+					  multi1d<LatticeColorMatrix>,
+					  multi1d<LatticeColorMatrix> >(u));
+
+  // Naive and fused Dslash
+  QDPWilsonDslash D(state);
+  FusedWilsonDslash D_fused(state);
+
+  for(int cb = 0; cb < 2; cb++) { 
+    for(int isign = 1; isign >= -1; isign -= 2) { 
+
+      chi = chi3;
+      chi2 = chi3;
+      D.apply(chi, psi, (isign > 0 ? PLUS : MINUS), cb);
+      D_fused.apply(chi2, psi, (isign > 0 ? PLUS : MINUS), cb);
+      
+      Double n2 = norm2( chi2 - chi );
+
+      QDPIO::cout << "FUSED test: || D(psi, "
+		  << (isign > 0 ? "+, " : "-, ") <<  cb 
+		  << ") - D_fused(psi, " 
+		  << (isign > 0 ? "+, " : "-, ") <<  cb << " ) ||  = " << n2 
+		  << std::endl;
+
+      push(xml,"FUSED_correctness_test");
+      write(xml,"isign", isign);
+      write(xml,"cb", cb);
+      write(xml,"norm2_diff",n2);
+      pop(xml);
+    }
+  }
+
+  // 12- and 8-real link reconstruction need SU(3) links
+  {
+    multi1d<LatticeColorMatrix> u_su3(Nd);
+    for(int m=0; m < u.size(); ++m)
+    {
+      u_su3[m] = u[m];
+      reunit(u_su3[m]);
+    }
+
+    Handle< FermState<LatticeFermion,
+      multi1d<LatticeColorMatrix>,
+      multi1d<LatticeColorMatrix> > > state_su3(new PeriodicFermState<LatticeFermion,
+						multi1d<LatticeColorMatrix>,
+						multi1d<LatticeColorMatrix> >(u_su3));
+
+    QDPWilsonDslash D_su3(state_su3);
+    FusedWilsonDslash D_comp(state_su3);
+
+    const int recons[2] = {RECONSTRUCT_12, RECONSTRUCT_8};
+    for(int r = 0; r < 2; r++) { 
+      D_comp.setReconstruct(recons[r]);
+
+      for(int cb = 0; cb < 2; cb++) { 
+	for(int isign = 1; isign >= -1; isign -= 2) { 
+
+	  chi = zero;
+	  chi2 = zero;
+	  D_su3.apply(chi, psi, (isign > 0 ? PLUS : MINUS), cb);
+	  D_comp.apply(chi2, psi, (isign > 0 ? PLUS : MINUS), cb);
+      
+	  Double rel = sqrt(norm2(chi2 - chi, rb[cb]) / norm2(chi, rb[cb]));
+
+	  QDPIO::cout << "RECONSTRUCT_" << D_comp.getReconstruct() 
+		      << " test: || D(psi) - D_comp(psi) || / || D(psi) || for isign = "
+		      << isign << " cb = " << cb << " : " << rel << std::endl;
+
+	  push(xml,"RECONSTRUCT_correctness_test");
+	  write(xml,"recon", D_comp.getReconstruct());
+	  write(xml,"isign", isign);
+	  write(xml,"cb", cb);
+	  write(xml,"rel_diff",rel);
+	  pop(xml);
+	}
+      }
+    }
+  }
+
+  // Single precision with the links stored in 16 bits
+  {
+    multi1d<LatticeColorMatrixF> u_f(Nd);
+    for(int m=0; m < u.size(); ++m)
+      u_f[m] = u[m];
+
+    Handle< FermState<LatticeFermionF,
+      multi1d<LatticeColorMatrixF>,
+      multi1d<LatticeColorMatrixF> > > state_f(new PeriodicFermState<LatticeFermionF,
+					       multi1d<LatticeColorMatrixF>,
+					       multi1d<LatticeColorMatrixF> >(u_f));
+
+    QDPWilsonDslashF D_f(state_f);
+    FusedWilsonDslashHalfLinksF D_half(state_f);
+
+    LatticeFermionF psi_f = psi;
+    LatticeFermionF chi_f, chi2_f;
+
+    for(int cb = 0; cb < 2; cb++) { 
+      for(int isign = 1; isign >= -1; isign -= 2) { 
+
+	chi_f = zero;
+	chi2_f = zero;
+	D_f.apply(chi_f, psi_f, (isign > 0 ? PLUS : MINUS), cb);
+	D_half.apply(chi2_f, psi_f, (isign > 0 ? PLUS : MINUS), cb);
+      
+	Double rel = sqrt(norm2(chi2_f - chi_f, rb[cb]) / norm2(chi_f, rb[cb]));
+
+	QDPIO::cout << "HALF_LINKS test: || D(psi) - D_half(psi) || / || D(psi) || for isign = "
+		    << isign << " cb = " << cb << " : " << rel << std::endl;
+
+	push(xml,"HALF_LINKS_correctness_test");
+	write(xml,"isign", isign);
+	write(xml,"cb", cb);
+	write(xml,"rel_diff",rel);
+	pop(xml);
+      }
+    }
+  }
+
+  // Face exchange overlapped with the interior sites. Without a split
+  // direction this runs the ordinary path
+  {
+    FusedWilsonDslash D_overlap(state);
+    D_overlap.setCommsOverlap(true);
+
+    QDPIO::cout << "Comms overlap active: " << D_overlap.getCommsOverlap() << std::endl;
+
+    for(int cb = 0; cb < 2; cb++) { 
+      for(int isign = 1; isign >= -1; isign -= 2) { 
+
+	chi = zero;
+	chi2 = zero;
+	D.apply(chi, psi, (isign > 0 ? PLUS : MINUS), cb);
+	D_overlap.apply(chi2, psi, (isign > 0 ? PLUS : MINUS), cb);
+      
+	Double rel = sqrt(norm2(chi2 - chi, rb[cb]) / norm2(chi, rb[cb]));
+
+	QDPIO::cout << "OVERLAP test: || D(psi) - D_overlap(psi) || / || D(psi) || for isign = "
+		    << isign << " cb = " << cb << " : " << rel << std::endl;
+
+	push(xml,"OVERLAP_correctness_test");
+	write(xml,"isign", isign);
+	write(xml,"cb", cb);
+	write(xml,"rel_diff",rel);
+	pop(xml);
+      }
+    }
+
+    for(int cb = 0; cb < 2; cb++) { 
+      for(int isign = 1; isign >= -1; isign -= 2) { 
+	float mflops_overlap = timeDslash(D_overlap, chi, psi, (isign > 0 ? PLUS : MINUS), cb, 50);
+
+	QDPIO::cout << "cb = " << cb << " isign = " << isign 
+		    << " overlapped: " << mflops_overlap << " Mflops" << std::endl;
+
+	push(xml,"OVERLAP_timing_test");
+	write(xml,"cb",cb);
+	write(xml,"isign",isign);
+	write(xml,"mflops_overlap",mflops_overlap);
+	pop(xml);
+      }
+    }
+  }
+
+  // A block of sources with shared link loads
+  {
+    const int nsrc = 3;
+    multi1d<LatticeFermion> psi_b(nsrc), chi_b;
+    for(int k=0; k < nsrc; ++k)
+      gaussian(psi_b[k]);
+
+    for(int cb = 0; cb < 2; cb++) { 
+      for(int isign = 1; isign >= -1; isign -= 2) { 
+
+	D_fused.applyBlock(chi_b, psi_b, (isign > 0 ? PLUS : MINUS), cb);
+
+	Double rel = 0;
+	for(int k=0; k < nsrc; ++k)
+	{
+	  chi = zero;
+	  D.apply(chi, psi_b[k], (isign > 0 ? PLUS : MINUS), cb);
+	  rel += norm2(chi_b[k] - chi, rb[cb]) / norm2(chi, rb[cb]);
+	}
+	rel = sqrt(rel);
+
+	QDPIO::cout << "BLOCK test: || D(psi_k) - D_fused.applyBlock(psi)_k || / || D(psi_k) || for isign = "
+		    << isign << " cb = " << cb << " : " << rel << std::endl;
+
+	push(xml,"BLOCK_correctness_test");
+	write(xml,"isign", isign);
+	write(xml,"cb", cb);
+	write(xml,"rel_diff",rel);
+	pop(xml);
+      }
+    }
+  }
+
+  const int iter = 50;
+  for(int cb = 0; cb < 2; cb++) { 
+    for(int isign = 1; isign >= -1; isign -= 2) { 
+      float mflops = timeDslash(D, chi, psi, (isign > 0 ? PLUS : MINUS), cb, iter);
+      float mflops_fused = timeDslash(D_fused, chi, psi, (isign > 0 ? PLUS : MINUS), cb, iter);
+
+      QDPIO::cout << "cb = " << cb << " isign = " << isign 
+		  << " naive: " << mflops << " Mflops  fused: " << mflops_fused << " Mflops" << std::endl;
+
+      push(xml,"FUSED_timing_test");
+      write(xml,"cb",cb);
+      write(xml,"isign",isign);
+      write(xml,"mflops",mflops);
+      write(xml,"mflops_fused",mflops_fused);
+      pop(xml);
+    }
+  }
+
+  pop(xml);
+  
+  // Time to bolt
+  Chroma::finalize();
+
+  exit(0);
+}
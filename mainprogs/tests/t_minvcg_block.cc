@@ -0,0 +1,95 @@
+#include "chroma.h"
+#include "actions/ferm/invert/minvcg_block.h"
+#include "actions/ferm/invert/minvcg2.h"
+#include "actions/ferm/linop/unprec_wilson_linop_w.h"
+#include <iostream>
+#include <cstdio>
+
+
+using namespace Chroma;
+
+
+int main(int argc, char **argv)
+{
+  // Put the machine into a known state
+  Chroma::initialize(&argc, &argv);
+
+  // Lattice Size
+  multi1d<int> nrow(Nd);
+  for(int mu=0; mu < Nd; ++mu)
+    nrow[mu] = 8;
+  
+  // Setup the layout
+  Layout::setLattSize(nrow);
+  Layout::create();
+
+  XMLFileWriter xml(Chroma::getXMLOutputFileName());
+  push(xml,"t_minvcg_block");
+  proginfo(xml);    // Print out basic program info
+
+  // Make up a random SU(3) gauge field.
+  multi1d<LatticeColorMatrix> u(Nd);
+  for(int m=0; m < u.size(); ++m)
+  {
+    gaussian(u[m]);
+    reunit(u[m]);
+  }
+
+  Handle< FermState<LatticeFermion,
+    multi1d<LatticeColorMatrix>,
+    multi1d<LatticeColorMatrix> > > state(new PeriodicFermState<LatticeFermion,
+					  multi1d<LatticeColorMatrix>,
+					  multi1d<LatticeColorMatrix> >(u));
+
+  UnprecWilsonLinOp M(state, Real(0.5));
+
+  const int n_src = 3;
+  multi1d<LatticeFermion> chi(n_src);
+  for(int n=0; n < n_src; ++n)
+    gaussian(chi[n]);
+
+  multi1d<Real> shifts(3);
+  shifts[0] = 0.0;
+  shifts[1] = 0.1;
+  shifts[2] = 1.0;
+
+  multi1d<Real> RsdCG(shifts.size());
+  RsdCG = 1.0e-10;
+  const int MaxCG = 1000;
+
+  // All sources together
+  multi1d< multi1d<LatticeFermion> > psi;
+  SystemSolverResults_t res = MInvCGBlock(M, chi, psi, shifts, RsdCG, MaxCG);
+
+  // Reference solutions, one source at a time
+  for(int n=0; n < n_src; ++n)
+  {
+    multi1d<LatticeFermion> psi_ref;
+    int n_count_ref;
+    MInvCG2(M, chi[n], psi_ref, shifts, RsdCG, MaxCG, n_count_ref);
+
+    for(int s=0; s < shifts.size(); ++s)
+    {
+      Double rel = sqrt(norm2(psi[n][s] - psi_ref[s]) / norm2(psi_ref[s]));
+
+      QDPIO::cout << "BLOCK test: source = " << n << " shift = " << shifts[s]
+		  << " iterations = " << res.n_count << " (MInvCG2: " << n_count_ref << ")"
+		  << " || psi - psi_cg2 || / || psi_cg2 || = " << rel << std::endl;
+
+      push(xml,"MINVCG_BLOCK_correctness_test");
+      write(xml,"source", n);
+      write(xml,"shift", shifts[s]);
+      write(xml,"n_count", res.n_count);
+      write(xml,"n_count_cg2", n_count_ref);
+      write(xml,"rel_diff",rel);
+      pop(xml);
+    }
+  }
+
+  pop(xml);
+  
+  // Time to bolt
+  Chroma::finalize();
+
+  exit(0);
+}
@@ -0,0 +1,104 @@
+#include "chroma.h"
+#include "update/molecdyn/hamiltonian/repro_sum.h"
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+#include <cstdio>
+
+
+using namespace Chroma;
+
+
+//! All digits of a double, to compare runs on different layouts
+std::string allDigits(const Double& d)
+{
+  std::ostringstream os;
+  os << std::setprecision(17) << toDouble(d);
+  return os.str();
+}
+
+
+int main(int argc, char **argv)
+{
+  // Put the machine into a known state
+  Chroma::initialize(&argc, &argv);
+
+  // Lattice Size
+  multi1d<int> nrow(Nd);
+  for(int mu=0; mu < Nd; ++mu)
+    nrow[mu] = 8;
+  
+  // Setup the layout
+  Layout::setLattSize(nrow);
+  Layout::create();
+
+  XMLFileWriter xml(Chroma::getXMLOutputFileName());
+  push(xml,"t_repro_sum");
+  proginfo(xml);    // Print out basic program info
+
+  // Values of very different size, so the order of an ordinary sum matters
+  LatticeReal f, g;
+  gaussian(f);
+  gaussian(g);
+  f *= exp(Real(8)*g);
+
+  setReproducibleSums(true);
+  Double s_repro = reproSum(f);
+  Double s_plain = sum(f);
+
+  QDPIO::cout << "REPRO_SUM: reproSum = " << allDigits(s_repro) 
+	      << " sum = " << allDigits(s_plain) << std::endl;
+
+  push(xml,"REPRO_SUM_layout_test");
+  write(xml,"nodes", Layout::numNodes());
+  write(xml,"threads", qdpNumThreads());
+  write(xml,"repro_sum", allDigits(s_repro));
+  write(xml,"plain_sum", allDigits(s_plain));
+  pop(xml);
+
+#ifndef QDP_IS_QDPJIT
+  // The same sites in reverse order, split over 1 to 64 partial sums as
+  // different thread counts would do. All must give the same bits.
+  const int n = Layout::sitesOnNode();
+  for(int nt = 1; nt <= 64; nt *= 4)
+  {
+    multi1d<ReproSumAccumulator> part(nt);
+    for(int site = n-1; site >= 0; --site)
+      part[(site*nt)/n].add(double(f.elem(site).elem().elem().elem()));
+
+    ReproSumAccumulator tot;
+    for(int t = nt-1; t >= 0; --t)
+      tot.add(part[t]);
+
+    Double s = tot.globalSum();
+    bool same = (toDouble(s) == toDouble(s_repro));
+
+    QDPIO::cout << "REPRO_SUM test: partial sums = " << nt << " sum = " << allDigits(s)
+		<< (same ? " same bits" : " FAILED") << std::endl;
+
+    push(xml,"REPRO_SUM_thread_test");
+    write(xml,"partial_sums", nt);
+    write(xml,"repro_sum", allDigits(s));
+    write(xml,"same_bits", same);
+    pop(xml);
+  }
+#endif
+
+  // The expression versions against the ordinary norm2
+  LatticeFermion psi;
+  gaussian(psi);
+  Double rel = fabs(reproNorm2(psi, rb[1]) - norm2(psi, rb[1])) / norm2(psi, rb[1]);
+
+  QDPIO::cout << "REPRO_NORM2 test: | reproNorm2 - norm2 | / norm2 = " << rel << std::endl;
+
+  push(xml,"REPRO_NORM2_test");
+  write(xml,"rel_diff", rel);
+  pop(xml);
+
+  pop(xml);
+  
+  // Time to bolt
+  Chroma::finalize();
+
+  exit(0);
+}
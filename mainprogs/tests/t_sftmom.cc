@@ -0,0 +1,172 @@
+#include "chroma.h"
+#include "util/ft/sftmom.h"
+#include <iostream>
+#include <cstdio>
+
+
+using namespace Chroma;
+
+
+//! Largest difference of two transforms, relative to the largest entry
+Double maxRelDiff(const multi2d<DComplex>& a, const multi2d<DComplex>& b)
+{
+  Double d = 0;
+  Double n = 0;
+  for(int m=0; m < a.size2(); ++m)
+    for(int t=0; t < a.size1(); ++t)
+    {
+      d = max(d, Double(sqrt(norm2(a[m][t] - b[m][t]))));
+      n = max(n, Double(sqrt(norm2(a[m][t]))));
+    }
+
+  return d / n;
+}
+
+
+//! Compare the transform by directions with the sumMulti over the phases
+void testSft(XMLWriter& xml, const std::string& name, const SftMom& phases,
+	     const LatticeComplex& cf, const LatticeReal& rf)
+{
+  Double diff = 0;
+
+  setSftMomFFT(false);
+  multi2d<DComplex> c_ref = phases.sft(cf);
+  multi2d<DComplex> r_ref = phases.sft(rf);
+
+  setSftMomFFT(true);
+  diff = max(diff, maxRelDiff(phases.sft(cf), c_ref));
+  diff = max(diff, maxRelDiff(phases.sft(rf), r_ref));
+
+  // The subset versions, one time slice at a time
+  for(int t=0; t < phases.numSubsets(); ++t)
+  {
+    setSftMomFFT(false);
+    multi2d<DComplex> c_t = phases.sft(cf, t);
+    multi2d<DComplex> r_t = phases.sft(rf, t);
+
+    setSftMomFFT(true);
+    diff = max(diff, maxRelDiff(phases.sft(cf, t), c_t));
+    diff = max(diff, maxRelDiff(phases.sft(rf, t), r_t));
+  }
+
+  setSftMomFFT(false);
+
+  QDPIO::cout << "SFTMOM test: " << name << " num_mom = " << phases.numMom()
+	      << " max | fft - sumMulti | / max | sumMulti | = " << diff
+	      << (toBool(diff > Real(1.0e-5)) ? " FAILED" : "") << std::endl;
+
+  push(xml,"SFTMOM_FFT_test");
+  write(xml,"name", name);
+  write(xml,"num_mom", phases.numMom());
+  write(xml,"rel_diff", diff);
+  pop(xml);
+}
+
+
+//! Compare bounded phases with the phases all kept
+void testBounded(XMLWriter& xml, const SftMom& bounded, const SftMom& full,
+		 const LatticeComplex& cf)
+{
+  const Set& set = full.getSet();
+  Double diff = 0;
+
+  // In an order that evicts the kept phases, holding on to the first one
+  LatticeComplex first = bounded[0];
+  for(int m = full.numMom()-1; m >= 0; --m)
+    diff = max(diff, Double(norm2(bounded[m] - full[m])));
+  for(int m=0; m < full.numMom(); ++m)
+    diff = max(diff, Double(norm2(bounded[(3*m) % full.numMom()] - full[(3*m) % full.numMom()])));
+  diff = max(diff, Double(norm2(first - full[0])));
+
+  // The phases on a single time slice
+  LatticeComplex tmp;
+  for(int t=0; t < full.numSubsets(); ++t)
+    for(int m=0; m < full.numMom(); ++m)
+      diff = max(diff, Double(norm2(bounded.slicePhase(tmp, m, t) - full[m], set[t])));
+
+  QDPIO::cout << "SFTMOM bounded test: max | phase - phase_all_kept |^2 = " << diff
+	      << (toBool(diff > Real(0)) ? " FAILED" : "") << std::endl;
+
+  // The transforms, which do not go through operator[]
+  Double sft_diff = maxRelDiff(bounded.sft(cf), full.sft(cf));
+  for(int t=0; t < full.numSubsets(); ++t)
+    sft_diff = max(sft_diff, maxRelDiff(bounded.sft(cf, t), full.sft(cf, t)));
+
+  QDPIO::cout << "SFTMOM bounded test: max | sft - sft_all_kept | / max | sft_all_kept | = " << sft_diff
+	      << (toBool(sft_diff > Real(1.0e-5)) ? " FAILED" : "") << std::endl;
+
+  push(xml,"SFTMOM_bounded_test");
+  write(xml,"phase_diff", diff);
+  write(xml,"sft_rel_diff", sft_diff);
+  pop(xml);
+}
+
+
+int main(int argc, char **argv)
+{
+  // Put the machine into a known state
+  Chroma::initialize(&argc, &argv);
+
+  // Lattice Size, not the same in all directions
+  multi1d<int> nrow(Nd);
+  for(int mu=0; mu < Nd; ++mu)
+    nrow[mu] = 4 + 2*mu;
+  
+  // Setup the layout
+  Layout::setLattSize(nrow);
+  Layout::create();
+
+  XMLFileWriter xml(Chroma::getXMLOutputFileName());
+  push(xml,"t_sftmom");
+  proginfo(xml);    // Print out basic program info
+
+  LatticeComplex cf;
+  LatticeReal rf;
+  gaussian(cf);
+  gaussian(rf);
+
+  const int j_decay = Nd-1;
+
+  testSft(xml, "plain", SftMom(3, false, j_decay), cf, rf);
+  testSft(xml, "avg_equiv_mom", SftMom(3, true, j_decay), cf, rf);
+  testSft(xml, "no_decay_dir", SftMom(2, false, -1), cf, rf);
+
+  // Shifted origin and momentum offset
+  multi1d<int> origin_offset(Nd);
+  for(int mu=0; mu < Nd; ++mu)
+    origin_offset[mu] = mu+1;
+
+  multi1d<int> mom_offset(Nd-1);
+  mom_offset = 0;
+  mom_offset[0] = 1;
+
+  testSft(xml, "origin_offset", SftMom(2, origin_offset, false, j_decay), cf, rf);
+  testSft(xml, "mom_offset", SftMom(2, origin_offset, mom_offset, false, j_decay), cf, rf);
+  testSft(xml, "mom_offset_avg", SftMom(2, origin_offset, mom_offset, true, j_decay), cf, rf);
+
+  // A list of momenta
+  multi2d<int> moms(3, Nd-1);
+  moms = 0;
+  moms[1][0] = 1;
+  moms[2][0] = -1;
+  moms[2][1] = 2;
+  moms[2][2] = 1;
+  testSft(xml, "mom_list", SftMom(moms, j_decay), cf, rf);
+
+  // At most 2 of the phases kept, made on demand
+  {
+    SftMom full(2, origin_offset, mom_offset, true, j_decay);
+    setSftMomMaxPhases(2);
+    SftMom bounded(2, origin_offset, mom_offset, true, j_decay);
+    setSftMomMaxPhases(0);
+
+    testBounded(xml, bounded, full, cf);
+  }
+
+  pop(xml);
+  
+  // Time to bolt
+  Chroma::finalize();
+
+  exit(0);
+}